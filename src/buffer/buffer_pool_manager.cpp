@@ -15,8 +15,13 @@
  */
 
 #include "buffer/buffer_pool_manager.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <thread>
 #include "common/config.h"
+#include "common/stats.h"
+#include "recovery/log_manager.h"
 
 namespace easydb {
 
@@ -26,6 +31,9 @@ namespace easydb {
  * See the documentation for `BufferPoolManager` in "buffer/buffer_pool_manager.h" for more information.
  * @param num_frames The size of the buffer pool.
  * @param disk_manager The disk manager.
+ * @param num_partitions The number of latch partitions the frames are split into.
+ * @param replacer_type The replacement policy of the partitions.
+ * @param use_huge_pages Back the frame data with 2 MiB pages.
  * @param k_dist The backward k-distance for the LRU-K replacer.
  * @param log_manager The log manager. Please ignore this for P1.
  */
@@ -41,23 +49,56 @@ namespace easydb {
 //   // Not strictly necessary...
 //   std::scoped_lock latch(*bpm_latch_);
 
-BufferPoolManager::BufferPoolManager(size_t num_frames, DiskManager *disk_manager)
-    : num_frames_(num_frames),
-      replacer_(std::make_unique<LRUReplacer>(num_frames)),
-      disk_manager_(disk_manager)
-//   disk_manager_(std::make_unique<DiskManager>(disk_manager)) {
-{
-  // Allocate all of the in-memory frames up front.
-  frames_ = new Page[num_frames_];
-
-  // // The page table should have exactly `num_frames_` slots, corresponding to exactly `num_frames_` frames.
+BufferPoolPartition::BufferPoolPartition(frame_id_t first_frame, size_t num_frames, const std::string &replacer_type)
+    : first_frame_(first_frame),
+      num_frames_(num_frames),
+      replacer_(MakeReplacer(replacer_type, num_frames)),
+      io_pending_(num_frames, false),
+      lookup_(num_frames),
+      frame_keys_(std::make_unique<std::atomic<uint64_t>[]>(num_frames)),
+      replacer_pinned_(std::make_unique<std::atomic<bool>[]>(num_frames)),
+      referenced_(std::make_unique<std::atomic<bool>[]>(num_frames)) {
+  // The page table should have exactly `num_frames_` slots, corresponding to exactly `num_frames_` frames.
   page_table_.reserve(num_frames_);
+  for (size_t i = 0; i < num_frames_; i++) {
+    frame_keys_[i].store(FrameLookupTable::NO_PAGE, std::memory_order_relaxed);
+    replacer_pinned_[i].store(false, std::memory_order_relaxed);
+    referenced_[i].store(false, std::memory_order_relaxed);
+  }
 
-  // Initialize all of the frame headers, and fill the free frame list with all possible frame IDs (since all frames are
-  // initially free).
+  // All frames are initially free.
   for (size_t i = 0; i < num_frames_; i++) {
-    // frames_.push_back(std::make_shared<PageId>());
-    free_frames_.push_back(static_cast<int>(i));
+    free_frames_.push_back(ToGlobal(static_cast<frame_id_t>(i)));
+  }
+}
+
+BufferPoolManager::BufferPoolManager(size_t num_frames, DiskManager *disk_manager, size_t num_partitions,
+                                     const std::string &replacer_type, bool use_huge_pages)
+    : num_frames_(num_frames), arena_(num_frames, use_huge_pages), disk_manager_(disk_manager) {
+  // Allocate all of the in-memory frames up front, the frame headers are separate from the frame data.
+  frames_ = new Page[num_frames_];
+  for (size_t i = 0; i < num_frames_; i++) {
+    frames_[i].data_ = arena_.GetFrameData(static_cast<frame_id_t>(i));
+  }
+
+  // Every partition needs at least one frame.
+  num_partitions = std::max<size_t>(1, std::min(num_partitions, num_frames_));
+
+  // Split the frames into contiguous ranges, the first `num_frames_ % num_partitions` partitions get one more frame.
+  size_t first_frame = 0;
+  for (size_t i = 0; i < num_partitions; i++) {
+    size_t partition_frames = num_frames_ / num_partitions + (i < num_frames_ % num_partitions ? 1 : 0);
+    partitions_.push_back(
+        std::make_unique<BufferPoolPartition>(static_cast<frame_id_t>(first_frame), partition_frames, replacer_type));
+    first_frame += partition_frames;
+  }
+
+  if (PREFETCH_THREADS > 0) {
+    prefetcher_ = std::make_unique<PagePrefetcher>(this, PREFETCH_THREADS);
+  }
+  if (PAGE_WRITER_MAX_PAGES > 0) {
+    page_writer_ = std::make_unique<PageWriter>(this, std::chrono::milliseconds(PAGE_WRITER_INTERVAL_MS),
+                                                PAGE_WRITER_MAX_PAGES);
   }
 }
 
@@ -65,53 +106,78 @@ BufferPoolManager::BufferPoolManager(size_t num_frames, DiskManager *disk_manage
  * @brief Destroys the `BufferPoolManager`, freeing up all memory that the buffer pool was using.
  */
 // BufferPoolManager::~BufferPoolManager() = default;
-BufferPoolManager::~BufferPoolManager() { delete[] frames_; };
+BufferPoolManager::~BufferPoolManager() {
+  // the read-ahead workers and the page writer use the frames, stop them first
+  prefetcher_.reset();
+  page_writer_.reset();
+  delete[] frames_;
+};
 
 /**
  * @brief Returns the number of frames that this buffer pool manages.
  */
 auto BufferPoolManager::Size() const -> size_t { return num_frames_; }
 
+auto BufferPoolManager::GetAccessStats(AccessType type) -> BufferPoolAccessStats {
+  BufferPoolAccessStats stats;
+  for (auto &partition : partitions_) {
+    std::scoped_lock lock{partition->latch_};
+    size_t optimistic_hits = partition->optimistic_hits_[static_cast<int>(type)].load(std::memory_order_relaxed);
+    stats.hits += partition->hits_[static_cast<int>(type)] + optimistic_hits;
+    stats.misses += partition->misses_[static_cast<int>(type)];
+    stats.optimistic_hits += optimistic_hits;
+  }
+  return stats;
+}
+
+auto BufferPoolManager::GetWriteStats() -> BufferPoolWriteStats {
+  BufferPoolWriteStats stats;
+  for (auto &partition : partitions_) {
+    std::scoped_lock lock{partition->latch_};
+    stats.sync_evictions += partition->sync_evictions_;
+    stats.clean_evictions += partition->clean_evictions_;
+    stats.background_writes += partition->background_writes_count_;
+  }
+  return stats;
+}
+
+void BufferPoolManager::PrefetchPages(int fd, page_id_t first_page, int num_pages,
+                                      std::shared_ptr<BufferAccessStrategy> strategy) {
+  if (IsPrefetchEnabled()) {
+    prefetcher_->Prefetch(fd, first_page, num_pages, std::move(strategy));
+  }
+}
+
+void BufferPoolManager::PrefetchChain(PageId first_page, int num_pages, PagePrefetcher::NextPageFn next_page) {
+  if (IsPrefetchEnabled()) {
+    prefetcher_->PrefetchChain(first_page, num_pages, std::move(next_page), nullptr);
+  }
+}
+
 /**
  * @brief Allocates a new page on disk.
  * @return The page ID of the newly allocated page.
+ * @note The page number is taken from the DiskManager before the owning partition is known, so it is consumed even if
+ *       the partition has no victim frame and nullptr is returned.
  */
-auto BufferPoolManager::NewPage(PageId *page_id) -> Page * {
-  // std::cerr << "[BufferPoolManager] NewPage" << std::endl;
-  //  std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
-
-  // 1. Find a victim frame
-  frame_id_t frame_id;
-  if (!FindVictimPage(&frame_id)) {
-    return nullptr;
-  }
-
-  // 2. Allocate a new PageId from the DiskManager
+auto BufferPoolManager::NewPage(PageId *page_id, BufferAccessStrategy *strategy) -> Page * {
+  // 1. Allocate a new PageId from the DiskManager, it decides which partition owns the page
   int fd = page_id->fd;  // Get the file descriptor from page_id
   page_id->page_no = disk_manager_->AllocatePage(fd);
 
-  // Page* page = &pages_[frame_id];
-  Page *frame = &frames_[frame_id];
+  auto &partition = GetPartition(*page_id);
+  std::unique_lock lock{partition.latch_};
 
-  // 3. If the frame is dirty, flush its content to disk
-  if (frame->is_dirty_) {
-    disk_manager_->WritePage(frame->page_id_.fd, frame->page_id_.page_no, frame->GetData(), PAGE_SIZE);
+  // 2. Find a victim frame
+  frame_id_t frame_id;
+  if (!FindVictimPage(partition, strategy, *page_id, &frame_id)) {
+    return nullptr;
   }
 
-  // Update the page table
-  page_table_.erase(frame->page_id_);
-  page_table_[*page_id] = frame_id;
-
-  // 4. Update the frame with the new page ID and pin it
-  replacer_->Pin(frame_id);
-  // Reset the page memory
-  frame->ResetMemory();
-  frame->page_id_ = *page_id;
-  frame->pin_count_ = 1;
-  frame->is_dirty_ = false;
+  // 3. Write back the victim if it is dirty, and hand the zeroed frame over to the new page, pinned once
+  LoadFrame(partition, lock, frame_id, *page_id, false);
 
-  return frame;
+  return &frames_[frame_id];
 }
 
 /**
@@ -124,22 +190,24 @@ auto BufferPoolManager::NewPage(PageId *page_id) -> Page * {
  * @return `false` if the page exists but could not be deleted, `true` if the page didn't exist or deletion succeeded.
  */
 auto BufferPoolManager::DeletePage(PageId page_id) -> bool {
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
+  auto &partition = GetPartition(page_id);
+  std::unique_lock lock{partition.latch_};
+  WaitForBackgroundWrite(partition, lock, page_id);
 
   // 1. Search for the target page in the page_table_
-  auto it = page_table_.find(page_id);
-  if (it == page_table_.end()) {
+  auto it = partition.page_table_.find(page_id);
+  if (it == partition.page_table_.end()) {
     // If the page is not found, return true
     return true;
   }
 
   frame_id_t frame_id = it->second;
-  // Page* page = &pages_[frame_id];
+  frame_id_t local_id = partition.ToLocal(frame_id);
   Page *frame = &frames_[frame_id];
 
-  // 2. If the target page's pin_count_ is not 0, return false
-  if (frame->pin_count_ != 0) {
+  // 2. If the target page is pinned, return false (a frame under I/O is always pinned); otherwise claim the frame so
+  //    that the optimistic hit path can not pin it any more
+  if (!TryClaimFrame(partition, local_id)) {
     return false;
   }
 
@@ -148,17 +216,19 @@ auto BufferPoolManager::DeletePage(PageId page_id) -> bool {
     disk_manager_->WritePage(frame->page_id_.fd, frame->page_id_.page_no, frame->GetData(), PAGE_SIZE);
   }
 
-  // Remove the page from the page_table_
-  page_table_.erase(it);
+  // Remove the page from the page_table_ and the replacer
+  partition.page_table_.erase(it);
+  partition.replacer_->Remove(local_id);
+  partition.replacer_pinned_[local_id] = false;
 
-  // Reset the page's metadata
+  // Reset the page's metadata and drop the claim
   frame->ResetMemory();
   frame->page_id_ = {-1, INVALID_PAGE_ID};
   frame->is_dirty_ = false;
-  frame->pin_count_ = 0;
+  frame->pin_count_.fetch_sub(1);
 
   // Add the frame to the free_frames_
-  free_frames_.push_back(frame_id);
+  partition.free_frames_.push_back(frame_id);
 
   return true;
 }
@@ -167,28 +237,43 @@ auto BufferPoolManager::DeletePage(PageId page_id) -> bool {
  * @brief Flushes a page's data out to disk.
  * @param page_id The page ID of the page to be flushed.
  * @return `false` if the page could not be found in the page table, otherwise `true`.
+ * @note The page is pinned while it is written, the write itself is done without the partition latch.
  */
 auto BufferPoolManager::FlushPage(PageId page_id) -> bool {
-  // std::cerr << "[BufferPoolManager] FlushPage" << std::endl;
-  //  std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
+  auto &partition = GetPartition(page_id);
+  std::unique_lock lock{partition.latch_};
 
   // 1. Search for the page in the page_table_
-  auto it = page_table_.find(page_id);
+  auto it = partition.page_table_.find(page_id);
   // 1.1 If the page is not found, return false
-  if (it == page_table_.end()) {
+  if (it == partition.page_table_.end()) {
     return false;
   }
 
   frame_id_t frame_id = it->second;
-  // Page* page = &pages_[frame_id];
+  frame_id_t local_id = partition.ToLocal(frame_id);
   Page *frame = &frames_[frame_id];
 
-  // 2. Write the page's data to the disk
-  disk_manager_->WritePage(page_id.fd, page_id.page_no, frame->GetData(), PAGE_SIZE);
+  // 2. Pin the page so that it can not be evicted while it is written, and wait for it to be loaded
+  PinFrame(partition, local_id);
+  partition.io_cv_.wait(lock, [&] {
+    return !partition.io_pending_[local_id] && partition.background_writes_.count(page_id) == 0;
+  });
 
-  // 3. Update the is_dirty_ flag of the page
+  // 3. Clear the is_dirty_ flag before writing, so that a concurrent modification marks the page dirty again
   frame->is_dirty_ = false;
+  partition.inflight_io_++;
+  lock.unlock();
+
+  // 4. Write the page's data to the disk
+  disk_manager_->WritePage(page_id.fd, page_id.page_no, frame->GetData(), PAGE_SIZE);
+  Stats::Add(StatCounter::BUFFER_FLUSHED_PAGES);
+
+  lock.lock();
+  partition.inflight_io_--;
+  UnpinFrame(partition, local_id);
+  lock.unlock();
+  partition.io_cv_.notify_all();
 
   return true;
 }
@@ -196,56 +281,154 @@ auto BufferPoolManager::FlushPage(PageId page_id) -> bool {
 /**
  * @brief Flushes all page data in a table (distinguished by fd) that is in memory to disk.
  * @param {int} fd file descriptor
+ * @note Used before the file is closed, so its outstanding read-ahead is cancelled first.
  */
 void BufferPoolManager::FlushAllPages(int fd) {
-  // std::cerr << "[BufferPoolManager] FlushAllPages" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
-
-  // Iterate through the page_table_
-  for (auto &entry : page_table_) {
-    PageId page_id = entry.first;
-    frame_id_t frame_id = entry.second;
-    Page *frame = &frames_[frame_id];
-    // Page* page = &pages_[frame_id];
-
-    // Check if the page belongs to the specified file descriptor
-    if (page_id.fd == fd) {
-      // Write the page's data to the disk
-      disk_manager_->WritePage(page_id.fd, page_id.page_no, frame->GetData(), PAGE_SIZE);
-
-      // Update the is_dirty_ flag of the page
-      frame->is_dirty_ = false;
-    }
+  if (prefetcher_ != nullptr) {
+    prefetcher_->Cancel(fd);
   }
+  FlushPages([fd](const PageId &page_id, const Page &) { return page_id.fd == fd; });
 }
 
 /**
  * @description: This function flushes all dirty pages in the buffer pool to disk.
  * @return {void}
- * @note This function uses a scoped lock to ensure thread safety during the operation.
  */
 void BufferPoolManager::FlushAllDirtyPages() {
-  // std::cerr << "[BufferPoolManager] FlushAllDirtyPages" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
-
-  // Iterate through the page_table_
-  for (auto &entry : page_table_) {
-    PageId page_id = entry.first;
-    frame_id_t frame_id = entry.second;
-    Page *frame = &frames_[frame_id];
-    // Page* page = &pages_[frame_id];
-
-    // Check if the page belongs to the specified file descriptor
-    if (frame->is_dirty_) {
-      // Write the page's data to the disk
-      disk_manager_->WritePage(page_id.fd, page_id.page_no, frame->GetData(), PAGE_SIZE);
-
-      // Update the is_dirty_ flag of the page
+  FlushPages([](const PageId &, const Page &frame) { return frame.IsDirty(); });
+}
+
+/**
+ * @brief Pin the selected pages partition by partition, write all of them with one batched write and unpin them.
+ * @note Frames that are being loaded are skipped: their content is about to be read from disk (or zeroed for a new
+ *       page) and is not dirty.
+ */
+void BufferPoolManager::FlushPages(const std::function<bool(const PageId &, const Page &)> &filter) {
+  std::vector<std::vector<frame_id_t>> pinned(partitions_.size());
+  std::vector<PageIORequest> requests;
+
+  // 1. Pin the selected frames so that they can not be evicted, and clear their dirty flags before the write so that
+  //    a concurrent modification marks them dirty again
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    auto &partition = *partitions_[i];
+    std::unique_lock lock{partition.latch_};
+    // an older copy written by the page writer must not land after the version written here
+    partition.io_cv_.wait(lock, [&] { return partition.background_writes_.empty(); });
+    for (auto &entry : partition.page_table_) {
+      frame_id_t frame_id = entry.second;
+      frame_id_t local_id = partition.ToLocal(frame_id);
+      Page *frame = &frames_[frame_id];
+      if (partition.io_pending_[local_id] || !filter(entry.first, *frame)) {
+        continue;
+      }
+      PinFrame(partition, local_id);
+      frame->is_dirty_ = false;
+      pinned[i].push_back(frame_id);
+      requests.push_back({entry.first.fd, entry.first.page_no, frame->GetData()});
+    }
+    partition.inflight_io_ += pinned[i].size();
+  }
+
+  // 2. Write the pages, adjacent pages of a file go out in one vectored write
+  disk_manager_->WritePageBatch(requests);
+  Stats::Add(StatCounter::BUFFER_FLUSHED_PAGES, requests.size());
+
+  // 3. Unpin the frames
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    if (pinned[i].empty()) {
+      continue;
+    }
+    auto &partition = *partitions_[i];
+    {
+      std::scoped_lock lock{partition.latch_};
+      for (frame_id_t frame_id : pinned[i]) {
+        UnpinFrame(partition, partition.ToLocal(frame_id));
+      }
+      partition.inflight_io_ -= pinned[i].size();
+    }
+    partition.io_cv_.notify_all();
+  }
+}
+
+/**
+ * @brief Write dirty pages ahead of their eviction.
+ * @note The pages are copied under the partition latch and written from the copies, so that no frame is pinned (which
+ *       would count as an access for the replacer). Until a copy is on disk its page is kept in `background_writes_`.
+ *       Only unpinned pages are taken: they are the eviction candidates. The latch does not keep them unpinned though,
+ *       since FetchPageOptimistic() and UnpinPage() pin and unpin published pages without it. So the dirty flag is
+ *       cleared before the copy, as FlushPage() does, and a page that was pinned or dirtied again while it was copied
+ *       is left dirty and skipped: its copy may be torn, and its next round writes it whole.
+ */
+auto BufferPoolManager::WriteBackDirtyPages(size_t max_pages, FrameArena *copies) -> size_t {
+  // WAL: a page may only reach the disk after the log records up to its LSN have
+  lsn_t persist_lsn = log_manager_ != nullptr ? log_manager_->GetPersistLsn() : INVALID_LSN;
+  // page aligned, so that the copies can be written to O_DIRECT files as they are; mapped once a page is found
+  std::unique_ptr<FrameArena> own_copies;
+  std::vector<PageIORequest> requests;
+  std::vector<std::vector<PageId>> taken(partitions_.size());
+
+  // 1. Copy the dirty pages, starting at a different partition each round so that a small `max_pages` still reaches
+  //    all of them
+  size_t first = writer_cursor_.fetch_add(1) % partitions_.size();
+  for (size_t n = 0; n < partitions_.size() && requests.size() < max_pages; n++) {
+    size_t i = (first + n) % partitions_.size();
+    auto &partition = *partitions_[i];
+    std::scoped_lock lock{partition.latch_};
+    for (auto &entry : partition.page_table_) {
+      if (requests.size() == max_pages) {
+        break;
+      }
+      Page *frame = &frames_[entry.second];
+      if (!frame->IsDirty() || frame->GetPinCount() != 0 || partition.io_pending_[partition.ToLocal(entry.second)] ||
+          partition.background_writes_.count(entry.first) != 0) {
+        continue;
+      }
+      if (log_manager_ != nullptr && frame->GetLSN() > persist_lsn) {
+        continue;
+      }
+      if (copies == nullptr) {
+        own_copies = std::make_unique<FrameArena>(max_pages, false);
+        copies = own_copies.get();
+      }
+      char *copy = copies->GetFrameData(static_cast<frame_id_t>(requests.size()));
       frame->is_dirty_ = false;
+      memcpy(copy, frame->GetData(), PAGE_SIZE);
+      if (frame->GetPinCount() != 0 || frame->IsDirty()) {
+        frame->is_dirty_ = true;
+        continue;
+      }
+      partition.background_writes_.insert(entry.first);
+      taken[i].push_back(entry.first);
+      requests.push_back({entry.first.fd, entry.first.page_no, copy});
     }
+    partition.inflight_io_ += taken[i].size();
   }
+
+  if (requests.empty()) {
+    return 0;
+  }
+
+  // 2. Write them in page order, adjacent pages coalesced
+  disk_manager_->WritePageBatch(requests);
+  Stats::Add(StatCounter::BUFFER_BACKGROUND_WRITES, requests.size());
+
+  // 3. Let the waiters of these pages go
+  for (size_t i = 0; i < partitions_.size(); i++) {
+    if (taken[i].empty()) {
+      continue;
+    }
+    auto &partition = *partitions_[i];
+    {
+      std::scoped_lock lock{partition.latch_};
+      for (const PageId &page_id : taken[i]) {
+        partition.background_writes_.erase(page_id);
+      }
+      partition.inflight_io_ -= taken[i].size();
+      partition.background_writes_count_ += taken[i].size();
+    }
+    partition.io_cv_.notify_all();
+  }
+  return requests.size();
 }
 
 /**
@@ -256,19 +439,40 @@ void BufferPoolManager::FlushAllDirtyPages() {
         (fd maybe reused, so residual pages is not true pages from this file)
  */
 void BufferPoolManager::RemoveAllPages(int fd) {
-  std::scoped_lock lock{latch_};
-
-  // Iterate through the page_table_
-  for (auto it = page_table_.begin(); it != page_table_.end();) {
-    PageId page_id = it->first;
-    if (page_id.fd == fd) {
-      frame_id_t frame_id = it->second;
-      Page *frame = &frames_[frame_id];
-      frame->ResetMemory();
-      // Remove the page from the page_table_
-      it = page_table_.erase(it);
-    } else {
-      it++;
+  if (prefetcher_ != nullptr) {
+    prefetcher_->Cancel(fd);
+  }
+  for (auto &partition : partitions_) {
+    std::unique_lock lock{partition->latch_};
+    partition->io_cv_.wait(lock, [&] { return partition->inflight_io_ == 0; });
+
+    // Iterate through the page_table_
+    for (auto it = partition->page_table_.begin(); it != partition->page_table_.end();) {
+      PageId page_id = it->first;
+      if (page_id.fd == fd) {
+        frame_id_t frame_id = it->second;
+        frame_id_t local_id = partition->ToLocal(frame_id);
+        Page *frame = &frames_[frame_id];
+        // An unpinned frame goes back to the free list instead of waiting in the replacer
+        if (TryClaimFrame(*partition, local_id)) {
+          partition->replacer_->Remove(local_id);
+          partition->replacer_pinned_[local_id] = false;
+          frame->ResetMemory();
+          frame->pin_count_.fetch_sub(1);
+          partition->free_frames_.push_back(frame_id);
+        } else {
+          // A pinned frame keeps its data for its holders, nobody else finds it, and its last unpin frees it
+          UnpublishFrame(*partition, local_id);
+          partition->replacer_->Remove(local_id);
+          partition->removed_pages_.emplace(page_id, frame_id);
+          partition->replacer_pinned_[local_id] = true;
+          ReturnToReplacer(*partition, local_id);
+        }
+        // Remove the page from the page_table_
+        it = partition->page_table_.erase(it);
+      } else {
+        it++;
+      }
     }
   }
 }
@@ -283,32 +487,30 @@ void BufferPoolManager::RemoveAllPages(int fd) {
  *
  */
 auto BufferPoolManager::RecoverPage(PageId page_id) -> Page * {
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
+  auto &partition = GetPartition(page_id);
+  std::unique_lock lock{partition.latch_};
+  // Recovery runs alone, but do not race with a write-back that is still in flight.
+  partition.io_cv_.wait(lock, [&] { return partition.inflight_io_ == 0; });
 
   // 1. Search for the target page in page_table_
-  auto it = page_table_.find(page_id);
-  if (it != page_table_.end()) {
+  auto it = partition.page_table_.find(page_id);
+  if (it != partition.page_table_.end()) {
     // 1.1 If the target page is found, pin it and return it
     frame_id_t frame_id = it->second;
-    replacer_->Pin(frame_id);
-    Page *frame = &frames_[frame_id];
-    // Page* page = &pages_[frame_id];
-    frame->pin_count_++;
-    return frame;
+    PinFrame(partition, partition.ToLocal(frame_id));
+    return &frames_[frame_id];
   }
 
   // 1.2 If the page is not found, find a victim frame
   frame_id_t frame_id;
-  if (!FindVictimPage(&frame_id)) {
+  if (!FindVictimPage(partition, &frame_id)) {
     throw InternalError("BufferPoolManager::recover_page: No victim frame found");
   }
 
-  // Page* page = &pages_[frame_id];
   Page *frame = &frames_[frame_id];
 
   // 2. If the frame is dirty, update it
-  UpdatePage(frame, page_id, frame_id);
+  UpdatePage(partition, frame, page_id, frame_id);
 
   // 3. Try to read the target page from disk into the frame
   try {
@@ -324,63 +526,246 @@ auto BufferPoolManager::RecoverPage(PageId page_id) -> Page * {
     }
   }
 
-  // 4. Pin the frame and set pin_count_ to 1
-  replacer_->Pin(frame_id);
-  frame->pin_count_ = 1;
+  // 4. The frame was claimed with a pin count of 1, keep it pinned in the replacer and publish it
+  frame_id_t local_id = partition.ToLocal(frame_id);
+  partition.replacer_->Pin(local_id);
+  partition.replacer_pinned_[local_id] = true;
+  PublishFrame(partition, local_id);
 
   return frame;
 }
 
-// /**
-//  * @brief Retrieves the pin count of a page. If the page does not exist in memory, return `std::nullopt`.
-//  * @param page_id The page ID of the page we want to get the pin count of.
-//  * @return std::optional<size_t> The pin count if the page exists, otherwise `std::nullopt`.
-//  */
-// auto BufferPoolManager::GetPinCount(page_id_t page_id) -> std::optional<size_t> {
-//   std::scoped_lock latch(*bpm_latch_);
-//   std::scoped_lock lock{latch_};
-
-//   // 1. Search for the target page in page_table_
-//   auto it = page_table_.find(page_id);
-//   if (it != page_table_.end()) {
-//     // 1.1 If the target page is found, return it
-//     frame_id_t frame_id = it->second;
-//     Page *frame = &frames_[frame_id];
-//     // Page* page = &pages_[frame_id];
-//     return frame->pin_count_;
-//   }
-
-//   return std::nullopt;
-// }
-
 /**
- * @brief Find a victim frame from the free_frame_list or the replacer.
+ * @brief Find a victim frame from the free_frame_list or the replacer of a partition.
  * @return {bool} true: find a victim frame , false: fail to find a victim frame
  * @param {frame_id_t*} return the frame_id of the found victim frame
  *
  */
-auto BufferPoolManager::FindVictimPage(frame_id_t *frame_id) -> bool {
-  // std::cerr << "[BufferPoolManager] FindVictimPage" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  // std::scoped_lock lock{latch_};
-
+auto BufferPoolManager::FindVictimPage(BufferPoolPartition &partition, frame_id_t *frame_id) -> bool {
   // 1. Check if there are any free frames available
-  if (!free_frames_.empty()) {
+  if (!partition.free_frames_.empty()) {
     // 1.1 If free frames are available, use one
-    *frame_id = free_frames_.front();
-    free_frames_.pop_front();
+    *frame_id = partition.free_frames_.front();
+    partition.free_frames_.pop_front();
+    // a free frame is not published, but a lookup that raced with its eviction may still hold a pin for a moment
+    while (!TryClaimFrame(partition, partition.ToLocal(*frame_id))) {
+      std::this_thread::yield();
+    }
     return true;
   }
 
-  // 1.2 If no free frames are available, use the LRUReplacer to find a victim frame
-  if (replacer_->Victim(frame_id)) {
-    return true;
+  // 1.2 If no free frames are available, use the replacer to find a victim frame. The replacer does not see pins taken
+  //     by the optimistic hit path, so the victim has to be claimed; every round either skips a referenced frame
+  //     once or takes a frame out of the replacer, so the loop is bounded.
+  for (size_t round = 0; round <= 2 * partition.num_frames_; round++) {
+    frame_id_t local_id;
+    if (!partition.replacer_->Victim(&local_id)) {
+      break;
+    }
+    if (partition.referenced_[local_id].exchange(false, std::memory_order_relaxed)) {
+      // hit without the latch since the replacer saw it last: record the access now and give it another round
+      partition.replacer_->Pin(local_id);
+      partition.replacer_->Unpin(local_id);
+      continue;
+    }
+    if (TryClaimFrame(partition, local_id)) {
+      *frame_id = partition.ToGlobal(local_id);
+      return true;
+    }
+    // pinned by the optimistic hit path, its last unpin returns it to the replacer (or it already has been unpinned)
+    partition.replacer_pinned_[local_id] = true;
+    ReturnToReplacer(partition, local_id);
   }
 
   // If no victim frame can be found, return false
   return false;
 }
 
+/**
+ * @brief Find a victim frame in the buffer ring of a strategy.
+ * @note A ring slot is recycled only if its frame still holds the page the ring put there and is not pinned; if the
+ *       frame has been taken over by someone else, the slot is refilled from the shared free list / replacer.
+ */
+auto BufferPoolManager::FindVictimPage(BufferPoolPartition &partition, BufferAccessStrategy *strategy,
+                                       PageId new_page_id, frame_id_t *frame_id) -> bool {
+  if (strategy == nullptr || strategy->type_ == AccessType::NORMAL || strategy->ring_size_ == 0) {
+    return FindVictimPage(partition, frame_id);
+  }
+
+  if (strategy->rings_.size() != partitions_.size()) {
+    strategy->rings_.assign(partitions_.size(), {});
+    strategy->cursors_.assign(partitions_.size(), 0);
+  }
+  size_t index = GetPartitionIndex(new_page_id);
+  auto &ring = strategy->rings_[index];
+  size_t capacity = std::max<size_t>(1, strategy->ring_size_ / partitions_.size());
+
+  // 1. The ring is not full yet, grow it by a shared victim
+  if (ring.size() < capacity) {
+    if (!FindVictimPage(partition, frame_id)) {
+      return false;
+    }
+    ring.push_back({*frame_id, new_page_id});
+    return true;
+  }
+
+  // 2. Recycle the next ring slot if the ring still owns its frame
+  auto &slot = ring[strategy->cursors_[index]++ % capacity];
+  auto owner = partition.page_table_.find(slot.page_id);
+  if (owner != partition.page_table_.end() && owner->second == slot.frame_id &&
+      TryClaimFrame(partition, partition.ToLocal(slot.frame_id))) {
+    partition.replacer_->Remove(partition.ToLocal(slot.frame_id));
+    *frame_id = slot.frame_id;
+    slot.page_id = new_page_id;
+    return true;
+  }
+
+  // 3. Otherwise refill the slot from the shared pool
+  if (!FindVictimPage(partition, frame_id)) {
+    return false;
+  }
+  slot = {*frame_id, new_page_id};
+  return true;
+}
+
+/**
+ * @brief Hand a victim frame over to a new page. The mapping is switched under the partition latch, the write back of
+ * the old page and the read of the new page are done without it. Threads that hit the new page while it is loading
+ * wait on `io_cv_`, threads that miss on the old page wait until its write back is done.
+ * @note after load : PageId is new_page_id; pin_count is 1; is_dirty is false
+ */
+void BufferPoolManager::LoadFrame(BufferPoolPartition &partition, std::unique_lock<std::mutex> &lock,
+                                  frame_id_t frame_id, PageId new_page_id, bool read_page) {
+  Page *frame = &frames_[frame_id];
+
+  // 1. Update the page table and the frame meta data to reflect the new mapping
+  PendingLoad load = BeginLoad(partition, frame_id, new_page_id);
+  lock.unlock();
+
+  // 2. Write back the old content and bring in the new one
+  if (load.write_back) {
+    lock.lock();
+    WaitForBackgroundWrite(partition, lock, load.old_page_id);
+    lock.unlock();
+    disk_manager_->WritePage(load.old_page_id.fd, load.old_page_id.page_no, frame->GetData(), PAGE_SIZE);
+  }
+  if (read_page) {
+    disk_manager_->ReadPage(new_page_id.fd, new_page_id.page_no, frame->GetData(), PAGE_SIZE);
+  } else {
+    memset(frame->GetData(), 0, PAGE_SIZE);
+  }
+
+  lock.lock();
+  FinishLoad(load);
+}
+
+auto BufferPoolManager::BeginLoad(BufferPoolPartition &partition, frame_id_t frame_id, PageId new_page_id)
+    -> PendingLoad {
+  Page *frame = &frames_[frame_id];
+  frame_id_t local_id = partition.ToLocal(frame_id);
+  PendingLoad load{&partition, frame_id, frame->page_id_, frame->is_dirty_};
+
+  partition.page_table_.erase(load.old_page_id);
+  partition.page_table_[new_page_id] = frame_id;
+  if (load.write_back) {
+    partition.writing_back_.insert(load.old_page_id);
+    partition.sync_evictions_++;
+    Stats::Add(StatCounter::BUFFER_SYNC_EVICTIONS);
+    if (page_writer_ != nullptr) {
+      page_writer_->Wake();
+    }
+  } else if (load.old_page_id.page_no != INVALID_PAGE_ID) {
+    partition.clean_evictions_++;
+    Stats::Add(StatCounter::BUFFER_CLEAN_EVICTIONS);
+  }
+  // the frame was claimed with a pin count of 1, it stays unpublished until FinishLoad()
+  partition.replacer_->Pin(local_id);
+  partition.replacer_pinned_[local_id] = true;
+  partition.io_pending_[local_id] = true;
+  partition.inflight_io_++;
+  frame->page_id_ = new_page_id;
+  frame->is_dirty_ = false;
+  return load;
+}
+
+void BufferPoolManager::WaitForBackgroundWrite(BufferPoolPartition &partition, std::unique_lock<std::mutex> &lock,
+                                               PageId page_id) {
+  partition.io_cv_.wait(lock, [&] { return partition.background_writes_.count(page_id) == 0; });
+}
+
+void BufferPoolManager::FinishLoad(const PendingLoad &load) {
+  BufferPoolPartition &partition = *load.partition;
+  if (load.write_back) {
+    partition.writing_back_.erase(load.old_page_id);
+  }
+  partition.io_pending_[partition.ToLocal(load.frame_id)] = false;
+  PublishFrame(partition, partition.ToLocal(load.frame_id));
+  partition.inflight_io_--;
+  partition.io_cv_.notify_all();
+}
+
+/**
+ * @brief Bring a range of pages into the pool with batched I/O.
+ * @note Pages that are resident count as hits and are left alone, pages that are still being written back are skipped
+ *       rather than waited for: read-ahead never blocks. Pages beyond the last allocated one are not loaded, their
+ *       zero filled frames would shadow the page NewPage() creates there later.
+ */
+auto BufferPoolManager::LoadPages(int fd, page_id_t first_page, int num_pages, BufferAccessStrategy *strategy)
+    -> int {
+  int access_type = static_cast<int>(strategy == nullptr ? AccessType::NORMAL : strategy->GetType());
+  num_pages = std::min(num_pages, disk_manager_->GetFd2Pageno(fd) - first_page);
+  std::vector<PendingLoad> loads;
+  std::vector<PageIORequest> writes;
+  std::vector<PageIORequest> reads;
+
+  // 1. Reserve a frame for every page that is not resident
+  for (int i = 0; i < num_pages; i++) {
+    PageId page_id{fd, first_page + i};
+    auto &partition = GetPartition(page_id);
+    std::scoped_lock lock{partition.latch_};
+    if (partition.page_table_.count(page_id) != 0) {
+      partition.hits_[access_type]++;
+      continue;
+    }
+    if (partition.writing_back_.count(page_id) != 0 || partition.background_writes_.count(page_id) != 0) {
+      continue;
+    }
+    partition.misses_[access_type]++;
+    frame_id_t frame_id;
+    if (!FindVictimPage(partition, strategy, page_id, &frame_id)) {
+      // every frame is pinned
+      break;
+    }
+    PendingLoad load = BeginLoad(partition, frame_id, page_id);
+    char *data = frames_[frame_id].GetData();
+    if (load.write_back) {
+      writes.push_back({load.old_page_id.fd, load.old_page_id.page_no, data});
+    }
+    reads.push_back({page_id.fd, page_id.page_no, data});
+    loads.push_back(load);
+  }
+
+  // 2. Write back the dirty victims, then read the new pages over them
+  for (const auto &write : writes) {
+    PageId old_page_id{write.fd, write.page_id};
+    auto &partition = GetPartition(old_page_id);
+    std::unique_lock lock{partition.latch_};
+    WaitForBackgroundWrite(partition, lock, old_page_id);
+  }
+  disk_manager_->WritePageBatch(writes);
+  disk_manager_->ReadPageBatch(reads);
+  Stats::Add(StatCounter::BUFFER_PREFETCHED_PAGES, reads.size());
+
+  // 3. Publish the pages and unpin them
+  for (const auto &load : loads) {
+    auto &partition = *load.partition;
+    std::scoped_lock lock{partition.latch_};
+    FinishLoad(load);
+    UnpinFrame(partition, partition.ToLocal(load.frame_id));
+  }
+  return static_cast<int>(loads.size());
+}
+
 /**
  * @brief Update the page data, page meta data (data, is_dirty_, page_id) and page table.
  * If it is dirty, it should be write back to disk first before update.
@@ -390,26 +775,21 @@ auto BufferPoolManager::FindVictimPage(frame_id_t *frame_id) -> bool {
  * @note after update : PageId is new_page_id; pin_count is 0; is_dirty is false; data reset to 0
  *
  */
-void BufferPoolManager::UpdatePage(Page *frame, PageId new_page_id, frame_id_t new_frame_id) {
-  // std::cerr << "[BufferPoolManager] UpdatePage" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  // std::scoped_lock lock{latch_};
-
+void BufferPoolManager::UpdatePage(BufferPoolPartition &partition, Page *frame, PageId new_page_id,
+                                   frame_id_t new_frame_id) {
   if (frame->is_dirty_) {
     disk_manager_->WritePage(frame->page_id_.fd, frame->page_id_.page_no, frame->GetData(), PAGE_SIZE);
-    // page->is_dirty_ = false;
   }
 
   // 2. Update the page table to reflect the new mapping
   // Remove the old page id mapping
-  page_table_.erase(frame->page_id_);
+  partition.page_table_.erase(frame->page_id_);
   // Add the new page id mapping
-  page_table_[new_page_id] = new_frame_id;
+  partition.page_table_[new_page_id] = new_frame_id;
 
   // 3. Reset the page's data and update its PageId
   frame->ResetMemory();
   frame->page_id_ = new_page_id;
-  frame->pin_count_ = 0;
   frame->is_dirty_ = false;
 }
 
@@ -422,44 +802,59 @@ void BufferPoolManager::UpdatePage(Page *frame, PageId new_page_id, frame_id_t n
  * @param {PageId} page_id : PageId of the target page.
  * @note: pin the page, need to unpin the page outside
  */
-auto BufferPoolManager::FetchPage(PageId page_id) -> Page * {
-  // std::cerr << "[BufferPoolManager] FetchPage" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
+auto BufferPoolManager::FetchPage(PageId page_id, BufferAccessStrategy *strategy) -> Page * {
+  auto &partition = GetPartition(page_id);
+  int access_type = static_cast<int>(strategy == nullptr ? AccessType::NORMAL : strategy->GetType());
+
+  // 0. A hit on a loaded page pins it without the latch
+  if (optimistic_hits_enabled_.load(std::memory_order_relaxed)) {
+    Page *frame = FetchPageOptimistic(partition, page_id, access_type);
+    if (frame != nullptr) {
+      return frame;
+    }
+  }
 
-  // 1. Search for the target page in page_table_
-  auto it = page_table_.find(page_id);
-  if (it != page_table_.end()) {
-    // 1.1 If the target page is found, pin it and return it
-    frame_id_t frame_id = it->second;
-    replacer_->Pin(frame_id);
-    Page *frame = &frames_[frame_id];
-    // Page* page = &pages_[frame_id];
-    frame->pin_count_++;
-    return frame;
+  std::unique_lock lock{partition.latch_};
+
+  while (true) {
+    // 1. Search for the target page in page_table_
+    auto it = partition.page_table_.find(page_id);
+    if (it != partition.page_table_.end()) {
+      // 1.1 If the target page is found, pin it, wait until it is loaded and return it
+      frame_id_t frame_id = it->second;
+      frame_id_t local_id = partition.ToLocal(frame_id);
+      PinFrame(partition, local_id);
+      Page *frame = &frames_[frame_id];
+      partition.hits_[access_type]++;
+      Stats::Add(StatCounter::BUFFER_HITS);
+      if (partition.io_pending_[local_id]) {
+        Stats::Add(StatCounter::BUFFER_PIN_WAITS);
+        partition.io_cv_.wait(lock, [&] { return !partition.io_pending_[local_id]; });
+      }
+      return frame;
+    }
+
+    // 1.2 The page was just evicted and is still being written back, reading it now would see stale data
+    if (partition.writing_back_.count(page_id) == 0 && partition.background_writes_.count(page_id) == 0) {
+      break;
+    }
+    Stats::Add(StatCounter::BUFFER_PIN_WAITS);
+    partition.io_cv_.wait(lock);
   }
 
-  // 1.2 If the page is not found, find a victim frame
+  // 1.3 If the page is not found, find a victim frame
+  partition.misses_[access_type]++;
+  Stats::Add(StatCounter::BUFFER_MISSES);
   frame_id_t frame_id;
-  if (!FindVictimPage(&frame_id)) {
+  if (!FindVictimPage(partition, strategy, page_id, &frame_id)) {
     return nullptr;
   }
 
-  Page *frame = &frames_[frame_id];
-  // Page* page = &pages_[frame_id];
-
-  // 2. If the victim frame contains a dirty page, update it
-  UpdatePage(frame, page_id, frame_id);
-
-  // 3. Read the target page from disk into the frame
-  disk_manager_->ReadPage(page_id.fd, page_id.page_no, frame->GetData(), PAGE_SIZE);
+  // 2. Write back the victim if it is dirty and read the target page from disk into the frame, pinned once
+  LoadFrame(partition, lock, frame_id, page_id, true);
 
-  // 4. Pin the frame and set pin_count_ to 1
-  replacer_->Pin(frame_id);
-  frame->pin_count_ = 1;
-
-  // 5. Return the target page
-  return frame;
+  // 3. Return the target page
+  return &frames_[frame_id];
 }
 
 /**
@@ -469,42 +864,174 @@ auto BufferPoolManager::FetchPage(PageId page_id) -> Page * {
  * @param {bool} is_dirty: mark if the target frame need to be marked dirty
  */
 auto BufferPoolManager::UnpinPage(PageId page_id, bool is_dirty) -> bool {
-  // std::cerr << "[BufferPoolManager] UnpinPage" << std::endl;
-  // std::scoped_lock latch(*bpm_latch_);
-  std::scoped_lock lock{latch_};
+  auto &partition = GetPartition(page_id);
 
-  // 1. Search for the page in the page_table_
-  auto it = page_table_.find(page_id);
-  if (it == page_table_.end()) {
-    // 1.1 If the page is not found, return false
-    return false;
+  // 1. A pinned page can not change frames, so an indexed page is unpinned without the latch
+  frame_id_t local_id = FindPublished(partition, FrameLookupTable::Key(page_id));
+  if (local_id != INVALID_FRAME_ID) {
+    return DropPin(partition, local_id, is_dirty, nullptr);
   }
 
-  // 1.2 If the page is found, get its pin_count_
-  frame_id_t frame_id = it->second;
-  Page *frame = &frames_[frame_id];
-  // Page* page = &pages_[frame_id];
+  // 2. Otherwise search for the page in the page_table_
+  std::unique_lock lock{partition.latch_};
+  auto it = partition.page_table_.find(page_id);
+  if (it != partition.page_table_.end()) {
+    return DropPin(partition, partition.ToLocal(it->second), is_dirty, &lock);
+  }
 
-  // Check the pin_count_
-  // 2.1 If pin_count_ is already 0, return false
-  if (frame->pin_count_ == 0) {
-    return false;
+  // 2.1 The page may have been removed by RemoveAllPages() while it was pinned
+  auto [first, last] = partition.removed_pages_.equal_range(page_id);
+  for (auto removed = first; removed != last; removed++) {
+    if (frames_[removed->second].GetPinCount() != 0) {
+      return DropPin(partition, partition.ToLocal(removed->second), is_dirty, &lock);
+    }
+  }
+  // 2.2 If the page is not found, return false
+  return false;
+}
+
+auto BufferPoolManager::FindPublished(BufferPoolPartition &partition, uint64_t key) -> frame_id_t {
+  return partition.lookup_.Find(
+      key, [&](frame_id_t local_id) { return partition.frame_keys_[local_id].load(std::memory_order_acquire) == key; });
+}
+
+/**
+ * @brief Pin a loaded page without the latch.
+ * @note The pin is taken before the frame is checked: once it is held the frame can not be claimed for another page,
+ *       so if the frame still publishes the page after the pin, it is the page (and its data is loaded). Otherwise the
+ *       frame is being evicted or has been reused, the pin is dropped again and the locked path decides.
+ */
+auto BufferPoolManager::FetchPageOptimistic(BufferPoolPartition &partition, PageId page_id, int access_type)
+    -> Page * {
+  uint64_t key = FrameLookupTable::Key(page_id);
+  frame_id_t local_id = FindPublished(partition, key);
+  if (local_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+
+  Page *frame = &frames_[partition.ToGlobal(local_id)];
+  frame->pin_count_.fetch_add(1);
+  if (partition.frame_keys_[local_id].load() != key) {
+    DropPin(partition, local_id, false, nullptr);
+    return nullptr;
   }
 
-  // 2.2 If pin_count_ is greater than 0, decrement it
-  frame->pin_count_--;
+  // tell the replacer about the access when it looks at the frame next, without writing the flag on every hit
+  if (!partition.referenced_[local_id].load(std::memory_order_relaxed)) {
+    partition.referenced_[local_id].store(true, std::memory_order_relaxed);
+  }
+  partition.optimistic_hits_[access_type].fetch_add(1, std::memory_order_relaxed);
+  Stats::Add(StatCounter::BUFFER_HITS);
+  Stats::Add(StatCounter::BUFFER_OPTIMISTIC_HITS);
+  return frame;
+}
+
+auto BufferPoolManager::DropPin(BufferPoolPartition &partition, frame_id_t local_id, bool is_dirty,
+                                std::unique_lock<std::mutex> *lock) -> bool {
+  Page *frame = &frames_[partition.ToGlobal(local_id)];
 
-  // 2.2.1 If pin_count_ becomes 0 after decrementing, call replacer's Unpin
-  if (frame->pin_count_ == 0) {
-    replacer_->Unpin(frame_id);
+  // 1. If pin_count_ is already 0, return false
+  size_t pin_count = frame->pin_count_.load();
+  if (pin_count == 0) {
+    return false;
   }
 
-  // 3. Update the is_dirty flag based on the input parameter
+  // 2. Mark the page dirty while it is still pinned, so that an eviction can not miss it
   if (is_dirty) {
     frame->is_dirty_ = true;
   }
 
+  // 3. Decrement pin_count_, it never goes below 0
+  while (!frame->pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+    if (pin_count == 0) {
+      return false;
+    }
+  }
+
+  // 4. The last unpin of a frame the replacer holds as pinned makes it evictable again
+  if (pin_count == 1 && partition.replacer_pinned_[local_id].load()) {
+    if (lock != nullptr) {
+      ReturnToReplacer(partition, local_id);
+    } else {
+      std::scoped_lock latch{partition.latch_};
+      ReturnToReplacer(partition, local_id);
+    }
+  }
+  return true;
+}
+
+void BufferPoolManager::ReturnToReplacer(BufferPoolPartition &partition, frame_id_t local_id) {
+  // whoever sees the frame unpinned with the flag set returns it, the flag is written and read under the latch
+  Page *frame = &frames_[partition.ToGlobal(local_id)];
+  if (!partition.replacer_pinned_[local_id].load() || frame->pin_count_.load() != 0) {
+    return;
+  }
+  partition.replacer_pinned_[local_id] = false;
+  auto removed = FindRemovedPage(partition, local_id);
+  if (removed == partition.removed_pages_.end()) {
+    partition.replacer_->Unpin(local_id);
+    return;
+  }
+  // the last holder of a removed page is gone, nobody can pin the frame any more
+  partition.removed_pages_.erase(removed);
+  frame->ResetMemory();
+  partition.free_frames_.push_back(partition.ToGlobal(local_id));
+}
+
+auto BufferPoolManager::FindRemovedPage(BufferPoolPartition &partition, frame_id_t local_id)
+    -> std::unordered_multimap<PageId, frame_id_t, PageIdHash>::iterator {
+  if (partition.removed_pages_.empty()) {
+    return partition.removed_pages_.end();
+  }
+  frame_id_t frame_id = partition.ToGlobal(local_id);
+  auto [first, last] = partition.removed_pages_.equal_range(frames_[frame_id].page_id_);
+  for (auto removed = first; removed != last; removed++) {
+    if (removed->second == frame_id) {
+      return removed;
+    }
+  }
+  return partition.removed_pages_.end();
+}
+
+void BufferPoolManager::PinFrame(BufferPoolPartition &partition, frame_id_t local_id) {
+  partition.replacer_->Pin(local_id);
+  partition.replacer_pinned_[local_id] = true;
+  frames_[partition.ToGlobal(local_id)].pin_count_.fetch_add(1);
+}
+
+void BufferPoolManager::UnpinFrame(BufferPoolPartition &partition, frame_id_t local_id) {
+  if (frames_[partition.ToGlobal(local_id)].pin_count_.fetch_sub(1) == 1) {
+    ReturnToReplacer(partition, local_id);
+  }
+}
+
+auto BufferPoolManager::TryClaimFrame(BufferPoolPartition &partition, frame_id_t local_id) -> bool {
+  Page *frame = &frames_[partition.ToGlobal(local_id)];
+  // withdraw the key first: a lookup that pins the frame after the claim sees it gone and backs off
+  uint64_t key = partition.frame_keys_[local_id].exchange(FrameLookupTable::NO_PAGE);
+  size_t unpinned = 0;
+  if (!frame->pin_count_.compare_exchange_strong(unpinned, 1)) {
+    partition.frame_keys_[local_id].store(key);
+    return false;
+  }
+  if (key != FrameLookupTable::NO_PAGE) {
+    partition.lookup_.Erase(key, local_id);
+  }
+  partition.referenced_[local_id].store(false, std::memory_order_relaxed);
   return true;
 }
 
+void BufferPoolManager::PublishFrame(BufferPoolPartition &partition, frame_id_t local_id) {
+  uint64_t key = FrameLookupTable::Key(frames_[partition.ToGlobal(local_id)].page_id_);
+  partition.frame_keys_[local_id].store(key);
+  partition.lookup_.Insert(key, local_id);
+}
+
+void BufferPoolManager::UnpublishFrame(BufferPoolPartition &partition, frame_id_t local_id) {
+  uint64_t key = partition.frame_keys_[local_id].exchange(FrameLookupTable::NO_PAGE);
+  if (key != FrameLookupTable::NO_PAGE) {
+    partition.lookup_.Erase(key, local_id);
+  }
+}
+
 }  // namespace easydb
@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * clock_replacer.cpp
+ *
+ * Identification: src/buffer/clock_replacer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/clock_replacer.h"
+
+namespace easydb {
+
+ClockReplacer::ClockReplacer(size_t num_frames)
+    : num_frames_(num_frames), state_(std::make_unique<std::atomic<uint8_t>[]>(num_frames)) {
+  for (size_t i = 0; i < num_frames_; i++) {
+    state_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool {
+  if (num_frames_ == 0) {
+    return false;
+  }
+  // Every evictable frame reaches a zero usage count after at most MAX_USAGE_COUNT full sweeps.
+  const size_t max_steps = num_frames_ * (MAX_USAGE_COUNT + 1);
+  for (size_t step = 0; step < max_steps; step++) {
+    if (curr_size_.load(std::memory_order_relaxed) == 0) {
+      return false;
+    }
+    size_t pos = hand_.fetch_add(1, std::memory_order_relaxed) % num_frames_;
+    auto &state = state_[pos];
+    uint8_t old_state = state.load(std::memory_order_acquire);
+    if ((old_state & EVICTABLE) == 0) {
+      continue;
+    }
+    uint8_t usage = old_state & USAGE_MASK;
+    if (usage > 0) {
+      // Second chance: age the frame, losing the race to a concurrent Pin/Unpin is fine.
+      state.compare_exchange_strong(old_state, static_cast<uint8_t>(EVICTABLE | (usage - 1)),
+                                    std::memory_order_acq_rel);
+      continue;
+    }
+    if (state.compare_exchange_strong(old_state, 0, std::memory_order_acq_rel)) {
+      curr_size_.fetch_sub(1, std::memory_order_relaxed);
+      *frame_id = static_cast<frame_id_t>(pos);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  auto &state = state_[frame_id];
+  uint8_t old_state = state.load(std::memory_order_relaxed);
+  uint8_t new_state;
+  do {
+    uint8_t usage = old_state & USAGE_MASK;
+    new_state = usage < MAX_USAGE_COUNT ? usage + 1 : usage;
+  } while (!state.compare_exchange_weak(old_state, new_state, std::memory_order_acq_rel));
+  if ((old_state & EVICTABLE) != 0) {
+    curr_size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  uint8_t old_state = state_[frame_id].fetch_or(EVICTABLE, std::memory_order_acq_rel);
+  if ((old_state & EVICTABLE) == 0) {
+    curr_size_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  uint8_t old_state = state_[frame_id].exchange(0, std::memory_order_acq_rel);
+  if ((old_state & EVICTABLE) != 0) {
+    curr_size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+auto ClockReplacer::Size() -> size_t { return curr_size_.load(std::memory_order_relaxed); }
+
+}  // namespace easydb
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * frame_arena.cpp
+ *
+ * Identification: src/buffer/frame_arena.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/errors.h"
+#include "common/logger.h"
+
+namespace easydb {
+
+FrameArena::FrameArena(size_t num_frames, bool use_huge_pages) {
+  size_t size = std::max<size_t>(num_frames, 1) * PAGE_SIZE;
+  void *data = MAP_FAILED;
+
+  if (use_huge_pages) {
+    mapped_size_ = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_tlb_ = data != MAP_FAILED;
+#endif
+    if (data == MAP_FAILED) {
+      // No reserved huge pages: map 2 MiB more than needed, keep a 2 MiB aligned range and let the kernel back it with
+      // transparent huge pages.
+      void *raw = mmap(nullptr, mapped_size_ + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+      if (raw != MAP_FAILED) {
+        auto begin = reinterpret_cast<uintptr_t>(raw);
+        auto aligned = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (aligned > begin) {
+          munmap(raw, aligned - begin);
+        }
+        munmap(reinterpret_cast<void *>(aligned + mapped_size_), begin + HUGE_PAGE_SIZE - aligned);
+        data = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+        if (madvise(data, mapped_size_, MADV_HUGEPAGE) != 0) {
+          LOG_WARN("transparent huge pages are not available for the buffer pool");
+        }
+#endif
+      }
+    }
+  } else {
+    mapped_size_ = size;
+    data = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+
+  if (data == MAP_FAILED) {
+    throw UnixError();
+  }
+  data_ = static_cast<char *>(data);
+}
+
+FrameArena::~FrameArena() { munmap(data_, mapped_size_); }
+
+}  // namespace easydb
@@ -0,0 +1,59 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * frame_lookup_table.cpp
+ *
+ * Identification: src/buffer/frame_lookup_table.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/frame_lookup_table.h"
+
+namespace easydb {
+
+FrameLookupTable::FrameLookupTable(size_t num_frames) {
+  size_t capacity = MAX_PROBES;
+  while (capacity < 2 * num_frames) {
+    capacity <<= 1;
+  }
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+  for (size_t i = 0; i < capacity; i++) {
+    slots_[i].store(EMPTY, std::memory_order_relaxed);
+  }
+  mask_ = capacity - 1;
+}
+
+auto FrameLookupTable::Insert(uint64_t key, frame_id_t frame_id) -> bool {
+  uint64_t hash = Hash(key);
+  uint64_t value = MakeSlot(hash, frame_id);
+  for (size_t i = 0; i < MAX_PROBES; i++) {
+    auto &slot = slots_[(hash + i) & mask_];
+    uint64_t old_value = slot.load(std::memory_order_relaxed);
+    if (old_value == value) {
+      return true;
+    }
+    if (old_value == EMPTY) {
+      // a single writer per table (the partition latch), readers only ever see EMPTY or a complete entry
+      slot.store(value, std::memory_order_release);
+      return true;
+    }
+  }
+  return false;
+}
+
+void FrameLookupTable::Erase(uint64_t key, frame_id_t frame_id) {
+  uint64_t hash = Hash(key);
+  uint64_t value = MakeSlot(hash, frame_id);
+  for (size_t i = 0; i < MAX_PROBES; i++) {
+    auto &slot = slots_[(hash + i) & mask_];
+    if (slot.load(std::memory_order_relaxed) == value) {
+      // lookups always scan all MAX_PROBES slots, so a hole needs no tombstone
+      slot.store(EMPTY, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+}  // namespace easydb
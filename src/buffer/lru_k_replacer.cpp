@@ -0,0 +1,89 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * lru_k_replacer.cpp
+ *
+ * Identification: src/buffer/lru_k_replacer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/*
+ * Original copyright:
+ * Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+ */
+
+#include "buffer/lru_k_replacer.h"
+
+namespace easydb {
+
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : num_frames_(num_frames),
+      k_(k == 0 ? 1 : k),
+      history_(num_frames * k_, 0),
+      access_count_(num_frames, 0),
+      evictable_(num_frames, false) {}
+
+auto LRUKReplacer::OldestAccess(frame_id_t frame_id) const -> size_t {
+  size_t count = access_count_[frame_id];
+  if (count == 0) {
+    return 0;
+  }
+  // Before the ring wraps the oldest access is in slot 0, afterwards it is the slot to be overwritten next.
+  return history_[frame_id * k_ + (count < k_ ? 0 : count % k_)];
+}
+
+auto LRUKReplacer::KeyOf(frame_id_t frame_id) const -> EvictionKey {
+  return {access_count_[frame_id] >= k_, OldestAccess(frame_id), frame_id};
+}
+
+void LRUKReplacer::MakeUnevictable(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evictable_frames_.erase(KeyOf(frame_id));
+    evictable_[frame_id] = false;
+  }
+}
+
+auto LRUKReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock{latch_};
+  if (evictable_frames_.empty()) {
+    return false;
+  }
+  // A frame with an infinite k-distance always beats one with a finite distance, ties go to the oldest access.
+  frame_id_t victim = std::get<2>(*evictable_frames_.begin());
+  evictable_frames_.erase(evictable_frames_.begin());
+  evictable_[victim] = false;
+  access_count_[victim] = 0;
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  // the key depends on the history, so the frame leaves the set before the access is recorded
+  MakeUnevictable(frame_id);
+  history_[frame_id * k_ + access_count_[frame_id] % k_] = ++current_timestamp_;
+  access_count_[frame_id]++;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  if (!evictable_[frame_id]) {
+    evictable_[frame_id] = true;
+    evictable_frames_.insert(KeyOf(frame_id));
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  MakeUnevictable(frame_id);
+  access_count_[frame_id] = 0;
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock lock{latch_};
+  return evictable_frames_.size();
+}
+
+}  // namespace easydb
@@ -19,79 +19,64 @@
 
 namespace easydb {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : prev_(num_pages, INVALID_FRAME_ID), next_(num_pages, INVALID_FRAME_ID), in_list_(num_pages, false) {}
 
-LRUReplacer::~LRUReplacer() {
-  LinkListNode *p = head_;
-  while (p != nullptr) {
-    LinkListNode *tmp = p;
-    p = p->next_;
-    delete (tmp);
+void LRUReplacer::DeleteNode(frame_id_t frame_id) {
+  frame_id_t prev = prev_[frame_id];
+  frame_id_t next = next_[frame_id];
+  if (prev == INVALID_FRAME_ID) {
+    head_ = next;
+  } else {
+    next_[prev] = next;
   }
-}
-
-void LRUReplacer::DeleteNode(LinkListNode *curr) {
-  if (curr == head_ && curr == tail_) {
-    head_ = nullptr;
-    tail_ = nullptr;
-  } else if (curr == head_) {
-    head_ = head_->next_;
-    curr->next_->prev_ = curr->prev_;
-  } else if (curr == tail_) {
-    tail_ = tail_->prev_;
-    curr->prev_->next_ = curr->next_;
+  if (next == INVALID_FRAME_ID) {
+    tail_ = prev;
   } else {
-    curr->prev_->next_ = curr->next_;
-    curr->next_->prev_ = curr->prev_;
+    prev_[next] = prev;
   }
-  delete (curr);
+  prev_[frame_id] = next_[frame_id] = INVALID_FRAME_ID;
+  in_list_[frame_id] = false;
+  size_--;
 }
+
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  data_latch_.lock();
-  if (data_idx_.empty()) {
-    data_latch_.unlock();
+  std::scoped_lock lock{data_latch_};
+  if (head_ == INVALID_FRAME_ID) {
     return false;
   }
-  *frame_id = head_->val_;
-  data_idx_.erase(head_->val_);
-  LinkListNode *tmp = head_;
-  DeleteNode(tmp);
-  data_latch_.unlock();
+  *frame_id = head_;
+  DeleteNode(head_);
   return true;
 }
 
 void LRUReplacer::Pin(frame_id_t frame_id) {
-  data_latch_.lock();
-  auto it = data_idx_.find(frame_id);
-  if (it != data_idx_.end()) {
-    DeleteNode(data_idx_[frame_id]);
-    data_idx_.erase(it);
+  std::scoped_lock lock{data_latch_};
+  if (in_list_[frame_id]) {
+    DeleteNode(frame_id);
   }
-  data_latch_.unlock();
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-  data_latch_.lock();
-  auto it = data_idx_.find(frame_id);
-  if (it == data_idx_.end()) {
-    LinkListNode *new_node = new LinkListNode(frame_id);
-    if (data_idx_.empty()) {
-      head_ = tail_ = new_node;
-    } else {
-      tail_->next_ = new_node;
-      new_node->prev_ = tail_;
-      tail_ = new_node;
-    }
-    data_idx_[frame_id] = tail_;
+  std::scoped_lock lock{data_latch_};
+  if (in_list_[frame_id]) {
+    return;
+  }
+  prev_[frame_id] = tail_;
+  next_[frame_id] = INVALID_FRAME_ID;
+  if (tail_ == INVALID_FRAME_ID) {
+    head_ = frame_id;
+  } else {
+    next_[tail_] = frame_id;
   }
-  data_latch_.unlock();
+  tail_ = frame_id;
+  in_list_[frame_id] = true;
+  size_++;
 }
 
 size_t LRUReplacer::Size() {
-  data_latch_.lock();
-  size_t ret = data_idx_.size();
-  data_latch_.unlock();
-  return ret;
+  std::scoped_lock lock{data_latch_};
+  return size_;
 }
 
 }  // namespace easydb
@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * page_prefetcher.cpp
+ *
+ * Identification: src/buffer/page_prefetcher.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/page_prefetcher.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace easydb {
+
+PagePrefetcher::PagePrefetcher(BufferPoolManager *bpm, size_t num_threads) : bpm_(bpm) {
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (auto &worker : workers_) {
+    worker->thread = std::thread(&PagePrefetcher::WorkerLoop, this, worker.get());
+  }
+}
+
+PagePrefetcher::~PagePrefetcher() {
+  stop_ = true;
+  for (auto &worker : workers_) {
+    {
+      std::scoped_lock lock{worker->latch};
+      worker->queue.clear();
+    }
+    worker->cv.notify_all();
+    worker->thread.join();
+  }
+}
+
+void PagePrefetcher::Prefetch(int fd, page_id_t first_page, int num_pages,
+                              std::shared_ptr<BufferAccessStrategy> strategy) {
+  if (num_pages <= 0) {
+    return;
+  }
+  Submit({{fd, first_page}, num_pages, nullptr, std::move(strategy)});
+}
+
+void PagePrefetcher::PrefetchChain(PageId first_page, int num_pages, NextPageFn next_page,
+                                   std::shared_ptr<BufferAccessStrategy> strategy) {
+  if (num_pages <= 0 || first_page.page_no == INVALID_PAGE_ID) {
+    return;
+  }
+  Submit({first_page, num_pages, std::move(next_page), std::move(strategy)});
+}
+
+void PagePrefetcher::Submit(Request request) {
+  if (workers_.empty()) {
+    return;
+  }
+  // Requests of the same ring go to the same worker, the others are spread round robin.
+  size_t index = request.strategy != nullptr ? std::hash<BufferAccessStrategy *>{}(request.strategy.get())
+                                             : next_worker_.fetch_add(1, std::memory_order_relaxed);
+  auto &worker = workers_[index % workers_.size()];
+  {
+    std::scoped_lock lock{worker->latch};
+    if (worker->queue.size() >= MAX_QUEUED_REQUESTS) {
+      return;
+    }
+    worker->queue.push_back(std::move(request));
+  }
+  worker->cv.notify_all();
+}
+
+void PagePrefetcher::Cancel(int fd) {
+  for (auto &worker : workers_) {
+    std::unique_lock lock{worker->latch};
+    for (auto it = worker->queue.begin(); it != worker->queue.end();) {
+      it = it->first_page.fd == fd ? worker->queue.erase(it) : it + 1;
+    }
+    worker->cv.wait(lock, [&] { return worker->running_fd != fd; });
+  }
+}
+
+void PagePrefetcher::WorkerLoop(Worker *worker) {
+  std::unique_lock lock{worker->latch};
+  while (true) {
+    worker->cv.wait(lock, [&] { return stop_ || !worker->queue.empty(); });
+    if (stop_) {
+      return;
+    }
+    Request request = std::move(worker->queue.front());
+    worker->queue.pop_front();
+    worker->running_fd = request.first_page.fd;
+    lock.unlock();
+
+    Serve(worker, request);
+
+    lock.lock();
+    worker->running_fd = -1;
+    worker->cv.notify_all();
+  }
+}
+
+void PagePrefetcher::Serve(Worker *worker, const Request &request) {
+  BufferAccessStrategy *strategy =
+      request.strategy != nullptr ? request.strategy.get() : &worker->shared_strategy;
+  PageId page_id = request.first_page;
+  if (request.next_page == nullptr) {
+    // a plain range: reserve the frames and read all missing pages with one batched read
+    bpm_->LoadPages(page_id.fd, page_id.page_no, request.num_pages, strategy);
+    return;
+  }
+  for (int i = 0; i < request.num_pages && page_id.page_no != INVALID_PAGE_ID && !stop_; i++) {
+    Page *page = bpm_->FetchPage(page_id, strategy);
+    if (page == nullptr) {
+      // every frame is pinned, read-ahead is not worth waiting for
+      return;
+    }
+    page->RLatch();
+    page_id_t next_page_no = request.next_page(page->GetData());
+    page->RUnlatch();
+    bpm_->UnpinPage(page_id, false);
+    page_id.page_no = next_page_no;
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * page_writer.cpp
+ *
+ * Identification: src/buffer/page_writer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/page_writer.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace easydb {
+
+PageWriter::PageWriter(BufferPoolManager *bpm, std::chrono::milliseconds interval, size_t max_pages)
+    : bpm_(bpm), interval_(interval), max_pages_(max_pages), copies_(max_pages, false) {
+  thread_ = std::thread(&PageWriter::Run, this);
+}
+
+PageWriter::~PageWriter() {
+  {
+    std::scoped_lock lock{latch_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void PageWriter::Wake() {
+  {
+    std::scoped_lock lock{latch_};
+    woken_ = true;
+  }
+  cv_.notify_all();
+}
+
+void PageWriter::Run() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    cv_.wait_for(lock, interval_, [&] { return stop_ || woken_; });
+    if (stop_) {
+      return;
+    }
+    woken_ = false;
+    lock.unlock();
+
+    // A full round means there may be more dirty pages, keep going for at most one pass over the pool.
+    if (bpm_->IsPageWriterEnabled()) {
+      size_t written = 0;
+      size_t round;
+      do {
+        round = bpm_->WriteBackDirtyPages(max_pages_, &copies_);
+        written += round;
+      } while (round == max_pages_ && written < bpm_->Size() && !stop_);
+    }
+
+    lock.lock();
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,34 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * replacer.cpp
+ *
+ * Identification: src/buffer/replacer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "buffer/replacer.h"
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "common/logger.h"
+
+namespace easydb {
+
+auto MakeReplacer(const std::string &type, size_t num_frames) -> std::unique_ptr<Replacer> {
+  if (type == "LRU-K") {
+    return std::make_unique<LRUKReplacer>(num_frames, LRUK_REPLACER_K);
+  }
+  if (type == "CLOCK") {
+    return std::make_unique<ClockReplacer>(num_frames);
+  }
+  if (type != "LRU") {
+    LOG_WARN("unknown replacer type %s, using LRU", type.c_str());
+  }
+  return std::make_unique<LRUReplacer>(num_frames);
+}
+
+}  // namespace easydb
@@ -0,0 +1,52 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * arena.cpp
+ *
+ * Identification: src/common/arena.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "common/arena.h"
+
+namespace easydb {
+
+auto Arena::AllocateSlow(size_t size) -> char * {
+  bytes_allocated_ += size;
+  if (size > block_size_ / 4) {
+    // a block of its own, the current block keeps serving the small allocations
+    blocks_.push_back({std::make_unique<char[]>(size), size});
+    return blocks_.back().data_.get();
+  }
+  blocks_.push_back({std::make_unique<char[]>(block_size_), block_size_});
+  cur_ = blocks_.back().data_.get();
+  pos_ = size;
+  end_ = block_size_;
+  return cur_;
+}
+
+void Arena::Reset() {
+  bytes_allocated_ = 0;
+  // keep the first regular block, a query that fits in it never goes to the system again
+  auto first = blocks_.begin();
+  while (first != blocks_.end() && first->size_ != block_size_) {
+    ++first;
+  }
+  if (first == blocks_.end()) {
+    blocks_.clear();
+    cur_ = nullptr;
+    pos_ = 0;
+    end_ = 0;
+    return;
+  }
+  Block kept = std::move(*first);
+  blocks_.clear();
+  blocks_.push_back(std::move(kept));
+  cur_ = blocks_.back().data_.get();
+  pos_ = 0;
+  end_ = block_size_;
+}
+
+}  // namespace easydb
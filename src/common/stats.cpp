@@ -0,0 +1,177 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * stats.cpp
+ *
+ * Identification: src/common/stats.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "common/stats.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace easydb {
+
+namespace {
+
+/** @brief All live ThreadStats, and the sums of the exited threads. */
+struct StatsRegistry {
+  std::mutex latch_;
+  std::vector<ThreadStats *> live_;
+  ThreadStats retired_;
+};
+
+auto GetRegistry() -> StatsRegistry & {
+  // never destroyed: threads may still exit (and fold their stats in) during static destruction
+  static auto *registry = new StatsRegistry();
+  return *registry;
+}
+
+/** @brief Add the values of `from` to `to`. The caller excludes concurrent writers of `to`. */
+void Accumulate(ThreadStats &to, const ThreadStats &from) {
+  for (int i = 0; i < NUM_STAT_COUNTERS; i++) {
+    ThreadStats::Bump(to.counters_[i], from.counters_[i].load(std::memory_order_relaxed));
+  }
+  for (int h = 0; h < NUM_STAT_HISTOGRAMS; h++) {
+    for (size_t b = 0; b < LatencyBuckets::NUM_BUCKETS; b++) {
+      ThreadStats::Bump(to.buckets_[h][b], from.buckets_[h][b].load(std::memory_order_relaxed));
+    }
+    ThreadStats::Bump(to.sums_[h], from.sums_[h].load(std::memory_order_relaxed));
+    uint64_t max = std::max(to.maxs_[h].load(std::memory_order_relaxed), from.maxs_[h].load(std::memory_order_relaxed));
+    to.maxs_[h].store(max, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+auto LatencyBuckets::HighestValue(size_t index) -> uint64_t {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+  uint64_t sub_bucket = index % SUB_BUCKETS;
+  uint64_t lowest = (SUB_BUCKETS + sub_bucket) << (exponent - SUB_BUCKET_BITS);
+  return lowest + (static_cast<uint64_t>(1) << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+auto HistogramSnapshot::Percentile(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count_));
+  rank = std::max<uint64_t>(1, std::min(rank, count_));
+  uint64_t seen = 0;
+  for (size_t b = 0; b < buckets_.size(); b++) {
+    seen += buckets_[b];
+    if (seen >= rank) {
+      // report the bucket's upper bound, but never more than has actually been recorded
+      return std::min(LatencyBuckets::HighestValue(b), max_);
+    }
+  }
+  return max_;
+}
+
+Stats::ThreadStatsHandle::ThreadStatsHandle() : stats_(new ThreadStats()) {
+  auto &registry = GetRegistry();
+  std::scoped_lock lock(registry.latch_);
+  registry.live_.push_back(stats_);
+}
+
+Stats::ThreadStatsHandle::~ThreadStatsHandle() {
+  auto &registry = GetRegistry();
+  {
+    std::scoped_lock lock(registry.latch_);
+    Accumulate(registry.retired_, *stats_);
+    registry.live_.erase(std::find(registry.live_.begin(), registry.live_.end(), stats_));
+  }
+  delete stats_;
+}
+
+auto Stats::Snapshot() -> StatsSnapshot {
+  // sum everything into a scratch ThreadStats first, it has the same layout as the per-thread ones
+  auto total = std::make_unique<ThreadStats>();
+  {
+    auto &registry = GetRegistry();
+    std::scoped_lock lock(registry.latch_);
+    Accumulate(*total, registry.retired_);
+    for (ThreadStats *stats : registry.live_) {
+      Accumulate(*total, *stats);
+    }
+  }
+
+  StatsSnapshot snapshot;
+  for (int i = 0; i < NUM_STAT_COUNTERS; i++) {
+    snapshot.counters_[i] = total->counters_[i].load(std::memory_order_relaxed);
+  }
+  for (int h = 0; h < NUM_STAT_HISTOGRAMS; h++) {
+    HistogramSnapshot &histogram = snapshot.histograms_[h];
+    for (size_t b = 0; b < LatencyBuckets::NUM_BUCKETS; b++) {
+      histogram.buckets_[b] = total->buckets_[h][b].load(std::memory_order_relaxed);
+      histogram.count_ += histogram.buckets_[b];
+    }
+    histogram.sum_ = total->sums_[h].load(std::memory_order_relaxed);
+    histogram.max_ = total->maxs_[h].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+auto Stats::CounterName(StatCounter counter) -> const char * {
+  switch (counter) {
+    case StatCounter::BUFFER_HITS:
+      return "hits";
+    case StatCounter::BUFFER_OPTIMISTIC_HITS:
+      return "optimistic_hits";
+    case StatCounter::BUFFER_MISSES:
+      return "misses";
+    case StatCounter::BUFFER_PIN_WAITS:
+      return "pin_waits";
+    case StatCounter::BUFFER_SYNC_EVICTIONS:
+      return "dirty_evictions";
+    case StatCounter::BUFFER_CLEAN_EVICTIONS:
+      return "clean_evictions";
+    case StatCounter::BUFFER_BACKGROUND_WRITES:
+      return "writer_pages";
+    case StatCounter::BUFFER_FLUSHED_PAGES:
+      return "flushed_pages";
+    case StatCounter::BUFFER_PREFETCHED_PAGES:
+      return "prefetched_pages";
+    case StatCounter::IO_PAGES_READ:
+      return "pages_read";
+    case StatCounter::IO_PAGES_WRITTEN:
+      return "pages_written";
+    case StatCounter::IO_BYTES_READ:
+      return "bytes_read";
+    case StatCounter::IO_BYTES_WRITTEN:
+      return "bytes_written";
+    case StatCounter::SCAN_PAGES_SKIPPED:
+      return "scan_pages_skipped";
+    case StatCounter::TOAST_CHUNKS_READ:
+      return "toast_chunks_read";
+    case StatCounter::SPILL_BYTES_WRITTEN:
+      return "spill_bytes_written";
+    default:
+      return "unknown";
+  }
+}
+
+auto Stats::HistogramName(StatHistogram histogram) -> const char * {
+  switch (histogram) {
+    case StatHistogram::READ_PAGE:
+      return "read_page";
+    case StatHistogram::WRITE_PAGE:
+      return "write_page";
+    case StatHistogram::READ_BATCH:
+      return "read_batch";
+    case StatHistogram::WRITE_BATCH:
+      return "write_batch";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace easydb
@@ -18,6 +18,7 @@
 #include <setjmp.h>
 #include <signal.h>
 #include <unistd.h>
+#include <algorithm>
 #include "analyze/analyze.h"
 #include "common/errors.h"
 #include "common/portal.h"
@@ -25,6 +26,7 @@
 #include "planner/plan.h"
 #include "planner/planner.h"
 #include "recovery/log_recovery.h"
+#include "system/auto_vacuum.h"
 
 // #define SOCK_PORT 8765
 #define MAX_CONN_LIMIT 256
@@ -49,6 +51,7 @@ std::unique_ptr<LogManager> log_manager;
 std::unique_ptr<RecoveryManager> recovery;
 std::unique_ptr<Analyze> analyze;
 std::unique_ptr<Portal> portal;
+std::unique_ptr<AutoVacuum> auto_vacuum;
 
 int sockfd;
 pthread_mutex_t *buffer_mutex;
@@ -149,7 +152,7 @@ void *client_handler(void *sock_fd) {
             if (plan->tag != easydb::T_Empty) {
               std::shared_ptr<PortalStmt> portalStmt = portal->start(plan, context);
               portal->run(portalStmt, ql_manager.get(), &txn_id, context);
-              portal->drop();
+              portal->drop(portalStmt, context);
             } else {
               std::string str = "empty set\n";
               memcpy(context->data_send_, str.c_str(), str.length());
@@ -314,17 +317,27 @@ void start_server() {
     printf("%s\n", strerror(errno));
   }
   //    assert(ret != -1);
+  auto_vacuum.reset();
   sm_manager->CloseDB();
   std::cout << " DB has been closed.\n";
   std::cout << "Server shuts down." << std::endl;
 }
 
-void print_help() { std::cout << "Usage: ./easydb_server -p <port> -d <database>"; }
+void print_help() {
+  std::cout << "Usage: ./easydb_server -p <port> -d <database> [-s <buffer pool partitions>] "
+               "[-b <buffer pool size in MiB>] [-H (huge pages for the buffer pool)] [-D (O_DIRECT data files)] "
+               "[-V (background vacuum)]";
+}
 
 int main(int argc, char **argv) {
   std::string db_name;
+  size_t bpm_partitions = BUFFER_POOL_PARTITIONS;
+  size_t bpm_frames = BUFFER_POOL_SIZE;
+  bool bpm_huge_pages = BUFFER_POOL_HUGE_PAGES;
+  bool direct_io = ENABLE_DIRECT_IO;
+  bool enable_auto_vacuum = ENABLE_AUTOVACUUM;
   int opt;
-  while ((opt = getopt(argc, argv, "d:p:hw")) > 0) {
+  while ((opt = getopt(argc, argv, "d:p:s:b:HDVhw")) > 0) {
     switch (opt) {
       case 'd':
         db_name = optarg;
@@ -332,6 +345,21 @@ int main(int argc, char **argv) {
       case 'p':
         SOCK_PORT = std::stoi(std::string(optarg));
         break;
+      case 's':
+        bpm_partitions = std::stoul(std::string(optarg));
+        break;
+      case 'b':
+        bpm_frames = std::max<size_t>(1, std::stoul(std::string(optarg)) * 1024 * 1024 / PAGE_SIZE);
+        break;
+      case 'H':
+        bpm_huge_pages = true;
+        break;
+      case 'D':
+        direct_io = true;
+        break;
+      case 'V':
+        enable_auto_vacuum = true;
+        break;
       case 'h':
         print_help();
         exit(0);
@@ -362,7 +390,9 @@ int main(int argc, char **argv) {
     // Database name is passed by args
 
     disk_manager = std::make_unique<DiskManager>(db_name);
-    buffer_pool_manager = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+    disk_manager->SetDirectIO(direct_io);
+    buffer_pool_manager = std::make_unique<BufferPoolManager>(bpm_frames, disk_manager.get(), bpm_partitions,
+                                                              REPLACER_TYPE, bpm_huge_pages);
     rm_manager = std::make_unique<RmManager>(disk_manager.get(), buffer_pool_manager.get());
     ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
     sm_manager =
@@ -373,6 +403,7 @@ int main(int argc, char **argv) {
     optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
     ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get(), planner.get());
     log_manager = std::make_unique<LogManager>(disk_manager.get());
+    buffer_pool_manager->SetLogManager(log_manager.get());
     recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(),
                                                  txn_manager.get(), log_manager.get());
 
@@ -392,6 +423,12 @@ int main(int argc, char **argv) {
     recovery->redo();
     recovery->undo();
 
+    if (enable_auto_vacuum) {
+      auto_vacuum = std::make_unique<AutoVacuum>(sm_manager.get(), txn_manager.get(), lock_manager.get(),
+                                                 log_manager.get(), std::chrono::milliseconds(AUTOVACUUM_INTERVAL_MS),
+                                                 AUTOVACUUM_MIN_DEAD_TUPLES);
+    }
+
     // 开启服务端，开始接受客户端连接
     start_server();
   } catch (EASYDBError &e) {
@@ -0,0 +1,71 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * aggregate_hash_table.cpp
+ *
+ * Identification: src/execution/aggregate_hash_table.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/aggregate_hash_table.h"
+
+#include <algorithm>
+
+namespace easydb {
+
+AggregateHashTable::AggregateHashTable(uint32_t state_size, std::vector<char> initial_state)
+    : state_size_(state_size),
+      initial_state_(std::move(initial_state)),
+      slots_(AGG_HASH_TABLE_INITIAL_SLOTS, EMPTY),
+      mask_(AGG_HASH_TABLE_INITIAL_SLOTS - 1) {}
+
+auto AggregateHashTable::FindOrInsert(const char *key, uint32_t key_size, hash_t hash) -> char * {
+  uint64_t fingerprint = static_cast<uint64_t>(hash) >> 32;
+  size_t pos = hash & mask_;
+  for (;; pos = (pos + 1) & mask_) {
+    uint64_t slot = slots_[pos];
+    if (slot == EMPTY) {
+      break;
+    }
+    if ((slot >> 32) != fingerprint) {
+      continue;
+    }
+    const Group &group = groups_[(slot & GROUP_MASK) - 1];
+    if (group.key_size_ == key_size && std::memcmp(group.key_, key, key_size) == 0) {
+      return group.state_;
+    }
+  }
+
+  // a new group, in the empty slot that ended the probe
+  char *state = arena_.Allocate(state_size_);
+  std::memcpy(state, initial_state_.data(), state_size_);
+  const char *key_copy = key_size == 0 ? nullptr : arena_.Copy(key, key_size);
+  slots_[pos] = MakeSlot(hash, groups_.size());
+  groups_.push_back({key_copy, state, hash, key_size});
+  if (groups_.size() * 2 > slots_.size()) {
+    Grow();
+  }
+  return state;
+}
+
+void AggregateHashTable::Clear() {
+  std::fill(slots_.begin(), slots_.end(), EMPTY);
+  groups_.clear();
+  arena_.Reset();
+}
+
+void AggregateHashTable::Grow() {
+  slots_.assign(slots_.size() * 2, EMPTY);
+  mask_ = slots_.size() - 1;
+  for (size_t group = 0; group < groups_.size(); group++) {
+    size_t pos = groups_[group].hash_ & mask_;
+    while (slots_[pos] != EMPTY) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = MakeSlot(groups_[group].hash_, group);
+  }
+}
+
+}  // namespace easydb
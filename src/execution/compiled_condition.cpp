@@ -0,0 +1,159 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * compiled_condition.cpp
+ *
+ * Identification: src/execution/compiled_condition.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/compiled_condition.h"
+
+#include "common/errors.h"
+
+namespace easydb {
+
+namespace {
+
+using Kernel = bool (*)(const char *lhs, const char *rhs);
+
+/**
+ * Compare a value of type lhs_type with one of type rhs_type by `op`. The C++ comparison promotes the two values
+ * the way the Types compare them, and a NULL on either side fails every operator, as its CmpNull does.
+ */
+template <TypeId lhs_type, TypeId rhs_type, CompOp op>
+auto CompareKernel(const char *lhs, const char *rhs) -> bool {
+  auto lhs_v = TypedReader<lhs_type>::Read(lhs);
+  auto rhs_v = TypedReader<rhs_type>::Read(rhs);
+  if (TypedReader<lhs_type>::IsNull(lhs_v) || TypedReader<rhs_type>::IsNull(rhs_v)) {
+    return false;
+  }
+  if constexpr (op == OP_EQ) {
+    return lhs_v == rhs_v;
+  } else if constexpr (op == OP_NE) {
+    return lhs_v != rhs_v;
+  } else if constexpr (op == OP_LT) {
+    return lhs_v < rhs_v;
+  } else if constexpr (op == OP_GT) {
+    return lhs_v > rhs_v;
+  } else if constexpr (op == OP_LE) {
+    return lhs_v <= rhs_v;
+  } else {
+    return lhs_v >= rhs_v;
+  }
+}
+
+template <TypeId lhs_type, TypeId rhs_type>
+auto KernelFor(CompOp op) -> Kernel {
+  switch (op) {
+    case OP_EQ:
+      return &CompareKernel<lhs_type, rhs_type, OP_EQ>;
+    case OP_NE:
+      return &CompareKernel<lhs_type, rhs_type, OP_NE>;
+    case OP_LT:
+      return &CompareKernel<lhs_type, rhs_type, OP_LT>;
+    case OP_GT:
+      return &CompareKernel<lhs_type, rhs_type, OP_GT>;
+    case OP_LE:
+      return &CompareKernel<lhs_type, rhs_type, OP_LE>;
+    case OP_GE:
+      return &CompareKernel<lhs_type, rhs_type, OP_GE>;
+    default:
+      return nullptr;
+  }
+}
+
+// a number compares with a number of any of the numeric types
+template <TypeId lhs_type>
+auto NumericKernelFor(TypeId rhs_type, CompOp op) -> Kernel {
+  switch (rhs_type) {
+    case TYPE_INT:
+      return KernelFor<lhs_type, TYPE_INT>(op);
+    case TYPE_LONG:
+      return KernelFor<lhs_type, TYPE_LONG>(op);
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      return KernelFor<lhs_type, TYPE_DOUBLE>(op);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+CompiledCondition::CompiledCondition(const Condition &cond, const Schema &lhs_schema, const Schema &rhs_schema)
+    : lhs_(lhs_schema, cond.lhs_col.col_name) {
+  if (cond.is_rhs_stmt || cond.op == OP_IN) {
+    // the right-hand side is only known once the subquery has run
+    return;
+  }
+  TypeId rhs_type;
+  if (cond.is_rhs_val) {
+    rhs_type = cond.rhs_val.GetTypeId();
+    if (rhs_type != TYPE_CHAR && rhs_type != TYPE_VARCHAR) {
+      rhs_storage_.resize(Type::GetTypeSize(rhs_type));
+    } else if (cond.rhs_val.IsNull()) {
+      rhs_storage_.resize(sizeof(uint32_t));
+    } else {
+      rhs_storage_.resize(sizeof(uint32_t) + cond.rhs_val.GetStorageSize());
+    }
+    cond.rhs_val.SerializeTo(rhs_storage_.data());
+  } else {
+    rhs_ = ColumnAccessor(rhs_schema, cond.rhs_col.col_name);
+    rhs_is_col_ = true;
+    rhs_type = rhs_.GetType();
+  }
+  kernel_ = FindKernel(lhs_.GetType(), rhs_type, cond.op);
+}
+
+auto CompiledCondition::ForJoin(const Condition &cond, const std::string &left_tab_name, const Schema &left_schema,
+                                const std::string &right_tab_name, const Schema &right_schema) -> CompiledCondition {
+  // If the left or right is a join executor, then the table name will be join_tab_name instead of tab_name in the
+  // condition. We assume that there must be a raw table name from the left or right executor, that means one side
+  // must not be join executor.
+  bool lhs_on_right;
+  if (!cond.is_rhs_val) {
+    if (cond.lhs_col.tab_name == left_tab_name || cond.rhs_col.tab_name == right_tab_name) {
+      lhs_on_right = false;
+    } else if (cond.lhs_col.tab_name == right_tab_name || cond.rhs_col.tab_name == left_tab_name) {
+      lhs_on_right = true;
+    } else {
+      throw InternalError("Unknown table in condition (lhs or rhs)");
+    }
+  } else {
+    if (cond.lhs_col.tab_name == left_tab_name) {
+      lhs_on_right = false;
+    } else if (cond.lhs_col.tab_name == right_tab_name) {
+      lhs_on_right = true;
+    } else {
+      throw InternalError("Unknown table in condition (lhs)");
+    }
+  }
+  CompiledCondition compiled = lhs_on_right ? CompiledCondition(cond, right_schema, left_schema)
+                                            : CompiledCondition(cond, left_schema, right_schema);
+  compiled.lhs_on_right_ = lhs_on_right;
+  return compiled;
+}
+
+auto CompiledCondition::FindKernel(TypeId lhs_type, TypeId rhs_type, CompOp op) -> Kernel {
+  switch (lhs_type) {
+    case TYPE_INT:
+      return NumericKernelFor<TYPE_INT>(rhs_type, op);
+    case TYPE_LONG:
+      return NumericKernelFor<TYPE_LONG>(rhs_type, op);
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      return NumericKernelFor<TYPE_DOUBLE>(rhs_type, op);
+    case TYPE_DATE:
+      return rhs_type == TYPE_DATE ? KernelFor<TYPE_DATE, TYPE_DATE>(op) : nullptr;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+      return rhs_type == TYPE_CHAR || rhs_type == TYPE_VARCHAR ? KernelFor<TYPE_VARCHAR, TYPE_VARCHAR>(op) : nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace easydb
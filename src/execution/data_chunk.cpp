@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * data_chunk.cpp
+ *
+ * Identification: src/execution/data_chunk.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/data_chunk.h"
+
+#include "record/rm_toast.h"
+#include "type/limits.h"
+
+namespace easydb {
+
+ColumnVector::ColumnVector(TypeId type, uint32_t width, uint32_t capacity)
+    : type_(type),
+      inlined_(type != TYPE_CHAR && type != TYPE_VARCHAR),
+      width_(width),
+      data_(static_cast<size_t>(width) * capacity) {}
+
+void DataChunk::Initialize(const Schema &schema, uint32_t capacity) {
+  capacity_ = capacity;
+  owned_.clear();
+  accessors_.clear();
+  offsets_.clear();
+  for (const Column &col : schema.GetColumns()) {
+    uint32_t width = col.IsInlined() ? col.GetStorageSize() : static_cast<uint32_t>(sizeof(const char *));
+    owned_.push_back(std::make_unique<ColumnVector>(col.GetType(), width, capacity));
+    accessors_.emplace_back(col);
+    offsets_.push_back(col.GetOffset());
+  }
+  varlen_cols_ = schema.GetUnlinedColumns();
+  inlined_size_ = schema.GetInlinedStorageSize();
+  Reset();
+}
+
+void DataChunk::Reset() {
+  size_ = 0;
+  has_selection_ = false;
+  selection_.clear();
+  columns_.resize(owned_.size());
+  for (size_t i = 0; i < owned_.size(); i++) {
+    columns_[i] = owned_[i].get();
+  }
+  arena_.Reset();
+}
+
+void DataChunk::AppendTuple(const char *tuple) {
+  uint32_t row = size_++;
+  for (size_t i = 0; i < owned_.size(); i++) {
+    ColumnVector &column = *owned_[i];
+    const char *storage = accessors_[i].GetDataPtr(tuple);
+    char *slot = column.data_.data() + static_cast<size_t>(row) * column.width_;
+    if (column.inlined_) {
+      std::memcpy(slot, storage, column.width_);
+      continue;
+    }
+    const char *copy = arena_.Copy(storage, GetStringStorageSize(storage));
+    std::memcpy(slot, &copy, sizeof(copy));
+  }
+}
+
+void DataChunk::SelectBitmap(const uint64_t *bitmap) {
+  if (has_selection_) {
+    Select([bitmap](uint32_t row) { return ((bitmap[row >> 6] >> (row & 63)) & 1) != 0; });
+    return;
+  }
+  // every row is selected, the selection is the set bits
+  selection_.clear();
+  for (uint32_t word_idx = 0; word_idx * 64 < size_; word_idx++) {
+    for (uint64_t word = bitmap[word_idx]; word != 0; word &= word - 1) {
+      uint32_t row = word_idx * 64 + static_cast<uint32_t>(__builtin_ctzll(word));
+      if (row >= size_) {
+        break;
+      }
+      selection_.push_back(row);
+    }
+  }
+  has_selection_ = true;
+}
+
+auto DataChunk::GetRowSize(uint32_t row) const -> uint32_t {
+  uint32_t size = inlined_size_;
+  for (uint32_t col_idx : varlen_cols_) {
+    size += GetStringStorageSize(columns_[col_idx]->GetStorage(row));
+  }
+  return size;
+}
+
+void DataChunk::WriteRow(uint32_t row, char *dst) const {
+  // [inlined columns][strings], each string column holding the offset of its value, like the Tuple constructor
+  uint32_t tail = inlined_size_;
+  for (size_t i = 0; i < columns_.size(); i++) {
+    const ColumnVector &column = *columns_[i];
+    const char *storage = column.GetStorage(row);
+    if (column.inlined_) {
+      std::memcpy(dst + offsets_[i], storage, column.width_);
+      continue;
+    }
+    uint32_t size = GetStringStorageSize(storage);
+    std::memcpy(dst + offsets_[i], &tail, sizeof(tail));
+    std::memcpy(dst + tail, storage, size);
+    tail += size;
+  }
+}
+
+void DataChunk::GetRow(uint32_t row, std::vector<char> *out) const {
+  out->resize(GetRowSize(row));
+  WriteRow(row, out->data());
+}
+
+void DataChunk::Reference(const DataChunk &other, const std::vector<uint32_t> &col_ids) {
+  for (size_t i = 0; i < col_ids.size(); i++) {
+    columns_[i] = other.columns_[col_ids[i]];
+  }
+  size_ = other.size_;
+  has_selection_ = other.has_selection_;
+  selection_ = other.selection_;
+}
+
+auto DataChunk::GetStringStorageSize(const char *storage) -> uint32_t {
+  uint32_t len;
+  std::memcpy(&len, storage, sizeof(len));
+  if (len == EASYDB_VALUE_NULL) {
+    return sizeof(uint32_t);
+  }
+  // a value the scan did not read back from the toast is passed on as the pointer to its chunks
+  if (len == RmToast::TOAST_MARKER) {
+    return RmToast::TOAST_STORAGE_SIZE;
+  }
+  return sizeof(uint32_t) + len;
+}
+
+}  // namespace easydb
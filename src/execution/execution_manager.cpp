@@ -32,10 +32,11 @@ const char *help_info =
     "Supported SQL syntax:\n"
     "  command ;\n"
     "command:\n"
-    "  CREATE TABLE table_name (column_name type [, column_name type ...])\n"
+    "  CREATE TABLE table_name (column_name type [, column_name type ...]) [WITH (storage = {row | column})]\n"
     "  DROP TABLE table_name\n"
     "  CREATE INDEX table_name (column_name)\n"
     "  DROP INDEX table_name (column_name)\n"
+    "  VACUUM table_name\n"
     "  INSERT INTO table_name VALUES (value [, value ...])\n"
     "  DELETE FROM table_name [WHERE where_clause]\n"
     "  UPDATE table_name SET column_name = value [, column_name = value ...] [WHERE where_clause]\n"
@@ -58,7 +59,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context) {
   if (auto x = std::dynamic_pointer_cast<DDLPlan>(plan)) {
     switch (x->tag) {
       case T_CreateTable: {
-        sm_manager_->CreateTable(x->tab_name_, x->cols_, context);
+        sm_manager_->CreateTable(x->tab_name_, x->cols_, context, x->column_storage_);
         break;
       }
       case T_DropTable: {
@@ -97,6 +98,18 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
         sm_manager_->ShowIndex(x->tab_name_, context);
         break;
       }
+      case T_ShowBufferStats: {
+        sm_manager_->ShowBufferStats(context);
+        break;
+      }
+      case T_ShowIoStats: {
+        sm_manager_->ShowIoStats(context);
+        break;
+      }
+      case T_Vacuum: {
+        sm_manager_->Vacuum(x->tab_name_, context);
+        break;
+      }
       case T_DescTable: {
         sm_manager_->DescTable(x->tab_name_, context);
         break;
@@ -190,45 +203,45 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
 
   // Print records
   size_t num_rec = 0;
-  // 执行query_plan
-  for (executorTreeRoot->beginTuple(); !executorTreeRoot->IsEnd(); executorTreeRoot->nextTuple()) {
-    auto tuple = executorTreeRoot->Next();
-    if (num_rec == 0 && executorTreeRoot->IsEnd()) {
-      outfile << "empty set\n\0";
-    }
-    std::vector<std::string> columns;
-    std::string col_str;
-    auto schema = &executorTreeRoot->schema();
-    int column_count = schema->GetColumnCount();
-    for (int column_itr = 0; column_itr < column_count; column_itr++) {
-      if (tuple->IsNull(schema, column_itr)) {
-        col_str = "NULL";
-      } else {
-        Value val = (tuple->GetValue(schema, column_itr));
-        col_str = val.ToString();
+  // 执行query_plan，结果按批(DataChunk)取出
+  auto schema = &executorTreeRoot->schema();
+  int column_count = schema->GetColumnCount();
+  DataChunk chunk(*schema);
+  for (executorTreeRoot->beginBatch(); executorTreeRoot->NextBatch(chunk);) {
+    for (uint32_t sel = 0; sel < chunk.GetNumSelected(); sel++) {
+      uint32_t row = chunk.GetSelected(sel);
+      std::vector<std::string> columns;
+      std::string col_str;
+      for (int column_itr = 0; column_itr < column_count; column_itr++) {
+        Value val = chunk.GetValue(column_itr, row);
+        if (val.IsNull()) {
+          col_str = "NULL";
+        } else {
+          col_str = val.ToString();
+        }
+        columns.emplace_back(col_str);
       }
-      columns.emplace_back(col_str);
-    }
 
-    if (!print_caption && enable_output) {
-      outfile << "|";
-      for (int i = 0; i < captions.size(); ++i) {
-        outfile << " " << captions[i] << " |";
+      if (!print_caption && enable_output) {
+        outfile << "|";
+        for (int i = 0; i < captions.size(); ++i) {
+          outfile << " " << captions[i] << " |";
+        }
+        outfile << "\n";
+        print_caption = true;
       }
-      outfile << "\n";
-      print_caption = true;
-    }
-    // print record into buffer
-    rec_printer.print_record(columns, context);
-    // print record into file
-    if (enable_output) {
-      outfile << "|";
-      for (int i = 0; i < columns.size(); ++i) {
-        outfile << " " << columns[i] << " |";
+      // print record into buffer
+      rec_printer.print_record(columns, context);
+      // print record into file
+      if (enable_output) {
+        outfile << "|";
+        for (int i = 0; i < columns.size(); ++i) {
+          outfile << " " << columns[i] << " |";
+        }
+        outfile << "\n";
       }
-      outfile << "\n";
+      num_rec++;
     }
-    num_rec++;
   }
   if (!print_caption && enable_output) {
     outfile << "|";
@@ -10,6 +10,10 @@
 
 #include "execution/executor_aggregation.h"
 
+#include <type_traits>
+
+#include "type/limits.h"
+
 /**
  * e.g.
  *
@@ -24,314 +28,361 @@
  * group by id
  * having COUNT(*) > 1 and MIN(score) > 88;
  *
- * TYPE: COUNT MIN MAX SUM
+ * TYPE: COUNT MIN MAX SUM AVG
  *
  * enum AggregationType {
- *  MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, NO_AGG
+ *  MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, AVG_AGG, NO_AGG
  *  };
  */
 
 namespace easydb {
 
-AggregationExecutor::AggregationExecutor(SmManager *sm_manager, std::unique_ptr<AbstractExecutor> prev,
-                                         std::vector<TabCol> sel_col_) {
-  //  std::vector<TabCol> group_cols, std::vector<Condition> having_conds) {
-  sm_manager_ = sm_manager;
+namespace {
+
+/**
+ * 一个组的一个聚合函数的累加器. COUNT只用count_; SUM和AVG在value_中累加非NULL值的和; MIN和MAX在value_中存
+ * 当前的最值(字符串和日期字段存其在values_中的下标), count_为0表示还没有值.
+ */
+struct AggregateState {
+  union {
+    int64_t int_;
+    double double_;
+  };
+  int64_t count_;
+
+  /** @return 类型T的值累加和比较所用的成员 */
+  template <typename T>
+  inline auto Get() -> decltype(auto) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return (double_);
+    } else {
+      return (int_);
+    }
+  }
+};
+
+auto IsNumeric(TypeId type) -> bool {
+  return type == TYPE_INT || type == TYPE_LONG || type == TYPE_FLOAT || type == TYPE_DOUBLE;
+}
+
+auto NullValue(TypeId type) -> Value {
+  switch (type) {
+    case TYPE_INT:
+      return Value(TYPE_INT, EASYDB_INT32_NULL);
+    case TYPE_LONG:
+      return Value(TYPE_LONG, static_cast<int64_t>(EASYDB_INT64_NULL));
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      return Value(type, EASYDB_DECIMAL_NULL);
+    case TYPE_DATE:
+      return Value(TYPE_DATE, static_cast<uint64_t>(EASYDB_TIMESTAMP_NULL));
+    default:
+      return Value(type);
+  }
+}
+
+}  // namespace
+
+AggregationExecutor::AggregationExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols,
+                                         const std::vector<TabCol> &group_cols,
+                                         const std::vector<Condition> &having_conds) {
   prev_ = std::move(prev);
   prev_schema_ = prev_->schema();
   tab_name_ = prev_->getTabName();
+  for (auto &col : group_cols) {
+    group_col_ids_.push_back(prev_schema_.GetColIdx(col.col_name));
+  }
+
   int offset = 0;
   std::vector<Column> new_colus_;
-  for (auto &sel_col : sel_col_) {
+  for (auto &sel_col : sel_cols) {
     Column colu_tp;
     if (sel_col.col_name == "*" && sel_col.aggregation_type == AggregationType::COUNT_AGG) {
-      // todo
-      // colu_tp = {.tab_name_ = "",
-      //            .column_name_ = "*",
-      //            .column_type_ = TYPE_INT,
-      //            .length_ = sizeof(int),
-      //            .column_offset_ = offset,
-      //            .agg_type = AggregationType::COUNT_AGG};
       colu_tp.SetTabName("");
-      colu_tp.SetName("*");
+      colu_tp.SetName(generate_new_name(sel_col));
       colu_tp.SetType(TYPE_INT);
       colu_tp.SetStorageSize(sizeof(int));
       colu_tp.SetOffset(offset);
       colu_tp.SetAggregationType(AggregationType::COUNT_AGG);
-      sel_colus_.push_back(colu_tp);
-      colu_tp.SetName(generate_new_name(sel_col));
       new_colus_.push_back(colu_tp);
+      outputs_.push_back(resolve_output(sel_col));
       offset += sizeof(int);
       continue;
     }
-    // col_tp = *get_col(prev_cols_, sel_col);
 
     colu_tp = prev_schema_.GetColumn(sel_col.col_name);
-
     colu_tp.SetAggregationType(sel_col.aggregation_type);
-    sel_colus_.push_back(colu_tp);
     if (sel_col.aggregation_type != AggregationType::NO_AGG) {
       if (sel_col.aggregation_type == AggregationType::COUNT_AGG) {
         colu_tp.SetType(ColType::TYPE_INT);
         colu_tp.SetStorageSize(sizeof(int));
-      } else if (sel_col.aggregation_type == AggregationType::SUM_AGG &&
-                 (colu_tp.GetType() == ColType::TYPE_VARCHAR || colu_tp.GetType() == ColType::TYPE_CHAR)) {
-        throw InternalError("string type do not supports sum aggreagation.");
+      } else if (sel_col.aggregation_type == AggregationType::AVG_AGG) {
+        colu_tp.SetType(ColType::TYPE_FLOAT);
+        colu_tp.SetStorageSize(sizeof(double));
       }
       colu_tp.SetName(generate_new_name(sel_col));
     }
+    // 不在group by中的非聚集字段没有确定的值
+    outputs_.push_back(resolve_output(sel_col));
     colu_tp.SetOffset(offset);
     offset += colu_tp.GetStorageSize();
     new_colus_.push_back(colu_tp);
   }
   schema_ = Schema(new_colus_);
-
   len_ = offset;
-  isend_ = false;
-  // key_length = 0;
-  // for (auto &col : group_cols) {
-  //   Column colu_tp = prev_schema_.GetColumn(col.col_name);
-  //   ;
-  //   key_length += colu_tp.GetStorageSize();
-  //   group_colus_.push_back(colu_tp);
-  // }
-  // having_conds_ = std::move(having_conds);
-
-  // for (prev_->beginTuple(); !prev_->IsEnd(); prev_->nextTuple()) {
-  //   auto record_tp = *prev_->Next();
-  //   all_records_.push_back(record_tp);
-  // }
+
+  for (auto &cond : having_conds) {
+    if (cond.is_rhs_stmt) {
+      throw InternalError("subquery in having-conds is not supported.");
+    }
+    HavingCond having{.cond_ = cond, .lhs_ = resolve_output(cond.lhs_col), .rhs_ = {}};
+    if (!cond.is_rhs_val) {
+      having.rhs_ = resolve_output(cond.rhs_col);
+    }
+    having_conds_.push_back(std::move(having));
+  }
+
+  // 每个组的累加器: 每个聚合函数一个AggregateState, 初始全0
+  size_t state_size = aggregates_.size() * sizeof(AggregateState);
+  hash_table_ = std::make_unique<AggregateHashTable>(state_size, std::vector<char>(state_size, 0));
+  chunk_.Initialize(prev_schema_);
+  group_idx_ = 0;
+}
+
+AggregationExecutor::Output AggregationExecutor::resolve_output(const TabCol &col) {
+  if (col.aggregation_type == AggregationType::NO_AGG) {
+    uint32_t col_idx = prev_schema_.GetColIdx(col.col_name);
+    for (size_t i = 0; i < group_col_ids_.size(); i++) {
+      if (group_col_ids_[i] == col_idx) {
+        return {.is_agg_ = false, .idx_ = i};
+      }
+    }
+    throw InternalError("only cols in \"group by\" statement can be projected without aggregation.");
+  }
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    if (aggregates_[i].type_ == col.aggregation_type && aggregates_[i].col_name_ == col.col_name) {
+      return {.is_agg_ = true, .idx_ = i};
+    }
+  }
+
+  Aggregate agg{.type_ = col.aggregation_type, .col_name_ = col.col_name, .col_idx_ = 0, .col_type_ = TYPE_INT};
+  if (col.col_name != "*") {
+    agg.col_idx_ = prev_schema_.GetColIdx(col.col_name);
+    agg.col_type_ = prev_schema_.GetColumn(agg.col_idx_).GetType();
+    if ((agg.type_ == AggregationType::SUM_AGG || agg.type_ == AggregationType::AVG_AGG) && !IsNumeric(agg.col_type_)) {
+      throw InternalError(coltype2str(agg.col_type_) + " type does not support sum or avg aggregation.");
+    }
+  } else if (agg.type_ != AggregationType::COUNT_AGG) {
+    throw InternalError("only COUNT supports *.");
+  }
+  aggregates_.push_back(std::move(agg));
+  return {.is_agg_ = true, .idx_ = aggregates_.size() - 1};
 }
 
 void AggregationExecutor::beginTuple() {
-  // do nothing
-
-  // group by
-  // if (group_colus_.size() != 0) {
-  //   // having group by statement
-  //   for (auto ait = all_records_.begin(); ait != all_records_.end(); ait++) {
-  //     std::string key = "";
-  //     int offset = 0;
-  //     for (auto &group_col : group_colus_) {
-  //       key += std::string(ait->GetData() + group_col.GetOffset(), group_col.GetStorageSize());
-  //       offset += group_col.GetStorageSize();
-  //     }
-  //     if (key_records_map_.find(key) == key_records_map_.end()) {
-  //       // not grouped.
-  //       std::vector<Tuple> tuple_tp;
-  //       tuple_tp.push_back(*ait);
-  //       key_records_map_[key] = tuple_tp;
-  //     } else {
-  //       key_records_map_[key].push_back(*ait);
-  //     }
-  //   }
-  // } else {
-  // std::string key_tp = "*";
-  // key_records_map_[key_tp] = std::move(all_records_);
-  // }
-  // it = key_records_map_.begin();
-  // while (!IsEnd()) {
-  // while (!IsEnd() && !predicate(it->second)) {
-  // it++;
-  // }
+  build();
+  group_idx_ = 0;
+  seek();
 }
 
 void AggregationExecutor::nextTuple() {
-  // do nothing
-  isend_ = true;
-  // do {
-  //   it++;
-  // } while (!IsEnd());
-  // } while (!IsEnd() && !predicate(it->second));
+  group_idx_++;
+  seek();
 }
 
 std::unique_ptr<Tuple> AggregationExecutor::Next() {
-  // std::vector<Tuple> records = it->second;
   std::vector<Value> value_vec;
-  for (auto &sel_col : sel_colus_) {
-    // if(sel_col.agg_type==AggregationType::NO_AGG && !in_groupby_cols(sel_col)){
-    //     throw InternalError("only cols in \"group by\" statement can be projected without aggregation.");
-    // }
-    value_vec.push_back(aggregation_to_value(sel_col));
+  value_vec.reserve(outputs_.size());
+  for (auto &output : outputs_) {
+    value_vec.push_back(output_value(group_idx_, output));
   }
   return std::make_unique<Tuple>(value_vec, &schema_);
 }
 
-// bool AggregationExecutor::in_groupby_cols(Column target) {
-//   auto pos = std::find_if(group_colus_.begin(), group_colus_.end(), [&](const ColMeta &col) {
-//     return col.tab_name == target.tab_name && col.name == target.name;
-//   });
-//   if (pos == group_colus_.end()) {
-//     return false;
-//   }
-//   return true;
-// }
-
-// bool AggregationExecutor::predicate(std::vector<RmRecord> records) {
-//   bool satisfy = true;
-//   // return true only all the conditions were true
-//   // i.e. all conditions are connected with 'and' operator
-//   for (auto &cond : having_conds_) {
-//     Value lhs_v, rhs_v;
-//     if (cond.lhs_col.aggregation_type != AggregationType::NO_AGG) {
-//       // case 1. e.g. count(*)
-//       if (cond.lhs_col.col_name == "*" && cond.lhs_col.aggregation_type == AggregationType::COUNT_AGG) {
-//         ColMeta col_tp;
-//         col_tp = {.tab_name = "",
-//                   .name = "*",
-//                   .type = TYPE_INT,
-//                   .len = sizeof(int),
-//                   .offset = 0,
-//                   .index = false,
-//                   .agg_type = AggregationType::COUNT_AGG};
-//         lhs_v = aggregation_to_value(records, col_tp);
-//       } else {  // case 2. e.g. min(val)
-//         ColMeta col_tp;
-//         col_tp = {.tab_name = cond.lhs_col.tab_name,
-//                   .name = cond.lhs_col.col_name,
-//                   .type = TYPE_INT,
-//                   .len = sizeof(int),
-//                   .offset = 0,
-//                   .index = false,
-//                   .agg_type = cond.lhs_col.aggregation_type};
-
-//         lhs_v = aggregation_to_value(records, col_tp);
-//       }
-
-//     } else {
-//       throw InternalError("having-conds with no aggregation.");
-//     }
-
-//     if (cond.is_rhs_val) {
-//       rhs_v = cond.rhs_val;
-//     } else if (cond.rhs_col.aggregation_type != AggregationType::NO_AGG) {
-//       rhs_v = aggregation_to_value(records, *get_col(prev_cols_, cond.rhs_col));
-//     } else {
-//       throw InternalError("having-conds with no aggregation.");
-//     }
-
-//     if (!cond.satisfy(lhs_v, rhs_v)) {
-//       satisfy = false;
-//       break;
-//     }
-//   }
-//   return satisfy;
-// }
-
-Value AggregationExecutor::aggregation_to_value(Column target_colu) {
-  AggregationType type = target_colu.GetAggregationType();
-  std::string col_name = target_colu.GetName();
-  int length = target_colu.GetStorageSize();
-  Value val;
-  switch (type) {
-    // case AggregationType::NO_AGG:
-    case AggregationType::SUM_AGG:
-      if(target_colu.GetType() == TypeId::TYPE_INT){
-        return Value(target_colu.GetType(), int(sm_manager_->GetTableAttrSum(tab_name_, col_name)));
-      }else{
-        return Value(target_colu.GetType(), sm_manager_->GetTableAttrSum(tab_name_, col_name));
+void AggregationExecutor::build() {
+  hash_table_->Clear();
+  values_.clear();
+  if (group_col_ids_.empty()) {
+    // 没有group by, 所有记录为一个组
+    hash_table_->FindOrInsert(nullptr, 0, AggregateHashTable::Hash(nullptr, 0));
+  }
+
+  for (prev_->beginBatch(); prev_->NextBatch(chunk_);) {
+    uint32_t num_rows = chunk_.GetNumSelected();
+    states_.resize(num_rows);
+    if (group_col_ids_.empty()) {
+      std::fill(states_.begin(), states_.end(), hash_table_->GetState(0));
+    } else {
+      // key: group by字段的storage依次拼接, 字符串为[length][bytes]
+      for (uint32_t i = 0; i < num_rows; i++) {
+        uint32_t row = chunk_.GetSelected(i);
+        key_.clear();
+        for (uint32_t col_idx : group_col_ids_) {
+          const ColumnVector &column = chunk_.GetColumn(col_idx);
+          const char *storage = column.GetStorage(row);
+          uint32_t size = column.IsInlined() ? column.GetWidth() : DataChunk::GetStringStorageSize(storage);
+          key_.insert(key_.end(), storage, storage + size);
+        }
+        auto key_size = static_cast<uint32_t>(key_.size());
+        states_[i] = hash_table_->FindOrInsert(key_.data(), key_size, AggregateHashTable::Hash(key_.data(), key_size));
       }
-    case AggregationType::COUNT_AGG:
-      return Value(TypeId::TYPE_INT, sm_manager_->GetTableCount(tab_name_));
-    case AggregationType::MAX_AGG:
-      if(target_colu.GetType() == TypeId::TYPE_INT){
-        return Value(target_colu.GetType(), int(sm_manager_->GetTableAttrMax(tab_name_, col_name)));
-      }else{
-        return Value(target_colu.GetType(), sm_manager_->GetTableAttrMax(tab_name_, col_name));
+    }
+    for (size_t agg_idx = 0; agg_idx < aggregates_.size(); agg_idx++) {
+      update_aggregate(agg_idx);
+    }
+  }
+}
+
+void AggregationExecutor::update_aggregate(size_t agg_idx) {
+  const Aggregate &agg = aggregates_[agg_idx];
+  size_t offset = agg_idx * sizeof(AggregateState);
+  if (agg.col_name_ == "*") {
+    for (char *state : states_) {
+      reinterpret_cast<AggregateState *>(state + offset)->count_++;
+    }
+    return;
+  }
+  const ColumnVector &column = chunk_.GetColumn(agg.col_idx_);
+  switch (agg.col_type_) {
+    case TYPE_INT:
+      update_numbers<int32_t>(agg.type_, column, offset, EASYDB_INT32_NULL);
+      break;
+    case TYPE_LONG:
+      update_numbers<int64_t>(agg.type_, column, offset, EASYDB_INT64_NULL);
+      break;
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      update_numbers<double>(agg.type_, column, offset, EASYDB_DECIMAL_NULL);
+      break;
+    default:
+      update_values(agg, column, offset);
+  }
+}
+
+template <typename T>
+void AggregationExecutor::update_numbers(AggregationType type, const ColumnVector &column, size_t offset, T null) {
+  // 一列的值连续存放, 按聚合函数分别循环, 每个循环只做一种更新
+  const char *data = column.GetData();
+  auto for_each_value = [&](auto &&update) {
+    for (size_t i = 0; i < states_.size(); i++) {
+      T val;
+      std::memcpy(&val, data + static_cast<size_t>(chunk_.GetSelected(i)) * sizeof(T), sizeof(T));
+      if (val != null) {
+        update(reinterpret_cast<AggregateState *>(states_[i] + offset), val);
       }
+    }
+  };
+  switch (type) {
+    case AggregationType::COUNT_AGG:
+      for_each_value([](AggregateState *state, T) { state->count_++; });
+      break;
+    case AggregationType::SUM_AGG:
+    case AggregationType::AVG_AGG:
+      for_each_value([](AggregateState *state, T val) {
+        state->Get<T>() += val;
+        state->count_++;
+      });
+      break;
     case AggregationType::MIN_AGG:
-      if(target_colu.GetType() == TypeId::TYPE_INT){
-        return Value(target_colu.GetType(), int(sm_manager_->GetTableAttrMin(tab_name_, col_name)));
-      }else{
-        return Value(target_colu.GetType(), sm_manager_->GetTableAttrMin(tab_name_, col_name));
-      }
+      for_each_value([](AggregateState *state, T val) {
+        if (state->count_++ == 0 || val < state->Get<T>()) {
+          state->Get<T>() = val;
+        }
+      });
+      break;
+    case AggregationType::MAX_AGG:
+      for_each_value([](AggregateState *state, T val) {
+        if (state->count_++ == 0 || val > state->Get<T>()) {
+          state->Get<T>() = val;
+        }
+      });
+      break;
     default:
       throw InternalError("unsupported aggregation operator.");
   }
 }
 
-// Value AggregationExecutor::aggregation_to_value(std::vector<Tuple> records, Column target_colu) {
-//   AggregationType type = target_colu.GetAggregationType();
-//   std::string col_name = target_colu.GetName();
-//   int length = target_colu.GetStorageSize();
-//   Value val;
-//   switch (type) {
-//     case AggregationType::NO_AGG:
-//       if (records.empty()) {
-//         //   val.type = TYPE_EMPTY;
-//         //   val.init_raw(0);
-//         //   return val;
-//         return Value();
-//       }
-//       // if (val.get_value_from_record(records[0], sel_cols_, col_name) == nullptr) {
-//       //   throw InternalError("target column not found.");
-//       // }
-//       // val.init_raw(length);
-//       val = records[0].GetValue(prev_schema_, col_name);
-//       return val;
-//     case AggregationType::SUM_AGG:
-//       if (records.empty()) {
-//         for (auto &col_tp : sel_colus_) {
-//           if (col_tp.name == col_name) {
-//             val.type = col_tp.type;
-//             break;
-//           }
-//         }
-//         if (val.type == TYPE_STRING) {
-//           throw InternalError("TYPE_STRING don't support sum aggregation.");
-//         } else if (val.type == TYPE_FLOAT) {
-//           val.set_float(0);
-//         } else {
-//           val.set_int(0);
-//         }
-//         // val.init_raw(length);
-//         return val;
-//       }
-//       val = records[0].GetValue(prev_schema_, col_name);
-
-//       for (int i = 1; i < records.size(); i++) {
-//         Value tp = records[i].GetValue(prev_schema_, col_name);
-//         val = val + tp;
-//       }
-//       // val.init_raw(length);
-//       return val;
-//     case AggregationType::COUNT_AGG:
-//       val.set_int(records.size());
-//       val.init_raw(sizeof(int));
-//       return val;
-//     case AggregationType::MAX_AGG:
-//       if (records.empty()) {
-//         val.type = TYPE_EMPTY;
-//         val.init_raw(0);
-//         return val;
-//       }
-//       val = records[0].GetValue(prev_schema_, col_name);
-//       for (auto &rec : records) {
-//         Value tp = rec.GetValue(prev_schema_, col_name);
-//         if (val < tp) {
-//           val = tp;
-//         }
-//       }
-//       return val;
-//     case AggregationType::MIN_AGG:
-//       if (records.empty()) {
-//         val.type = TYPE_EMPTY;
-//         val.init_raw(0);
-//         return val;
-//       }
-//       val = records[0].GetValue(prev_schema_, col_name);
-
-//       for (auto &rec : records) {
-//         Value tp = rec.GetValue(prev_schema_, col_name);
-//         if (val > tp) {
-//           val = tp;
-//         }
-//       }
-//       return val;
-//     default:
-//       throw InternalError("unsupported aggregation operator.");
-//   }
-// }
+void AggregationExecutor::update_values(const Aggregate &agg, const ColumnVector &column, size_t offset) {
+  for (size_t i = 0; i < states_.size(); i++) {
+    Value val = Value::DeserializeFrom(column.GetStorage(chunk_.GetSelected(i)), agg.col_type_);
+    if (val.IsNull()) {
+      continue;
+    }
+    auto *state = reinterpret_cast<AggregateState *>(states_[i] + offset);
+    if (agg.type_ == AggregationType::COUNT_AGG) {
+      state->count_++;
+      continue;
+    }
+    if (state->count_++ == 0) {
+      state->int_ = static_cast<int64_t>(values_.size());
+      values_.push_back(std::move(val));
+    } else if (agg.type_ == AggregationType::MIN_AGG ? val < values_[state->int_] : val > values_[state->int_]) {
+      values_[state->int_] = std::move(val);
+    }
+  }
+}
+
+void AggregationExecutor::seek() {
+  for (; !IsEnd(); group_idx_++) {
+    bool satisfy = true;
+    // 所有having条件以and连接
+    for (auto &having : having_conds_) {
+      Value lhs_v = output_value(group_idx_, having.lhs_);
+      Value rhs_v = having.cond_.is_rhs_val ? having.cond_.rhs_val : output_value(group_idx_, having.rhs_);
+      if (!having.cond_.satisfy(lhs_v, rhs_v)) {
+        satisfy = false;
+        break;
+      }
+    }
+    if (satisfy) {
+      return;
+    }
+  }
+}
+
+Value AggregationExecutor::group_value(size_t group, size_t group_col) {
+  const char *storage = hash_table_->GetKey(group);
+  for (size_t i = 0; i < group_col; i++) {
+    const ColumnVector &column = chunk_.GetColumn(group_col_ids_[i]);
+    storage += column.IsInlined() ? column.GetWidth() : DataChunk::GetStringStorageSize(storage);
+  }
+  return Value::DeserializeFrom(storage, prev_schema_.GetColumn(group_col_ids_[group_col]).GetType());
+}
+
+Value AggregationExecutor::output_value(size_t group, const Output &output) {
+  if (!output.is_agg_) {
+    return group_value(group, output.idx_);
+  }
+  const Aggregate &agg = aggregates_[output.idx_];
+  auto *state = reinterpret_cast<const AggregateState *>(hash_table_->GetState(group) +
+                                                         output.idx_ * sizeof(AggregateState));
+  if (agg.type_ == AggregationType::COUNT_AGG) {
+    return Value(TYPE_INT, static_cast<int32_t>(state->count_));
+  }
+  if (agg.type_ == AggregationType::AVG_AGG) {
+    if (state->count_ == 0) {
+      return NullValue(TYPE_FLOAT);
+    }
+    double sum = agg.col_type_ == TYPE_INT || agg.col_type_ == TYPE_LONG ? static_cast<double>(state->int_)
+                                                                          : state->double_;
+    return Value(TYPE_FLOAT, sum / static_cast<double>(state->count_));
+  }
+  // SUM, MIN, MAX: 没有非NULL值时为NULL
+  if (state->count_ == 0) {
+    return NullValue(agg.col_type_);
+  }
+  switch (agg.col_type_) {
+    case TYPE_INT:
+      return Value(TYPE_INT, static_cast<int32_t>(state->int_));
+    case TYPE_LONG:
+      return Value(TYPE_LONG, state->int_);
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      return Value(agg.col_type_, state->double_);
+    default:
+      return values_[state->int_];
+  }
+}
 
 std::string AggregationExecutor::generate_new_name(TabCol col) {
   if (col.new_col_name != "") {
@@ -346,6 +397,8 @@ std::string AggregationExecutor::generate_new_name(TabCol col) {
       return "COUNT(" + col.col_name + ")";
     case SUM_AGG:
       return "SUM(" + col.col_name + ")";
+    case AVG_AGG:
+      return "AVG(" + col.col_name + ")";
     default:
       throw InternalError("unsupported aggregation type.");
   }
@@ -19,7 +19,8 @@
 namespace easydb {
 
 IndexScanExecutor::IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
-                                     std::vector<std::string> index_col_names, Context *context) {
+                                     std::vector<std::string> index_col_names, Context *context,
+                                     const std::vector<std::string> *read_cols) {
   sm_manager_ = sm_manager;
   context_ = context;
   tab_name_ = std::move(tab_name);
@@ -51,6 +52,14 @@ IndexScanExecutor::IndexScanExecutor(SmManager *sm_manager, std::string tab_name
     cond_cols.emplace_back(cond.lhs_col.col_name);
     cond_cols_set.emplace(cond.lhs_col.col_name);
   }
+  if (fh_->GetToast() != nullptr) {
+    toast_cols_ = getToastColumns(schema_, tab_name_, read_cols, conds_);
+  }
+  // the columns of the conditions are looked up once here, not for every record
+  compiled_conds_.reserve(conds_.size());
+  for (const auto &cond : conds_) {
+    compiled_conds_.emplace_back(cond, schema_, schema_);
+  }
   // Now we just check columns of conditions must be the same as the index.
   // Actually, parts of columns can use the index.
   // TODO: support more complex conditions
@@ -223,18 +232,8 @@ bool IndexScanExecutor::predicate() {
   auto tuple = *this->Next();
   bool satisfy = true;
   // i.e. all conditions are connected with 'and' operator
-  for (auto &cond : conds_) {
-    // auto lhs_col = get_col(cols_, cond.lhs_col);
-    Value lhs_v, rhs_v;
-    lhs_v = tuple.GetValue(&schema_, cond.lhs_col.col_name);
-    // lhs_v.DeserializeFrom(tuple.GetData(), &schema_, cond.lhs_col.col_name);
-    if (cond.is_rhs_val) {
-      rhs_v = cond.rhs_val;
-    } else {
-      rhs_v = tuple.GetValue(&schema_, cond.rhs_col.col_name);
-      // rhs_v.DeserializeFrom(tuple.GetData(), &schema_, cond.rhs_col.col_name);
-    }
-    if (!cond.satisfy(lhs_v, rhs_v)) {
+  for (size_t i = 0; i < conds_.size(); i++) {
+    if (!compiled_conds_[i].Evaluate(conds_[i], tuple.GetData(), tuple.GetData())) {
       satisfy = false;
       break;
     }
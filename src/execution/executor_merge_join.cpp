@@ -156,8 +156,8 @@ void MergeJoinExecutor::iterate_helper() {
   right_tuple.DeserializeFrom(current_right_data_);
   Value lhs_v, rhs_v;
 
-  lhs_v = left_tuple.GetValue(&left_->schema(), left_sel_colu_.GetName());
-  rhs_v = right_tuple.GetValue(&right_->schema(), right_sel_colu_.GetName());
+  lhs_v = left_tuple.GetValue(left_sel_colu_);
+  rhs_v = right_tuple.GetValue(right_sel_colu_);
 
   while ((!leftSorter_->IsEnd() && !rightSorter_->IsEnd())) {
     if (lhs_v == rhs_v) {
@@ -167,13 +167,13 @@ void MergeJoinExecutor::iterate_helper() {
       memcpy(current_left_data_, tp, left_size_);
       free(tp);
       left_tuple.DeserializeFrom(current_left_data_);
-      lhs_v = left_tuple.GetValue(&left_->schema(), left_sel_colu_.GetName());
+      lhs_v = left_tuple.GetValue(left_sel_colu_);
     } else {
       tp = rightSorter_->getOneRecord();
       memcpy(current_right_data_, tp, right_size_);
       free(tp);
       right_tuple.DeserializeFrom(current_right_data_);
-      rhs_v = right_tuple.GetValue(&right_->schema(), right_sel_colu_.GetName());
+      rhs_v = right_tuple.GetValue(right_sel_colu_);
     }
   }
 
@@ -182,7 +182,7 @@ void MergeJoinExecutor::iterate_helper() {
     memcpy(current_right_data_, tp, right_size_);
     free(tp);
     right_tuple.DeserializeFrom(current_right_data_);
-    rhs_v = right_tuple.GetValue(&right_->schema(), right_sel_colu_.GetName());
+    rhs_v = right_tuple.GetValue(right_sel_colu_);
   }
 
   if (lhs_v != rhs_v) {
@@ -200,40 +200,40 @@ void MergeJoinExecutor::index_iterate_helper() {
 
   if (!initialize_flag_) {
     current_right_tup_ = right_buffer_[right_idx_];
-    rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+    rhs_v = current_right_tup_.GetValue(right_sel_colu_);
     last_right_val_ = rhs_v;
     last_right_idx_ = right_idx_;
     right_idx_++;
 
     current_left_tup_ = left_buffer_[left_idx_];
-    lhs_v = current_left_tup_.GetValue(&left_->schema(), left_sel_colu_.GetName());
+    lhs_v = current_left_tup_.GetValue(left_sel_colu_);
     last_left_val_ = lhs_v;
     left_idx_++;
 
     initialize_flag_ = true;
   } else {
-    rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+    rhs_v = current_right_tup_.GetValue(right_sel_colu_);
     Value next_right_v;
     if (right_idx_ < right_buffer_.size())
-      next_right_v = right_buffer_[right_idx_].GetValue(&right_->schema(), right_sel_colu_.GetName());
+      next_right_v = right_buffer_[right_idx_].GetValue(right_sel_colu_);
 
     if (right_idx_ >= right_buffer_.size() || rhs_v != next_right_v) {
       current_left_tup_ = left_buffer_[left_idx_];
       left_idx_++;
 
-      lhs_v = current_left_tup_.GetValue(&left_->schema(), left_sel_colu_.GetName());
+      lhs_v = current_left_tup_.GetValue(left_sel_colu_);
       if (last_left_val_.GetTypeId() != TYPE_EMPTY && last_left_val_ == lhs_v && right_idx_ < right_buffer_.size()) {
         right_idx_ = last_right_idx_;
         current_right_tup_ = right_buffer_[right_idx_];
-        rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+        rhs_v = current_right_tup_.GetValue(right_sel_colu_);
         right_idx_++;
       }
       last_left_val_ = lhs_v;
     } else {
-      lhs_v = current_left_tup_.GetValue(&left_->schema(), left_sel_colu_.GetName());
+      lhs_v = current_left_tup_.GetValue(left_sel_colu_);
       current_right_tup_ = right_buffer_[right_idx_];
       right_idx_++;
-      rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+      rhs_v = current_right_tup_.GetValue(right_sel_colu_);
     }
   }
 
@@ -242,12 +242,12 @@ void MergeJoinExecutor::index_iterate_helper() {
       break;
     } else if (lhs_v < rhs_v) {
       current_left_tup_ = left_buffer_[left_idx_];
-      lhs_v = current_left_tup_.GetValue(&left_->schema(), left_sel_colu_.GetName());
+      lhs_v = current_left_tup_.GetValue(left_sel_colu_);
       last_left_val_ = lhs_v;
       left_idx_++;
     } else {
       current_right_tup_ = right_buffer_[right_idx_];
-      rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+      rhs_v = current_right_tup_.GetValue(right_sel_colu_);
       if (last_right_val_ != rhs_v) {
         last_right_val_ = rhs_v;
         last_right_idx_ = right_idx_;
@@ -258,7 +258,7 @@ void MergeJoinExecutor::index_iterate_helper() {
 
   while (lhs_v > rhs_v && right_idx_ < right_buffer_.size()) {
     current_right_tup_ = right_buffer_[right_idx_];
-    rhs_v = current_right_tup_.GetValue(&right_->schema(), right_sel_colu_.GetName());
+    rhs_v = current_right_tup_.GetValue(right_sel_colu_);
     if (last_right_val_ != rhs_v) {
       last_right_val_ = rhs_v;
       last_right_idx_ = right_idx_;
@@ -15,6 +15,7 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor>
                                                std::unique_ptr<AbstractExecutor> right, std::vector<Condition> conds) {
   left_ = std::move(left);
   right_ = std::move(right);
+  context_ = left_->context_ != nullptr ? left_->context_ : right_->context_;
 
   left_tab_name_ = left_->getTabName();
   right_tab_name_ = right_->getTabName();
@@ -35,6 +36,10 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor>
   // cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
   isend = false;
   fed_conds_ = std::move(conds);
+  for (const auto &cond : fed_conds_) {
+    compiled_conds_.push_back(
+        CompiledCondition::ForJoin(cond, left_tab_name_, left_->schema(), right_tab_name_, right_->schema()));
+  }
 
   if (fed_conds_.size() > 0) {
     need_sort_ = false;
@@ -58,11 +63,13 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor>
 
 void NestedLoopJoinExecutor::beginTuple() {
   // Load left and right buffers
+  left_buffer_.clear();
+  right_buffer_.clear();
   for (left_->beginTuple(); !left_->IsEnd(); left_->nextTuple()) {
-    left_buffer_.emplace_back(*(left_->Next()));
+    left_buffer_.push_back(left_->NextInArena());
   }
   for (right_->beginTuple(); !right_->IsEnd(); right_->nextTuple()) {
-    right_buffer_.emplace_back(*(right_->Next()));
+    right_buffer_.push_back(right_->NextInArena());
   }
 
   left_idx_ = 0;
@@ -72,7 +79,7 @@ void NestedLoopJoinExecutor::beginTuple() {
   if (isend) {
     return;
   }
-  joined_records_ = concat_records();
+  concat_records();
 }
 
 void NestedLoopJoinExecutor::nextTuple() {
@@ -85,13 +92,13 @@ void NestedLoopJoinExecutor::nextTuple() {
   if (isend) {
     return;
   }
-  joined_records_ = concat_records();
+  concat_records();
 }
 
 void NestedLoopJoinExecutor::sorted_iterate_helper() {
   Value lhs_v, rhs_v;
-  lhs_v = left_buffer_[left_idx_].GetValue(&left_->schema(), left_sel_colu_.GetName());
-  rhs_v = right_buffer_[right_idx_].GetValue(&right_->schema(), right_sel_colu_.GetName());
+  lhs_v = left_buffer_[left_idx_].GetValue(left_sel_colu_);
+  rhs_v = right_buffer_[right_idx_].GetValue(right_sel_colu_);
 
   // lhs_v.get_value_from_record(left_buffer_[left_idx_], left_sel_col_);
   // rhs_v.get_value_from_record(right_buffer_[right_idx_], right_sel_col_);
@@ -142,68 +149,13 @@ void NestedLoopJoinExecutor::iterate_next() {
   }
 }
 
-Tuple NestedLoopJoinExecutor::concat_records() {
-  auto left_value_vec = left_buffer_[left_idx_].GetValueVec(&left_->schema());
-  auto right_value_vec = right_buffer_[right_idx_].GetValueVec(&right_->schema());
-  left_value_vec.insert(left_value_vec.end(), right_value_vec.begin(), right_value_vec.end());
-  return Tuple(left_value_vec, &schema_);
+void NestedLoopJoinExecutor::concat_records() {
+  ConcatTuples(left_buffer_[left_idx_], left_->schema(), right_buffer_[right_idx_], right_->schema(), &joined_records_);
 }
 
-bool NestedLoopJoinExecutor::predicate(const Tuple &left_tuple, const Tuple &right_tuple) {
-  for (const auto &cond : fed_conds_) {
-    Value lhs_v, rhs_v;
-    // Determine the values based on whether RHS is a column or a value
-    if (!cond.is_rhs_val) {
-      // Both sides are columns
-      // If the left or right is a join executor, then the table name will be join_tab_name instead of tab_name in the
-      // condition. We assume that there must be a raw table name from the left or right executor, that means one side
-      // must not be join executor.
-      if (cond.lhs_col.tab_name == left_tab_name_ || cond.rhs_col.tab_name == right_tab_name_) {
-        lhs_v = left_tuple.GetValue(&left_->schema(), cond.lhs_col.col_name);
-        rhs_v = right_tuple.GetValue(&right_->schema(), cond.rhs_col.col_name);
-      } else if (cond.lhs_col.tab_name == right_tab_name_ || cond.rhs_col.tab_name == left_tab_name_) {
-        lhs_v = right_tuple.GetValue(&right_->schema(), cond.lhs_col.col_name);
-        rhs_v = left_tuple.GetValue(&left_->schema(), cond.rhs_col.col_name);
-      } else {
-        throw InternalError("Unknown table in condition (lhs or rhs)");
-      }
-    } else {
-      // RHS is a value
-      if (cond.lhs_col.tab_name == left_tab_name_) {
-        lhs_v = left_tuple.GetValue(&left_->schema(), cond.lhs_col.col_name);
-      } else if (cond.lhs_col.tab_name == right_tab_name_) {
-        lhs_v = right_tuple.GetValue(&right_->schema(), cond.lhs_col.col_name);
-      } else {
-        throw InternalError("Unknown table in condition (lhs)");
-      }
-      rhs_v = cond.rhs_val;
-    }
-
-    // Evaluate the condition
-    bool condition_satisfied = false;
-    switch (cond.op) {
-      case OP_EQ:
-        condition_satisfied = (lhs_v.CompareEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_NE:
-        condition_satisfied = (lhs_v.CompareNotEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_LT:
-        condition_satisfied = (lhs_v.CompareLessThan(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_GT:
-        condition_satisfied = (lhs_v.CompareGreaterThan(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_LE:
-        condition_satisfied = (lhs_v.CompareLessThanEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_GE:
-        condition_satisfied = (lhs_v.CompareGreaterThanEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      default:
-        throw InternalError("Unsupported operator in condition.");
-    }
-    if (!condition_satisfied) {
+bool NestedLoopJoinExecutor::predicate(const TupleView &left_tuple, const TupleView &right_tuple) {
+  for (size_t i = 0; i < fed_conds_.size(); i++) {
+    if (!compiled_conds_[i].EvaluateJoin(fed_conds_[i], left_tuple.GetData(), right_tuple.GetData())) {
       return false;  // Condition not satisfied
     }
   }
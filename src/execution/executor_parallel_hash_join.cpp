@@ -0,0 +1,251 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * executor_parallel_hash_join.cpp
+ *
+ * Identification: src/execution/executor_parallel_hash_join.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/executor_parallel_hash_join.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace easydb {
+
+/** Morsels of the right child each worker gets a round, on average: enough to even out their speeds. */
+static constexpr size_t PROBE_MORSELS_PER_WORKER = 4;
+
+static auto DefaultNumThreads() -> size_t {
+  size_t cores = std::max(std::thread::hardware_concurrency(), 1U);
+  return std::min(cores, static_cast<size_t>(PARALLEL_HASH_JOIN_THREADS));
+}
+
+ParallelHashJoinExecutor::ParallelHashJoinExecutor(std::unique_ptr<AbstractExecutor> left,
+                                                   std::unique_ptr<AbstractExecutor> right,
+                                                   std::vector<Condition> conds, size_t num_threads,
+                                                   size_t output_budget)
+    : left_(std::move(left)),
+      right_(std::move(right)),
+      conds_(std::move(conds)),
+      pool_(num_threads == 0 ? DefaultNumThreads() : num_threads),
+      tables_(static_cast<size_t>(1) << PARALLEL_HASH_JOIN_PARTITION_BITS),
+      worker_output_budget_(std::max<size_t>(output_budget / pool_.GetNumThreads(), 1)),
+      outputs_(pool_.GetNumThreads()) {
+  context_ = left_->context_ != nullptr ? left_->context_ : right_->context_;
+  left_tab_name_ = left_->getTabName();
+  right_tab_name_ = right_->getTabName();
+  join_tab_name_ = left_tab_name_ + "_" + right_tab_name_;
+
+  auto left_columns = left_->schema().GetColumns();
+  auto right_columns = right_->schema().GetColumns();
+  left_columns.insert(left_columns.end(), right_columns.begin(), right_columns.end());
+  schema_ = Schema(left_columns);
+
+  len_ = left_->tupleLen() + right_->tupleLen();
+  for (const auto &cond : conds_) {
+    compiled_conds_.push_back(
+        CompiledCondition::ForJoin(cond, left_tab_name_, left_->schema(), right_tab_name_, right_->schema()));
+  }
+  JoinKeyEncoder::ForJoin(conds_, left_tab_name_, left_->schema(), right_tab_name_, right_->schema(), &left_keys_,
+                          &right_keys_);
+}
+
+void ParallelHashJoinExecutor::beginTuple() {
+  Build();
+  isend_ = !Advance();
+}
+
+void ParallelHashJoinExecutor::nextTuple() { isend_ = !Advance(); }
+
+std::unique_ptr<Tuple> ParallelHashJoinExecutor::Next() {
+  if (isend_) {
+    return nullptr;
+  }
+  return std::make_unique<Tuple>(static_cast<int>(current_.GetLength()), current_.GetData());
+}
+
+std::optional<TupleView> ParallelHashJoinExecutor::NextView() {
+  if (isend_) {
+    return std::nullopt;
+  }
+  return current_;
+}
+
+void ParallelHashJoinExecutor::beginBatch() {
+  Build();
+  isend_ = false;
+}
+
+bool ParallelHashJoinExecutor::NextBatch(DataChunk &chunk) {
+  chunk.Reset();
+  while (!isend_ && !chunk.IsFull()) {
+    if (!Advance()) {
+      isend_ = true;
+      break;
+    }
+    chunk.AppendTuple(current_.GetData());
+  }
+  return chunk.GetSize() > 0;
+}
+
+void ParallelHashJoinExecutor::Build() {
+  for (auto &table : tables_) {
+    table.Clear();
+  }
+  // The left child is read by this thread alone, the workers share out the morsels it gave
+  std::vector<Morsel> build_morsels;
+  left_->beginBatch();
+  ReadMorsels(left_.get(), &build_morsels, SIZE_MAX);
+
+  // Each worker sorts the rows of the morsels it takes into lists of its own, one a partition
+  size_t num_threads = pool_.GetNumThreads();
+  std::vector<std::vector<std::vector<BuildRow>>> partitions(num_threads,
+                                                             std::vector<std::vector<BuildRow>>(tables_.size()));
+  std::atomic<size_t> next_morsel{0};
+  pool_.Run([&](size_t worker) {
+    std::vector<char> key;
+    for (size_t idx; (idx = next_morsel.fetch_add(1)) < build_morsels.size();) {
+      const Morsel &morsel = build_morsels[idx];
+      for (size_t row = 0; row < morsel.GetNumRows(); row++) {
+        TupleView tuple = morsel.GetRow(row);
+        if (!left_keys_.Encode(tuple.GetData(), &key)) {
+          continue;  // a NULL key joins no row
+        }
+        hash_t hash = JoinHashTable::Hash(key.data(), static_cast<uint32_t>(key.size()));
+        partitions[worker][PartitionOf(hash)].push_back({tuple.GetData(), tuple.GetLength(), hash});
+      }
+    }
+  });
+
+  // then each table is built by the worker that takes its partition, from the lists of every worker
+  std::atomic<size_t> next_partition{0};
+  std::atomic<size_t> num_rows{0};
+  pool_.Run([&](size_t) {
+    std::vector<char> key;
+    for (size_t part; (part = next_partition.fetch_add(1)) < tables_.size();) {
+      for (const auto &lists : partitions) {
+        for (const BuildRow &row : lists[part]) {
+          left_keys_.Encode(row.tuple_, &key);
+          tables_[part].Insert(key.data(), static_cast<uint32_t>(key.size()), row.hash_, row.tuple_, row.size_);
+        }
+      }
+      num_rows += tables_[part].GetNumEntries();
+    }
+  });
+  num_build_rows_ = num_rows;
+
+  right_->beginBatch();
+  num_probe_morsels_ = 0;
+  next_probe_morsel_ = 0;
+  probe_done_ = false;
+  for (auto &output : outputs_) {
+    output.Clear();
+  }
+  output_worker_ = 0;
+  output_row_ = 0;
+}
+
+auto ParallelHashJoinExecutor::ReadMorsels(AbstractExecutor *child, std::vector<Morsel> *morsels, size_t max_morsels)
+    -> size_t {
+  DataChunk chunk(child->schema());
+  std::vector<char> row;
+  size_t num_morsels = 0;
+  while (num_morsels < max_morsels && child->NextBatch(chunk)) {
+    if (chunk.GetNumSelected() == 0) {
+      continue;
+    }
+    if (num_morsels == morsels->size()) {
+      morsels->emplace_back();
+    }
+    Morsel &morsel = (*morsels)[num_morsels++];
+    morsel.Clear();
+    for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+      chunk.GetRow(chunk.GetSelected(i), &row);
+      morsel.Append(row.data(), row.size());
+    }
+  }
+  return num_morsels;
+}
+
+auto ParallelHashJoinExecutor::ProbeRound() -> bool {
+  if (probe_done_ || num_build_rows_ == 0) {
+    return false;
+  }
+  if (next_probe_morsel_ == num_probe_morsels_) {
+    num_probe_morsels_ =
+        ReadMorsels(right_.get(), &probe_morsels_, pool_.GetNumThreads() * PROBE_MORSELS_PER_WORKER);
+    next_probe_morsel_ = 0;
+    if (num_probe_morsels_ == 0) {
+      probe_done_ = true;
+      return false;
+    }
+  }
+
+  // A worker with its share of the budget takes no more morsels, the ones nobody took are left to the next round.
+  // Every worker starts empty, so a round probes at least one morsel.
+  std::atomic<size_t> next_morsel{next_probe_morsel_};
+  pool_.Run([&](size_t worker) {
+    Morsel &output = outputs_[worker];
+    output.Clear();
+    std::vector<char> key;
+    std::vector<char> joined;
+    for (size_t idx;
+         output.data_.size() < worker_output_budget_ && (idx = next_morsel.fetch_add(1)) < num_probe_morsels_;) {
+      const Morsel &morsel = probe_morsels_[idx];
+      for (size_t row = 0; row < morsel.GetNumRows(); row++) {
+        TupleView probe_tuple = morsel.GetRow(row);
+        if (!right_keys_.Encode(probe_tuple.GetData(), &key)) {
+          continue;
+        }
+        auto key_size = static_cast<uint32_t>(key.size());
+        hash_t hash = JoinHashTable::Hash(key.data(), key_size);
+        const JoinHashTable &table = tables_[PartitionOf(hash)];
+        for (auto entry = table.Find(key.data(), key_size, hash); entry != nullptr; entry = table.Next(entry)) {
+          if (!predicate(entry->tuple_, probe_tuple.GetData())) {
+            continue;
+          }
+          ConcatTuples(TupleView(entry->tuple_, entry->tuple_size_, RID()), left_->schema(), probe_tuple,
+                       right_->schema(), &joined);
+          output.Append(joined.data(), joined.size());
+        }
+      }
+    }
+  });
+  next_probe_morsel_ = std::min(next_morsel.load(), num_probe_morsels_);
+  return true;
+}
+
+auto ParallelHashJoinExecutor::Advance() -> bool {
+  while (true) {
+    while (output_worker_ < outputs_.size()) {
+      const Morsel &output = outputs_[output_worker_];
+      if (output_row_ < output.GetNumRows()) {
+        current_ = output.GetRow(output_row_++);
+        return true;
+      }
+      output_worker_++;
+      output_row_ = 0;
+    }
+    if (!ProbeRound()) {
+      return false;
+    }
+    output_worker_ = 0;
+    output_row_ = 0;
+  }
+}
+
+bool ParallelHashJoinExecutor::predicate(const char *left_tuple, const char *right_tuple) {
+  for (size_t i = 0; i < conds_.size(); i++) {
+    if (!compiled_conds_[i].EvaluateJoin(conds_[i], left_tuple, right_tuple)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace easydb
@@ -103,6 +103,27 @@ void ProjectionExecutor::nextTuple() {
   }
 }
 
+void ProjectionExecutor::beginBatch() {
+  // SELECT UNIQUE drops duplicates one row at a time
+  if (is_unique_) {
+    beginTuple();
+    return;
+  }
+  prev_->beginBatch();
+  prev_chunk_.Initialize(prev_->schema());
+}
+
+bool ProjectionExecutor::NextBatch(DataChunk &chunk) {
+  if (is_unique_) {
+    return AbstractExecutor::NextBatch(chunk);
+  }
+  if (!prev_->NextBatch(prev_chunk_)) {
+    return false;
+  }
+  chunk.Reference(prev_chunk_, sel_ids_);
+  return true;
+}
+
 std::unique_ptr<Tuple> ProjectionExecutor::Next() {
   if (IsEnd()) {
     return nullptr;
@@ -111,12 +132,16 @@ std::unique_ptr<Tuple> ProjectionExecutor::Next() {
 }
 
 Tuple ProjectionExecutor::projectRecord() {
+  const Schema &prev_schema = prev_->schema();
+  // project straight out of the child's storage if it can show its tuple in place
+  if (auto view = prev_->NextView()) {
+    return view->KeyFromTuple(prev_schema, schema_, sel_ids_);
+  }
   auto prev_tuple_ptr = prev_->Next();
   if (!prev_tuple_ptr) {
     throw InternalError("Previous executor returned null tuple.");
   }
   const Tuple &prev_tuple = *prev_tuple_ptr;
-  const Schema &prev_schema = prev_->schema();
   Tuple proj_tuple = prev_tuple.KeyFromTuple(prev_schema, schema_, sel_ids_);
   return proj_tuple;
 }
@@ -134,6 +159,8 @@ std::string ProjectionExecutor::generate_new_name(const TabCol &col) {
       return "COUNT(" + col.col_name + ")";
     case AggregationType::SUM_AGG:
       return "SUM(" + col.col_name + ")";
+    case AggregationType::AVG_AGG:
+      return "AVG(" + col.col_name + ")";
     default:
       throw InternalError("Unsupported aggregation type.");
   }
@@ -13,7 +13,7 @@
 namespace easydb {
 
 SeqScanExecutor::SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
-                                 Context *context) {
+                                 Context *context, const std::vector<std::string> *read_cols) {
   sm_manager_ = sm_manager;
   tab_name_ = std::move(tab_name);
   conds_ = std::move(conds);
@@ -28,6 +28,61 @@ SeqScanExecutor::SeqScanExecutor(SmManager *sm_manager, std::string tab_name, st
 
   fed_conds_ = conds_;
 
+  // the columns of the conditions are looked up once here, not for every record
+  compiled_conds_.reserve(conds_.size());
+  for (const auto &cond : conds_) {
+    compiled_conds_.emplace_back(cond, schema_, schema_);
+  }
+
+  // a large table is scanned through a small buffer ring, so that it does not push the hot pages out of the pool
+  if (static_cast<size_t>(fh_->GetFileHdr().num_pages) > sm_manager_->GetBpm()->Size() / 4) {
+    strategy_ = std::make_unique<BufferAccessStrategy>(AccessType::SEQ_SCAN, SEQ_SCAN_RING_SIZE);
+  }
+
+  // the conditions on constants can be tested on a column of values on its own, without the rest of the record
+  is_vector_cond_.assign(conds_.size(), false);
+  for (size_t i = 0; i < conds_.size(); i++) {
+    const Condition &cond = conds_[i];
+    bool is_constant = cond.is_rhs_val && !cond.is_rhs_stmt && cond.op != OP_IN;
+    bool is_in_list = cond.op == OP_IN && cond.is_rhs_stmt && cond.rhs_stmt == nullptr;  // IN (1, 2, ...)
+    if (!(is_constant || is_in_list) || cond.lhs_col.tab_name != tab_name_) {
+      continue;
+    }
+    if (auto col_idx = schema_.TryGetColIdx(cond.lhs_col.col_name)) {
+      vector_conds_.emplace_back(*col_idx, i);
+      is_vector_cond_[i] = true;
+      filter_kernels_.push_back(FilterKernel::Create(cond, schema_.GetColumn(*col_idx).GetType()));
+    }
+  }
+
+  // a PAX table tests them column by column, before the records are put together
+  if (fh_->GetFileHdr().page_format == RM_PAGE_FORMAT_PAX) {
+    column_conds_ = vector_conds_;
+  }
+
+  // the conditions on constants over the columns of the zone map let the scan skip pages without reading them
+  if (RmZoneMap *zone_map = fh_->GetZoneMap()) {
+    for (size_t i = 0; i < conds_.size(); i++) {
+      const Condition &cond = conds_[i];
+      if (!cond.is_rhs_val || cond.is_rhs_stmt || cond.op == OP_IN || cond.lhs_col.tab_name != tab_name_) {
+        continue;
+      }
+      if (auto col_idx = schema_.TryGetColIdx(cond.lhs_col.col_name)) {
+        if (auto zone_col = zone_map->FindColumn(schema_.GetColumn(*col_idx).GetOffset())) {
+          zone_conds_.emplace_back(*zone_col, i);
+        }
+      }
+    }
+  }
+
+  // a scan that does not read the long values of a table never touches its toast
+  if (RmToast *toast = fh_->GetToast()) {
+    toast_cols_ = getToastColumns(schema_, tab_name_, read_cols, conds_);
+    toast_ = toast_cols_.empty() ? nullptr : toast;
+    std::vector<std::string> no_cols;
+    detoast_before_predicate_ = !getToastColumns(schema_, tab_name_, &no_cols, conds_).empty();
+  }
+
   // lock table
   if (context_ != nullptr) {
     context_->lock_mgr_->LockSharedOnTable(context_->txn_, fh_->GetFd());
@@ -35,29 +90,158 @@ SeqScanExecutor::SeqScanExecutor(SmManager *sm_manager, std::string tab_name, st
 }
 
 void SeqScanExecutor::beginTuple() {
-  scan_ = std::make_unique<RmScan>(fh_);
-  rid_ = scan_->GetRid();
+  beginBatch();
   while (!IsEnd() && !predicate()) {
-    scan_->Next();
-    rid_ = scan_->GetRid();
+    advance();
+  }
+}
+
+void SeqScanExecutor::beginBatch() {
+  RmScan::PageFilter page_filter = nullptr;
+  if (!zone_conds_.empty()) {
+    page_filter = [this](page_id_t page_no) { return pageMayMatch(page_no); };
   }
+  scan_ = std::make_unique<RmScan>(fh_, strategy_.get(), std::move(page_filter));
+  // the records are walked a page at a time, the scan only touches the buffer pool when it moves to the next page
+  fetchBatch();
+  batch_pos_ = 0;
+  rid_ = IsEnd() ? scan_->GetRid() : batch_[batch_pos_].GetRid();
 }
 
 void SeqScanExecutor::nextTuple() {
   do {
-    scan_->Next();
-    rid_ = scan_->GetRid();
+    advance();
   } while (!IsEnd() && !predicate());
 }
 
-std::unique_ptr<Tuple> SeqScanExecutor::Next() { return fh_->GetTupleValue(rid_, context_); }
+bool SeqScanExecutor::NextBatch(DataChunk &chunk) {
+  do {
+    chunk.Reset();
+    for (; !IsEnd() && !chunk.IsFull(); advance()) {
+      if (predicate(true)) {
+        chunk.AppendTuple(tuple_.GetData());
+      }
+    }
+    // the kernels run over every row of the batch, the rows that pass all of them are selected at once
+    size_t num_words = FilterKernel::BitmapWords(chunk.GetSize());
+    filter_bitmap_.assign(num_words, ~static_cast<uint64_t>(0));
+    cond_bitmap_.resize(num_words);
+    bool has_kernel = false;
+    for (size_t i = 0; i < vector_conds_.size(); i++) {
+      if (filter_kernels_[i] == nullptr) {
+        continue;
+      }
+      filter_kernels_[i]->Evaluate(chunk.GetColumn(vector_conds_[i].first), chunk.GetSize(), cond_bitmap_.data());
+      for (size_t word = 0; word < num_words; word++) {
+        filter_bitmap_[word] &= cond_bitmap_[word];
+      }
+      has_kernel = true;
+    }
+    if (has_kernel) {
+      chunk.SelectBitmap(filter_bitmap_.data());
+    }
+    for (size_t i = 0; i < vector_conds_.size(); i++) {
+      if (filter_kernels_[i] != nullptr) {
+        continue;
+      }
+      auto &[col_idx, cond_idx] = vector_conds_[i];
+      Condition &cond = conds_[cond_idx];
+      const CompiledCondition &compiled = compiled_conds_[cond_idx];
+      const ColumnVector &column = chunk.GetColumn(col_idx);
+      chunk.Select([&](uint32_t row) { return compiled.EvaluateStorage(cond, column.GetStorage(row)); });
+    }
+    // a batch whose rows were all filtered out is not handed over, the next one is filled instead
+  } while (chunk.GetNumSelected() == 0 && !IsEnd());
+  return chunk.GetNumSelected() > 0;
+}
+
+void SeqScanExecutor::advance() {
+  if (++batch_pos_ < batch_.size()) {
+    rid_ = batch_[batch_pos_].GetRid();
+    return;
+  }
+  scan_->Next();
+  fetchBatch();
+  batch_pos_ = 0;
+  rid_ = IsEnd() ? scan_->GetRid() : batch_[batch_pos_].GetRid();
+}
+
+void SeqScanExecutor::fetchBatch() {
+  if (column_conds_.empty()) {
+    scan_->GetPageBatch(batch_);
+    return;
+  }
+  batch_.clear();
+  while (!scan_->IsEnd()) {
+    scan_->GetPageColumns(column_batch_);
+    selected_ = column_batch_.slots_;
+    for (auto &[col_idx, cond_idx] : column_conds_) {
+      Condition &cond = conds_[cond_idx];
+      const CompiledCondition &compiled = compiled_conds_[cond_idx];
+      size_t num_selected = 0;
+      for (uint32_t slot_no : selected_) {
+        if (compiled.EvaluateStorage(cond, column_batch_.GetValueData(col_idx, slot_no))) {
+          selected_[num_selected++] = slot_no;
+        }
+      }
+      selected_.resize(num_selected);
+    }
+    // predicate() still tests every condition on the records that are left, and takes their record locks
+    if (!selected_.empty()) {
+      scan_->GetPageRecords(selected_, batch_);
+      return;
+    }
+    scan_->Next();
+  }
+}
 
-bool SeqScanExecutor::predicate() {
-  auto tuple = *this->Next();
+bool SeqScanExecutor::pageMayMatch(page_id_t page_no) {
+  // a page that has never held a record since its ranges were computed has nothing to return
+  if (!fh_->GetZoneMap()->GetZones(page_no, &zones_)) {
+    return false;
+  }
+  for (auto &[zone_col, cond_idx] : zone_conds_) {
+    Condition &cond = conds_[cond_idx];
+    if (!cond.may_satisfy_range(zones_[zone_col].first, zones_[zone_col].second, cond.rhs_val)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the record lock was taken by predicate(), and the page of rid_ is still pinned by the scan
+std::unique_ptr<Tuple> SeqScanExecutor::Next() {
+  auto tuple = std::make_unique<Tuple>(static_cast<int>(tuple_.GetLength()), tuple_.GetData());
+  tuple->SetRid(rid_);
+  return tuple;
+}
+
+std::optional<TupleView> SeqScanExecutor::NextView() { return tuple_; }
+
+void SeqScanExecutor::detoast() {
+  if (toast_ != nullptr && toast_->Detoast(tuple_, &toast_cols_, &detoasted_)) {
+    tuple_ = TupleView(detoasted_.data(), detoasted_.size(), rid_);
+  }
+}
+
+bool SeqScanExecutor::predicate(bool skip_vector_conds) {
+  if (context_ != nullptr) {
+    context_->lock_mgr_->LockSharedOnRecord(context_->txn_, rid_, fh_->GetFd());
+  }
+  // the conditions are evaluated in place, the record is only copied by Next() if it qualifies
+  tuple_ = batch_[batch_pos_];
+  if (detoast_before_predicate_) {
+    detoast();
+  }
+  const TupleView &tuple = tuple_;
   bool satisfy = true;
   // return true only all the conditions were true
   // i.e. all conditions are connected with 'and' operator
-  for (auto &cond : conds_) {
+  for (size_t i = 0; i < conds_.size(); i++) {
+    if (skip_vector_conds && is_vector_cond_[i]) {
+      continue;
+    }
+    auto &cond = conds_[i];
     // check subquery
     if (cond.is_rhs_stmt && !cond.is_rhs_exe_processed) {
       std::shared_ptr<AbstractExecutor> rhs_stmt_executor_tree_root =
@@ -81,25 +265,15 @@ bool SeqScanExecutor::predicate() {
       }
       cond.is_rhs_exe_processed = true;
     }
-    Value lhs_v, rhs_v;
-    lhs_v = tuple.GetValue(&schema_, cond.lhs_col.col_name);
-    // if (lhs_v.GetData() == nullptr) {
-    //   throw InternalError("target column not found.");
-    // }
-    if (cond.is_rhs_val) {
-      rhs_v = cond.rhs_val;
-    } else if (cond.op != OP_IN) {
-      rhs_v = tuple.GetValue(&schema_, cond.rhs_col.col_name);
-      // rhs_v.get_value_from_tuple(tuple, cols_, cond.rhs_col.col_name)
-      // if(rhs_v.GetData() == nullptr){
-      //   throw InternalError("target column not found.");
-      // }
-    }
-    if (!cond.satisfy(lhs_v, rhs_v)) {
+    if (!compiled_conds_[i].Evaluate(cond, tuple.GetData(), tuple.GetData())) {
       satisfy = false;
       break;
     }
   }
+  // the long values are only read back for the records that qualify
+  if (satisfy && !detoast_before_predicate_) {
+    detoast();
+  }
   return satisfy;
 }
 
@@ -26,10 +26,14 @@ SortExecutor::SortExecutor(std::unique_ptr<AbstractExecutor> prev, TabCol sel_co
 SortExecutor::~SortExecutor() { delete[] current_data_; }
 
 void SortExecutor::beginTuple() {
-  std::unique_ptr<Tuple> current_tuple;
-  for (prev_->beginTuple(); !prev_->IsEnd(); prev_->nextTuple()) {
-    current_tuple = prev_->Next();
-    sorter->writeBuffer(*current_tuple);
+  // the child is drained a batch at a time
+  DataChunk chunk(prev_->schema());
+  std::vector<char> row;
+  for (prev_->beginBatch(); prev_->NextBatch(chunk);) {
+    for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+      chunk.GetRow(chunk.GetSelected(i), &row);
+      sorter->writeBuffer(Tuple(static_cast<int>(row.size()), row.data()));
+    }
   }
   sorter->clearBuffer();
   sorter->initializeMergeListAndConstructTree();
@@ -46,6 +50,15 @@ void SortExecutor::nextTuple() {
   }
 }
 
+bool SortExecutor::NextBatch(DataChunk &chunk) {
+  chunk.Reset();
+  // a sorted record is [size][tuple]
+  for (; !isend_ && !chunk.IsFull(); nextTuple()) {
+    chunk.AppendTuple(current_data_ + sizeof(uint32_t));
+  }
+  return chunk.GetSize() > 0;
+}
+
 void SortExecutor::printRecord(RmRecord record, std::vector<ColMeta> cols) {
   std::string str;
   int str_size = 0;
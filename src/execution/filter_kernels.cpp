@@ -0,0 +1,531 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * filter_kernels.cpp
+ *
+ * Identification: src/execution/filter_kernels.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/filter_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EASYDB_FILTER_X86 1
+#endif
+
+#include "common/config.h"
+#include "storage/table/tuple_accessor.h"
+#include "type/limits.h"
+
+namespace easydb {
+
+namespace {
+
+/** @return `lhs` compared with `rhs` by `op`, which is not OP_IN */
+template <CompOp op, typename T>
+inline auto Compare(const T &lhs, const T &rhs) -> bool {
+  if constexpr (op == OP_EQ) {
+    return lhs == rhs;
+  } else if constexpr (op == OP_NE) {
+    return lhs != rhs;
+  } else if constexpr (op == OP_LT) {
+    return lhs < rhs;
+  } else if constexpr (op == OP_GT) {
+    return lhs > rhs;
+  } else if constexpr (op == OP_LE) {
+    return lhs <= rhs;
+  } else {
+    return lhs >= rhs;
+  }
+}
+
+/**
+ * The scalar kernel, which also finishes the rows at the end of a column that do not fill a vector register.
+ * @param begin the first row to test, `bitmap` is already zero from there on
+ */
+template <CompOp op, typename T>
+void FilterScalar(const char *values, uint32_t begin, uint32_t end, const std::vector<T> &consts, T null,
+                  uint64_t *bitmap) {
+  for (uint32_t row = begin; row < end; row++) {
+    T value;
+    std::memcpy(&value, values + static_cast<size_t>(row) * sizeof(T), sizeof(T));
+    bool match = false;
+    if (value != null) {
+      if constexpr (op == OP_IN) {
+        match = std::find(consts.begin(), consts.end(), value) != consts.end();
+      } else {
+        match = Compare<op>(value, consts[0]);
+      }
+    }
+    bitmap[row >> 6] |= static_cast<uint64_t>(match) << (row & 63);
+  }
+}
+
+#ifdef EASYDB_FILTER_X86
+
+// Each vector kernel handles the rows of whole registers and returns the first row it left to FilterScalar(). The
+// lanes of a register hold consecutive rows, so the mask of a register is shifted into the bitmap word of its first
+// row, which it never straddles. A NULL value is the sentinel of its type and is masked out after the comparison.
+
+template <CompOp op>
+__attribute__((target("avx2"))) auto FilterInt32Avx2(const char *values, uint32_t num_rows,
+                                                    const std::vector<int32_t> &consts, uint64_t *bitmap) -> uint32_t {
+  const __m256i nulls = _mm256_set1_epi32(EASYDB_INT32_NULL);
+  const __m256i rhs = _mm256_set1_epi32(consts[0]);
+  uint32_t row = 0;
+  for (; row + 8 <= num_rows; row += 8) {
+    __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + row * sizeof(int32_t)));
+    __m256i mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm256_setzero_si256();
+      for (int32_t value : consts) {
+        mask = _mm256_or_si256(mask, _mm256_cmpeq_epi32(lhs, _mm256_set1_epi32(value)));
+      }
+    } else if constexpr (op == OP_EQ || op == OP_NE) {
+      mask = _mm256_cmpeq_epi32(lhs, rhs);
+    } else if constexpr (op == OP_GT || op == OP_LE) {
+      mask = _mm256_cmpgt_epi32(lhs, rhs);
+    } else {
+      mask = _mm256_cmpgt_epi32(rhs, lhs);
+    }
+    // NE, LE and GE are the complements of EQ, GT and LT
+    if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) {
+      mask = _mm256_xor_si256(mask, _mm256_set1_epi32(-1));
+    }
+    mask = _mm256_andnot_si256(_mm256_cmpeq_epi32(lhs, nulls), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+template <CompOp op>
+__attribute__((target("sse4.2"))) auto FilterInt32Sse42(const char *values, uint32_t num_rows,
+                                                       const std::vector<int32_t> &consts, uint64_t *bitmap)
+    -> uint32_t {
+  const __m128i nulls = _mm_set1_epi32(EASYDB_INT32_NULL);
+  const __m128i rhs = _mm_set1_epi32(consts[0]);
+  uint32_t row = 0;
+  for (; row + 4 <= num_rows; row += 4) {
+    __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + row * sizeof(int32_t)));
+    __m128i mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm_setzero_si128();
+      for (int32_t value : consts) {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi32(lhs, _mm_set1_epi32(value)));
+      }
+    } else if constexpr (op == OP_EQ || op == OP_NE) {
+      mask = _mm_cmpeq_epi32(lhs, rhs);
+    } else if constexpr (op == OP_GT || op == OP_LE) {
+      mask = _mm_cmpgt_epi32(lhs, rhs);
+    } else {
+      mask = _mm_cmpgt_epi32(rhs, lhs);
+    }
+    if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) {
+      mask = _mm_xor_si128(mask, _mm_set1_epi32(-1));
+    }
+    mask = _mm_andnot_si128(_mm_cmpeq_epi32(lhs, nulls), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+template <CompOp op>
+__attribute__((target("avx2"))) auto FilterInt64Avx2(const char *values, uint32_t num_rows,
+                                                    const std::vector<int64_t> &consts, uint64_t *bitmap) -> uint32_t {
+  const __m256i nulls = _mm256_set1_epi64x(EASYDB_INT64_NULL);
+  const __m256i rhs = _mm256_set1_epi64x(consts[0]);
+  uint32_t row = 0;
+  for (; row + 4 <= num_rows; row += 4) {
+    __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + row * sizeof(int64_t)));
+    __m256i mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm256_setzero_si256();
+      for (int64_t value : consts) {
+        mask = _mm256_or_si256(mask, _mm256_cmpeq_epi64(lhs, _mm256_set1_epi64x(value)));
+      }
+    } else if constexpr (op == OP_EQ || op == OP_NE) {
+      mask = _mm256_cmpeq_epi64(lhs, rhs);
+    } else if constexpr (op == OP_GT || op == OP_LE) {
+      mask = _mm256_cmpgt_epi64(lhs, rhs);
+    } else {
+      mask = _mm256_cmpgt_epi64(rhs, lhs);
+    }
+    if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) {
+      mask = _mm256_xor_si256(mask, _mm256_set1_epi64x(-1));
+    }
+    mask = _mm256_andnot_si256(_mm256_cmpeq_epi64(lhs, nulls), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+// _mm_cmpgt_epi64 is the instruction SSE4.2 adds for this kernel
+template <CompOp op>
+__attribute__((target("sse4.2"))) auto FilterInt64Sse42(const char *values, uint32_t num_rows,
+                                                       const std::vector<int64_t> &consts, uint64_t *bitmap)
+    -> uint32_t {
+  const __m128i nulls = _mm_set1_epi64x(EASYDB_INT64_NULL);
+  const __m128i rhs = _mm_set1_epi64x(consts[0]);
+  uint32_t row = 0;
+  for (; row + 2 <= num_rows; row += 2) {
+    __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + row * sizeof(int64_t)));
+    __m128i mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm_setzero_si128();
+      for (int64_t value : consts) {
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi64(lhs, _mm_set1_epi64x(value)));
+      }
+    } else if constexpr (op == OP_EQ || op == OP_NE) {
+      mask = _mm_cmpeq_epi64(lhs, rhs);
+    } else if constexpr (op == OP_GT || op == OP_LE) {
+      mask = _mm_cmpgt_epi64(lhs, rhs);
+    } else {
+      mask = _mm_cmpgt_epi64(rhs, lhs);
+    }
+    if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) {
+      mask = _mm_xor_si128(mask, _mm_set1_epi64x(-1));
+    }
+    mask = _mm_andnot_si128(_mm_cmpeq_epi64(lhs, nulls), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+// the comparisons of doubles are not complements of each other once a NaN is involved, so each operator has its own
+// predicate: the ordered ones are false on a NaN, NE is true on it, like the C++ operators
+
+template <CompOp op>
+__attribute__((target("avx2"))) auto FilterDoubleAvx2(const char *values, uint32_t num_rows,
+                                                     const std::vector<double> &consts, uint64_t *bitmap) -> uint32_t {
+  const __m256d nulls = _mm256_set1_pd(EASYDB_DECIMAL_NULL);
+  const __m256d rhs = _mm256_set1_pd(consts[0]);
+  uint32_t row = 0;
+  for (; row + 4 <= num_rows; row += 4) {
+    __m256d lhs = _mm256_loadu_pd(reinterpret_cast<const double *>(values + row * sizeof(double)));
+    __m256d mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm256_setzero_pd();
+      for (double value : consts) {
+        mask = _mm256_or_pd(mask, _mm256_cmp_pd(lhs, _mm256_set1_pd(value), _CMP_EQ_OQ));
+      }
+    } else if constexpr (op == OP_EQ) {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ);
+    } else if constexpr (op == OP_NE) {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_NEQ_UQ);
+    } else if constexpr (op == OP_LT) {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_LT_OQ);
+    } else if constexpr (op == OP_GT) {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_GT_OQ);
+    } else if constexpr (op == OP_LE) {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_LE_OQ);
+    } else {
+      mask = _mm256_cmp_pd(lhs, rhs, _CMP_GE_OQ);
+    }
+    mask = _mm256_andnot_pd(_mm256_cmp_pd(lhs, nulls, _CMP_EQ_OQ), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm256_movemask_pd(mask));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+template <CompOp op>
+__attribute__((target("sse4.2"))) auto FilterDoubleSse42(const char *values, uint32_t num_rows,
+                                                        const std::vector<double> &consts, uint64_t *bitmap)
+    -> uint32_t {
+  const __m128d nulls = _mm_set1_pd(EASYDB_DECIMAL_NULL);
+  const __m128d rhs = _mm_set1_pd(consts[0]);
+  uint32_t row = 0;
+  for (; row + 2 <= num_rows; row += 2) {
+    __m128d lhs = _mm_loadu_pd(reinterpret_cast<const double *>(values + row * sizeof(double)));
+    __m128d mask;
+    if constexpr (op == OP_IN) {
+      mask = _mm_setzero_pd();
+      for (double value : consts) {
+        mask = _mm_or_pd(mask, _mm_cmpeq_pd(lhs, _mm_set1_pd(value)));
+      }
+    } else if constexpr (op == OP_EQ) {
+      mask = _mm_cmpeq_pd(lhs, rhs);
+    } else if constexpr (op == OP_NE) {
+      mask = _mm_cmpneq_pd(lhs, rhs);
+    } else if constexpr (op == OP_LT) {
+      mask = _mm_cmplt_pd(lhs, rhs);
+    } else if constexpr (op == OP_GT) {
+      mask = _mm_cmpgt_pd(lhs, rhs);
+    } else if constexpr (op == OP_LE) {
+      mask = _mm_cmple_pd(lhs, rhs);
+    } else {
+      mask = _mm_cmpge_pd(lhs, rhs);
+    }
+    mask = _mm_andnot_pd(_mm_cmpeq_pd(lhs, nulls), mask);
+    uint64_t bits = static_cast<uint32_t>(_mm_movemask_pd(mask));
+    bitmap[row >> 6] |= bits << (row & 63);
+  }
+  return row;
+}
+
+#endif  // EASYDB_FILTER_X86
+
+/** The vector kernels of one C++ type, the same signature for every level so that they can be picked from a table. */
+template <typename T>
+using VectorKernel = auto (*)(const char *values, uint32_t num_rows, const std::vector<T> &consts, uint64_t *bitmap)
+    -> uint32_t;
+
+template <CompOp op, typename T>
+auto PickVectorKernel(SimdLevel level) -> VectorKernel<T> {
+#ifdef EASYDB_FILTER_X86
+  bool avx2 = level == SimdLevel::AVX2;
+  if (level == SimdLevel::SCALAR) {
+    return nullptr;
+  }
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return avx2 ? &FilterInt32Avx2<op> : &FilterInt32Sse42<op>;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return avx2 ? &FilterInt64Avx2<op> : &FilterInt64Sse42<op>;
+  } else {
+    return avx2 ? &FilterDoubleAvx2<op> : &FilterDoubleSse42<op>;
+  }
+#else
+  return nullptr;
+#endif
+}
+
+template <CompOp op, typename T>
+void FilterNumbers(const char *values, uint32_t num_rows, const std::vector<T> &consts, T null, SimdLevel level,
+                   uint64_t *bitmap) {
+  uint32_t row = 0;
+  if (auto kernel = PickVectorKernel<op, T>(level)) {
+    row = kernel(values, num_rows, consts, bitmap);
+  }
+  FilterScalar<op>(values, row, num_rows, consts, null, bitmap);
+}
+
+template <typename T>
+void FilterNumbers(CompOp op, const char *values, uint32_t num_rows, const std::vector<T> &consts, T null,
+                   SimdLevel level, uint64_t *bitmap) {
+  switch (op) {
+    case OP_EQ:
+      return FilterNumbers<OP_EQ>(values, num_rows, consts, null, level, bitmap);
+    case OP_NE:
+      return FilterNumbers<OP_NE>(values, num_rows, consts, null, level, bitmap);
+    case OP_LT:
+      return FilterNumbers<OP_LT>(values, num_rows, consts, null, level, bitmap);
+    case OP_GT:
+      return FilterNumbers<OP_GT>(values, num_rows, consts, null, level, bitmap);
+    case OP_LE:
+      return FilterNumbers<OP_LE>(values, num_rows, consts, null, level, bitmap);
+    case OP_GE:
+      return FilterNumbers<OP_GE>(values, num_rows, consts, null, level, bitmap);
+    case OP_IN:
+      return FilterNumbers<OP_IN>(values, num_rows, consts, null, level, bitmap);
+  }
+}
+
+/**
+ * The first 8 bytes of a string, zero padded, as a big-endian number: two strings without '\0' in them compare as
+ * their prefixes do, unless the prefixes are equal.
+ */
+inline auto StringPrefix(std::string_view str) -> uint64_t {
+  char bytes[sizeof(uint64_t)] = {};
+  std::memcpy(bytes, str.data(), std::min(str.size(), sizeof(bytes)));
+  uint64_t prefix;
+  std::memcpy(&prefix, bytes, sizeof(prefix));
+  return __builtin_bswap64(prefix);
+}
+
+/** @return the sign of `lhs` compared with `rhs`, by their prefixes first */
+inline auto CompareStrings(std::string_view lhs, uint64_t lhs_prefix, std::string_view rhs, uint64_t rhs_prefix)
+    -> int {
+  if (lhs_prefix != rhs_prefix) {
+    return lhs_prefix < rhs_prefix ? -1 : 1;
+  }
+  return lhs.compare(rhs);
+}
+
+void FilterStrings(CompOp op, const ColumnVector &column, uint32_t num_rows, const std::vector<std::string> &consts,
+                   uint64_t *bitmap) {
+  std::vector<uint64_t> const_prefixes;
+  for (const auto &value : consts) {
+    const_prefixes.push_back(StringPrefix(value));
+  }
+  for (uint32_t row = 0; row < num_rows; row++) {
+    std::string_view value = TypedReader<TYPE_VARCHAR>::Read(column.GetStorage(row));
+    if (TypedReader<TYPE_VARCHAR>::IsNull(value)) {
+      continue;
+    }
+    uint64_t prefix = StringPrefix(value);
+    bool match = false;
+    if (op == OP_IN) {
+      for (size_t i = 0; i < consts.size() && !match; i++) {
+        match = prefix == const_prefixes[i] && value == consts[i];
+      }
+    } else {
+      int cmp = CompareStrings(value, prefix, consts[0], const_prefixes[0]);
+      switch (op) {
+        case OP_EQ:
+          match = cmp == 0;
+          break;
+        case OP_NE:
+          match = cmp != 0;
+          break;
+        case OP_LT:
+          match = cmp < 0;
+          break;
+        case OP_GT:
+          match = cmp > 0;
+          break;
+        case OP_LE:
+          match = cmp <= 0;
+          break;
+        default:
+          match = cmp >= 0;
+          break;
+      }
+    }
+    bitmap[row >> 6] |= static_cast<uint64_t>(match) << (row & 63);
+  }
+}
+
+/** @return the storage of a constant, as it would be in a tuple */
+auto SerializeConstant(const Value &value) -> std::vector<char> {
+  std::vector<char> storage;
+  TypeId type = value.GetTypeId();
+  if (type != TYPE_CHAR && type != TYPE_VARCHAR) {
+    storage.resize(Type::GetTypeSize(type));
+  } else if (value.IsNull()) {
+    storage.resize(sizeof(uint32_t));
+  } else {
+    storage.resize(sizeof(uint32_t) + value.GetStorageSize());
+  }
+  value.SerializeTo(storage.data());
+  return storage;
+}
+
+/**
+ * Read a numeric constant as a `T`, the type a column compares it as.
+ * @return false if it is not a type whose values convert to `T` the way the Types compare them
+ */
+template <typename T>
+auto ReadNumber(const Value &value, std::vector<T> *consts) -> bool {
+  std::vector<char> storage = SerializeConstant(value);
+  auto add = [&](auto number, bool is_null) {
+    if (!is_null) {
+      consts->push_back(static_cast<T>(number));
+    }
+    return true;
+  };
+  switch (value.GetTypeId()) {
+    case TYPE_INT: {
+      auto number = TypedReader<TYPE_INT>::Read(storage.data());
+      return add(number, TypedReader<TYPE_INT>::IsNull(number));
+    }
+    case TYPE_LONG:
+      // an INT column compares a BIGINT constant as a BIGINT
+      if constexpr (!std::is_same_v<T, int32_t>) {
+        auto number = TypedReader<TYPE_LONG>::Read(storage.data());
+        return add(number, TypedReader<TYPE_LONG>::IsNull(number));
+      }
+      return false;
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      // an integer column compares a DOUBLE constant as a DOUBLE
+      if constexpr (std::is_same_v<T, double>) {
+        auto number = TypedReader<TYPE_DOUBLE>::Read(storage.data());
+        return add(number, TypedReader<TYPE_DOUBLE>::IsNull(number));
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+auto ReadString(const Value &value, std::vector<std::string> *consts) -> bool {
+  if (value.GetTypeId() != TYPE_CHAR && value.GetTypeId() != TYPE_VARCHAR) {
+    return false;
+  }
+  std::vector<char> storage = SerializeConstant(value);
+  std::string_view str = TypedReader<TYPE_VARCHAR>::Read(storage.data());
+  if (!TypedReader<TYPE_VARCHAR>::IsNull(str)) {
+    consts->emplace_back(str);
+  }
+  return true;
+}
+
+}  // namespace
+
+auto FilterKernel::Create(const Condition &cond, TypeId type) -> std::unique_ptr<FilterKernel> {
+  std::unique_ptr<FilterKernel> kernel(new FilterKernel(type, cond.op));
+  std::vector<Value> consts = cond.op == OP_IN ? cond.rhs_in_col : std::vector<Value>{cond.rhs_val};
+  for (const auto &value : consts) {
+    bool ok;
+    switch (type) {
+      case TYPE_INT:
+        ok = ReadNumber(value, &kernel->ints_);
+        break;
+      case TYPE_LONG:
+        ok = ReadNumber(value, &kernel->longs_);
+        break;
+      case TYPE_FLOAT:
+      case TYPE_DOUBLE:
+        ok = ReadNumber(value, &kernel->doubles_);
+        break;
+      case TYPE_CHAR:
+      case TYPE_VARCHAR:
+        ok = ReadString(value, &kernel->strings_);
+        break;
+      default:
+        ok = false;
+    }
+    if (!ok) {
+      return nullptr;
+    }
+  }
+  return kernel;
+}
+
+auto FilterKernel::GetSimdLevel() -> SimdLevel {
+  static const SimdLevel level = []() {
+#ifdef EASYDB_FILTER_X86
+    if (ENABLE_SIMD_FILTERS && __builtin_cpu_supports("avx2")) {
+      return SimdLevel::AVX2;
+    }
+    if (ENABLE_SIMD_FILTERS && __builtin_cpu_supports("sse4.2")) {
+      return SimdLevel::SSE42;
+    }
+#endif
+    return SimdLevel::SCALAR;
+  }();
+  return level;
+}
+
+void FilterKernel::Evaluate(const ColumnVector &column, uint32_t num_rows, uint64_t *bitmap, SimdLevel level) const {
+  std::fill(bitmap, bitmap + BitmapWords(num_rows), 0);
+  // a NULL constant, or an IN list of NULLs only, is satisfied by no value
+  if (ints_.empty() && longs_.empty() && doubles_.empty() && strings_.empty()) {
+    return;
+  }
+  switch (type_) {
+    case TYPE_INT:
+      return FilterNumbers(op_, column.GetData(), num_rows, ints_, EASYDB_INT32_NULL, level, bitmap);
+    case TYPE_LONG:
+      return FilterNumbers(op_, column.GetData(), num_rows, longs_, EASYDB_INT64_NULL, level, bitmap);
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      return FilterNumbers(op_, column.GetData(), num_rows, doubles_, EASYDB_DECIMAL_NULL, level, bitmap);
+    default:
+      return FilterStrings(op_, column, num_rows, strings_, bitmap);
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,208 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * join_hash_table.cpp
+ *
+ * Identification: src/execution/join_hash_table.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+
+#include "type/limits.h"
+
+namespace easydb {
+
+void JoinKeyEncoder::ForJoin(const std::vector<Condition> &conds, const std::string &left_tab_name,
+                             const Schema &left_schema, const std::string &right_tab_name, const Schema &right_schema,
+                             JoinKeyEncoder *left, JoinKeyEncoder *right) {
+  auto is_integer = [](TypeId type) { return type == TYPE_INT || type == TYPE_LONG; };
+  auto is_decimal = [](TypeId type) { return type == TYPE_FLOAT || type == TYPE_DOUBLE; };
+  auto is_string = [](TypeId type) { return type == TYPE_CHAR || type == TYPE_VARCHAR; };
+  for (const auto &cond : conds) {
+    if (cond.op != OP_EQ || cond.is_rhs_val) {
+      continue;
+    }
+    // Both sides are columns
+    const Column *left_col;
+    const Column *right_col;
+    if (cond.lhs_col.tab_name == left_tab_name || cond.rhs_col.tab_name == right_tab_name) {
+      left_col = &left_schema.GetColumn(cond.lhs_col.col_name);
+      right_col = &right_schema.GetColumn(cond.rhs_col.col_name);
+    } else if (cond.rhs_col.tab_name == left_tab_name || cond.lhs_col.tab_name == right_tab_name) {
+      left_col = &left_schema.GetColumn(cond.rhs_col.col_name);
+      right_col = &right_schema.GetColumn(cond.lhs_col.col_name);
+    } else {
+      continue;
+    }
+    TypeId left_type = left_col->GetType();
+    TypeId right_type = right_col->GetType();
+    KeyKind kind;
+    if (is_integer(left_type) && is_integer(right_type)) {
+      kind = KeyKind::INT64;
+    } else if ((is_integer(left_type) || is_decimal(left_type)) && (is_integer(right_type) || is_decimal(right_type))) {
+      kind = KeyKind::DOUBLE;
+    } else if (is_string(left_type) && is_string(right_type)) {
+      kind = KeyKind::STRING;
+    } else if (left_type == TYPE_DATE && right_type == TYPE_DATE) {
+      kind = KeyKind::DATE;
+    } else {
+      continue;
+    }
+    left->cols_.push_back({ColumnAccessor(*left_col), kind});
+    right->cols_.push_back({ColumnAccessor(*right_col), kind});
+  }
+}
+
+auto JoinKeyEncoder::Encode(const char *tuple, std::vector<char> *key) const -> bool {
+  key->clear();
+  for (const auto &col : cols_) {
+    const char *storage = col.accessor_.GetDataPtr(tuple);
+    TypeId type = col.accessor_.GetType();
+    switch (col.kind_) {
+      case KeyKind::INT64: {
+        int64_t val;
+        if (type == TYPE_INT) {
+          int32_t int_val;
+          std::memcpy(&int_val, storage, sizeof(int_val));
+          if (int_val == EASYDB_INT32_NULL) {
+            return false;
+          }
+          val = int_val;
+        } else {
+          std::memcpy(&val, storage, sizeof(val));
+          if (val == EASYDB_INT64_NULL) {
+            return false;
+          }
+        }
+        key->insert(key->end(), reinterpret_cast<const char *>(&val), reinterpret_cast<const char *>(&val + 1));
+        break;
+      }
+      case KeyKind::DOUBLE: {
+        double val;
+        if (type == TYPE_INT) {
+          int32_t int_val;
+          std::memcpy(&int_val, storage, sizeof(int_val));
+          if (int_val == EASYDB_INT32_NULL) {
+            return false;
+          }
+          val = int_val;
+        } else if (type == TYPE_LONG) {
+          int64_t long_val;
+          std::memcpy(&long_val, storage, sizeof(long_val));
+          if (long_val == EASYDB_INT64_NULL) {
+            return false;
+          }
+          val = static_cast<double>(long_val);
+        } else {
+          std::memcpy(&val, storage, sizeof(val));
+          if (val == EASYDB_DECIMAL_NULL) {
+            return false;
+          }
+        }
+        if (val == 0) {
+          val = 0;  // -0.0 has the bytes of no other zero
+        }
+        key->insert(key->end(), reinterpret_cast<const char *>(&val), reinterpret_cast<const char *>(&val + 1));
+        break;
+      }
+      case KeyKind::DATE: {
+        uint64_t val;
+        std::memcpy(&val, storage, sizeof(val));
+        if (val == EASYDB_TIMESTAMP_NULL) {
+          return false;
+        }
+        key->insert(key->end(), storage, storage + sizeof(val));
+        break;
+      }
+      case KeyKind::STRING: {
+        uint32_t len;
+        std::memcpy(&len, storage, sizeof(len));
+        if (len == EASYDB_VALUE_NULL) {
+          return false;
+        }
+        key->insert(key->end(), storage, storage + sizeof(len) + len);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+JoinHashTable::JoinHashTable() : slots_(INITIAL_SLOTS, EMPTY), mask_(INITIAL_SLOTS - 1) {}
+
+void JoinHashTable::Insert(const char *key, uint32_t key_size, hash_t hash, const char *tuple, uint32_t tuple_size) {
+  uint64_t fingerprint = static_cast<uint64_t>(hash) >> 32;
+  size_t pos = hash & mask_;
+  for (;; pos = (pos + 1) & mask_) {
+    uint64_t slot = slots_[pos];
+    if (slot == EMPTY) {
+      break;
+    }
+    if ((slot >> 32) != fingerprint) {
+      continue;
+    }
+    size_t head = (slot & ENTRY_MASK) - 1;
+    const Entry &entry = entries_[head];
+    if (entry.key_size_ == key_size && std::memcmp(entry.key_, key, key_size) == 0) {
+      // one more tuple of a known key, the new first entry of its chain, sharing the key of the others
+      entries_.push_back({entry.key_, arena_.Copy(tuple, tuple_size), hash, key_size, tuple_size,
+                          static_cast<uint32_t>(head + 1)});
+      slots_[pos] = MakeSlot(hash, entries_.size() - 1);
+      return;
+    }
+  }
+
+  entries_.push_back({arena_.Copy(key, key_size), arena_.Copy(tuple, tuple_size), hash, key_size, tuple_size, 0});
+  slots_[pos] = MakeSlot(hash, entries_.size() - 1);
+  if (++num_keys_ * 2 > slots_.size()) {
+    Grow();
+  }
+}
+
+auto JoinHashTable::Find(const char *key, uint32_t key_size, hash_t hash) const -> const Entry * {
+  uint64_t fingerprint = static_cast<uint64_t>(hash) >> 32;
+  for (size_t pos = hash & mask_;; pos = (pos + 1) & mask_) {
+    uint64_t slot = slots_[pos];
+    if (slot == EMPTY) {
+      return nullptr;
+    }
+    if ((slot >> 32) != fingerprint) {
+      continue;
+    }
+    const Entry &entry = entries_[(slot & ENTRY_MASK) - 1];
+    if (entry.key_size_ == key_size && std::memcmp(entry.key_, key, key_size) == 0) {
+      return &entry;
+    }
+  }
+}
+
+void JoinHashTable::Clear() {
+  slots_.assign(INITIAL_SLOTS, EMPTY);
+  mask_ = INITIAL_SLOTS - 1;
+  num_keys_ = 0;
+  entries_.clear();
+  arena_.Reset();
+}
+
+void JoinHashTable::Grow() {
+  std::vector<uint64_t> old_slots(slots_.size() * 2, EMPTY);
+  old_slots.swap(slots_);
+  mask_ = slots_.size() - 1;
+  for (uint64_t slot : old_slots) {
+    if (slot == EMPTY) {
+      continue;
+    }
+    size_t pos = entries_[(slot & ENTRY_MASK) - 1].hash_ & mask_;
+    while (slots_[pos] != EMPTY) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+}  // namespace easydb
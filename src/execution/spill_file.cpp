@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * spill_file.cpp
+ *
+ * Identification: src/execution/spill_file.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/spill_file.h"
+
+#include "common/errors.h"
+#include "common/stats.h"
+
+namespace easydb {
+
+SpillFile::SpillFile() : file_(std::tmpfile()) {
+  if (file_ == nullptr) {
+    throw UnixError();
+  }
+}
+
+SpillFile::~SpillFile() { std::fclose(file_); }
+
+void SpillFile::Append(const char *data, uint32_t size) {
+  if (std::fwrite(&size, sizeof(size), 1, file_) != 1 || std::fwrite(data, 1, size, file_) != size) {
+    throw UnixError();
+  }
+  num_rows_++;
+  num_bytes_ += sizeof(size) + size;
+  Stats::Add(StatCounter::SPILL_BYTES_WRITTEN, sizeof(size) + size);
+}
+
+void SpillFile::StartReading() {
+  if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0) {
+    throw UnixError();
+  }
+}
+
+auto SpillFile::Read(std::vector<char> *out) -> bool {
+  uint32_t size;
+  if (std::fread(&size, sizeof(size), 1, file_) != 1) {
+    if (std::ferror(file_)) {
+      throw UnixError();
+    }
+    return false;
+  }
+  out->resize(size);
+  if (std::fread(out->data(), 1, size, file_) != size) {
+    throw InternalError("SpillFile::Read: truncated row");
+  }
+  return true;
+}
+
+}  // namespace easydb
@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * worker_pool.cpp
+ *
+ * Identification: src/execution/worker_pool.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "execution/worker_pool.h"
+
+#include <utility>
+
+namespace easydb {
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  for (size_t i = 1; i < num_threads; i++) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this, i);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(const Task &task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    generation_++;
+    num_running_ = threads_.size();
+    error_ = nullptr;
+  }
+  start_cv_.notify_all();
+
+  try {
+    task(0);
+  } catch (...) {
+    SetError();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return num_running_ == 0; });
+  task_ = nullptr;
+  if (error_ != nullptr) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+void WorkerPool::WorkerLoop(size_t worker) {
+  uint64_t done_generation = 0;
+  while (true) {
+    const Task *task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&] { return stop_ || generation_ != done_generation; });
+      if (stop_) {
+        return;
+      }
+      done_generation = generation_;
+      task = task_;
+    }
+
+    try {
+      (*task)(worker);
+    } catch (...) {
+      SetError();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_running_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void WorkerPool::SetError() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_ == nullptr) {
+    error_ = std::current_exception();
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * buffer_access_strategy.h
+ *
+ * Identification: src/include/buffer/buffer_access_strategy.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace easydb {
+
+/** How a caller is going to use the pages it fetches / creates. PREFETCH marks background read-ahead. */
+enum class AccessType { NORMAL = 0, SEQ_SCAN, BULK_WRITE, PREFETCH };
+
+static constexpr int NUM_ACCESS_TYPES = 4;
+
+/**
+ * @brief A buffer ring for one large sequential operation (similar to PostgreSQL's BufferAccessStrategy).
+ *
+ * Pages that miss while a strategy is passed to `FetchPage` / `NewPage` are loaded into a small private set of frames
+ * that is recycled round robin, instead of taking victims from the shared replacement order. A full table scan or a
+ * bulk load therefore only ever occupies `ring_size` frames and the hot pages of other queries stay cached.
+ *
+ * A ring frame is only reused if it still holds the page the ring loaded into it and nobody has it pinned; otherwise
+ * the ring slot is refilled with a normal victim. A strategy is owned by one operator and must not be shared between
+ * threads.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * @param type the access pattern, NORMAL behaves exactly like passing no strategy
+   * @param ring_size the number of frames the ring may occupy in the whole pool, 0 takes frames from the shared
+   * replacement order and only tags the accesses with `type` for the hit/miss statistics
+   */
+  BufferAccessStrategy(AccessType type, size_t ring_size) : type_(type), ring_size_(ring_size) {}
+
+  auto GetType() const -> AccessType { return type_; }
+
+  auto GetRingSize() const -> size_t { return ring_size_; }
+
+ private:
+  struct RingSlot {
+    frame_id_t frame_id;
+    PageId page_id;  // the page this ring loaded into the frame
+  };
+
+  AccessType type_;
+  size_t ring_size_;
+  /** One ring per buffer pool partition, each holds at most ring_size / #partitions frames (at least one). */
+  std::vector<std::vector<RingSlot>> rings_;
+  std::vector<size_t> cursors_;
+};
+
+}  // namespace easydb
@@ -16,13 +16,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <list>
 #include <memory>
 #include <shared_mutex>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/frame_arena.h"
+#include "buffer/frame_lookup_table.h"
+#include "buffer/page_prefetcher.h"
+#include "buffer/page_writer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/errors.h"
 // #include "recovery/log_manager.h"
@@ -32,6 +42,113 @@
 namespace easydb {
 
 class BufferPoolManager;
+class LogManager;
+
+/**
+ * @brief One latch-sharded slice of the buffer pool.
+ *
+ * Every page id is owned by exactly one partition (chosen by `PageIdHash`), so the page table, the free list and the
+ * replacer of a partition only ever see its own frames. The partition latch protects these structures only; disk I/O
+ * for a miss or a dirty victim is done with the latch released, and `io_cv_` is used to wait for it.
+ *
+ * Hits on resident pages do not take the latch: `lookup_` indexes the frames whose page is loaded, and a frame is
+ * pinned by incrementing its pin count and then checking that it still holds the page (`frame_keys_`). A frame is
+ * only handed over to another page by moving its pin count from 0 to 1 with a compare-and-swap after its key has been
+ * withdrawn, so a pinned frame can not change pages, and a frame whose key is withdrawn is not pinned by the hit path.
+ * The replacer does not see these pins: a victim it picks may turn out to be pinned, it is then kept out of the
+ * replacer (`replacer_pinned_`) until its last unpin.
+ */
+struct BufferPoolPartition {
+  BufferPoolPartition(frame_id_t first_frame, size_t num_frames, const std::string &replacer_type);
+
+  /** @brief Translate a global frame id into the id used by this partition's replacer. */
+  inline auto ToLocal(frame_id_t frame_id) const -> frame_id_t { return frame_id - first_frame_; }
+
+  /** @brief Translate a replacer frame id back into a global frame id. */
+  inline auto ToGlobal(frame_id_t local_id) const -> frame_id_t { return local_id + first_frame_; }
+
+  /** @brief The latch protecting the partition's inner data structures. */
+  std::mutex latch_;
+
+  /** @brief Signalled whenever an I/O issued by this partition completes. */
+  std::condition_variable io_cv_;
+
+  /** @brief The first (global) frame id owned by this partition. */
+  const frame_id_t first_frame_;
+
+  /** @brief The number of frames owned by this partition. */
+  const size_t num_frames_;
+
+  /** @brief The page table that keeps track of the mapping between pages and buffer pool frames. */
+  std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_;
+
+  /** @brief A list of free frames (global ids) that do not hold any page's data. */
+  std::list<frame_id_t> free_frames_;
+
+  /** @brief The replacer (REPLACER_TYPE) to find unpinned / candidate pages for eviction, indexed by local frame id. */
+  std::unique_ptr<Replacer> replacer_;
+
+  /** @brief True while the frame (local id) is being filled from disk. */
+  std::vector<bool> io_pending_;
+
+  /** @brief Lock-free index of the frames (local ids) holding a loaded page, for the optimistic hit path. */
+  FrameLookupTable lookup_;
+
+  /** @brief FrameLookupTable::Key() of the page a frame (local id) holds, NO_PAGE while it is free or under I/O. */
+  std::unique_ptr<std::atomic<uint64_t>[]> frame_keys_;
+
+  /** @brief The replacer holds the frame (local id) as pinned, its last unpin has to hand it back to the replacer. */
+  std::unique_ptr<std::atomic<bool>[]> replacer_pinned_;
+
+  /** @brief The frame (local id) was hit without the latch since the replacer last saw it, see FindVictimPage(). */
+  std::unique_ptr<std::atomic<bool>[]> referenced_;
+
+  /** @brief Evicted dirty pages whose write-back has not finished yet; they must not be re-read until it has. */
+  std::unordered_set<PageId, PageIdHash> writing_back_;
+
+  /**
+   * @brief Pages whose copy is being written by the background writer. Their frames may be evicted meanwhile, so a
+   * miss must not re-read them and another write of them must not overtake the copy until it is done.
+   */
+  std::unordered_set<PageId, PageIdHash> background_writes_;
+
+  /**
+   * @brief Pages RemoveAllPages() dropped while they were pinned, with their frames (global ids). Such a frame is out
+   * of the page table and the replacer, its last unpin puts it on the free list.
+   */
+  std::unordered_multimap<PageId, frame_id_t, PageIdHash> removed_pages_;
+
+  /** @brief The number of outstanding I/Os issued without the latch held. */
+  size_t inflight_io_{0};
+
+  /** @brief Page table hits and misses, indexed by AccessType. */
+  size_t hits_[NUM_ACCESS_TYPES]{};
+  size_t misses_[NUM_ACCESS_TYPES]{};
+
+  /** @brief Hits served without the latch, indexed by AccessType. */
+  std::atomic<size_t> optimistic_hits_[NUM_ACCESS_TYPES]{};
+
+  /** @brief Evictions that had to write the victim back / found it clean, and pages written by the page writer. */
+  size_t sync_evictions_{0};
+  size_t clean_evictions_{0};
+  size_t background_writes_count_{0};
+};
+
+/** @brief Buffer hit / miss counts of one access type. */
+struct BufferPoolAccessStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t optimistic_hits{0};  // the part of `hits` served without the partition latch
+
+  auto HitRate() const -> double { return hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses); }
+};
+
+/** @brief How dirty pages got to disk. */
+struct BufferPoolWriteStats {
+  size_t sync_evictions{0};     // a miss wrote its dirty victim back itself
+  size_t clean_evictions{0};    // a miss found its victim clean
+  size_t background_writes{0};  // pages written ahead of eviction by the page writer
+};
 
 /**
  * @brief The declaration of the `BufferPoolManager` class.
@@ -45,7 +162,16 @@ class BufferPoolManager;
  */
 class BufferPoolManager {
  public:
-  BufferPoolManager(size_t num_frames, DiskManager *disk_manager);
+  /**
+   * @param num_frames the number of frames in the whole pool
+   * @param disk_manager the disk manager
+   * @param num_partitions the number of independently latched partitions the frames are split into; 1 keeps a single
+   * global latch and a single replacement order
+   * @param replacer_type the replacement policy of every partition, see REPLACER_TYPE
+   * @param use_huge_pages back the frame data with 2 MiB pages, see FrameArena
+   */
+  BufferPoolManager(size_t num_frames, DiskManager *disk_manager, size_t num_partitions = BUFFER_POOL_PARTITIONS,
+                    const std::string &replacer_type = REPLACER_TYPE, bool use_huge_pages = BUFFER_POOL_HUGE_PAGES);
   ~BufferPoolManager();
 
   /**
@@ -59,11 +185,76 @@ class BufferPoolManager {
    */
   auto Size() const -> size_t;
 
+  /**
+   * @brief Returns the number of latch partitions of the buffer pool.
+   */
+  auto NumPartitions() const -> size_t { return partitions_.size(); }
+
+  /**
+   * @brief Returns the page table hits and misses of FetchPage calls made with the given access type.
+   */
+  auto GetAccessStats(AccessType type) -> BufferPoolAccessStats;
+
+  /**
+   * @brief Read pages [first_page, first_page + num_pages) of a file into the pool in the background. Does nothing
+   * when read-ahead is disabled.
+   * @param strategy the buffer ring of the scan's read-ahead, nullptr for the shared replacement order
+   */
+  void PrefetchPages(int fd, page_id_t first_page, int num_pages,
+                     std::shared_ptr<BufferAccessStrategy> strategy = nullptr);
+
+  /**
+   * @brief Read up to `num_pages` pages of a chain (e.g. B+ tree leaves) into the pool in the background, the page
+   * after each page is computed from its data by `next_page`. Does nothing when read-ahead is disabled.
+   */
+  void PrefetchChain(PageId first_page, int num_pages, PagePrefetcher::NextPageFn next_page);
+
+  /**
+   * @brief Bring pages [first_page, first_page + num_pages) of a file into the pool, unpinned. The victims' dirty
+   * pages are written back with one batched write and the missing pages are read with one batched read, instead of a
+   * system call per page. Used by the read-ahead workers.
+   * @param strategy buffer ring to take the frames from, nullptr for the shared replacement order
+   * @return the number of pages read from disk
+   */
+  auto LoadPages(int fd, page_id_t first_page, int num_pages, BufferAccessStrategy *strategy = nullptr) -> int;
+
+  /**
+   * @brief Write up to `max_pages` dirty, unpinned pages back to disk in one batched write, leaving them clean in the
+   * pool. Pages whose LSN is beyond the persisted log are skipped (write-ahead logging), as are pages that are pinned
+   * or being loaded. Called by the background page writer.
+   * @param copies at least `max_pages` frames to copy the pages into, kept by the caller from one round to the next;
+   * nullptr to map them only if there is a page to write
+   * @return the number of pages written
+   */
+  auto WriteBackDirtyPages(size_t max_pages, FrameArena *copies = nullptr) -> size_t;
+
+  /** @brief Returns the eviction and background write counters. */
+  auto GetWriteStats() -> BufferPoolWriteStats;
+
+  /** @brief The log whose persisted LSN bounds the pages the background writer may write, nullptr for no bound. */
+  void SetLogManager(LogManager *log_manager) { log_manager_ = log_manager; }
+
+  /** @brief Turn the background page writer on or off, it is on by default. */
+  void SetPageWriterEnabled(bool enabled) { page_writer_enabled_ = enabled; }
+
+  auto IsPageWriterEnabled() const -> bool { return page_writer_enabled_; }
+
+  /** @brief Turn background read-ahead on or off, it is on by default. */
+  void SetPrefetchEnabled(bool enabled) { prefetch_enabled_ = enabled; }
+
+  auto IsPrefetchEnabled() const -> bool { return prefetch_enabled_ && prefetcher_ != nullptr; }
+
+  /** @brief Turn the lock-free hit path of FetchPage on or off, it is on by default. */
+  void SetOptimisticHitsEnabled(bool enabled) { optimistic_hits_enabled_ = enabled; }
+
+  auto IsOptimisticHitsEnabled() const -> bool { return optimistic_hits_enabled_; }
+
   /**
    * @brief Allocates a new page on disk.
+   * @param strategy buffer ring to take the frame from, nullptr for the shared replacement order
    * @return The page ID of the newly allocated page.
    */
-  auto NewPage(PageId *page_id) -> Page *;
+  auto NewPage(PageId *page_id, BufferAccessStrategy *strategy = nullptr) -> Page *;
 
   /**
    * @description: fetch a page;
@@ -72,15 +263,17 @@ class BufferPoolManager {
    * pin_count to 1;
    * @return {Page*} the target page or nullptr.
    * @param {PageId} page_id : PageId of the target page.
-   * @note: pin the page, need to unpin the page outside
+   * @param {BufferAccessStrategy*} strategy : buffer ring used on a miss, nullptr for the shared replacement order
+   * @note: pin the page, need to unpin the page outside; a hit on a loaded page takes no latch
    */
-  auto FetchPage(PageId page_id) -> Page *;
+  auto FetchPage(PageId page_id, BufferAccessStrategy *strategy = nullptr) -> Page *;
 
   /**
    * @description: unpin a frame in buffer pool.
    * @return {bool} return false if the target frame.pin_count_ <= 0, else return true.
    * @param {PageId} page_id: page_id of the target page.
    * @param {bool} is_dirty: mark if the target frame need to be marked dirty
+   * @note takes no latch unless the page is not indexed or this is the last unpin of a frame held by the replacer
    */
   auto UnpinPage(PageId page_id, bool is_dirty) -> bool;
 
@@ -105,13 +298,15 @@ class BufferPoolManager {
   /**
    * @brief Flushes all page data in a table (distinguished by fd) that is in memory to disk.
    * @param {int} fd file descriptor
+   * @note The pages are written with one batched write, see DiskManager::WritePageBatch().
    */
   void FlushAllPages(int fd);
 
   /**
    * @description: This function flushes all dirty pages in the buffer pool to disk.
    * @return {void}
-   * @note This function uses a scoped lock to ensure thread safety during the operation.
+   * @note The pages are pinned under the partition latches and written with one batched write after the latches are
+   *       released, see DiskManager::WritePageBatch().
    */
   void FlushAllDirtyPages();
 
@@ -136,13 +331,115 @@ class BufferPoolManager {
   auto RecoverPage(PageId page_id) -> Page *;
 
  private:
+  /** @brief Returns the partition that owns `page_id`. */
+  auto GetPartition(const PageId &page_id) -> BufferPoolPartition & {
+    return *partitions_[GetPartitionIndex(page_id)];
+  }
+
+  auto GetPartitionIndex(const PageId &page_id) const -> size_t { return PageIdHash{}(page_id) % partitions_.size(); }
+
   /**
-   * @brief Find a victim frame from the free_frame_list or the replacer.
+   * @brief Find a victim frame from the free_frame_list or the replacer of a partition, claimed (pinned once).
    * @return {bool} true: find a victim frame , false: fail to find a victim frame
-   * @param {frame_id_t*} return the frame_id of the found victim frame
+   * @param {BufferPoolPartition&} partition: the partition to take the frame from, its latch must be held
+   * @param {frame_id_t*} return the (global) frame_id of the found victim frame
    *
    */
-  auto FindVictimPage(frame_id_t *frame_id) -> bool;
+  auto FindVictimPage(BufferPoolPartition &partition, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Find a frame for `new_page_id` in the buffer ring of `strategy`, or in the shared free list / replacer if
+   * there is no strategy. A ring that is not full yet grows by one shared victim.
+   * @param {BufferAccessStrategy*} strategy: the buffer ring, may be nullptr
+   * @param {PageId} new_page_id: the page that is going to be loaded into the frame
+   * @param {frame_id_t*} return the (global) frame_id of the found victim frame
+   */
+  auto FindVictimPage(BufferPoolPartition &partition, BufferAccessStrategy *strategy, PageId new_page_id,
+                      frame_id_t *frame_id) -> bool;
+
+  /** @brief Returns the local id of the frame of `partition` whose published key is `key`, INVALID_FRAME_ID if none. */
+  auto FindPublished(BufferPoolPartition &partition, uint64_t key) -> frame_id_t;
+
+  /** @brief The lock-free hit path of FetchPage(), nullptr if the page has to be fetched with the latch held. */
+  auto FetchPageOptimistic(BufferPoolPartition &partition, PageId page_id, int access_type) -> Page *;
+
+  /**
+   * @brief Drop one pin of a frame (local id), see UnpinPage().
+   * @param lock the partition latch if it is held, nullptr otherwise
+   * @return false if the frame was not pinned
+   */
+  auto DropPin(BufferPoolPartition &partition, frame_id_t local_id, bool is_dirty, std::unique_lock<std::mutex> *lock)
+      -> bool;
+
+  /**
+   * @brief Make a frame (local id) evictable again if it is unpinned and the replacer still holds it as pinned, or
+   * free it if its page has been removed meanwhile. The partition latch must be held.
+   */
+  void ReturnToReplacer(BufferPoolPartition &partition, frame_id_t local_id);
+
+  /** @brief The entry of removed_pages_ of a frame (local id), end() if its page has not been removed. */
+  auto FindRemovedPage(BufferPoolPartition &partition, frame_id_t local_id)
+      -> std::unordered_multimap<PageId, frame_id_t, PageIdHash>::iterator;
+
+  /** @brief Pin a frame (local id) with the partition latch held, the replacer sees the access. */
+  void PinFrame(BufferPoolPartition &partition, frame_id_t local_id);
+
+  /** @brief Drop a pin taken with PinFrame(). The partition latch must be held. */
+  void UnpinFrame(BufferPoolPartition &partition, frame_id_t local_id);
+
+  /**
+   * @brief Take an unpinned frame (local id) for another page: withdraw its key and move its pin count from 0 to 1.
+   * The partition latch must be held.
+   * @return false if the frame is pinned (by the optimistic hit path), its key is then restored
+   */
+  auto TryClaimFrame(BufferPoolPartition &partition, frame_id_t local_id) -> bool;
+
+  /** @brief Make a frame (local id) holding a loaded page visible to the optimistic hit path. */
+  void PublishFrame(BufferPoolPartition &partition, frame_id_t local_id);
+
+  /** @brief Hide a frame (local id) from the optimistic hit path. */
+  void UnpublishFrame(BufferPoolPartition &partition, frame_id_t local_id);
+
+  /** @brief A frame handed over to a new page whose I/O has not been done yet, see BeginLoad(). */
+  struct PendingLoad {
+    BufferPoolPartition *partition;
+    frame_id_t frame_id;
+    PageId old_page_id;
+    bool write_back;  // the old page is dirty
+  };
+
+  /**
+   * @brief First half of LoadFrame(): switch the page table and the frame metadata over to `new_page_id` and mark the
+   * frame as under I/O. The partition latch must be held.
+   */
+  auto BeginLoad(BufferPoolPartition &partition, frame_id_t frame_id, PageId new_page_id) -> PendingLoad;
+
+  /** @brief Second half of LoadFrame(): the I/O is done, wake up the waiters. The partition latch must be held. */
+  void FinishLoad(const PendingLoad &load);
+
+  /**
+   * @brief Wait until the background write of `page_id` (if any) is done, so that a newer version of the page can be
+   * written without being overwritten by the older copy.
+   */
+  void WaitForBackgroundWrite(BufferPoolPartition &partition, std::unique_lock<std::mutex> &lock, PageId page_id);
+
+  /**
+   * @brief Pin the pages selected by `filter` in every partition and clear their dirty flags, write them with one
+   * batched write with no latch held, then unpin them.
+   */
+  void FlushPages(const std::function<bool(const PageId &, const Page &)> &filter);
+
+  /**
+   * @brief Hand a victim frame over to `new_page_id`, pinned once.
+   * The page table and frame metadata are updated with the partition latch held; the old content (if dirty) is
+   * written back and the new content is read from disk (if `read_page`) after the latch is released.
+   * @param {std::unique_lock<std::mutex>&} lock: the held partition latch, it is held again on return
+   * @param {frame_id_t} frame_id : victim frame
+   * @param {PageId} new_page_id : page to be loaded into the frame
+   * @param {bool} read_page : read the page from disk, otherwise the frame is zeroed
+   */
+  void LoadFrame(BufferPoolPartition &partition, std::unique_lock<std::mutex> &lock, frame_id_t frame_id,
+                 PageId new_page_id, bool read_page);
 
   /**
    * @brief Update the page data, page meta data (data, is_dirty_, page_id) and page table.
@@ -150,38 +447,40 @@ class BufferPoolManager {
    * @param {Page*} frame : frame to be updated
    * @param {PageId} new_page_id : new page_id
    * @param {frame_id_t} new_frame_id : new frame_id
-   * @note after update : PageId is new_page_id; pin_count is 0; is_dirty is false; data reset to 0
-   *
+   * @note after update : PageId is new_page_id; pin_count is left as is; is_dirty is false; data reset to 0
+   *       the write back is done with the partition latch held, only used by recovery.
    */
-  void UpdatePage(Page *frame, PageId new_page_id, frame_id_t new_frame_id);
+  void UpdatePage(BufferPoolPartition &partition, Page *frame, PageId new_page_id, frame_id_t new_frame_id);
 
   /** @brief The number of frames in the buffer pool. */
   const size_t num_frames_;
 
-  /** @brief The Next page ID to be allocated.  */
-  // std::atomic<PageId> next_page_id_;
+  /** @brief The data of all frames, one PAGE_SIZE aligned block. */
+  FrameArena arena_;
 
-  /**
-   * @brief The latch protecting the buffer pool's inner data structures.
-   */
-  std::mutex latch_;
-  // std::shared_ptr<std::mutex> bpm_latch_;
-
-  /** @brief The frame headers of the frames that this buffer pool manages. */
-  // std::vector<Page> frames_;
+  /** @brief The frame headers of the frames that this buffer pool manages, their data lives in `arena_`. */
   Page *frames_;
-  // std::vector<std::shared_ptr<FrameHeader>> frames_;
 
-  /** @brief The page table that keeps track of the mapping between pages and buffer pool frames. */
-  std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_;
+  /** @brief The latch partitions, each owning a contiguous range of `frames_`. */
+  std::vector<std::unique_ptr<BufferPoolPartition>> partitions_;
 
-  /** @brief A list of free frames that do not hold any page's data. */
-  std::list<frame_id_t> free_frames_;
+  DiskManager *disk_manager_;
 
-  /** @brief The replacer to find unpinned / candidate pages for eviction. */
-  std::shared_ptr<LRUReplacer> replacer_;
+  /** @brief Background read-ahead workers, nullptr if PREFETCH_THREADS is 0. */
+  std::unique_ptr<PagePrefetcher> prefetcher_;
 
-  // std::shared_ptr<DiskManager> disk_manager_;
-  DiskManager *disk_manager_;
+  std::atomic<bool> prefetch_enabled_{true};
+
+  std::atomic<bool> optimistic_hits_enabled_{true};
+
+  LogManager *log_manager_{nullptr};
+
+  /** @brief The partition the next background write round starts with. */
+  std::atomic<size_t> writer_cursor_{0};
+
+  /** @brief Background writer, nullptr if PAGE_WRITER_MAX_PAGES is 0. */
+  std::unique_ptr<PageWriter> page_writer_;
+
+  std::atomic<bool> page_writer_enabled_{true};
 };
 }  // namespace easydb
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * clock_replacer.h
+ *
+ * Identification: src/include/buffer/clock_replacer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace easydb {
+
+/**
+ * ClockReplacer implements a lock-free generalized CLOCK (clock sweep) replacement policy.
+ *
+ * Each frame has one atomic state byte: an evictable bit and a small saturating usage count. Every access (Pin) bumps
+ * the usage count, the sweeping hand decrements it and takes the first evictable frame whose count is already zero.
+ * A page that is touched once by a scan gets a count of 1 and goes on the next sweep, while a page that is accessed
+ * repeatedly survives up to `MAX_USAGE_COUNT` sweeps.
+ *
+ * All state changes are single compare-and-swap operations on the frame's byte, so Pin and Unpin never block and the
+ * hand can be advanced by several threads at once. The state array is allocated once in the constructor.
+ */
+class ClockReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ClockReplacer.
+   * @param num_frames the maximum number of frames the ClockReplacer will be required to store
+   */
+  explicit ClockReplacer(size_t num_frames);
+
+  ~ClockReplacer() override = default;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  /** The usage count saturates here, it bounds how many sweeps a hot frame survives. */
+  static constexpr uint8_t MAX_USAGE_COUNT = 5;
+
+ private:
+  static constexpr uint8_t EVICTABLE = 0x80;
+  static constexpr uint8_t USAGE_MASK = 0x7f;
+
+  const size_t num_frames_;
+  std::unique_ptr<std::atomic<uint8_t>[]> state_;
+  std::atomic<size_t> hand_{0};
+  std::atomic<size_t> curr_size_{0};
+};
+
+}  // namespace easydb
@@ -0,0 +1,55 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * frame_arena.h
+ *
+ * Identification: src/include/buffer/frame_arena.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace easydb {
+
+/**
+ * @brief The memory holding the data of all buffer pool frames.
+ *
+ * One anonymous mapping of `num_frames * PAGE_SIZE` bytes, so every frame is PAGE_SIZE aligned (as O_DIRECT requires)
+ * and neighbouring frames are neighbours in memory. With `use_huge_pages` the mapping is backed by 2 MiB pages:
+ * explicit huge pages (MAP_HUGETLB) if the system has them reserved, transparent huge pages otherwise.
+ */
+class FrameArena {
+ public:
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  FrameArena(size_t num_frames, bool use_huge_pages);
+
+  ~FrameArena();
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  /** @return the PAGE_SIZE bytes of a frame */
+  inline auto GetFrameData(frame_id_t frame_id) const -> char * {
+    return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE;
+  }
+
+  /** @return the number of bytes mapped */
+  auto GetMappedSize() const -> size_t { return mapped_size_; }
+
+  /** @return true if the arena is backed by explicit (MAP_HUGETLB) huge pages */
+  auto IsHugeTlb() const -> bool { return huge_tlb_; }
+
+ private:
+  char *data_{nullptr};
+  size_t mapped_size_{0};
+  bool huge_tlb_{false};
+};
+
+}  // namespace easydb
@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * frame_lookup_table.h
+ *
+ * Identification: src/include/buffer/frame_lookup_table.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace easydb {
+
+/**
+ * @brief A lock-free index from pages to the frames of one buffer pool partition, used by the optimistic hit path.
+ *
+ * Open addressing over a power of two array of 64-bit slots, each slot packs a 32-bit fingerprint of the page key and
+ * the frame id, so a slot is read and written with a single atomic access. The table is a hint only: a reader checks
+ * every candidate frame against the page the frame currently holds (its published key), and entries that do not fit
+ * into the MAX_PROBES slots of their home bucket are simply not indexed, such pages are found through the locked page
+ * table instead. Inserts and erases are done with the partition latch held, lookups take no lock at all.
+ */
+class FrameLookupTable {
+ public:
+  /** @brief The key of no page: fd -1, page -1. Free frames and frames under I/O publish it. */
+  static constexpr uint64_t NO_PAGE = ~static_cast<uint64_t>(0);
+
+  /** @brief The number of slots searched from the home bucket of a key. */
+  static constexpr size_t MAX_PROBES = 8;
+
+  /** @param num_frames the number of frames of the partition, the table gets at least twice as many slots */
+  explicit FrameLookupTable(size_t num_frames);
+
+  /** @return the packed key of a page */
+  static inline auto Key(const PageId &page_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id.fd)) << 32) |
+           static_cast<uint32_t>(page_id.page_no);
+  }
+
+  /**
+   * @brief Find the frame holding `key`.
+   * @param validate called for every candidate frame with a matching fingerprint, returns true if the frame holds key
+   * @return the frame id, INVALID_FRAME_ID if no indexed frame holds the page
+   */
+  template <typename Validate>
+  auto Find(uint64_t key, Validate &&validate) const -> frame_id_t {
+    uint64_t hash = Hash(key);
+    uint64_t fingerprint = hash >> 32;
+    for (size_t i = 0; i < MAX_PROBES; i++) {
+      uint64_t slot = slots_[(hash + i) & mask_].load(std::memory_order_acquire);
+      if (slot != EMPTY && (slot >> 32) == fingerprint) {
+        auto frame_id = static_cast<frame_id_t>((slot & FRAME_MASK) - 1);
+        if (validate(frame_id)) {
+          return frame_id;
+        }
+      }
+    }
+    return INVALID_FRAME_ID;
+  }
+
+  /**
+   * @brief Index `frame_id` as the frame holding `key`. The partition latch must be held.
+   * @return false if every slot near the home bucket is taken, the page is then not indexed
+   */
+  auto Insert(uint64_t key, frame_id_t frame_id) -> bool;
+
+  /** @brief Remove the entry of `frame_id` holding `key`, if there is one. The partition latch must be held. */
+  void Erase(uint64_t key, frame_id_t frame_id);
+
+ private:
+  static constexpr uint64_t EMPTY = 0;
+  static constexpr uint64_t FRAME_MASK = 0xffffffff;
+
+  /** @brief 64-bit finalizer of MurmurHash3, the low bits pick the bucket and the high bits are the fingerprint. */
+  static inline auto Hash(uint64_t key) -> uint64_t {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+  }
+
+  /** @brief The slot value of a frame: the fingerprint and frame id + 1, so that no entry is EMPTY. */
+  static inline auto MakeSlot(uint64_t hash, frame_id_t frame_id) -> uint64_t {
+    return ((hash >> 32) << 32) | (static_cast<uint64_t>(frame_id) + 1);
+  }
+
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t mask_;
+};
+
+}  // namespace easydb
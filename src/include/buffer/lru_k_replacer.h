@@ -0,0 +1,86 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * lru_k_replacer.h
+ *
+ * Identification: src/include/buffer/lru_k_replacer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+/*
+ * Original copyright:
+ * Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+ */
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace easydb {
+
+/**
+ * LRUKReplacer implements the LRU-k replacement policy.
+ *
+ * The victim is the evictable frame whose k-th most recent access is the oldest (largest backward k-distance). Frames
+ * with fewer than k accesses have an infinite distance and are evicted first, oldest access first. A page touched once
+ * by a sequential scan therefore never pushes out a page that has been used k times.
+ *
+ * Every frame keeps its last k access timestamps in a ring inside one array allocated by the constructor. The evictable
+ * frames are kept ordered by their eviction priority, which cannot change while a frame is evictable since only an
+ * access (a pin) moves it, so Victim(), Pin() and Unpin() are O(log n) rather than a scan of every frame.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_frames the maximum number of frames the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per frame
+   */
+  LRUKReplacer(size_t num_frames, size_t k);
+
+  ~LRUKReplacer() override = default;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  /** Pinning a frame is what the buffer pool does on every access, so it is recorded as an access. */
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+ private:
+  /** (has k accesses, oldest remembered access, frame): the smallest is the victim */
+  using EvictionKey = std::tuple<bool, size_t, frame_id_t>;
+
+  /** @return the oldest remembered access of a frame, the k-th most recent one once the frame has k accesses */
+  auto OldestAccess(frame_id_t frame_id) const -> size_t;
+
+  /** @return where a frame goes in evictable_frames_, infinite k-distances first, then by oldest access */
+  auto KeyOf(frame_id_t frame_id) const -> EvictionKey;
+
+  /** @brief Take a frame out of evictable_frames_ if it is there. */
+  void MakeUnevictable(frame_id_t frame_id);
+
+  const size_t num_frames_;
+  const size_t k_;
+  size_t current_timestamp_{0};
+  /** The last k access timestamps of frame i are history_[i * k_, (i + 1) * k_), written round robin. */
+  std::vector<size_t> history_;
+  std::vector<size_t> access_count_;
+  std::vector<bool> evictable_;
+  std::set<EvictionKey> evictable_frames_;
+  std::mutex latch_;
+};
+
+}  // namespace easydb
@@ -30,14 +30,10 @@
 namespace easydb {
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * The LRU list is intrusive: it is threaded through `prev_` / `next_` arrays indexed by frame id that are allocated
+ * once in the constructor, so pinning and unpinning never touch the heap.
  */
-class LinkListNode {
- public:
-  frame_id_t val_{0};
-  LinkListNode *prev_{nullptr};
-  LinkListNode *next_{nullptr};
-  explicit LinkListNode(frame_id_t Val) : val_(Val) {}
-};
 class LRUReplacer : public Replacer {
  public:
   /**
@@ -49,7 +45,7 @@ class LRUReplacer : public Replacer {
   /**
    * Destroys the LRUReplacer.
    */
-  ~LRUReplacer() override;
+  ~LRUReplacer() override = default;
 
   bool Victim(frame_id_t *frame_id) override;
 
@@ -59,13 +55,16 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
-  void DeleteNode(LinkListNode *curr);
-
  private:
-  // TODO(student): implement me!
-  std::unordered_map<frame_id_t, LinkListNode *> data_idx_;
-  LinkListNode *head_{nullptr};
-  LinkListNode *tail_{nullptr};
+  /** @brief Unlink a frame from the LRU list, the frame must be in the list. */
+  void DeleteNode(frame_id_t frame_id);
+
+  std::vector<frame_id_t> prev_;
+  std::vector<frame_id_t> next_;
+  std::vector<bool> in_list_;
+  frame_id_t head_{INVALID_FRAME_ID};  // least recently unpinned
+  frame_id_t tail_{INVALID_FRAME_ID};  // most recently unpinned
+  size_t size_{0};
   std::mutex data_latch_;
 };
 
@@ -0,0 +1,101 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * page_prefetcher.h
+ *
+ * Identification: src/include/buffer/page_prefetcher.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace easydb {
+
+class BufferPoolManager;
+
+/**
+ * @brief Background read-ahead for the buffer pool.
+ *
+ * Scans hand the pages they are going to need next to a small pool of worker threads, which fetch and immediately
+ * unpin them, so that the disk reads overlap with the processing of the current page. Requests are hints: a request
+ * that does not fit into a worker's queue is dropped.
+ *
+ * All requests that use the same buffer ring are served by the same worker, one after another, because a
+ * BufferAccessStrategy must not be used by two threads at once.
+ */
+class PagePrefetcher {
+ public:
+  /** Computes the page that follows a page in a chain (e.g. the next leaf) from its data, INVALID_PAGE_ID stops. */
+  using NextPageFn = std::function<page_id_t(const char *page_data)>;
+
+  PagePrefetcher(BufferPoolManager *bpm, size_t num_threads);
+
+  ~PagePrefetcher();
+
+  /**
+   * @brief Read pages [first_page, first_page + num_pages) of a file in the background.
+   * @param strategy the buffer ring to load the pages into, nullptr for the shared replacement order
+   */
+  void Prefetch(int fd, page_id_t first_page, int num_pages, std::shared_ptr<BufferAccessStrategy> strategy);
+
+  /**
+   * @brief Read up to `num_pages` pages of a chain in the background, starting at `first_page`.
+   */
+  void PrefetchChain(PageId first_page, int num_pages, NextPageFn next_page,
+                     std::shared_ptr<BufferAccessStrategy> strategy);
+
+  /**
+   * @brief Drop the queued requests of a file and wait for the running ones to finish. Must be called before the file
+   * is closed, otherwise a late read-ahead could cache pages of a file descriptor that is being reused.
+   */
+  void Cancel(int fd);
+
+  /** Queued requests beyond this per-worker limit are dropped. */
+  static constexpr size_t MAX_QUEUED_REQUESTS = 64;
+
+ private:
+  struct Request {
+    PageId first_page;
+    int num_pages;
+    NextPageFn next_page;  // nullptr for consecutive pages
+    std::shared_ptr<BufferAccessStrategy> strategy;
+  };
+
+  struct Worker {
+    std::thread thread;
+    std::mutex latch;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    int running_fd{-1};  // the file of the request being served, -1 when idle
+    // prefetches without a ring of their own are still accounted as PREFETCH accesses
+    BufferAccessStrategy shared_strategy{AccessType::PREFETCH, 0};
+  };
+
+  void Submit(Request request);
+
+  void WorkerLoop(Worker *worker);
+
+  void Serve(Worker *worker, const Request &request);
+
+  BufferPoolManager *bpm_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_{0};
+  std::atomic<bool> stop_{false};
+};
+
+}  // namespace easydb
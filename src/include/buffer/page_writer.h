@@ -0,0 +1,62 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * page_writer.h
+ *
+ * Identification: src/include/buffer/page_writer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "buffer/frame_arena.h"
+#include "common/config.h"
+
+namespace easydb {
+
+class BufferPoolManager;
+
+/**
+ * @brief Background writer of the buffer pool.
+ *
+ * A single thread that periodically writes dirty, unpinned pages back to disk (see
+ * BufferPoolManager::WriteBackDirtyPages()), so that a miss usually finds a clean victim and does not have to write it
+ * back itself. The thread is also woken up early whenever a foreground eviction had to write a dirty page.
+ */
+class PageWriter {
+ public:
+  /**
+   * @param interval time between two rounds when nothing wakes the writer up
+   * @param max_pages pages written per round at most
+   */
+  PageWriter(BufferPoolManager *bpm, std::chrono::milliseconds interval, size_t max_pages);
+
+  ~PageWriter();
+
+  /** @brief Start a round now. */
+  void Wake();
+
+ private:
+  void Run();
+
+  BufferPoolManager *bpm_;
+  const std::chrono::milliseconds interval_;
+  const size_t max_pages_;
+  FrameArena copies_;  // the copies of the pages of a round, mapped once
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool woken_{false};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace easydb
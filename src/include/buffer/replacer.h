@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "common/config.h"
 
 namespace easydb {
@@ -47,8 +50,23 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame whose page has left the buffer pool without being victimized (deleted page, dropped file).
+   * The frame is no longer evictable and its access history, if any, is discarded.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual auto Size() -> size_t = 0;
 };
 
+/**
+ * Create the replacer named by `type` ("LRU", "LRU-K" or "CLOCK", see REPLACER_TYPE in common/config.h).
+ * An unknown name falls back to LRU.
+ * @param type the replacement policy
+ * @param num_frames the number of frames the replacer tracks, frame ids are in [0, num_frames)
+ */
+auto MakeReplacer(const std::string &type, size_t num_frames) -> std::unique_ptr<Replacer>;
+
 }  // namespace easydb
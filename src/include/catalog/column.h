@@ -127,7 +127,7 @@ class Column {
   /** @return column length */
   auto GetStorageSize() const -> uint32_t { return length_; }
 
-  void SetStorageSize(uint32_t length) { length = length_; }
+  void SetStorageSize(uint32_t length) { length_ = length; }
 
   /** @return column's offset in the tuple */
   auto GetOffset() const -> uint32_t { return column_offset_; }
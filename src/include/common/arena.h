@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * arena.h
+ *
+ * Identification: src/include/common/arena.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+
+namespace easydb {
+
+/**
+ * @brief A bump allocator for memory that lives as long as a query.
+ *
+ * Memory is carved out of blocks of block_size bytes, in the order it is asked for, and is never freed one
+ * allocation at a time: Reset() releases all of it at once. An allocation larger than a quarter of a block gets a
+ * block of its own, so that it does not waste the rest of the current one. Not thread-safe.
+ */
+class Arena {
+ public:
+  explicit Arena(size_t block_size = QUERY_ARENA_BLOCK_SIZE) : block_size_(block_size) {}
+
+  Arena(const Arena &) = delete;
+  auto operator=(const Arena &) -> Arena & = delete;
+
+  /**
+   * @brief Allocate `size` bytes aligned to `align`, which has to be a power of two no larger than
+   * alignof(std::max_align_t). The memory is uninitialized and valid until the next Reset().
+   */
+  inline auto Allocate(size_t size, size_t align = alignof(uint64_t)) -> char * {
+    size_t pos = (pos_ + align - 1) & ~(align - 1);
+    if (pos + size <= end_) {
+      pos_ = pos + size;
+      bytes_allocated_ += size;
+      return cur_ + pos;
+    }
+    return AllocateSlow(size);
+  }
+
+  /** @brief Copy `size` bytes of `data` into the arena. */
+  inline auto Copy(const char *data, size_t size) -> char * {
+    char *copy = Allocate(size, 1);
+    std::memcpy(copy, data, size);
+    return copy;
+  }
+
+  /** @brief Release everything allocated so far, keeping one block for the next query. */
+  void Reset();
+
+  /** @return the bytes handed out since the last Reset() */
+  inline auto GetBytesAllocated() const -> size_t { return bytes_allocated_; }
+
+  /** @return the blocks the arena holds, i.e. the allocations it made from the system */
+  inline auto GetNumBlocks() const -> size_t { return blocks_.size(); }
+
+ private:
+  auto AllocateSlow(size_t size) -> char *;
+
+  struct Block {
+    std::unique_ptr<char[]> data_;
+    size_t size_;
+  };
+
+  size_t block_size_;
+  std::vector<Block> blocks_;
+  char *cur_{nullptr};  // the block allocations are bumped in
+  size_t pos_{0};       // the first free byte of cur_
+  size_t end_{0};       // the size of cur_
+  size_t bytes_allocated_{0};
+};
+
+}  // namespace easydb
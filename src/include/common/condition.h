@@ -48,6 +48,26 @@ struct Condition {
         throw InternalError("unsupported operator.");
     }
   }
+
+  // false only if no lhs value in [min_v, max_v] can satisfy the condition with rhs_v, e.g. to skip a page by its zone
+  bool may_satisfy_range(const Value &min_v, const Value &max_v, const Value &rhs_v) {
+    switch (op) {
+      case OP_EQ:
+        return min_v <= rhs_v && max_v >= rhs_v;
+      case OP_NE:
+        return !(min_v == rhs_v && max_v == rhs_v);
+      case OP_LT:
+        return min_v < rhs_v;
+      case OP_GT:
+        return max_v > rhs_v;
+      case OP_LE:
+        return min_v <= rhs_v;
+      case OP_GE:
+        return max_v >= rhs_v;
+      default:
+        return true;
+    }
+  }
 };
 
 };  // namespace easydb
\ No newline at end of file
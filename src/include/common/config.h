@@ -37,11 +37,47 @@ static constexpr int INVALID_TXN_ID = -1;    // invalid transaction id
 static constexpr int INVALID_LSN = -1;       // invalid log sequence number
 
 static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
-static constexpr int BUFFER_POOL_SIZE = 1024;                                 // size of buffer pool
+static constexpr int BUFFER_POOL_SIZE = 1024;                                 // default frames of buffer pool
+static constexpr bool BUFFER_POOL_HUGE_PAGES = false;  // back the buffer pool frames with 2 MiB pages by default
+static constexpr int BUFFER_POOL_PARTITIONS = 1;                              // default number of buffer pool latches
+static constexpr int SEQ_SCAN_RING_SIZE = 32;     // frames recycled by a scan of a table larger than 1/4 of the pool
+static constexpr int BULK_WRITE_RING_SIZE = 128;  // frames recycled by a bulk load
+static constexpr int PREFETCH_THREADS = 2;        // read-ahead worker threads of the buffer pool
+static constexpr int PREFETCH_DEPTH = 8;          // pages a scan keeps requested ahead of its position
+static constexpr int PAGE_WRITER_MAX_PAGES = 64;  // dirty pages written per background writer round, 0 disables it
+static constexpr int PAGE_WRITER_INTERVAL_MS = 100;  // time between two background writer rounds
+static constexpr bool ENABLE_AUTOVACUUM = false;       // run the background vacuum by default
+static constexpr int AUTOVACUUM_INTERVAL_MS = 1000;    // time between two background vacuum rounds
+static constexpr int AUTOVACUUM_MIN_DEAD_TUPLES = 1000;  // tuples deleted since the last vacuum that trigger one
+// keep per-page min/max of numeric and date columns for scans to skip pages
+static constexpr bool ENABLE_ZONE_MAP = true;
+static constexpr bool ENABLE_TOAST_COMPRESSION = true;  // compress the long VARCHAR values moved out of their records
+static constexpr bool ENABLE_DIRECT_IO = false;   // open table and index files with O_DIRECT, bypassing the OS cache
+static constexpr bool ENABLE_IO_URING = false;    // submit batched page I/O through io_uring when the kernel allows it
+static constexpr int IO_URING_QUEUE_DEPTH = 64;   // submission queue entries of the io_uring instance
 static constexpr int DEFAULT_DB_IO_SIZE = 16;                                 // starting size of file on disk
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 64;                                        // size of extendible hash bucket
-// static constexpr int LRUK_REPLACER_K = 10;                                    // backward k-distance for lru-k
+static constexpr int LRUK_REPLACER_K = 2;                                     // backward k-distance for lru-k
+static constexpr int QUERY_ARENA_BLOCK_SIZE = 64 * 1024;  // bytes the per-query arena takes from the system at a time
+static constexpr int VECTOR_SIZE = 1024;  // rows an executor hands over at a time in a DataChunk
+static constexpr bool ENABLE_SIMD_FILTERS = true;  // test scan filters with SSE4.2 / AVX2 when the CPU has them
+// slots a GROUP BY hash table starts with, doubled at half load
+static constexpr int AGG_HASH_TABLE_INITIAL_SLOTS = 64;
+// bytes a hash join builds in memory before it spills
+static constexpr size_t HASH_JOIN_MEMORY_BUDGET = 64 * 1024 * 1024;
+// a spilling hash join splits its inputs 2^bits ways a pass
+static constexpr int HASH_JOIN_PARTITION_BITS = 4;
+// partitioning passes before a partition is joined however big it is
+static constexpr int HASH_JOIN_MAX_PASSES = 4;
+// workers of a parallel hash join, at most the cores there are
+static constexpr int PARALLEL_HASH_JOIN_THREADS = 16;
+// rows an input of a hash join needs to be joined in parallel
+static constexpr int PARALLEL_HASH_JOIN_MIN_ROWS = 100000;
+// a parallel hash join builds 2^bits tables, each by one worker
+static constexpr int PARALLEL_HASH_JOIN_PARTITION_BITS = 6;
+// bytes of joined rows a probe round holds
+static constexpr size_t PARALLEL_HASH_JOIN_OUTPUT_BUDGET = 16 * 1024 * 1024;
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -59,8 +95,8 @@ static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varcha
 static const std::string LOG_FILE_NAME = "db.log";
 static const std::string RESTART_FILE_NAME = "db.restart";
 
-// replacer
-static const std::string REPLACER_TYPE = "LRU";
+// replacer: "LRU", "LRU-K" (scan resistant, see LRUK_REPLACER_K) or "CLOCK" (lock-free clock sweep)
+static const std::string REPLACER_TYPE = "LRU-K";
 static const std::string DB_META_NAME = "db.meta";
 
 static const std::string DB_NAME = "test.db";
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <nlohmann/json.hpp>
 #include <vector>
+#include "common/arena.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/log_manager.h"
 #include "transaction/transaction.h"
@@ -50,6 +51,7 @@ class Context {
   int *offset_;
   bool ellipsis_;
   json result_json;
+  Arena arena_;  // memory of the running query, released when its portal is dropped
 
   void InitJson() {
     SetJsonMsg("");
@@ -25,6 +25,21 @@ class HashUtil {
     return hash;
   }
 
+  /**
+   * @return the hash of a key of a hash table: HashBytes, which mixes its input into the low bits only, spread over
+   * the whole word by the finalizer of MurmurHash3, so that the low bits can pick the bucket and the high bits be the
+   * fingerprint
+   */
+  static inline auto HashKey(const char *bytes, size_t length) -> hash_t {
+    uint64_t hash = HashBytes(bytes, length);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
   static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t {
     hash_t both[2] = {};
     both[0] = l;
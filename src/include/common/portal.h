@@ -26,6 +26,7 @@ See the Mulan PSL v2 for more details. */
 #include "execution/executor_insert.h"
 #include "execution/executor_merge_join.h"
 #include "execution/executor_nestedloop_join.h"
+#include "execution/executor_parallel_hash_join.h"
 #include "execution/executor_projection.h"
 #include "execution/executor_seq_scan.h"
 #include "execution/executor_update.h"
@@ -153,7 +154,11 @@ class Portal {
   }
 
   // 清空资源
-  void drop() {}
+  // the executors go first, they may still point into the memory of the query in the arena of the context
+  void drop(std::shared_ptr<PortalStmt> portal, Context *context) {
+    portal->root.reset();
+    context->arena_.Reset();
+  }
 
   std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context) {
     if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
@@ -172,11 +177,14 @@ class Portal {
           cond.rhs_stmt_exe = std::static_pointer_cast<void>(shared_executor);
         }
       }
+      // only the VARCHAR columns the query reads are fetched back from the toast
+      const std::vector<std::string> *read_cols = x->reads_all_cols_ ? nullptr : &x->read_cols_;
       if (x->tag == T_SeqScan) {
-        return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context);
+        return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context, read_cols);
         // return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_);
       } else {
-        return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context);
+        return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context,
+                                                   read_cols);
       }
     } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
       std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
@@ -191,6 +199,8 @@ class Portal {
       } else if (x->tag == T_HashJoin) {
         // UNIMPLEMENTED("HashJoinExecutor is not implemented yet.");
         join = std::make_unique<HashJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
+      } else if (x->tag == T_ParallelHashJoin) {
+        join = std::make_unique<ParallelHashJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
       } else {
         throw InternalError("Unexpected join plan type.");
       }
@@ -198,10 +208,8 @@ class Portal {
     } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
       return std::make_unique<SortExecutor>(convert_plan_executor(x->subplan_, context), x->sel_col_, x->is_desc_);
     } else if (auto x = std::dynamic_pointer_cast<AggregationPlan>(plan)) {
-      return std::make_unique<AggregationExecutor>(sm_manager_, convert_plan_executor(x->subplan_, context),
-                                                   x->sel_cols_);
-      //  x->sel_cols_, x->group_cols_, x->having_conds_);
-      // UNIMPLEMENTED("AggregationExecutor is not implemented yet.");
+      return std::make_unique<AggregationExecutor>(convert_plan_executor(x->subplan_, context), x->sel_cols_,
+                                                   x->group_cols_, x->having_conds_);
     }
     return nullptr;
   }
@@ -0,0 +1,189 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * stats.h
+ *
+ * Identification: src/include/common/stats.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace easydb {
+
+/** @brief The event counters kept by Stats. */
+enum class StatCounter : int {
+  BUFFER_HITS = 0,          // FetchPage found the page in the pool
+  BUFFER_OPTIMISTIC_HITS,   // the part of BUFFER_HITS served without the partition latch
+  BUFFER_MISSES,            // FetchPage had to read the page
+  BUFFER_PIN_WAITS,         // FetchPage had to wait for an I/O of the page (its load or its write-back)
+  BUFFER_SYNC_EVICTIONS,    // a miss wrote its dirty victim back itself
+  BUFFER_CLEAN_EVICTIONS,   // a miss found its victim clean
+  BUFFER_BACKGROUND_WRITES, // pages written ahead of eviction by the page writer
+  BUFFER_FLUSHED_PAGES,     // pages written by FlushPage / FlushAllPages / FlushAllDirtyPages
+  BUFFER_PREFETCHED_PAGES,  // pages read by the read-ahead workers
+  IO_PAGES_READ,
+  IO_PAGES_WRITTEN,
+  IO_BYTES_READ,
+  IO_BYTES_WRITTEN,
+  SCAN_PAGES_SKIPPED,       // table pages a sequential scan did not read, because the zone map ruled them out
+  TOAST_CHUNKS_READ,        // chunks of toasted VARCHAR values read back
+  SPILL_BYTES_WRITTEN,      // bytes of rows executors wrote to temp files, e.g. the partitions of a hash join
+  NUM_COUNTERS
+};
+
+/** @brief The latency histograms kept by Stats. */
+enum class StatHistogram : int {
+  READ_PAGE = 0,  // DiskManager::ReadPage
+  WRITE_PAGE,     // DiskManager::WritePage
+  READ_BATCH,     // one vectored read or io_uring submission of a page batch
+  WRITE_BATCH,    // one vectored write or io_uring submission of a page batch
+  NUM_HISTOGRAMS
+};
+
+static constexpr int NUM_STAT_COUNTERS = static_cast<int>(StatCounter::NUM_COUNTERS);
+static constexpr int NUM_STAT_HISTOGRAMS = static_cast<int>(StatHistogram::NUM_HISTOGRAMS);
+
+/**
+ * @brief The bucket layout of the latency histograms, in the style of HdrHistogram.
+ *
+ * Values (nanoseconds) below 2^SUB_BUCKET_BITS get a bucket each, above that every power of two is split into
+ * 2^SUB_BUCKET_BITS linear sub-buckets, so a value is known to within 1/16 (6.25%) of itself over the whole range.
+ * Values beyond 2^MAX_EXPONENT ns (~18 minutes) land in the last bucket.
+ */
+struct LatencyBuckets {
+  static constexpr int SUB_BUCKET_BITS = 4;
+  static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr int MAX_EXPONENT = 40;
+  static constexpr size_t NUM_BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  /** @return the bucket of a value */
+  static inline auto Index(uint64_t value) -> size_t {
+    if (value < SUB_BUCKETS) {
+      return static_cast<size_t>(value);
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > MAX_EXPONENT) {
+      return NUM_BUCKETS - 1;
+    }
+    uint64_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+  }
+
+  /** @return the largest value that falls into a bucket */
+  static auto HighestValue(size_t index) -> uint64_t;
+};
+
+/**
+ * @brief The counters and histograms of one thread. Only the owning thread writes them, so an update is a plain
+ * load and store; they are atomics so that a concurrent Stats::Snapshot() reads whole values.
+ */
+struct ThreadStats {
+  std::atomic<uint64_t> counters_[NUM_STAT_COUNTERS]{};
+  std::atomic<uint64_t> buckets_[NUM_STAT_HISTOGRAMS][LatencyBuckets::NUM_BUCKETS]{};
+  std::atomic<uint64_t> sums_[NUM_STAT_HISTOGRAMS]{};
+  std::atomic<uint64_t> maxs_[NUM_STAT_HISTOGRAMS]{};
+
+  static inline void Bump(std::atomic<uint64_t> &value, uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+};
+
+/** @brief The aggregated state of one latency histogram. */
+struct HistogramSnapshot {
+  uint64_t count_{0};
+  uint64_t sum_{0};
+  uint64_t max_{0};
+  std::vector<uint64_t> buckets_ = std::vector<uint64_t>(LatencyBuckets::NUM_BUCKETS);
+
+  auto Mean() const -> double { return count_ == 0 ? 0 : static_cast<double>(sum_) / count_; }
+
+  /** @return the value below which `percentile` percent of the recorded values are (to within a bucket) */
+  auto Percentile(double percentile) const -> uint64_t;
+};
+
+/** @brief The counters and histograms of all threads, summed up. */
+struct StatsSnapshot {
+  uint64_t counters_[NUM_STAT_COUNTERS]{};
+  HistogramSnapshot histograms_[NUM_STAT_HISTOGRAMS];
+
+  auto Get(StatCounter counter) const -> uint64_t { return counters_[static_cast<int>(counter)]; }
+
+  auto GetHistogram(StatHistogram histogram) const -> const HistogramSnapshot & {
+    return histograms_[static_cast<int>(histogram)];
+  }
+};
+
+/**
+ * @brief Process wide buffer pool and I/O statistics.
+ *
+ * Every thread counts into its own ThreadStats, registered on its first update and folded into the totals of exited
+ * threads when it exits, so recording an event never touches a cache line shared with another thread. The per-thread
+ * values are summed up only when they are read.
+ */
+class Stats {
+ public:
+  static inline void Add(StatCounter counter, uint64_t n = 1) {
+    ThreadStats::Bump(Local().counters_[static_cast<int>(counter)], n);
+  }
+
+  static inline void RecordLatency(StatHistogram histogram, uint64_t nanos) {
+    ThreadStats &stats = Local();
+    int h = static_cast<int>(histogram);
+    ThreadStats::Bump(stats.buckets_[h][LatencyBuckets::Index(nanos)], 1);
+    ThreadStats::Bump(stats.sums_[h], nanos);
+    if (nanos > stats.maxs_[h].load(std::memory_order_relaxed)) {
+      stats.maxs_[h].store(nanos, std::memory_order_relaxed);
+    }
+  }
+
+  /** @brief Sum up the statistics of all threads, the live ones and the exited ones. */
+  static auto Snapshot() -> StatsSnapshot;
+
+  static auto CounterName(StatCounter counter) -> const char *;
+
+  static auto HistogramName(StatHistogram histogram) -> const char *;
+
+ private:
+  /** @brief The ThreadStats of the calling thread, registered on first use. */
+  static auto Local() -> ThreadStats & {
+    thread_local ThreadStatsHandle handle;
+    return *handle.stats_;
+  }
+
+  /** @brief Registers a thread's ThreadStats for its lifetime. */
+  struct ThreadStatsHandle {
+    ThreadStatsHandle();
+    ~ThreadStatsHandle();
+    ThreadStats *stats_;
+  };
+};
+
+/** @brief Records the time from its construction to its destruction into a latency histogram. */
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(StatHistogram histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedLatency() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    Stats::RecordLatency(histogram_,
+                         static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+  }
+
+  ScopedLatency(const ScopedLatency &) = delete;
+  ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+ private:
+  StatHistogram histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace easydb
@@ -10,7 +10,7 @@
 
 #include <iostream>
 #include <map>
-enum AggregationType { MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, NO_AGG };
+enum AggregationType { MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, AVG_AGG, NO_AGG };
 // 此处重载了<<操作符，在ColMeta中进行了调用
 template <typename T, typename = typename std::enable_if<std::is_enum<T>::value, T>::type>
 std::ostream &operator<<(std::ostream &os, const T &enum_val) {
@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * aggregate_hash_table.h
+ *
+ * Identification: src/include/execution/aggregate_hash_table.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/arena.h"
+#include "common/config.h"
+#include "common/hashutil.h"
+
+namespace easydb {
+
+/**
+ * @brief The groups of a GROUP BY: for each distinct key, the accumulators of its aggregates.
+ *
+ * A key is the bytes of the values of the group-by columns, a state is a fixed number of bytes the caller lays its
+ * accumulators out in. Both are kept in an arena, one of each per group, so the table grows with the groups and not
+ * with the rows fed to it. The index is open addressing with linear probing over a power of two array of 64-bit
+ * slots, each packing a 32-bit fingerprint of the hash and the group number, and doubles once half of it is used.
+ * Groups are numbered in the order they were first seen.
+ */
+class AggregateHashTable {
+ public:
+  /**
+   * @param state_size the bytes of the accumulators of a group
+   * @param initial_state the state_size bytes a new group starts with
+   */
+  AggregateHashTable(uint32_t state_size, std::vector<char> initial_state);
+
+  AggregateHashTable(const AggregateHashTable &) = delete;
+  auto operator=(const AggregateHashTable &) -> AggregateHashTable & = delete;
+
+  /** @return the hash of a key */
+  static inline auto Hash(const char *key, uint32_t key_size) -> hash_t { return HashUtil::HashKey(key, key_size); }
+
+  /**
+   * @brief Find the group of `key`, adding it with the initial state if there is none yet.
+   * @param hash Hash(key, key_size)
+   * @return the state of the group, valid until Clear()
+   */
+  auto FindOrInsert(const char *key, uint32_t key_size, hash_t hash) -> char *;
+
+  inline auto GetNumGroups() const -> size_t { return groups_.size(); }
+
+  inline auto GetKey(size_t group) const -> const char * { return groups_[group].key_; }
+
+  inline auto GetKeySize(size_t group) const -> uint32_t { return groups_[group].key_size_; }
+
+  inline auto GetState(size_t group) const -> char * { return groups_[group].state_; }
+
+  /** @return the bytes the table holds: its slots, its groups and their keys and states */
+  inline auto GetMemoryUsage() const -> size_t {
+    return slots_.capacity() * sizeof(uint64_t) + groups_.capacity() * sizeof(Group) + arena_.GetBytesAllocated();
+  }
+
+  /** @brief Drop every group. */
+  void Clear();
+
+ private:
+  struct Group {
+    const char *key_;
+    char *state_;
+    hash_t hash_;
+    uint32_t key_size_;
+  };
+
+  static constexpr uint64_t EMPTY = 0;
+  static constexpr uint64_t GROUP_MASK = 0xffffffff;
+
+  /** @brief The slot value of a group: the fingerprint and group number + 1, so that no entry is EMPTY. */
+  static inline auto MakeSlot(hash_t hash, size_t group) -> uint64_t {
+    return ((static_cast<uint64_t>(hash) >> 32) << 32) | (static_cast<uint64_t>(group) + 1);
+  }
+
+  /** @brief Double the slots and index every group again. */
+  void Grow();
+
+  uint32_t state_size_;
+  std::vector<char> initial_state_;
+  std::vector<uint64_t> slots_;
+  size_t mask_;
+  std::vector<Group> groups_;
+  Arena arena_;  // the keys and states of the groups
+};
+
+}  // namespace easydb
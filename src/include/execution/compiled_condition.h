@@ -0,0 +1,104 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * compiled_condition.h
+ *
+ * Identification: src/include/execution/compiled_condition.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/condition.h"
+#include "storage/table/tuple_accessor.h"
+
+namespace easydb {
+
+/**
+ * A Condition resolved against the schemas of the tuples it is tested on, once, when the executor is built.
+ *
+ * Its columns become ColumnAccessors. A comparison between a column and a constant, or between two columns, whose
+ * types are both numeric, both dates or both strings is done by a kernel instantiated for the two types and the
+ * operator, which reads the values straight from the tuple bytes. Everything else (IN, subqueries, a date or a
+ * number against a string) builds Values and goes through Condition::satisfy, still without looking the columns up
+ * by name. Either way the result is the one Condition::satisfy gives on the Values of the columns.
+ */
+class CompiledCondition {
+ public:
+  /**
+   * @param cond the condition, whose rhs_val must not change any more unless it comes from a subquery
+   * @param lhs_schema the schema of the tuples that hold the column on the left-hand side
+   * @param rhs_schema the schema of the tuples that hold the column on the right-hand side, if there is one
+   */
+  CompiledCondition(const Condition &cond, const Schema &lhs_schema, const Schema &rhs_schema);
+
+  /**
+   * @brief Resolve a condition of a join against the schemas of its two children, finding the side of each column
+   * by the table names of the condition.
+   * @throws InternalError if a column of the condition is on neither side
+   */
+  static auto ForJoin(const Condition &cond, const std::string &left_tab_name, const Schema &left_schema,
+                      const std::string &right_tab_name, const Schema &right_schema) -> CompiledCondition;
+
+  /** @return true if the condition is tested by a typed kernel, without Values */
+  inline auto IsTyped() const -> bool { return kernel_ != nullptr; }
+
+  /**
+   * @brief Test the condition on the bytes of tuples.
+   * @param cond the condition it was compiled from, for the Values of its right-hand side
+   * @param lhs_tuple the tuple that holds the column on the left-hand side
+   * @param rhs_tuple the tuple that holds the column on the right-hand side, unused if it is not a column
+   */
+  inline auto Evaluate(Condition &cond, const char *lhs_tuple, const char *rhs_tuple) const -> bool {
+    if (kernel_ != nullptr) {
+      return kernel_(lhs_.GetDataPtr(lhs_tuple), rhs_is_col_ ? rhs_.GetDataPtr(rhs_tuple) : rhs_storage_.data());
+    }
+    Value lhs_v = lhs_.GetValue(lhs_tuple);
+    Value rhs_v;
+    if (cond.is_rhs_val) {
+      rhs_v = cond.rhs_val;
+    } else if (rhs_is_col_) {
+      rhs_v = rhs_.GetValue(rhs_tuple);
+    }
+    return cond.satisfy(lhs_v, rhs_v);
+  }
+
+  /** @brief Test a condition compiled by ForJoin() on a pair of tuples of the left and the right child. */
+  inline auto EvaluateJoin(Condition &cond, const char *left_tuple, const char *right_tuple) const -> bool {
+    return lhs_on_right_ ? Evaluate(cond, right_tuple, left_tuple) : Evaluate(cond, left_tuple, right_tuple);
+  }
+
+  /**
+   * @brief Test a condition with a constant on its right-hand side on a value of its column that is not in a tuple,
+   * e.g. in a PAX minipage.
+   * @param lhs_storage the storage of the value
+   */
+  inline auto EvaluateStorage(Condition &cond, const char *lhs_storage) const -> bool {
+    if (kernel_ != nullptr) {
+      return kernel_(lhs_storage, rhs_storage_.data());
+    }
+    return cond.satisfy(Value::DeserializeFrom(lhs_storage, lhs_.GetType()), cond.rhs_val);
+  }
+
+ private:
+  /** Compares the storage of a value of the left-hand side with one of the right-hand side. */
+  using Kernel = bool (*)(const char *lhs, const char *rhs);
+
+  /** @return the kernel comparing values of the two types with `op`, nullptr if there is none */
+  static auto FindKernel(TypeId lhs_type, TypeId rhs_type, CompOp op) -> Kernel;
+
+  ColumnAccessor lhs_;
+  ColumnAccessor rhs_;
+  bool rhs_is_col_{false};
+  std::vector<char> rhs_storage_;  // the constant on the right-hand side, stored like a value of a tuple
+  Kernel kernel_{nullptr};
+  bool lhs_on_right_{false};  // for a join, the left-hand side is a column of the right child
+};
+
+}  // namespace easydb
@@ -0,0 +1,184 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * data_chunk.h
+ *
+ * Identification: src/include/execution/data_chunk.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/arena.h"
+#include "common/config.h"
+#include "storage/table/tuple_accessor.h"
+#include "type/value.h"
+
+namespace easydb {
+
+/**
+ * The values of one column of a DataChunk, row after row.
+ *
+ * A value of a fixed-size type is kept as its storage (the bytes it has in a tuple), so that the values of the
+ * column are one packed array a kernel can run over. A string is kept as a pointer to its storage, [length][bytes],
+ * copied into the arena of the chunk.
+ */
+class ColumnVector {
+ public:
+  ColumnVector(TypeId type, uint32_t width, uint32_t capacity);
+
+  inline auto GetType() const -> TypeId { return type_; }
+
+  /** @return true if the values are kept in place, false if the column holds pointers to them */
+  inline auto IsInlined() const -> bool { return inlined_; }
+
+  /** @return the storage of the value of row `row`, as ColumnAccessor::GetDataPtr() gives it for a tuple */
+  inline auto GetStorage(uint32_t row) const -> const char * {
+    const char *slot = data_.data() + static_cast<size_t>(row) * width_;
+    if (inlined_) {
+      return slot;
+    }
+    const char *storage;
+    std::memcpy(&storage, slot, sizeof(storage));
+    return storage;
+  }
+
+  /** @return the packed storage of the values of a fixed-size column, GetWidth() bytes a row */
+  inline auto GetData() const -> const char * { return data_.data(); }
+
+  inline auto GetWidth() const -> uint32_t { return width_; }
+
+ private:
+  friend class DataChunk;
+
+  TypeId type_;
+  bool inlined_;
+  uint32_t width_;  // the bytes a row takes in data_
+  std::vector<char> data_;
+};
+
+/**
+ * A batch of up to VECTOR_SIZE rows of a schema, stored column by column, that executors hand to each other with
+ * NextBatch().
+ *
+ * The rows of a chunk are numbered 0 .. GetSize() - 1. A filter does not move them: it narrows the selection vector,
+ * the rows that are still part of the batch, which consumers walk with GetNumSelected() / GetSelected(). The
+ * contents of a chunk, strings included, are valid until the executor that filled it is asked for its next batch.
+ *
+ * A chunk can also reference the columns of another one instead of holding its own (see Reference()), which is how
+ * a projection passes a batch up without copying it.
+ */
+class DataChunk {
+ public:
+  DataChunk() = default;
+
+  explicit DataChunk(const Schema &schema, uint32_t capacity = VECTOR_SIZE) { Initialize(schema, capacity); }
+
+  DataChunk(const DataChunk &) = delete;
+  auto operator=(const DataChunk &) -> DataChunk & = delete;
+
+  /** @brief Make the chunk hold up to `capacity` rows of `schema`, dropping what it held. */
+  void Initialize(const Schema &schema, uint32_t capacity = VECTOR_SIZE);
+
+  /** @brief Empty the chunk for the next batch: no rows, no selection, its own columns again. */
+  void Reset();
+
+  inline auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the rows in the chunk, selected or not */
+  inline auto GetSize() const -> uint32_t { return size_; }
+
+  inline auto IsFull() const -> bool { return size_ >= capacity_; }
+
+  inline auto GetColumnCount() const -> uint32_t { return static_cast<uint32_t>(columns_.size()); }
+
+  inline auto GetColumn(uint32_t col_idx) const -> const ColumnVector & { return *columns_[col_idx]; }
+
+  /** @return the rows of the batch that passed the filters so far */
+  inline auto GetNumSelected() const -> uint32_t {
+    return has_selection_ ? static_cast<uint32_t>(selection_.size()) : size_;
+  }
+
+  /** @return the row number of the i-th selected row */
+  inline auto GetSelected(uint32_t i) const -> uint32_t { return has_selection_ ? selection_[i] : i; }
+
+  /**
+   * @brief Narrow the selection to the rows for which `pred(row)` is true.
+   * @param pred called with the number of each selected row, in order
+   */
+  template <typename Pred>
+  void Select(Pred &&pred) {
+    if (!has_selection_) {
+      selection_.resize(size_);
+      for (uint32_t row = 0; row < size_; row++) {
+        selection_[row] = row;
+      }
+      has_selection_ = true;
+    }
+    size_t num_selected = 0;
+    for (uint32_t row : selection_) {
+      if (pred(row)) {
+        selection_[num_selected++] = row;
+      }
+    }
+    selection_.resize(num_selected);
+  }
+
+  /**
+   * @brief Narrow the selection to the rows whose bit is set in `bitmap`.
+   * @param bitmap a bit for each row of the chunk, row i in bit i % 64 of word i / 64
+   */
+  void SelectBitmap(const uint64_t *bitmap);
+
+  /** @brief Append a row, reading its values from the bytes of a tuple of the schema. The chunk must not be full. */
+  void AppendTuple(const char *tuple);
+
+  /** @return the value of column `col_idx` of row `row` */
+  inline auto GetValue(uint32_t col_idx, uint32_t row) const -> Value {
+    const ColumnVector &column = *columns_[col_idx];
+    return Value::DeserializeFrom(column.GetStorage(row), column.GetType());
+  }
+
+  /** @return the size of row `row` as a tuple of the schema */
+  auto GetRowSize(uint32_t row) const -> uint32_t;
+
+  /** @brief Write row `row` as a tuple of the schema into `dst`, which has room for GetRowSize(row) bytes. */
+  void WriteRow(uint32_t row, char *dst) const;
+
+  /** @brief Write row `row` as a tuple of the schema into `out`, resized to fit. */
+  void GetRow(uint32_t row, std::vector<char> *out) const;
+
+  /**
+   * @brief Make the chunk a view of some columns of `other`, with its rows and its selection, without copying them.
+   * The columns must have the types of the columns of the chunk. The view is valid as long as the contents of
+   * `other` are, and the chunk gets its own columns back with the next Reset().
+   * @param col_ids the column of `other` each column of the chunk is
+   */
+  void Reference(const DataChunk &other, const std::vector<uint32_t> &col_ids);
+
+  /** @return the bytes the storage of a string takes, [length][bytes], in a tuple */
+  static auto GetStringStorageSize(const char *storage) -> uint32_t;
+
+ private:
+  uint32_t capacity_{0};
+  uint32_t size_{0};
+  std::vector<std::unique_ptr<ColumnVector>> owned_;  // the columns the chunk fills
+  std::vector<const ColumnVector *> columns_;         // the columns it shows, its own or those of another chunk
+  std::vector<ColumnAccessor> accessors_;             // where the value of each column is in a tuple of the schema
+  std::vector<uint32_t> offsets_;                     // the offset of each column in a tuple of the schema
+  std::vector<uint32_t> varlen_cols_;                 // the string columns, in the order their values are stored
+  uint32_t inlined_size_{0};                          // the size of the fixed part of a tuple of the schema
+  bool has_selection_{false};                         // false while every row is selected
+  std::vector<uint32_t> selection_;
+  Arena arena_;  // the storage of the strings of the rows
+};
+
+}  // namespace easydb
@@ -8,14 +8,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <optional>
+
 #include "catalog/column.h"
 #include "catalog/schema.h"
+#include "common/arena.h"
 #include "common/common.h"
+#include "common/condition.h"
 #include "common/context.h"
 #include "common/errors.h"
+#include "data_chunk.h"
 #include "defs.h"
 #include "storage/index/ix_manager.h"
 #include "storage/index/ix_scan.h"
+#include "storage/table/tuple.h"
 #include "system/sm_defs.h"
 #include "system/sm_meta.h"
 #include "type/type_id.h"
@@ -65,6 +72,66 @@ class AbstractExecutor {
 
   virtual std::unique_ptr<Tuple> Next() = 0;
 
+  /**
+   * @brief The current tuple without copying it, for executors that can point into storage they keep pinned.
+   * The view is only valid until the next beginTuple() / nextTuple(), consumers that keep the tuple longer have to
+   * use Next() (or materialize the view).
+   * @return std::nullopt if the executor has no view of its tuples
+   */
+  virtual std::optional<TupleView> NextView() { return std::nullopt; }
+
+  /**
+   * @brief Start the executor for NextBatch(), in place of beginTuple(). An executor that only works a row at a
+   * time is simply positioned on its first row.
+   */
+  virtual void beginBatch() { beginTuple(); }
+
+  /**
+   * @brief Fill `chunk` with the next batch of rows, after beginBatch().
+   * By default the rows are gathered one at a time with nextTuple(), so that every executor can be the child of one
+   * that works a batch at a time; executors that can produce whole batches override it.
+   * @param chunk a chunk of the schema of the executor, its contents valid until the next call
+   * @return false once there are no rows left, true if `chunk` has at least one selected row
+   */
+  virtual bool NextBatch(DataChunk &chunk) {
+    chunk.Reset();
+    for (; !IsEnd() && !chunk.IsFull(); nextTuple()) {
+      if (auto view = NextView()) {
+        chunk.AppendTuple(view->GetData());
+      } else {
+        auto tuple = Next();
+        chunk.AppendTuple(tuple->GetData());
+      }
+    }
+    return chunk.GetSize() > 0;
+  }
+
+  /**
+   * @brief The arena of the query, for memory an executor keeps until the portal is dropped (e.g. the tuples a join
+   * buffers). An executor without a context, e.g. one built by a test, gets an arena of its own.
+   */
+  Arena *GetArena() {
+    if (context_ != nullptr) {
+      return &context_->arena_;
+    }
+    if (local_arena_ == nullptr) {
+      local_arena_ = std::make_unique<Arena>();
+    }
+    return local_arena_.get();
+  }
+
+  /**
+   * @brief Copy the current tuple into the arena of the query, straight from the view of it if there is one.
+   * @return a view of the copy, valid until the portal is dropped
+   */
+  TupleView NextInArena() {
+    if (auto view = NextView()) {
+      return TupleView(GetArena()->Copy(view->GetData(), view->GetLength()), view->GetLength(), view->GetRid());
+    }
+    auto tuple = Next();
+    return TupleView(GetArena()->Copy(tuple->GetData(), tuple->GetLength()), tuple->GetLength(), tuple->GetRid());
+  }
+
   // virtual std::unique_ptr<RmRecord> Next() = 0;
 
   virtual ColMeta get_col_offset(const TabCol &target) { return ColMeta(); };
@@ -91,6 +158,31 @@ class AbstractExecutor {
     return pos;
   }
 
+  /**
+   * @brief The VARCHAR columns a scan of a table has to read back from the toast: the ones in `read_cols` and the
+   * ones its conditions test.
+   * @param read_cols the columns the operators above the scan use, nullptr for all of them
+   * @return the offsets of the columns, see RmToast::Detoast()
+   */
+  std::vector<uint32_t> getToastColumns(const Schema &schema, const std::string &tab_name,
+                                        const std::vector<std::string> *read_cols,
+                                        const std::vector<Condition> &conds) {
+    std::vector<uint32_t> toast_cols;
+    for (uint32_t col_idx : schema.GetUnlinedColumns()) {
+      const Column &col = schema.GetColumn(col_idx);
+      bool read = read_cols == nullptr ||
+                  std::find(read_cols->begin(), read_cols->end(), col.GetName()) != read_cols->end();
+      for (auto &cond : conds) {
+        read = read || (cond.lhs_col.tab_name == tab_name && cond.lhs_col.col_name == col.GetName()) ||
+               (!cond.is_rhs_val && !cond.is_rhs_stmt && cond.rhs_col.tab_name == tab_name && cond.rhs_col.col_name == col.GetName());
+      }
+      if (read) {
+        toast_cols.push_back(col.GetOffset());
+      }
+    }
+    return toast_cols;
+  }
+
   std::vector<Column>::const_iterator get_col(const std::vector<Column> &rec_cols, const std::string &target_tab_name,
                                               const std::string &target_col_name) {
     auto pos = std::find_if(rec_cols.begin(), rec_cols.end(),
@@ -100,6 +192,9 @@ class AbstractExecutor {
     }
     return pos;
   }
+
+ private:
+  std::unique_ptr<Arena> local_arena_;
 };
 
 }  // namespace easydb
@@ -10,6 +10,7 @@
 
 #include "common/errors.h"
 #include "defs.h"
+#include "execution/aggregate_hash_table.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
 #include "storage/index/ix_manager.h"
@@ -31,47 +32,65 @@
  * group by id
  * having COUNT(*) > 1 and MIN(score) > 88;
  *
- * TYPE: COUNT MIN MAX SUM
+ * TYPE: COUNT MIN MAX SUM AVG
  *
  * enum AggregationType {
- *  MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, NO_AGG
+ *  MAX_AGG, MIN_AGG, COUNT_AGG, SUM_AGG, AVG_AGG, NO_AGG
  *  };
  */
 
 namespace easydb {
 
+/**
+ * 哈希聚合: 按批读入儿子节点的全部记录, 每个组在AggregateHashTable中只保留group by字段的值和每个聚合函数的一个
+ * 累加器(计数, 和或当前的最值), 内存随组数而不是记录数增长. 读完后逐个组计算聚合结果并判断having条件.
+ * 没有group by时所有记录为一个组, 即使没有记录也输出一行.
+ */
 class AggregationExecutor : public AbstractExecutor {
  private:
+  /** 一个聚合函数 */
+  struct Aggregate {
+    AggregationType type_;
+    std::string col_name_;  // 参数字段, COUNT(*)为"*"
+    uint32_t col_idx_;      // 参数字段在儿子节点中的位置
+    TypeId col_type_;
+  };
+
+  /** 输出或having条件中的一项: 一个聚合函数的结果, 或一个group by字段的值 */
+  struct Output {
+    bool is_agg_;
+    size_t idx_;  // aggregates_或group_col_ids_的下标
+  };
+
+  /** 一个having条件, 右边不是常量时rhs_为其右边 */
+  struct HavingCond {
+    Condition cond_;
+    Output lhs_;
+    Output rhs_;
+  };
+
   std::unique_ptr<AbstractExecutor> prev_;  // 聚合操作的儿子节点
   size_t len_;                              // 聚合计算后得到的记录的长度
 
-  // std::vector<ColMeta> cols_;               // 聚合计算后得到的字段
-  // std::vector<ColMeta> prev_cols_;          // 原始字段
-  // std::vector<ColMeta> sel_cols_;           // 聚合计算选择的字段
-  // std::vector<ColMeta> group_cols_;         // groupby选择的字段
-
-  std::string tab_name_;           // 表名称
-  Schema schema_;                  // 聚合计算后得到的字段
-  Schema prev_schema_;             // 原始字段
-  std::vector<Column> sel_colus_;  // 聚合计算选择的字段
-  // std::vector<Column> group_colus_;  // groupby选择的字段
+  std::string tab_name_;  // 表名称
+  Schema schema_;         // 聚合计算后得到的字段
+  Schema prev_schema_;    // 原始字段
 
-  // std::vector<Condition> having_conds_;  // having算子的条件
+  std::vector<uint32_t> group_col_ids_;  // group by字段在儿子节点中的位置
+  std::vector<Aggregate> aggregates_;    // 输出和having条件用到的聚合函数, 相同的只计算一次
+  std::vector<Output> outputs_;          // 输出的每个字段
+  std::vector<HavingCond> having_conds_;  // having算子的条件
 
-  // std::vector<Tuple> all_records_;                             // 所有records
-  // std::map<std::string, std::vector<Tuple>> key_records_map_;  // 根据groupby条件分组的records <key,records>哈希表
-
-  std::unique_ptr<Tuple> result_;  // 用于返回的聚合结果记录
-  // bool isend_;
-  int key_length;
-  std::map<std::string, std::vector<Tuple>>::iterator it;
-  bool isend_;
-  // int traverse_idx;
-  SmManager *sm_manager_;
+  std::unique_ptr<AggregateHashTable> hash_table_;  // 每个组的key(group by字段的值)和累加器
+  std::vector<Value> values_;                       // 字符串和日期字段的MIN/MAX的当前值, 累加器中存其下标
+  DataChunk chunk_;                                 // 从儿子节点读入的batch
+  std::vector<char *> states_;                      // batch中每一行所在组的累加器
+  std::vector<char> key_;                           // 当前行的key
+  size_t group_idx_;                                // 当前输出的组
 
  public:
-  AggregationExecutor(SmManager *sm_manager, std::unique_ptr<AbstractExecutor> prev, std::vector<TabCol> sel_col_);
-  // std::vector<TabCol> group_cols, std::vector<Condition> having_conds);
+  AggregationExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols,
+                      const std::vector<TabCol> &group_cols, const std::vector<Condition> &having_conds);
 
   void beginTuple() override;
 
@@ -83,23 +102,38 @@ class AggregationExecutor : public AbstractExecutor {
 
   size_t tupleLen() const override { return len_; };
 
-  // const std::vector<ColMeta> &cols() const override { return cols_; };
   const Schema &schema() const override { return schema_; };
 
   auto GetTabName() const -> std::string { return tab_name_; }
 
-  bool IsEnd() const override { return isend_; };
-  // bool IsEnd() const override { return it == key_records_map_.end(); };
+  bool IsEnd() const override { return group_idx_ >= hash_table_->GetNumGroups(); };
+
+  /** @return 聚合的哈希表占用的内存 */
+  auto GetMemoryUsage() const -> size_t { return hash_table_->GetMemoryUsage(); }
 
  private:
-  // bool in_groupby_cols(Column target);
+  std::string generate_new_name(TabCol col);
 
-  // bool predicate(std::vector<Tuple> records);
+  /** @brief 输出或having条件中的字段对应的项, 聚合函数加入aggregates_ */
+  Output resolve_output(const TabCol &col);
 
-  // Value aggregation_to_value(std::vector<Tuple> records, Column target_colu);
-  std::string generate_new_name(TabCol col);
+  /** @brief 读入儿子节点的所有记录, 更新每个组的累加器 */
+  void build();
+
+  /** @brief 用当前batch中被选中的行更新第agg_idx个聚合函数的累加器 */
+  void update_aggregate(size_t agg_idx);
+
+  template <typename T>
+  void update_numbers(AggregationType type, const ColumnVector &column, size_t offset, T null);
+
+  void update_values(const Aggregate &agg, const ColumnVector &column, size_t offset);
+
+  /** @brief 从group_idx_开始找到第一个满足having条件的组 */
+  void seek();
+
+  Value group_value(size_t group, size_t group_col);
 
-  Value aggregation_to_value(Column target_colu);
+  Value output_value(size_t group, const Output &output);
 };
 
 }  // namespace easydb
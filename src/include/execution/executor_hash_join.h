@@ -1,57 +1,40 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <vector>
 #include "common/common.h"
 #include "common/condition.h"
 #include "common/errors.h"
-#include "common/hashutil.h"
+#include "compiled_condition.h"
 #include "defs.h"
+#include "execution/join_hash_table.h"
+#include "execution/spill_file.h"
 #include "executor_abstract.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
 namespace easydb {
 
-struct HashJoinKey {
-  std::vector<Value> values_;
-
-  bool operator==(const HashJoinKey &other) const {
-    if (values_.size() != other.values_.size()) {
-      return false;
-    }
-    for (size_t i = 0; i < values_.size(); ++i) {
-      if (values_[i].CompareEquals(other.values_[i]) != CmpBool::CmpTrue) {
-        return false;
-      }
-    }
-    return true;
-  }
-};
-
-}  // namespace easydb
-
-namespace std {
-
-/** Implements std::hash on HashJoinKey */
-template <>
-struct hash<easydb::HashJoinKey> {
-  std::size_t operator()(const easydb::HashJoinKey &key) const {
-    std::size_t curr_hash = 0;
-    for (const auto &value : key.values_) {
-      curr_hash = easydb::HashUtil::CombineHashes(curr_hash, easydb::HashUtil::HashValue(&value));
-    }
-    return curr_hash;
-  }
-};
-
-}  // namespace std
-
-namespace easydb {
-
+/**
+ * Joins the left child (the build side) with the right child (the probe side) on the equality conditions between
+ * their columns, the other conditions being checked on every pair the hash table gives.
+ *
+ * The left input is loaded into a JoinHashTable keyed by the bytes of its join columns. If it grows past the memory
+ * budget, the join turns into a grace hash join: the rows loaded so far and the rest of the left input are written to
+ * 2^HASH_JOIN_PARTITION_BITS temp files by the bits of the hash of their key, the right input is split the same way,
+ * and the pairs of partitions are then joined one at a time. A build partition that is still too big is split again
+ * by the next bits of the hash, up to HASH_JOIN_MAX_PASSES times; after that (e.g. a single key with more rows than
+ * the budget) it is joined in memory whatever its size.
+ */
 class HashJoinExecutor : public AbstractExecutor {
  private:
+  /** A pair of partitions of the two inputs, joined on their own */
+  struct Partition {
+    std::unique_ptr<SpillFile> build_;
+    std::unique_ptr<SpillFile> probe_;
+    int pass_;  // the partitioning passes its rows went through
+  };
+
   std::unique_ptr<AbstractExecutor> left_;
   std::unique_ptr<AbstractExecutor> right_;
   std::string left_tab_name_;
@@ -60,34 +43,49 @@ class HashJoinExecutor : public AbstractExecutor {
   size_t len_;
   Schema schema_;
   std::vector<Condition> conds_;
+  std::vector<CompiledCondition> compiled_conds_;  // conds_ resolved against the schemas of the children
   bool isend_;
-
-  // Hash table data structure
-  std::unordered_multimap<HashJoinKey, Tuple> hash_table_;
-
-  // Join columns
-  std::vector<Column> left_join_cols_;
-  std::vector<Column> right_join_cols_;
-
-  // Iterators for hash join
-  std::unordered_multimap<HashJoinKey, Tuple>::iterator match_iter_;
-  std::unordered_multimap<HashJoinKey, Tuple>::iterator match_end_;
-  Tuple current_probe_tuple_;
+  size_t memory_budget_;  // the bytes the hash table may use before the join spills
+
+  // The hash table of the left input, or of the partition being joined
+  JoinHashTable hash_table_;
+  JoinKeyEncoder left_keys_;  // the join columns of each side, in the same order
+  JoinKeyEncoder right_keys_;
+  std::vector<char> key_;        // the key of the current row, its memory reused by every row
+  std::vector<char> build_row_;  // the current row of the left input
+
+  // Once the join spilled, the partitions left to join and the probe rows of the current one
+  bool spilled_{false};
+  std::vector<Partition> partitions_;
+  std::unique_ptr<SpillFile> probe_file_;
+
+  // The right input is probed a row at a time, read a batch at a time from the child (or from probe_file_)
+  DataChunk probe_chunk_;                              // the current batch of the right child
+  uint32_t next_probe_{0};                             // the next selected row of probe_chunk_ to probe
+  std::vector<char> probe_row_;                        // the storage of current_probe_tuple_
+  TupleView current_probe_tuple_;                      // the current tuple of the right input
+  const JoinHashTable::Entry *match_{nullptr};         // the next entry of the key of the probe tuple to check
+  const JoinHashTable::Entry *current_match_{nullptr};  // the entry joined with the probe tuple
+  std::vector<char> joined_tuple_;                     // the current joined tuple, its memory reused by every row
 
   // For nested loop join fallback
   bool use_nested_loop_;
   size_t left_idx_;
   size_t right_idx_;
-  std::vector<Tuple> left_buffer_;
-  std::vector<Tuple> right_buffer_;
+  std::vector<TupleView> left_buffer_;  // copies in the arena of the query
+  std::vector<TupleView> right_buffer_;
 
  public:
+  /** @param memory_budget the bytes the hash table may use before the join spills to temp files */
   HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
-                   std::vector<Condition> conds);
+                   std::vector<Condition> conds, size_t memory_budget = HASH_JOIN_MEMORY_BUDGET);
 
   void beginTuple() override;
   void nextTuple() override;
   std::unique_ptr<Tuple> Next() override;
+  std::optional<TupleView> NextView() override;
+  void beginBatch() override;
+  bool NextBatch(DataChunk &chunk) override;
   RID &rid() override { return _abstract_rid; }
 
   size_t tupleLen() const override { return len_; }
@@ -96,23 +94,40 @@ class HashJoinExecutor : public AbstractExecutor {
 
   bool IsEnd() const override { return isend_; }
 
+  /** @return true if the last join did not fit in the memory budget and went through temp files */
+  bool IsSpilled() const { return spilled_; }
+
  private:
   void BuildHashTable();
-  void ProbeHashTable();
-  bool predicate(const Tuple &left_tuple, const Tuple &right_tuple);
+  bool NextPartition();
+  bool NextProbeTuple();
+  bool Advance();
+  void ConcatCurrent();
+  auto SpillHashTable(int pass) -> std::vector<std::unique_ptr<SpillFile>>;
+  auto SplitRows(SpillFile *file, const JoinKeyEncoder &key_cols, int pass)
+      -> std::vector<std::unique_ptr<SpillFile>>;
+  bool predicate(const TupleView &left_tuple, const TupleView &right_tuple);
   void NestedLoopBegin();
   void NestedLoopNext();
+
+  /** @return the partition of a key with `hash` in partitioning pass `pass`, each pass using the next bits */
+  static inline auto PartitionOf(hash_t hash, int pass) -> size_t {
+    int shift = 64 - HASH_JOIN_PARTITION_BITS * (pass + 1);
+    return (static_cast<uint64_t>(hash) >> shift) & ((1U << HASH_JOIN_PARTITION_BITS) - 1);
+  }
 };
 
 HashJoinExecutor::HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
-                                   std::vector<Condition> conds)
+                                   std::vector<Condition> conds, size_t memory_budget)
     : left_(std::move(left)),
       right_(std::move(right)),
       conds_(std::move(conds)),
       isend_(false),
+      memory_budget_(memory_budget),
       use_nested_loop_(false),
       left_idx_(0),
       right_idx_(0) {
+  context_ = left_->context_ != nullptr ? left_->context_ : right_->context_;
   left_tab_name_ = left_->getTabName();
   right_tab_name_ = right_->getTabName();
   join_tab_name_ = left_tab_name_ + "_" + right_tab_name_;
@@ -124,22 +139,16 @@ HashJoinExecutor::HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::
   schema_ = Schema(left_columns);
 
   len_ = left_->tupleLen() + right_->tupleLen();
+  for (const auto &cond : conds_) {
+    compiled_conds_.push_back(
+        CompiledCondition::ForJoin(cond, left_tab_name_, left_->schema(), right_tab_name_, right_->schema()));
+  }
 
   // Determine join columns
-  for (auto &cond : conds_) {
-    if (cond.op == OP_EQ && !cond.is_rhs_val) {
-      // Both sides are columns
-      if (cond.lhs_col.tab_name == left_tab_name_ || cond.rhs_col.tab_name == right_tab_name_) {
-        left_join_cols_.push_back(left_->schema().GetColumn(cond.lhs_col.col_name));
-        right_join_cols_.push_back(right_->schema().GetColumn(cond.rhs_col.col_name));
-      } else if (cond.rhs_col.tab_name == left_tab_name_ || cond.lhs_col.tab_name == right_tab_name_) {
-        left_join_cols_.push_back(left_->schema().GetColumn(cond.rhs_col.col_name));
-        right_join_cols_.push_back(right_->schema().GetColumn(cond.lhs_col.col_name));
-      }
-    }
-  }
+  JoinKeyEncoder::ForJoin(conds_, left_tab_name_, left_->schema(), right_tab_name_, right_->schema(), &left_keys_,
+                          &right_keys_);
 
-  if (left_join_cols_.empty()) {
+  if (left_keys_.IsEmpty()) {
     // No equality conditions, cannot perform hash join, use nested loop join
     use_nested_loop_ = true;
   }
@@ -154,24 +163,7 @@ void HashJoinExecutor::beginTuple() {
 
   // Hash join
   BuildHashTable();
-  right_->beginTuple();
-  if (right_->IsEnd()) {
-    isend_ = true;
-    return;
-  }
-  do {
-    current_probe_tuple_ = *(right_->Next());
-    ProbeHashTable();
-    while (match_iter_ != match_end_) {
-      if (predicate(match_iter_->second, current_probe_tuple_)) {
-        // Found a matching tuple that satisfies all conditions
-        return;
-      }
-      ++match_iter_;
-    }
-    right_->nextTuple();
-  } while (!right_->IsEnd());
-  isend_ = true;
+  isend_ = !Advance();
 }
 
 void HashJoinExecutor::nextTuple() {
@@ -181,128 +173,239 @@ void HashJoinExecutor::nextTuple() {
   }
 
   // Hash join
-  while (true) {
-    ++match_iter_;
-    while (match_iter_ == match_end_) {
-      right_->nextTuple();
-      if (right_->IsEnd()) {
-        isend_ = true;
-        return;
-      }
-      current_probe_tuple_ = *(right_->Next());
-      ProbeHashTable();
-    }
-    if (predicate(match_iter_->second, current_probe_tuple_)) {
-      // Found a matching tuple that satisfies all conditions
-      return;
-    }
-    // Else, continue to next matching tuple
-  }
+  isend_ = !Advance();
 }
 
 std::unique_ptr<Tuple> HashJoinExecutor::Next() {
   if (isend_) {
     return nullptr;
   }
+  ConcatCurrent();
+  return std::make_unique<Tuple>(static_cast<int>(joined_tuple_.size()), joined_tuple_.data());
+}
+
+std::optional<TupleView> HashJoinExecutor::NextView() {
+  if (isend_) {
+    return std::nullopt;
+  }
+  ConcatCurrent();
+  return TupleView(joined_tuple_.data(), joined_tuple_.size(), _abstract_rid);
+}
+
+void HashJoinExecutor::beginBatch() {
+  if (use_nested_loop_) {
+    beginTuple();
+    return;
+  }
+  isend_ = false;
+  BuildHashTable();
+}
+
+bool HashJoinExecutor::NextBatch(DataChunk &chunk) {
+  if (use_nested_loop_) {
+    return AbstractExecutor::NextBatch(chunk);
+  }
+  chunk.Reset();
+  while (!isend_ && !chunk.IsFull()) {
+    if (!Advance()) {
+      isend_ = true;
+      break;
+    }
+    ConcatCurrent();
+    chunk.AppendTuple(joined_tuple_.data());
+  }
+  return chunk.GetSize() > 0;
+}
+
+void HashJoinExecutor::ConcatCurrent() {
+  // Combine the current matching left and right tuples
   if (use_nested_loop_) {
-    // Combine the current matching left and right tuples
-    auto left_values = left_buffer_[left_idx_].GetValueVec(&left_->schema());
-    auto right_values = right_buffer_[right_idx_].GetValueVec(&right_->schema());
-    left_values.insert(left_values.end(), right_values.begin(), right_values.end());
-    Tuple joined_tuple(left_values, &schema_);
-    return std::make_unique<Tuple>(std::move(joined_tuple));
+    ConcatTuples(left_buffer_[left_idx_], left_->schema(), right_buffer_[right_idx_], right_->schema(), &joined_tuple_);
   } else {
-    // Hash join
-    auto left_values = match_iter_->second.GetValueVec(&left_->schema());
-    auto right_values = current_probe_tuple_.GetValueVec(&right_->schema());
-    left_values.insert(left_values.end(), right_values.begin(), right_values.end());
-    Tuple joined_tuple(left_values, &schema_);
-    return std::make_unique<Tuple>(std::move(joined_tuple));
+    TupleView left_tuple(current_match_->tuple_, current_match_->tuple_size_, RID());
+    ConcatTuples(left_tuple, left_->schema(), current_probe_tuple_, right_->schema(), &joined_tuple_);
   }
 }
 
 void HashJoinExecutor::BuildHashTable() {
-  // Build the hash table from the left input
-  left_->beginTuple();
-  while (!left_->IsEnd()) {
-    Tuple tuple = *(left_->Next());
-    // Extract join keys
-    std::vector<Value> key_values;
-    for (const auto &col : left_join_cols_) {
-      key_values.push_back(tuple.GetValue(&left_->schema(), col.GetName()));
+  // Build the hash table from the left input, read a batch at a time; past the memory budget every row goes to the
+  // partition files instead
+  hash_table_.Clear();
+  partitions_.clear();
+  probe_file_.reset();
+  spilled_ = false;
+  match_ = nullptr;
+  std::vector<std::unique_ptr<SpillFile>> build_files;
+  DataChunk chunk(left_->schema());
+  for (left_->beginBatch(); left_->NextBatch(chunk);) {
+    for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+      chunk.GetRow(chunk.GetSelected(i), &build_row_);
+      if (!left_keys_.Encode(build_row_.data(), &key_)) {
+        continue;  // a NULL key joins no row
+      }
+      auto key_size = static_cast<uint32_t>(key_.size());
+      hash_t hash = JoinHashTable::Hash(key_.data(), key_size);
+      if (!build_files.empty()) {
+        build_files[PartitionOf(hash, 0)]->Append(build_row_.data(), build_row_.size());
+        continue;
+      }
+      hash_table_.Insert(key_.data(), key_size, hash, build_row_.data(), build_row_.size());
+      if (hash_table_.GetMemoryUsage() > memory_budget_) {
+        build_files = SpillHashTable(0);
+      }
+    }
+  }
+
+  right_->beginBatch();
+  probe_chunk_.Initialize(right_->schema());
+  next_probe_ = 0;
+  if (build_files.empty()) {
+    return;
+  }
+
+  // Partition the right input the same way, then join the partitions one by one
+  spilled_ = true;
+  std::vector<std::unique_ptr<SpillFile>> probe_files(build_files.size());
+  for (auto &file : probe_files) {
+    file = std::make_unique<SpillFile>();
+  }
+  while (right_->NextBatch(probe_chunk_)) {
+    for (uint32_t i = 0; i < probe_chunk_.GetNumSelected(); i++) {
+      probe_chunk_.GetRow(probe_chunk_.GetSelected(i), &probe_row_);
+      if (right_keys_.Encode(probe_row_.data(), &key_)) {
+        hash_t hash = JoinHashTable::Hash(key_.data(), static_cast<uint32_t>(key_.size()));
+        probe_files[PartitionOf(hash, 0)]->Append(probe_row_.data(), probe_row_.size());
+      }
+    }
+  }
+  for (size_t i = 0; i < build_files.size(); i++) {
+    if (build_files[i]->GetNumRows() > 0 && probe_files[i]->GetNumRows() > 0) {
+      partitions_.push_back({std::move(build_files[i]), std::move(probe_files[i]), 1});
+    }
+  }
+}
+
+bool HashJoinExecutor::NextPartition() {
+  // Load the build rows of the next partition; if they are too big for the budget, split the partition again by the
+  // next bits of the hash and go on with its parts
+  while (!partitions_.empty()) {
+    Partition partition = std::move(partitions_.back());
+    partitions_.pop_back();
+    hash_table_.Clear();
+    probe_file_.reset();
+    std::vector<std::unique_ptr<SpillFile>> build_files;
+    SpillFile *build_file = partition.build_.get();
+    for (build_file->StartReading(); build_file->Read(&build_row_);) {
+      left_keys_.Encode(build_row_.data(), &key_);
+      auto key_size = static_cast<uint32_t>(key_.size());
+      hash_t hash = JoinHashTable::Hash(key_.data(), key_size);
+      if (!build_files.empty()) {
+        build_files[PartitionOf(hash, partition.pass_)]->Append(build_row_.data(), build_row_.size());
+        continue;
+      }
+      hash_table_.Insert(key_.data(), key_size, hash, build_row_.data(), build_row_.size());
+      if (hash_table_.GetMemoryUsage() > memory_budget_ && partition.pass_ < HASH_JOIN_MAX_PASSES) {
+        build_files = SpillHashTable(partition.pass_);
+      }
+    }
+    partition.build_.reset();
+    if (build_files.empty()) {
+      probe_file_ = std::move(partition.probe_);
+      probe_file_->StartReading();
+      return true;
+    }
+    std::vector<std::unique_ptr<SpillFile>> probe_files =
+        SplitRows(partition.probe_.get(), right_keys_, partition.pass_);
+    for (size_t i = 0; i < build_files.size(); i++) {
+      if (build_files[i]->GetNumRows() > 0 && probe_files[i]->GetNumRows() > 0) {
+        partitions_.push_back({std::move(build_files[i]), std::move(probe_files[i]), partition.pass_ + 1});
+      }
     }
-    HashJoinKey key{key_values};
-    hash_table_.emplace(key, tuple);
-    left_->nextTuple();
   }
+  hash_table_.Clear();
+  return false;
 }
 
-void HashJoinExecutor::ProbeHashTable() {
-  // Extract join keys from the right tuple
-  std::vector<Value> key_values;
-  for (const auto &col : right_join_cols_) {
-    key_values.push_back(current_probe_tuple_.GetValue(&right_->schema(), col.GetName()));
+auto HashJoinExecutor::SpillHashTable(int pass) -> std::vector<std::unique_ptr<SpillFile>> {
+  // the rows of the table go to the partitions, and the table is emptied
+  std::vector<std::unique_ptr<SpillFile>> files(1U << HASH_JOIN_PARTITION_BITS);
+  for (auto &file : files) {
+    file = std::make_unique<SpillFile>();
   }
-  HashJoinKey key{key_values};
-  auto range = hash_table_.equal_range(key);
-  match_iter_ = range.first;
-  match_end_ = range.second;
+  for (size_t i = 0; i < hash_table_.GetNumEntries(); i++) {
+    const JoinHashTable::Entry &entry = hash_table_.GetEntry(i);
+    files[PartitionOf(entry.hash_, pass)]->Append(entry.tuple_, entry.tuple_size_);
+  }
+  hash_table_.Clear();
+  return files;
 }
 
-bool HashJoinExecutor::predicate(const Tuple &left_tuple, const Tuple &right_tuple) {
-  for (const auto &cond : conds_) {
-    Value lhs_v, rhs_v;
-    if (!cond.is_rhs_val) {
-      // Both sides are columns
-      // If the left or right is a join executor, then the table name will be join_tab_name instead of tab_name in the
-      // condition. We assume that there must be a raw table name from the left or right executor, that means one side
-      // must not be join executor.
-      if (cond.lhs_col.tab_name == left_tab_name_ || cond.rhs_col.tab_name == right_tab_name_) {
-        lhs_v = left_tuple.GetValue(&left_->schema(), cond.lhs_col.col_name);
-        rhs_v = right_tuple.GetValue(&right_->schema(), cond.rhs_col.col_name);
-      } else if (cond.lhs_col.tab_name == right_tab_name_ || cond.rhs_col.tab_name == left_tab_name_) {
-        lhs_v = right_tuple.GetValue(&right_->schema(), cond.lhs_col.col_name);
-        rhs_v = left_tuple.GetValue(&left_->schema(), cond.rhs_col.col_name);
-      } else {
-        throw InternalError("Unknown table in condition (lhs or rhs)");
+auto HashJoinExecutor::SplitRows(SpillFile *file, const JoinKeyEncoder &key_cols, int pass)
+    -> std::vector<std::unique_ptr<SpillFile>> {
+  std::vector<std::unique_ptr<SpillFile>> files(1U << HASH_JOIN_PARTITION_BITS);
+  for (auto &part : files) {
+    part = std::make_unique<SpillFile>();
+  }
+  std::vector<char> row;
+  for (file->StartReading(); file->Read(&row);) {
+    key_cols.Encode(row.data(), &key_);
+    hash_t hash = JoinHashTable::Hash(key_.data(), static_cast<uint32_t>(key_.size()));
+    files[PartitionOf(hash, pass)]->Append(row.data(), row.size());
+  }
+  return files;
+}
+
+bool HashJoinExecutor::NextProbeTuple() {
+  while (true) {
+    if (spilled_) {
+      if (probe_file_ != nullptr && probe_file_->Read(&probe_row_)) {
+        return true;
       }
-    } else {
-      // Right-hand side is a value
-      if (cond.lhs_col.tab_name == left_tab_name_) {
-        lhs_v = left_tuple.GetValue(&left_->schema(), cond.lhs_col.col_name);
-      } else if (cond.lhs_col.tab_name == right_tab_name_) {
-        lhs_v = right_tuple.GetValue(&right_->schema(), cond.lhs_col.col_name);
-      } else {
-        throw InternalError("Unknown table in condition (lhs)");
+      if (!NextPartition()) {
+        return false;
       }
-      rhs_v = cond.rhs_val;
+      continue;
+    }
+    if (hash_table_.GetNumEntries() == 0) {
+      return false;  // nothing to join with
+    }
+    if (next_probe_ < probe_chunk_.GetNumSelected()) {
+      probe_chunk_.GetRow(probe_chunk_.GetSelected(next_probe_++), &probe_row_);
+      return true;
     }
+    if (!right_->NextBatch(probe_chunk_)) {
+      return false;
+    }
+    next_probe_ = 0;
+  }
+}
 
-    // Evaluate the condition based on the operator
-    bool condition_satisfied = false;
-    switch (cond.op) {
-      case OP_EQ:
-        condition_satisfied = (lhs_v.CompareEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_NE:
-        condition_satisfied = (lhs_v.CompareNotEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_LT:
-        condition_satisfied = (lhs_v.CompareLessThan(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_GT:
-        condition_satisfied = (lhs_v.CompareGreaterThan(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_LE:
-        condition_satisfied = (lhs_v.CompareLessThanEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      case OP_GE:
-        condition_satisfied = (lhs_v.CompareGreaterThanEquals(rhs_v) == CmpBool::CmpTrue);
-        break;
-      default:
-        throw InternalError("Unsupported operator in condition.");
+bool HashJoinExecutor::Advance() {
+  // the next pair of the current probe tuple and an entry of its key that satisfies every condition, moving on to the
+  // next probe tuple once the entries of the key are used up
+  while (true) {
+    while (match_ != nullptr) {
+      const JoinHashTable::Entry *entry = match_;
+      match_ = hash_table_.Next(match_);
+      if (predicate(TupleView(entry->tuple_, entry->tuple_size_, RID()), current_probe_tuple_)) {
+        current_match_ = entry;
+        return true;
+      }
     }
-    if (!condition_satisfied) {
+    if (!NextProbeTuple()) {
+      return false;
+    }
+    current_probe_tuple_ = TupleView(probe_row_.data(), probe_row_.size(), RID());
+    if (right_keys_.Encode(probe_row_.data(), &key_)) {
+      auto key_size = static_cast<uint32_t>(key_.size());
+      match_ = hash_table_.Find(key_.data(), key_size, JoinHashTable::Hash(key_.data(), key_size));
+    }
+  }
+}
+
+bool HashJoinExecutor::predicate(const TupleView &left_tuple, const TupleView &right_tuple) {
+  for (size_t i = 0; i < conds_.size(); i++) {
+    if (!compiled_conds_[i].EvaluateJoin(conds_[i], left_tuple.GetData(), right_tuple.GetData())) {
       return false;  // Condition not satisfied
     }
   }
@@ -315,15 +418,15 @@ void HashJoinExecutor::NestedLoopBegin() {
   right_buffer_.clear();
 
   for (left_->beginTuple(); !left_->IsEnd(); left_->nextTuple()) {
-    left_buffer_.emplace_back(*(left_->Next()));
+    left_buffer_.push_back(left_->NextInArena());
   }
 
   for (right_->beginTuple(); !right_->IsEnd(); right_->nextTuple()) {
-    right_buffer_.emplace_back(*(right_->Next()));
+    right_buffer_.push_back(right_->NextInArena());
   }
   left_idx_ = 0;
   right_idx_ = 0;
-  isend_ = false;
+  isend_ = left_buffer_.empty() || right_buffer_.empty();
 
   // Find the first pair that satisfies the conditions
   while (!isend_) {
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include "common/errors.h"
+#include "compiled_condition.h"
 #include "defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -35,18 +36,26 @@ class IndexScanExecutor : public AbstractExecutor {
   Schema schema_;                     // scan后生成的记录的字段
   size_t len_;                        // 选取出来的一条记录的长度
   std::vector<Condition> fed_conds_;  // 扫描条件，不一定和conds_字段相同(取决于索引的选择)
+  std::vector<CompiledCondition> compiled_conds_;  // conds_ resolved against schema_, in the same order
 
   std::vector<std::string> index_col_names_;  // index scan涉及到的索引包含的字段
   IndexMeta index_meta_;                      // index scan涉及到的索引元数据
 
+  std::vector<uint32_t> toast_cols_;  // the VARCHAR columns whose toasted values are read back, by offset
+
   RID rid_;
   std::unique_ptr<IxScan> scan_;
 
   SmManager *sm_manager_;
 
  public:
+  /**
+   * @param read_cols the columns the operators above the scan use, only their toasted values are read back;
+   * nullptr for all of them
+   */
   IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
-                    std::vector<std::string> index_col_names, Context *context);
+                    std::vector<std::string> index_col_names, Context *context,
+                    const std::vector<std::string> *read_cols = nullptr);
 
   std::string getTabName() const override { return tab_name_; }
 
@@ -67,7 +76,7 @@ class IndexScanExecutor : public AbstractExecutor {
 
   std::unique_ptr<Tuple> Next() override {
     // assert(!IsEnd());
-    return fh_->GetTupleValue(rid_, context_);
+    return fh_->GetTupleValue(rid_, context_, &toast_cols_);
   }
 
  private:
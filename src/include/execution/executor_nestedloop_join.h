@@ -11,6 +11,7 @@
 #include "common/common.h"
 #include "common/errors.h"
 #include "common/mergeSorter.h"
+#include "compiled_condition.h"
 #include "defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
@@ -34,18 +35,19 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   Schema schema_;  // scan后生成的记录的字段
 
   std::vector<Condition> fed_conds_;  // join条件
+  std::vector<CompiledCondition> compiled_conds_;  // fed_conds_ resolved against the schemas of the children
   bool isend;
 
   // RmRecord joined_records_;
-  Tuple joined_records_;
+  std::vector<char> joined_records_;  // the current joined tuple, its memory reused by every row
 
   // std::vector<RmRecord> left_buffer_;
   // std::vector<RmRecord> right_buffer_;
   // ColMeta left_sel_col_;
   // ColMeta right_sel_col_;
 
-  std::vector<Tuple> left_buffer_;
-  std::vector<Tuple> right_buffer_;
+  std::vector<TupleView> left_buffer_;  // copies of the tuples of the children, in the arena of the query
+  std::vector<TupleView> right_buffer_;
   Column left_sel_colu_;
   Column right_sel_colu_;
   std::unique_ptr<MergeSorter> leftSorter_;
@@ -85,7 +87,13 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   void nextTuple() override;
 
-  std::unique_ptr<Tuple> Next() override { return std::make_unique<Tuple>(std::move(joined_records_)); }
+  std::unique_ptr<Tuple> Next() override {
+    return std::make_unique<Tuple>(static_cast<int>(joined_records_.size()), joined_records_.data());
+  }
+
+  std::optional<TupleView> NextView() override {
+    return TupleView(joined_records_.data(), joined_records_.size(), _abstract_rid);
+  }
 
   RID &rid() override { return _abstract_rid; }
 
@@ -117,7 +125,7 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   }
 
  private:
-  bool predicate(const Tuple &left_tuple, const Tuple &right_tuple);
+  bool predicate(const TupleView &left_tuple, const TupleView &right_tuple);
 
   void sorted_iterate_helper();
 
@@ -126,6 +134,6 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   void iterate_next();
 
   // RmRecord concat_records();
-  Tuple concat_records();
+  void concat_records();
 };
 }  // namespace easydb
@@ -0,0 +1,153 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * executor_parallel_hash_join.h
+ *
+ * Identification: src/include/execution/executor_parallel_hash_join.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/condition.h"
+#include "compiled_condition.h"
+#include "execution/join_hash_table.h"
+#include "execution/worker_pool.h"
+#include "executor_abstract.h"
+#include "storage/table/tuple.h"
+
+namespace easydb {
+
+/**
+ * Joins the left child (the build side) with the right child (the probe side) like HashJoinExecutor, on a pool of
+ * worker threads.
+ *
+ * The children are read by the thread of the query, a batch at a time, each batch copied into a morsel the workers
+ * take from a shared counter. The build is radix partitioned: the workers first sort the rows of the morsels they
+ * take into 2^PARALLEL_HASH_JOIN_PARTITION_BITS lists by the top bits of the hash of their key, then each partition
+ * gets its own JoinHashTable, built by a single worker, so that no table is shared while it is written. The right
+ * child is probed a round of morsels at a time, every worker appending the rows it joins to its own output buffer,
+ * which the executor hands out once the round is over. A worker takes no more morsels in a round once its buffer
+ * holds its share of `output_budget` bytes; the morsels left over start the next round, so a key that joins many rows
+ * holds at most the budget and the output of one morsel per worker in memory.
+ *
+ * The build side is held in memory whatever its size: the planner only chooses this join when the left input is
+ * expected to fit in HASH_JOIN_MEMORY_BUDGET. Without an equality to hash on, every row has the same empty key, and
+ * the join tests its conditions on every pair of rows like a nested loop join.
+ */
+class ParallelHashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * @param num_threads the workers, 0 for as many as there are cores up to PARALLEL_HASH_JOIN_THREADS
+   * @param output_budget the bytes of joined rows the workers may buffer in a round, all of them together
+   */
+  ParallelHashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                           std::vector<Condition> conds, size_t num_threads = 0,
+                           size_t output_budget = PARALLEL_HASH_JOIN_OUTPUT_BUDGET);
+
+  void beginTuple() override;
+  void nextTuple() override;
+  std::unique_ptr<Tuple> Next() override;
+  std::optional<TupleView> NextView() override;
+  void beginBatch() override;
+  bool NextBatch(DataChunk &chunk) override;
+  RID &rid() override { return _abstract_rid; }
+
+  size_t tupleLen() const override { return len_; }
+  const Schema &schema() const override { return schema_; }
+  std::string getTabName() const override { return join_tab_name_; }
+
+  bool IsEnd() const override { return isend_; }
+
+  inline auto GetNumThreads() const -> size_t { return pool_.GetNumThreads(); }
+
+ private:
+  /** Rows stored back to back: a batch of a child, or the rows a worker joined */
+  struct Morsel {
+    std::vector<char> data_;
+    std::vector<size_t> offsets_{0};  // where each row starts, and where the last one ends
+
+    inline auto GetNumRows() const -> size_t { return offsets_.size() - 1; }
+
+    inline auto GetRow(size_t idx) const -> TupleView {
+      return TupleView(data_.data() + offsets_[idx], static_cast<uint32_t>(offsets_[idx + 1] - offsets_[idx]), RID());
+    }
+
+    inline void Append(const char *row, size_t size) {
+      data_.insert(data_.end(), row, row + size);
+      offsets_.push_back(data_.size());
+    }
+
+    inline void Clear() {
+      data_.clear();
+      offsets_.resize(1);
+    }
+  };
+
+  /** A row of the build side with the hash of its key, on its way to the table of its partition */
+  struct BuildRow {
+    const char *tuple_;
+    uint32_t size_;
+    hash_t hash_;
+  };
+
+  /** @brief Build the tables of the partitions from the left child, and start reading the right one. */
+  void Build();
+
+  /**
+   * @brief Read up to `max_morsels` batches of a child into `morsels`, one morsel a batch.
+   * @return the morsels filled, 0 once the child has no more rows
+   */
+  auto ReadMorsels(AbstractExecutor *child, std::vector<Morsel> *morsels, size_t max_morsels) -> size_t;
+
+  /**
+   * @brief Probe the next round of morsels into the outputs of the workers: the morsels the last round left over, or
+   * new ones of the right child.
+   */
+  auto ProbeRound() -> bool;
+
+  /** @brief Move to the next joined row, probing another round once the outputs are used up. */
+  auto Advance() -> bool;
+
+  bool predicate(const char *left_tuple, const char *right_tuple);
+
+  /** @return the partition of a key with `hash`, by its top bits; the tables index their slots by the low ones */
+  static inline auto PartitionOf(hash_t hash) -> size_t {
+    return static_cast<uint64_t>(hash) >> (64 - PARALLEL_HASH_JOIN_PARTITION_BITS);
+  }
+
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  std::string left_tab_name_;
+  std::string right_tab_name_;
+  std::string join_tab_name_;
+  size_t len_;
+  Schema schema_;
+  std::vector<Condition> conds_;
+  std::vector<CompiledCondition> compiled_conds_;  // conds_ resolved against the schemas of the children
+  JoinKeyEncoder left_keys_;                       // the join columns of each side, in the same order
+  JoinKeyEncoder right_keys_;
+  bool isend_{false};
+
+  WorkerPool pool_;
+  std::vector<JoinHashTable> tables_;  // the table of each partition of the left child
+  size_t num_build_rows_{0};
+
+  std::vector<Morsel> probe_morsels_;  // the morsels of the right child being probed, reused by every round
+  size_t num_probe_morsels_{0};        // the morsels in probe_morsels_
+  size_t next_probe_morsel_{0};        // the first one no round has probed yet
+  size_t worker_output_budget_;        // the bytes a worker buffers in a round before it stops taking morsels
+  bool probe_done_{false};             // the right child has no more rows
+  std::vector<Morsel> outputs_;        // the rows each worker joined in the current round
+  size_t output_worker_{0};            // the output the next row is taken from
+  size_t output_row_{0};
+  TupleView current_;  // the current joined row
+};
+
+}  // namespace easydb
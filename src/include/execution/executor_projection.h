@@ -33,6 +33,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
   std::unordered_set<std::string> seen_;
 
+  DataChunk prev_chunk_;  // the batch of the child the columns of a batch are taken from
+
   bool is_unique_;  // 是否select unique的结果集
 
  public:
@@ -44,6 +46,11 @@ class ProjectionExecutor : public AbstractExecutor {
   void nextTuple() override;
 
   std::unique_ptr<Tuple> Next() override;
+
+  void beginBatch() override;
+
+  /** A batch is the batch of the child, showing the projected columns of it without copying them. */
+  bool NextBatch(DataChunk &chunk) override;
   // std::unique_ptr<RmRecord> Next() override { return std::make_unique<RmRecord>(projection_records_); }
 
   RID &rid() override { return _abstract_rid; }
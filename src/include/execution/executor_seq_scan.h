@@ -12,9 +12,11 @@
 #include "catalog/schema.h"
 #include "common/condition.h"
 #include "common/errors.h"
+#include "compiled_condition.h"
 #include "defs.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
+#include "filter_kernels.h"
 #include "storage/index/ix_manager.h"
 #include "storage/index/ix_scan.h"
 #include "system/sm_defs.h"
@@ -31,14 +33,46 @@ class SeqScanExecutor : public AbstractExecutor {
   Schema schema_;                     // scan后生成的记录的字段
   size_t len_;                        // scan后生成的每条记录的长度
   std::vector<Condition> fed_conds_;  // 同conds_，两个字段相同
+  std::vector<CompiledCondition> compiled_conds_;  // conds_ resolved against schema_, in the same order
+
+  // the conditions on constants, which NextBatch() tests over the columns of a batch rather than record by record
+  std::vector<std::pair<uint32_t, size_t>> vector_conds_;  // the column and the index in conds_ of each filter
+  std::vector<bool> is_vector_cond_;                       // by index in conds_
+  std::vector<std::unique_ptr<FilterKernel>> filter_kernels_;  // the kernel of each of vector_conds_, or nullptr
+  std::vector<uint64_t> filter_bitmap_;                        // the rows of a batch that pass all the kernels
+  std::vector<uint64_t> cond_bitmap_;                          // the rows of a batch that pass one kernel
 
   RID rid_;
-  std::unique_ptr<RecScan> scan_;  // table_iterator
+  std::unique_ptr<RmScan> scan_;  // table_iterator, keeps the page of rid_ pinned
+  std::vector<TupleView> batch_;  // the live records of the scan's current page
+  size_t batch_pos_{0};           // the record of rid_ in batch_
+  std::unique_ptr<BufferAccessStrategy> strategy_;  // buffer ring, only for tables larger than 1/4 of the pool
+
+  // column by column filtering of a table stored in PAX pages (CREATE TABLE ... WITH (storage = column))
+  std::vector<std::pair<uint32_t, size_t>> column_conds_;  // the column and the index in conds_ of each filter
+  RmColumnBatch column_batch_;                             // the minipages of the scan's current page
+  std::vector<uint32_t> selected_;                         // the slots of the page that passed the filters so far
+
+  // page skipping by the zone map of the table
+  std::vector<std::pair<size_t, size_t>> zone_conds_;  // the zone map column and the index in conds_ of each filter
+  std::vector<std::pair<Value, Value>> zones_;         // the ranges of the page the filters are tested on
+
+  // the long VARCHAR values kept in the toast of the table
+  RmToast *toast_{nullptr};              // nullptr if no column the scan reads can be toasted
+  std::vector<uint32_t> toast_cols_;     // the columns read back from the toast, by offset
+  bool detoast_before_predicate_{false};  // a condition tests a column that can be toasted
+  TupleView tuple_;                       // the record of rid_, in the page or in detoasted_
+  std::vector<char> detoasted_;           // the record of rid_ with its toasted values read back
 
   SmManager *sm_manager_;
 
  public:
-  SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context);
+  /**
+   * @param read_cols the columns the operators above the scan use, only their toasted values are read back;
+   * nullptr for all of them
+   */
+  SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context,
+                  const std::vector<std::string> *read_cols = nullptr);
   // SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds);
 
   void beginTuple() override;
@@ -47,6 +81,18 @@ class SeqScanExecutor : public AbstractExecutor {
 
   std::unique_ptr<Tuple> Next() override;
 
+  std::optional<TupleView> NextView() override;
+
+  void beginBatch() override;
+
+  /**
+   * The records of a batch are locked, read back from the toast and tested on the conditions that need a whole
+   * record (subqueries, two columns) one at a time as they are appended; the conditions on constants and literal IN
+   * lists are then run column by column over the batch, by a FilterKernel where there is one, and narrow its
+   * selection.
+   */
+  bool NextBatch(DataChunk &chunk) override;
+
   RID &rid() override { return rid_; }
 
   bool IsEnd() const override { return scan_->IsEnd(); };
@@ -69,6 +115,23 @@ class SeqScanExecutor : public AbstractExecutor {
   std::string getTabName() const override { return tab_name_; }
 
  private:
-  bool predicate();
+  /** @param skip_vector_conds leave the conditions of vector_conds_ to NextBatch() */
+  bool predicate(bool skip_vector_conds = false);
+
+  /** Move to the next record, fetching the next page's batch once the current one is used up. */
+  void advance();
+
+  /**
+   * Fill batch_ from the scan's current page. On a PAX table, the conditions on constants are run over the
+   * minipages of their columns first, and only the records that pass them are put together; pages without any
+   * are skipped.
+   */
+  void fetchBatch();
+
+  /** @return false if the zone map shows that no record of the page can satisfy the conditions on constants */
+  bool pageMayMatch(page_id_t page_no);
+
+  /** Read the toasted values of toast_cols_ in tuple_ back. */
+  void detoast();
 };
 }  // namespace easydb
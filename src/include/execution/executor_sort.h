@@ -55,6 +55,8 @@ class SortExecutor : public AbstractExecutor {
   }
   // std::unique_ptr<RmRecord> Next() override { return std::move(current_tuple); }
 
+  bool NextBatch(DataChunk &chunk) override;
+
   RID &rid() override { return _abstract_rid; }
 
   // const std::vector<ColMeta> &cols() const override { return prev_->cols(); };
@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * filter_kernels.h
+ *
+ * Identification: src/include/execution/filter_kernels.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/condition.h"
+#include "execution/data_chunk.h"
+#include "type/type_id.h"
+
+namespace easydb {
+
+/** The instructions a FilterKernel runs with, each level a superset of the one before it. */
+enum class SimdLevel { SCALAR, SSE42, AVX2 };
+
+/**
+ * A condition between a column and constants (any CompOp, or IN a list of literals) tested on a whole column of a
+ * batch at once, with the result written as a bitmap of its rows.
+ *
+ * INT, BIGINT, FLOAT and DOUBLE columns are compared 4 to 8 values an instruction with SSE4.2 or AVX2, whichever the
+ * CPU has (the kernels are compiled for both and picked at run time, the build needs no -m flags), and one value at a
+ * time otherwise. A string column is compared by the first 8 bytes of its values, loaded as one number, so that only
+ * the values that share their prefix with the constant are compared in full. The result is the one
+ * Condition::satisfy gives on the Values, NULL failing every operator.
+ */
+class FilterKernel {
+ public:
+  /**
+   * @param cond a condition with a constant or a list of literals on its right-hand side
+   * @param type the type of the column on its left-hand side
+   * @return the kernel, nullptr if the types of the column and the constants are not ones a kernel compares (e.g. an
+   * INT column against a DOUBLE constant), which are left to CompiledCondition
+   */
+  static auto Create(const Condition &cond, TypeId type) -> std::unique_ptr<FilterKernel>;
+
+  /** @return the widest level the CPU supports, SCALAR if ENABLE_SIMD_FILTERS is off */
+  static auto GetSimdLevel() -> SimdLevel;
+
+  /**
+   * @brief Test the condition on the first `num_rows` values of `column`.
+   * @param[out] bitmap (num_rows + 63) / 64 words, bit i set if value i satisfies the condition and clear otherwise
+   * @param level the instructions to use, no wider than GetSimdLevel()
+   */
+  void Evaluate(const ColumnVector &column, uint32_t num_rows, uint64_t *bitmap) const {
+    Evaluate(column, num_rows, bitmap, GetSimdLevel());
+  }
+  void Evaluate(const ColumnVector &column, uint32_t num_rows, uint64_t *bitmap, SimdLevel level) const;
+
+  /** @return the words of a bitmap of `num_rows` rows */
+  static inline auto BitmapWords(uint32_t num_rows) -> size_t { return (num_rows + 63) / 64; }
+
+ private:
+  FilterKernel(TypeId type, CompOp op) : type_(type), op_(op) {}
+
+  TypeId type_;  // the type of the column
+  CompOp op_;
+  // the constant, or the literals of an IN list, in the C++ type the column is compared as; NULLs are left out
+  std::vector<int32_t> ints_;
+  std::vector<int64_t> longs_;
+  std::vector<double> doubles_;
+  std::vector<std::string> strings_;
+};
+
+}  // namespace easydb
@@ -0,0 +1,140 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * join_hash_table.h
+ *
+ * Identification: src/include/execution/join_hash_table.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/arena.h"
+#include "common/condition.h"
+#include "common/config.h"
+#include "common/hashutil.h"
+#include "storage/table/tuple_accessor.h"
+
+namespace easydb {
+
+/**
+ * @brief The join columns of one side of a hash join, written into the bytes of a key so that equal values of the two
+ * sides have the same bytes: INT and BIGINT as int64, a number compared with a FLOAT or a DOUBLE as a double, strings
+ * as their storage and dates as they are.
+ */
+class JoinKeyEncoder {
+ public:
+  /**
+   * @brief Resolve the equalities between a column of each child of a join into the encoders of the two sides, in
+   * the same order. A pair of types whose values never have the same key (e.g. a date and a string) is left out: the
+   * join has to test its conditions on every pair of rows with the same key anyway.
+   */
+  static void ForJoin(const std::vector<Condition> &conds, const std::string &left_tab_name, const Schema &left_schema,
+                      const std::string &right_tab_name, const Schema &right_schema, JoinKeyEncoder *left,
+                      JoinKeyEncoder *right);
+
+  /** @return true if there is no join column, and so no hash join */
+  inline auto IsEmpty() const -> bool { return cols_.empty(); }
+
+  /**
+   * @brief Write the key of a tuple.
+   * @param[out] key the bytes of the key, resized to fit
+   * @return false if a join column is NULL, which joins no row
+   */
+  auto Encode(const char *tuple, std::vector<char> *key) const -> bool;
+
+ private:
+  enum class KeyKind { INT64, DOUBLE, DATE, STRING };
+
+  struct KeyColumn {
+    ColumnAccessor accessor_;
+    KeyKind kind_;
+  };
+
+  std::vector<KeyColumn> cols_;
+};
+
+/**
+ * @brief The build side of a hash join: tuples indexed by the bytes of their join key.
+ *
+ * The tuples and their keys are copied into an arena. The index is open addressing with linear probing over a power
+ * of two array of 64-bit slots, one slot per distinct key, packing a 32-bit fingerprint of the hash and the first
+ * entry of the key. The entries of a key are chained through the entries themselves. The slots double once half of
+ * them are used.
+ */
+class JoinHashTable {
+ public:
+  struct Entry {
+    const char *key_;
+    const char *tuple_;
+    hash_t hash_;
+    uint32_t key_size_;
+    uint32_t tuple_size_;
+    uint32_t next_;  // the next entry of the same key + 1, 0 for the last one
+  };
+
+  JoinHashTable();
+
+  JoinHashTable(const JoinHashTable &) = delete;
+  auto operator=(const JoinHashTable &) -> JoinHashTable & = delete;
+
+  /** @return the hash of a key */
+  static inline auto Hash(const char *key, uint32_t key_size) -> hash_t { return HashUtil::HashKey(key, key_size); }
+
+  /**
+   * @brief Add a tuple under a key, both copied into the table.
+   * @param hash Hash(key, key_size)
+   */
+  void Insert(const char *key, uint32_t key_size, hash_t hash, const char *tuple, uint32_t tuple_size);
+
+  /**
+   * @return the first entry of `key`, nullptr if there is none. Valid until the next Insert() or Clear().
+   * @param hash Hash(key, key_size)
+   */
+  auto Find(const char *key, uint32_t key_size, hash_t hash) const -> const Entry *;
+
+  /** @return the entry of the same key after `entry`, nullptr after the last one */
+  inline auto Next(const Entry *entry) const -> const Entry * {
+    return entry->next_ == 0 ? nullptr : &entries_[entry->next_ - 1];
+  }
+
+  inline auto GetNumEntries() const -> size_t { return entries_.size(); }
+
+  inline auto GetEntry(size_t idx) const -> const Entry & { return entries_[idx]; }
+
+  /** @return the bytes the table uses: its slots, its entries and the tuples and keys they point to */
+  inline auto GetMemoryUsage() const -> size_t {
+    return slots_.size() * sizeof(uint64_t) + entries_.size() * sizeof(Entry) + arena_.GetBytesAllocated();
+  }
+
+  /** @brief Drop every entry. */
+  void Clear();
+
+ private:
+  static constexpr size_t INITIAL_SLOTS = 1024;
+  static constexpr uint64_t EMPTY = 0;
+  static constexpr uint64_t ENTRY_MASK = 0xffffffff;
+
+  /** @brief The slot value of an entry: the fingerprint and the entry + 1, so that no slot in use is EMPTY. */
+  static inline auto MakeSlot(hash_t hash, size_t entry) -> uint64_t {
+    return ((static_cast<uint64_t>(hash) >> 32) << 32) | (static_cast<uint64_t>(entry) + 1);
+  }
+
+  /** @brief Double the slots and index the first entry of every key again. */
+  void Grow();
+
+  std::vector<uint64_t> slots_;
+  size_t mask_;
+  size_t num_keys_{0};
+  std::vector<Entry> entries_;
+  Arena arena_;  // the keys and tuples of the entries
+};
+
+}  // namespace easydb
@@ -0,0 +1,58 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * spill_file.h
+ *
+ * Identification: src/include/execution/spill_file.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace easydb {
+
+/**
+ * @brief A temp file an executor writes rows to when they do not fit in memory, and reads back in the same order.
+ *
+ * Each row is stored as [uint32_t size][bytes]. The file is an anonymous one from tmpfile(), buffered by stdio and
+ * removed by the system when it is closed, so a query that fails leaves nothing behind.
+ */
+class SpillFile {
+ public:
+  SpillFile();
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  auto operator=(const SpillFile &) -> SpillFile & = delete;
+
+  /** @brief Append a row. Not after StartReading(). */
+  void Append(const char *data, uint32_t size);
+
+  /** @brief Go back to the first row, for Read(). */
+  void StartReading();
+
+  /**
+   * @brief Read the next row.
+   * @param[out] out the bytes of the row, resized to fit
+   * @return false once every row was read
+   */
+  auto Read(std::vector<char> *out) -> bool;
+
+  inline auto GetNumRows() const -> size_t { return num_rows_; }
+
+  /** @return the bytes of the rows appended, sizes included */
+  inline auto GetNumBytes() const -> size_t { return num_bytes_; }
+
+ private:
+  std::FILE *file_;
+  size_t num_rows_{0};
+  size_t num_bytes_{0};
+};
+
+}  // namespace easydb
@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * worker_pool.h
+ *
+ * Identification: src/include/execution/worker_pool.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace easydb {
+
+/**
+ * @brief Threads an executor keeps for the life of a query to run the steps of an operator in parallel.
+ *
+ * Run() hands the same task to every worker and returns once all of them are done; the calling thread is worker 0,
+ * so a pool of one thread starts none. The workers split the work among themselves, e.g. by taking morsels from a
+ * shared atomic counter.
+ */
+class WorkerPool {
+ public:
+  /** A step of an operator, given the number of the worker that runs it, 0 .. GetNumThreads() - 1 */
+  using Task = std::function<void(size_t worker)>;
+
+  /** @param num_threads the workers, the calling thread included */
+  explicit WorkerPool(size_t num_threads);
+
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  auto operator=(const WorkerPool &) -> WorkerPool & = delete;
+
+  inline auto GetNumThreads() const -> size_t { return threads_.size() + 1; }
+
+  /**
+   * @brief Run `task` on every worker and wait for all of them.
+   * @throws the first exception a worker threw, once every worker finished
+   */
+  void Run(const Task &task);
+
+ private:
+  void WorkerLoop(size_t worker);
+
+  /** @brief Record the exception being handled, if it is the first of the current task. */
+  void SetError();
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const Task *task_{nullptr};  // the task being run
+  uint64_t generation_{0};     // counts the tasks, so that a worker runs each one once
+  size_t num_running_{0};      // the workers still running the task
+  bool stop_{false};
+  std::exception_ptr error_;
+};
+
+}  // namespace easydb
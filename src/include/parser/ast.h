@@ -43,6 +43,16 @@ struct ShowIndex : public TreeNode {
   ShowIndex(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
 };
 
+struct ShowBufferStats : public TreeNode {};
+
+struct ShowIoStats : public TreeNode {};
+
+struct Vacuum : public TreeNode {
+  std::string tab_name;
+
+  Vacuum(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
+};
+
 struct TxnBegin : public TreeNode {};
 
 struct TxnCommit : public TreeNode {};
@@ -74,9 +84,11 @@ struct ColDef : public Field {
 struct CreateTable : public TreeNode {
   std::string tab_name;
   std::vector<std::shared_ptr<Field>> fields;
+  std::vector<std::pair<std::string, std::string>> options;  // WITH (name = value), e.g. storage = column
 
-  CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_)
-      : tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+  CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_,
+              std::vector<std::pair<std::string, std::string>> options_ = {})
+      : tab_name(std::move(tab_name_)), fields(std::move(fields_)), options(std::move(options_)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -141,12 +141,25 @@ class TreeDotPrinter {
       int _node_id = alloc_node("SHOW_INDEX");
       print_edge(_node_id, parent);
       print_val(x->tab_name, _node_id);
+    } else if (auto x = std::dynamic_pointer_cast<ShowBufferStats>(node)) {
+      int _node_id = alloc_node("SHOW_BUFFER_STATS");
+      print_edge(_node_id, parent);
+    } else if (auto x = std::dynamic_pointer_cast<ShowIoStats>(node)) {
+      int _node_id = alloc_node("SHOW_IO_STATS");
+      print_edge(_node_id, parent);
+    } else if (auto x = std::dynamic_pointer_cast<Vacuum>(node)) {
+      int _node_id = alloc_node("VACUUM");
+      print_edge(_node_id, parent);
+      print_val(x->tab_name, _node_id);
     } else if (auto x = std::dynamic_pointer_cast<CreateTable>(node)) {
       // std::cout << "CREATE_TABLE" << std::endl;
       int _node_id = alloc_node("CREATE_TABLE");
       print_edge(_node_id, parent);
       print_val(x->tab_name, _node_id);
       print_node_list(x->fields, _node_id);
+      for (auto &[name, value] : x->options) {
+        print_val(name + " = " + value, _node_id);
+      }
     } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
       // std::cout << "DROP_TABLE" << std::endl;
       int _node_id = alloc_node("DROP_TABLE");
@@ -80,10 +80,20 @@ class TreePrinter {
     } else if (auto x = std::dynamic_pointer_cast<ShowIndex>(node)) {
       std::cout << "SHOW_INDEX" << std::endl;
       print_val(x->tab_name, offset);
+    } else if (auto x = std::dynamic_pointer_cast<ShowBufferStats>(node)) {
+      std::cout << "SHOW_BUFFER_STATS" << std::endl;
+    } else if (auto x = std::dynamic_pointer_cast<ShowIoStats>(node)) {
+      std::cout << "SHOW_IO_STATS" << std::endl;
+    } else if (auto x = std::dynamic_pointer_cast<Vacuum>(node)) {
+      std::cout << "VACUUM" << std::endl;
+      print_val(x->tab_name, offset);
     } else if (auto x = std::dynamic_pointer_cast<CreateTable>(node)) {
       std::cout << "CREATE_TABLE" << std::endl;
       print_val(x->tab_name, offset);
       print_node_list(x->fields, offset);
+      for (auto &[name, value] : x->options) {
+        print_val(name + " = " + value, offset);
+      }
     } else if (auto x = std::dynamic_pointer_cast<DropTable>(node)) {
       std::cout << "DROP_TABLE" << std::endl;
       print_val(x->tab_name, offset);
@@ -29,6 +29,9 @@ typedef enum PlanTag {
   T_Help,
   T_ShowTable,
   T_ShowIndex,
+  T_ShowBufferStats,
+  T_ShowIoStats,
+  T_Vacuum,
   T_DescTable,
   T_CreateTable,
   T_DropTable,
@@ -51,6 +54,7 @@ typedef enum PlanTag {
   T_SortMerge,   // sort merge join
   T_IndexMerge,  // merge join using index
   T_HashJoin,
+  T_ParallelHashJoin,  // hash join on a pool of worker threads
   T_Sort,
   T_Projection,
   T_Aggregation,
@@ -100,6 +104,9 @@ class ScanPlan : public Plan {
   size_t len_;
   std::vector<Condition> fed_conds_;
   std::vector<std::string> index_col_names_;
+  // 上层算子用到的字段，只有这些VARCHAR字段（以及条件中的字段）的toast值才需要读回
+  std::vector<std::string> read_cols_;
+  bool reads_all_cols_ = true;  // 为true时read_cols_无效，所有字段都要读回
 };
 
 class JoinPlan : public Plan {
@@ -218,6 +225,7 @@ class DDLPlan : public Plan {
   std::string tab_name_;
   std::vector<std::string> tab_col_names_;
   std::vector<ColDef> cols_;
+  bool column_storage_{false};  // CREATE TABLE ... WITH (storage = column)
 };
 
 // load data语句对应的plan
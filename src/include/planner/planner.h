@@ -89,6 +89,10 @@ class Planner {
 
   std::shared_ptr<Plan> generate_select_plan(std::shared_ptr<Query> query, Context *context);
 
+  // 收集计划树中扫描之上的算子用到的字段，以及计划树中的所有扫描
+  void collect_read_cols(const std::shared_ptr<Plan> &plan, std::vector<TabCol> &read_cols,
+                         std::vector<std::shared_ptr<ScanPlan>> &scans);
+
   // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
   bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds,
                       std::vector<std::string> &index_col_names);
@@ -10,6 +10,7 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <cstring>
 // #include "common/config.h"
 // #include "storage/page/page.h"
@@ -22,10 +23,23 @@ constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
 
+/* 表数据页面的格式，见 rm_file_handle.h */
+constexpr int RM_PAGE_FORMAT_TUPLE_INFO = 0;  // 24字节的TupleInfo slot，未记录格式的旧文件读出的值为0
+constexpr int RM_PAGE_FORMAT_COMPACT = 1;     // 4字节的slot，删除标记在slot中，时间戳只在非0时存储
+constexpr int RM_PAGE_FORMAT_PAX = 2;         // 页面内每列一个minipage，只用于定长记录的表（CREATE TABLE ... WITH (storage = column)）
+constexpr int RM_PAX_MAX_COLUMNS = 64;        // PAX格式的表最多的列数
+
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
   int num_pages;           // 文件中分配的页面个数（初始化为1）
   int first_free_page_no;  // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
+  int page_format;         // 页面格式，新建的文件使用紧凑格式
+  /* 以下字段只用于PAX格式，由 RmPageHandle::InitPaxLayout() 计算，所有页面的布局相同 */
+  int record_size;                                  // 每条记录的大小，等于各列大小之和
+  int pax_capacity;                                 // 每个页面最多存储的记录个数
+  int pax_num_columns;                              // 列数，即每个页面的minipage个数
+  uint16_t pax_column_sizes[RM_PAX_MAX_COLUMNS];    // 每列的大小
+  uint16_t pax_column_offsets[RM_PAX_MAX_COLUMNS];  // 每列的minipage在页面中的偏移
   // int record_size;  // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
   // int num_records_per_page;  // 每个页面最多能存储的元组个数
   // int bitmap_size;           // 每个页面bitmap大小
@@ -33,6 +47,7 @@ struct RmFileHdr {
   void Init() {
     num_pages = 1;
     first_free_page_no = RM_NO_PAGE;
+    page_format = RM_PAGE_FORMAT_COMPACT;
   }
 };
 
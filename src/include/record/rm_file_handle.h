@@ -12,7 +12,10 @@
 #pragma once
 #include <assert.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "bitmap.h"
 #include "buffer/buffer_pool_manager.h"
@@ -20,6 +23,9 @@
 #include "common/context.h"
 #include "common/rid.h"
 #include "rm_defs.h"
+#include "rm_free_space_map.h"
+#include "rm_toast.h"
+#include "rm_zone_map.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
@@ -33,16 +39,40 @@ namespace easydb {
  *                                ^
  *                                free space pointer
  *
+ *  Tuples are stored from the end of the page towards the header in slot order, so the last slot always has the
+ *  lowest offset. Compact() keeps this order: a vacuumed dead slot keeps its number with size 0 and the offset of
+ *  the live tuple before it, only dead slots at the end of the slot array are given back.
+ *
  *  Header format (size in bytes):
  *  ----------------------------------------------------------------------------
  *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) |
  *  ----------------------------------------------------------------------------
+ *
+ *  The slot array follows the header, its format is chosen per file by RmFileHdr::page_format:
+ *
+ *  RM_PAGE_FORMAT_TUPLE_INFO (files created before the format was versioned), 24 bytes per slot:
+ *  ----------------------------------------------------------------
+ *  | Tuple_1 offset (2) + size (2) + TupleMeta (16) + padding | ... |
  *  ----------------------------------------------------------------
- *  | Tuple_1 offset+size (4) | Tuple_2 offset+size (4) | ... |
+ *
+ *  RM_PAGE_FORMAT_COMPACT, 4 bytes per slot (see RmSlot):
+ *  ----------------------------------------------------------------
+ *  | Tuple_1 offset (2) + flags (4 bits) size (12 bits) | ... |
  *  ----------------------------------------------------------------
+ *  The flags hold the deleted bit, the timestamp of the TupleMeta is only stored, in front of the tuple data, when
+ *  it is not 0.
+ *
+ *  RM_PAGE_FORMAT_PAX has no slot array and no free space pointer. The records of a page are split up by column,
+ *  each column has a minipage of its own at a fixed offset, so a scan can read one column of the page without
+ *  touching the others:
+ *  ---------------------------------------------------------------------------------------------
+ *  | HEADER | DELETED BITMAP | COLUMN 0: value_0 value_1 ... | COLUMN 1: value_0 value_1 ... | ... |
+ *  ---------------------------------------------------------------------------------------------
+ *  The capacity of a page and the offsets of the minipages are the same for every page, they are computed once when
+ *  the file is created and kept in RmFileHdr. Only fixed-length records fit, a timestamp of a TupleMeta is not stored.
  *
  * Tuple format:
- * | meta | data |
+ * | data |
  */
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
@@ -50,7 +80,7 @@ struct RmPageHdr {
   page_id_t next_page_id;  // 当前页面满了之后，下一个包含空闲空间的页面号（初始化为-1）
   uint16_t num_records;    // 当前页面中当前已经存储的记录个数（初始化为0）
   uint16_t num_deleted_records;  // 当前页面中已经删除的记录个数（初始化为0）
-  // num_records 只增不减，删除记录则增 num_deleted_records，标记相应的slot为已删除
+  // 删除记录则增 num_deleted_records，标记相应的slot为已删除；num_records 只在 VACUUM 回收末尾的已删除slot时减少
 
   void Init() {
     next_page_id = RM_NO_PAGE;
@@ -61,16 +91,36 @@ struct RmPageHdr {
 
 static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = Page::SIZE_PAGE_HEADER + sizeof(RmPageHdr);
 
+/* 紧凑页面格式中的slot：记录的偏移、大小和标志位 */
+struct RmSlot {
+  static constexpr uint16_t SIZE_MASK = 0x0fff;  // a tuple takes less than PAGE_SIZE bytes
+  static constexpr uint16_t DELETED = 0x8000;    // the tuple is deleted
+  static constexpr uint16_t HAS_TS = 0x4000;     // the stored tuple starts with the timestamp of its TupleMeta
+
+  uint16_t offset_;      // where the stored tuple starts
+  uint16_t size_flags_;  // size of the stored tuple (including the timestamp) and the flags
+
+  auto Size() const -> uint16_t { return size_flags_ & SIZE_MASK; }
+  auto IsDeleted() const -> bool { return (size_flags_ & DELETED) != 0; }
+  auto HasTs() const -> bool { return (size_flags_ & HAS_TS) != 0; }
+};
+static_assert(sizeof(RmSlot) == 4);
+static_assert(PAGE_SIZE - 1 <= RmSlot::SIZE_MASK);
+
 /* 对表数据文件中的页面进行封装 */
 class RmPageHandle {
   friend class RmFileHandle;
   friend class RmScan;
+  friend class RmToast;
 
  public:
   RmPageHandle(const RmFileHdr *fhdr_, Page *page_) : file_hdr(fhdr_), page(page_) {
     page_hdr_ = reinterpret_cast<RmPageHdr *>(page->GetData() + page->OFFSET_PAGE_HDR);
     tuple_info_ = reinterpret_cast<TupleInfo *>(page->GetData() + sizeof(RmPageHdr) + page->OFFSET_PAGE_HDR);
+    slots_ = reinterpret_cast<RmSlot *>(tuple_info_);
     page_start_ = page->GetData();
+    compact_ = file_hdr->page_format == RM_PAGE_FORMAT_COMPACT;
+    pax_ = file_hdr->page_format == RM_PAGE_FORMAT_PAX;
   }
 
   // // 返回指定slot_no的slot存储收地址
@@ -79,6 +129,28 @@ class RmPageHandle {
   //   每个slot的大小(每个record的大小)
   // }
 
+  /** @return the size of a slot of a page of the given format, a PAX page has no slots */
+  static inline auto SlotSize(int page_format) -> size_t {
+    if (page_format == RM_PAGE_FORMAT_PAX) {
+      return 0;
+    }
+    return page_format == RM_PAGE_FORMAT_COMPACT ? COMPACT_SLOT_SIZE : TUPLE_INFO_SIZE;
+  }
+
+  /**
+   * Lay out the pages of a PAX file: the deleted bitmap and one 8-byte aligned minipage per column, for as many
+   * records as fit into a page.
+   * @param[out] file_hdr the header of the new file, its page format is set to RM_PAGE_FORMAT_PAX
+   * @param column_sizes the size of each column, in the order of the columns in the record
+   */
+  static void InitPaxLayout(RmFileHdr *file_hdr, const std::vector<int> &column_sizes);
+
+  /** @return the bytes an insert of `tuple` takes on a page of the given format, its slot included */
+  static inline auto InsertSize(int page_format, const TupleMeta &meta, const Tuple &tuple) -> size_t {
+    bool store_ts = page_format == RM_PAGE_FORMAT_COMPACT && meta.ts_ != 0;
+    return SlotSize(page_format) + tuple.GetLength() + (store_ts ? sizeof(timestamp_t) : 0);
+  }
+
   /** @return number of tuples in this page */
   auto GetNumTuples() const -> uint32_t { return page_hdr_->num_records; }
 
@@ -88,6 +160,9 @@ class RmPageHandle {
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { page_hdr_->next_page_id = next_page_id; }
 
+  /** @return the free bytes between the slots and the tuples, an insert takes InsertSize() of them */
+  auto GetFreeSpace() const -> size_t;
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
@@ -108,6 +183,16 @@ class RmPageHandle {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple in place, the view is valid as long as the page stays pinned.
+   */
+  auto GetTupleView(const RID &rid) const -> TupleView;
+
+  /**
+   * Read the live tuples from slot `first_slot` on in place, appending them to `views` in slot order.
+   */
+  void GetTupleViews(uint32_t first_slot, std::vector<TupleView> &views) const;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -123,19 +208,98 @@ class RmPageHandle {
    */
   auto IsTupleDeleted(const RID &rid) -> bool;
 
+  /** @return true if Compact() would reclaim space, i.e. a deleted tuple still takes up room */
+  auto NeedsCompaction() const -> bool;
+
+  /**
+   * Move the live tuples together at the end of the page and drop the deleted ones, without changing any slot
+   * number. The dead slots at the end of the slot array are reclaimed, the others are left with size 0.
+   * The caller holds the page write latch and makes sure that no deleted tuple can be rolled back any more.
+   * @param[out] slots_reclaimed number of slots given back
+   * @return the number of bytes of free space gained
+   */
+  auto Compact(uint32_t *slots_reclaimed) -> size_t;
+
+  /** @return the minipage of a column of a PAX page, the value of slot i starts at i * pax_column_sizes[col_idx] */
+  inline auto GetColumnData(uint32_t col_idx) const -> const char * {
+    return page_start_ + file_hdr->pax_column_offsets[col_idx];
+  }
+
+  /** @return the deleted bitmap of a PAX page, see Bitmap */
+  inline auto GetDeletedBitmap() const -> const char * { return page_start_ + TABLE_PAGE_HEADER_SIZE; }
+
+  /** Copy the record of a slot of a PAX page together from the minipages, `dst` has room for record_size bytes. */
+  void ReadPaxRecord(uint32_t slot_no, char *dst) const;
+
  private:
+  /** @return where the stored bytes of a slot start, on a compact page they begin with the timestamp if any */
+  inline auto StoredOffset(uint32_t slot_no) const -> uint16_t {
+    return compact_ ? slots_[slot_no].offset_ : std::get<0>(tuple_info_[slot_no]);
+  }
+
+  /** @return the number of bytes stored for a slot */
+  inline auto StoredSize(uint32_t slot_no) const -> uint16_t {
+    return compact_ ? slots_[slot_no].Size() : std::get<1>(tuple_info_[slot_no]);
+  }
+
+  inline auto IsSlotDeleted(uint32_t slot_no) const -> bool {
+    if (pax_) {
+      return Bitmap::is_set(GetDeletedBitmap(), static_cast<int>(slot_no));
+    }
+    return compact_ ? slots_[slot_no].IsDeleted() : std::get<2>(tuple_info_[slot_no]).is_deleted_;
+  }
+
+  /** @return the offset and the length of the tuple data of a slot */
+  inline auto TupleData(uint32_t slot_no) const -> std::pair<uint16_t, uint16_t> {
+    if (!compact_) {
+      auto &[offset, size, meta] = tuple_info_[slot_no];
+      return {offset, size};
+    }
+    const RmSlot &slot = slots_[slot_no];
+    uint16_t ts_size = slot.HasTs() ? sizeof(timestamp_t) : 0;
+    return {slot.offset_ + ts_size, slot.Size() - ts_size};
+  }
+
+  auto ReadMeta(uint32_t slot_no) const -> TupleMeta;
+
+  /** Store the meta of a slot, on a compact page a timestamp only fits if the slot already has one. */
+  void WriteMeta(uint32_t slot_no, const TupleMeta &meta);
+
+  /** Move the stored bytes of a slot, a slot left with 0 bytes loses its timestamp. */
+  void SetStoredPlace(uint32_t slot_no, uint16_t offset, uint16_t size);
+
+  /** Fill in the next slot with a tuple at `offset`, returned by GetNextTupleOffset(). */
+  auto AppendTuple(uint16_t offset, const TupleMeta &meta, const Tuple &tuple) -> uint16_t;
+
+  /** Split a record of a PAX page up into the minipages. */
+  void WritePaxRecord(uint32_t slot_no, const char *src);
+
   const RmFileHdr *file_hdr;  // 当前页面所在文件的文件头指针
   Page *page;                 // 页面的实际数据，包括页面存储的数据、元信息等
   // 元组信息，包括slot号(offset)、大小(size)、元数据
   using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
   RmPageHdr *page_hdr_;  // page->data的第一部分，存储页面元信息，指针指向首地址，长度为sizeof(RmPageHdr)
   TupleInfo *tuple_info_;  // page->data的第二部分，存储页面的元组信息，长度为num_records * sizeof(TupleInfo)
+  RmSlot *slots_;          // 紧凑格式下的第二部分，与tuple_info_指向同一位置，长度为num_records * sizeof(RmSlot)
   // char *bitmap;  // page->data的第二部分，存储页面的bitmap，指针指向首地址，长度为file_hdr->bitmap_size
   // char *slots;  // page->data的第三部分，存储表的记录，指针指向首地址，每个slot的长度为file_hdr->record_size
   char *page_start_;
+  bool compact_;  // 页面是否为紧凑格式（RM_PAGE_FORMAT_COMPACT）
+  bool pax_;      // 页面是否为PAX格式（RM_PAGE_FORMAT_PAX），此时tuple_info_和slots_都不使用
 
+ public:
   static constexpr size_t TUPLE_INFO_SIZE = 24;
   static_assert(sizeof(TupleInfo) == TUPLE_INFO_SIZE);
+  static constexpr size_t COMPACT_SLOT_SIZE = sizeof(RmSlot);
+};
+
+/** What a vacuum of a table file reclaimed. */
+struct RmVacuumStats {
+  size_t pages_scanned_{0};    // pages looked at
+  size_t pages_compacted_{0};  // pages that had deleted tuples to remove
+  size_t pages_emptied_{0};    // compacted pages left without any slot
+  size_t slots_reclaimed_{0};  // tuple infos given back
+  size_t bytes_reclaimed_{0};  // free space gained over all pages
 };
 
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中 */
@@ -148,9 +312,15 @@ class RmFileHandle {
   BufferPoolManager *buffer_pool_manager_;
   int fd_;              // 打开文件后产生的文件句柄
   RmFileHdr file_hdr_;  // 文件头，维护当前表文件的元数据
+  std::unique_ptr<RmFreeSpaceMap> fsm_;  // 空闲空间映射，插入时用来找到有足够空间的页面
+  std::unique_ptr<RmZoneMap> zone_map_;  // 每个页面中数值和日期字段的取值范围，扫描时用来跳过页面，可以没有
+  std::unique_ptr<RmToast> toast_;       // 存放过长的VARCHAR值，表中没有VARCHAR字段时为空
+  std::mutex extend_latch_;              // 保护文件的扩展（CreateNewPageHandle）
+  std::atomic<size_t> num_dead_tuples_{0};  // 上次VACUUM之后删除的记录数，供后台VACUUM判断是否需要清理
 
  public:
-  RmFileHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
+  RmFileHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd,
+               const std::vector<RmZoneColumn> &zone_columns = {}, const RmToastLayout &toast_layout = {})
       : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
     // 注意：这里从磁盘中读出文件描述符为fd的文件的file_hdr，读到内存中
     // 这里实际就是初始化file_hdr，只不过是从磁盘中读出进行初始化
@@ -158,20 +328,45 @@ class RmFileHandle {
     disk_manager_->ReadPage(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
     // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
     disk_manager_->SetFd2Pageno(fd, file_hdr_.num_pages);
+    // 打开（或为旧版本的表创建）空闲空间映射文件
+    fsm_ = std::make_unique<RmFreeSpaceMap>(disk_manager_, buffer_pool_manager_,
+                                            disk_manager_->GetFileName(fd).string() + RM_FSM_SUFFIX);
+    if (fsm_->IsNew()) {
+      RebuildFreeSpaceMap();
+    }
+    // 打开区域映射（zone map），新建的或上次未正常关闭的映射要根据页面中的记录重建
+    if (!zone_columns.empty()) {
+      zone_map_ = std::make_unique<RmZoneMap>(disk_manager_, buffer_pool_manager_,
+                                              disk_manager_->GetFileName(fd).string() + RM_ZONE_MAP_SUFFIX,
+                                              zone_columns);
+      if (zone_map_->NeedsRebuild()) {
+        RebuildZoneMap();
+      }
+    }
+    // 过长的VARCHAR值存放在单独的toast文件中，文件在第一次用到时才创建
+    if (!toast_layout.varlen_offsets_.empty()) {
+      toast_ = std::make_unique<RmToast>(disk_manager_, buffer_pool_manager_,
+                                         disk_manager_->GetFileName(fd).string() + RM_TOAST_SUFFIX, toast_layout);
+    }
   }
 
   // RmFileHdr get_file_hdr() { return file_hdr_; }
   RmFileHdr GetFileHdr() { return file_hdr_; }
+  /** @return the number of pages of the file, may be called while another thread extends the file */
+  int GetNumPages() const { return __atomic_load_n(&file_hdr_.num_pages, __ATOMIC_ACQUIRE); }
   int GetFd() { return fd_; }
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
+   * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt. The long VARCHAR
+   * values of a large tuple are moved to the toast first.
    * @param meta tuple meta
    * @param tuple tuple to insert
    * @param context context of transaction
+   * @param strategy buffer ring for bulk loads, nullptr for normal inserts
    * @return rid of the inserted tuple
    */
-  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, Context *context) -> std::optional<RID>;
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, Context *context,
+                   BufferAccessStrategy *strategy = nullptr) -> std::optional<RID>;
 
   /**
    * Insert a tuple into the table for rollback.
@@ -223,9 +418,11 @@ class RmFileHandle {
    * Read a tuple from the table.
    * @param rid rid of the tuple to read
    * @param context context of transaction
+   * @param detoast_cols the VARCHAR columns whose toasted values are read back, by offset, nullptr for all of them
    * @return the tuple
    */
-  auto GetTupleValue(const RID &rid, Context *context) -> std::unique_ptr<Tuple>;
+  auto GetTupleValue(const RID &rid, Context *context, const std::vector<uint32_t> *detoast_cols = nullptr)
+      -> std::unique_ptr<Tuple>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` instead
@@ -269,17 +466,43 @@ class RmFileHandle {
   // void UpdateRecord(const RID &rid, char *buf);
 
   // RmPageHandle create_new_page_handle();
-  RmPageHandle CreateNewPageHandle();
+  RmPageHandle CreateNewPageHandle(BufferAccessStrategy *strategy = nullptr);
 
   // RmPageHandle fetch_page_handle(int page_no) const;
-  RmPageHandle FetchPageHandle(page_id_t page_no) const;
+  RmPageHandle FetchPageHandle(page_id_t page_no, BufferAccessStrategy *strategy = nullptr) const;
+
+  /**
+   * Compact every page of the file (see RmPageHandle::Compact()) and hand the space freed back to the inserts through
+   * the free space map. RIDs do not change, so the indexes stay valid.
+   * The caller excludes all the other users of the table, e.g. by an exclusive table lock, and makes sure that no
+   * deleted tuple of the table can still be rolled back.
+   */
+  auto Vacuum() -> RmVacuumStats;
+
+  /** @return the toast of the file, nullptr if its records have no VARCHAR value */
+  auto GetToast() const -> RmToast * { return toast_.get(); }
+
+  /** @return the zone map of the file, nullptr if it was opened without one */
+  auto GetZoneMap() const -> RmZoneMap * { return zone_map_.get(); }
+
+  /** @return the number of tuples deleted since the file was opened or last vacuumed */
+  auto GetNumDeadTuples() const -> size_t { return num_dead_tuples_.load(std::memory_order_relaxed); }
 
   //   void set_page_lsn(int page_no, lsn_t lsn);
   void SetPageLSN(page_id_t page_id_, lsn_t lsn);
 
  private:
-  // RmPageHandle create_page_handle();
-  RmPageHandle CreatePageHandle();
+  /** Fill a new free space map in from the pages of the file. */
+  void RebuildFreeSpaceMap();
+
+  /** Fill the zone map in from the live records of the file. */
+  void RebuildZoneMap();
+
+  /** Put the toasted values of some columns of a stored tuple back in place, see RmToast::Detoast(). */
+  void Detoast(Tuple &tuple, const std::vector<uint32_t> *detoast_cols);
+
+  /** Compute the ranges of a page again from its live records, the caller holds the page latch. */
+  void ResetZones(RmPageHandle &page_handle);
 
   // void release_page_handle(RmPageHandle &page_handle);
   void ReleasePageHandle(RmPageHandle &page_handle);
@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_free_space_map.h
+ *
+ * Identification: src/include/record/rm_free_space_map.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/errors.h"
+#include "rm_defs.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace easydb {
+
+/** The free space map of table file `name` is kept in the file `name` + RM_FSM_SUFFIX. */
+static const std::string RM_FSM_SUFFIX = ".fsm";
+
+/**
+ * The free space map of a table file: a 4-bit fill class for every page of the table, kept in pages of a file of
+ * its own that go through the buffer pool like the table pages do.
+ *
+ * A page of fill class c has at least c * FSM_CLASS_BYTES bytes of free space, so an insert that needs n bytes asks
+ * for a page of class ceil(n / FSM_CLASS_BYTES) or higher and never gets a page that is too small, unless the map is
+ * out of date (it is only a hint, it is not logged and may lag behind after a crash). The inserter checks the page
+ * anyway and corrects the map if it was wrong.
+ *
+ * Map page format (after the common page header):
+ *  ---------------------------------------------------------------------------------
+ *  | GroupMax (1) x FSM_GROUPS_PER_PAGE | FillClasses (4 bits) x FSM_PAGES_PER_MAP_PAGE |
+ *  ---------------------------------------------------------------------------------
+ * The table pages are grouped by FSM_GROUP_SIZE, GroupMax holds the highest fill class in a group, so a search
+ * only looks into the groups that have a page that is large enough. The highest class of every map page is kept in
+ * memory for the same reason.
+ */
+class RmFreeSpaceMap {
+ public:
+  static constexpr int FSM_NUM_CLASSES = 16;
+  static constexpr size_t FSM_CLASS_BYTES = PAGE_SIZE / FSM_NUM_CLASSES;
+  static constexpr size_t FSM_GROUP_SIZE = 64;
+  static constexpr size_t FSM_GROUPS_PER_PAGE = (PAGE_SIZE - Page::SIZE_PAGE_HEADER) / (1 + FSM_GROUP_SIZE / 2);
+  static constexpr size_t FSM_PAGES_PER_MAP_PAGE = FSM_GROUPS_PER_PAGE * FSM_GROUP_SIZE;
+
+  /** Number of search start points, inserting threads are spread over them. */
+  static constexpr size_t FSM_NUM_HINTS = 8;
+
+  /**
+   * @brief Open the free space map of a table file, creating it if it does not exist.
+   * @param path the path of the map file
+   */
+  RmFreeSpaceMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, const std::string &path);
+
+  /** @return true if the map file has just been created, it is then empty and has to be filled in by the caller */
+  auto IsNew() const -> bool { return is_new_; }
+
+  auto GetFd() const -> int { return fd_; }
+
+  /** @return the fill class of `free_space` bytes, rounded down */
+  static inline auto FreeSpaceToClass(size_t free_space) -> uint8_t {
+    return static_cast<uint8_t>(std::min<size_t>(free_space / FSM_CLASS_BYTES, FSM_NUM_CLASSES - 1));
+  }
+
+  /** @return the lowest fill class that is sure to have `size` free bytes, FSM_NUM_CLASSES if there is none */
+  static inline auto RequestToClass(size_t size) -> uint8_t {
+    return static_cast<uint8_t>(std::min<size_t>((size + FSM_CLASS_BYTES - 1) / FSM_CLASS_BYTES, FSM_NUM_CLASSES));
+  }
+
+  /** @return the fill class recorded for a table page */
+  auto GetClass(page_id_t page_no) -> uint8_t;
+
+  /** @brief Record the fill class of a table page, growing the map if needed. */
+  void SetClass(page_id_t page_no, uint8_t fill_class);
+
+  /**
+   * @brief Find a table page of fill class `min_class` or higher. The search starts at the page last found by the
+   * hint of the calling thread and wraps around, so concurrent inserters tend to fill different pages.
+   * @return the page number, RM_NO_PAGE if no page has enough room
+   */
+  auto FindPage(uint8_t min_class) -> page_id_t;
+
+  /** @brief Start the next searches of the calling thread at `page_no`, e.g. a page it has just added. */
+  void SetHint(page_id_t page_no);
+
+  /** @brief Write the map back, drop its pages from the buffer pool and close its file. */
+  void Close();
+
+ private:
+  /** @return map page `map_page_no`, pinned; the map is extended up to it if `create` */
+  auto FetchMapPage(size_t map_page_no, bool create) -> Page *;
+
+  /** @return the hint of the calling thread */
+  auto Hint() -> page_id_t & {
+    return hints_[std::hash<std::thread::id>()(std::this_thread::get_id()) % FSM_NUM_HINTS];
+  }
+
+  static inline auto GroupMax(Page *page) -> uint8_t * {
+    return reinterpret_cast<uint8_t *>(page->GetData() + Page::OFFSET_PAGE_HDR);
+  }
+
+  static inline auto Classes(Page *page) -> uint8_t * { return GroupMax(page) + FSM_GROUPS_PER_PAGE; }
+
+  static inline auto GetNibble(const uint8_t *classes, size_t index) -> uint8_t {
+    return (classes[index / 2] >> ((index % 2) * 4)) & 0xf;
+  }
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  int fd_;
+  bool is_new_;
+
+  std::mutex latch_;                            // protects the members below and the map pages
+  std::vector<uint8_t> map_page_max_;           // the highest fill class of every map page
+  std::array<page_id_t, FSM_NUM_HINTS> hints_;  // where the searches of each hint start
+};
+
+}  // namespace easydb
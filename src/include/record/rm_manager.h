@@ -32,18 +32,31 @@ class RmManager {
    * @description: 创建表的数据文件并初始化相关信息
    * @param {string&} filename 要创建的文件名称
    * @param {int} record_size 表中记录的大小
+   * @param {int} page_format 页面格式，默认为紧凑格式，旧格式只用于测试和对比
+   * @param {vector<int>&} column_sizes 每列的大小，只用于PAX格式，其和须等于record_size
    */
-  void CreateFile(const std::string &filename, int record_size) {
+  void CreateFile(const std::string &filename, int record_size, int page_format = RM_PAGE_FORMAT_COMPACT,
+                  const std::vector<int> &column_sizes = {}) {
     if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
       throw InvalidRecordSizeError(record_size);
     }
-    disk_manager_->CreateFile(filename);
-    int fd = disk_manager_->OpenFile(filename);
-
     // 初始化file header
     RmFileHdr file_hdr{};
     file_hdr.Init();
-    // file_hdr.record_size = record_size;
+    file_hdr.page_format = page_format;
+    file_hdr.record_size = record_size;
+    if (page_format == RM_PAGE_FORMAT_PAX) {
+      RmPageHandle::InitPaxLayout(&file_hdr, column_sizes);
+      if (file_hdr.record_size != record_size) {
+        throw InvalidRecordSizeError(record_size);
+      }
+    }
+
+    disk_manager_->CreateFile(filename);
+    // 删除同名旧表遗留的空闲空间映射等文件（例如只删除了数据文件），否则新表会用到其中不存在的页面
+    DestroySideFiles(filename);
+    int fd = disk_manager_->OpenFile(filename);
+
     // file_hdr.num_pages = 1;
     // file_hdr.first_free_page_no = RM_NO_PAGE;
     // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
@@ -61,17 +74,24 @@ class RmManager {
    * @description: 删除表的数据文件
    * @param {string&} filename 要删除的文件名称
    */
-  void DestoryFile(const std::string &filename) { disk_manager_->DestroyFile(filename); }
+  void DestoryFile(const std::string &filename) {
+    disk_manager_->DestroyFile(filename);
+    DestroySideFiles(filename);
+  }
 
   // 注意这里打开文件，创建并返回了record file handle的指针
   /**
    * @description: 打开表的数据文件，并返回文件句柄
    * @param {string&} filename 要打开的文件名称
+   * @param {vector<RmZoneColumn>&} zone_columns 区域映射记录取值范围的字段，为空则不使用区域映射
+   * @param {RmToastLayout&} toast_layout 记录中VARCHAR字段的位置，为空则不使用toast
    * @return {unique_ptr<RmFileHandle>} 文件句柄的指针
    */
-  std::unique_ptr<RmFileHandle> OpenFile(const std::string &filename) {
+  std::unique_ptr<RmFileHandle> OpenFile(const std::string &filename,
+                                         const std::vector<RmZoneColumn> &zone_columns = {},
+                                         const RmToastLayout &toast_layout = {}) {
     int fd = disk_manager_->OpenFile(filename);
-    return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd);
+    return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd, zone_columns, toast_layout);
   }
   /**
    * @description: 关闭表的数据文件
@@ -82,7 +102,27 @@ class RmManager {
                              sizeof(file_handle->file_hdr_));
     // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
     buffer_pool_manager_->FlushAllPages(file_handle->fd_);
+    // fd可能被之后打开的其他文件复用，缓冲区中不能留下本文件的页面
+    buffer_pool_manager_->RemoveAllPages(file_handle->fd_);
     disk_manager_->CloseFile(file_handle->fd_);
+    file_handle->fsm_->Close();
+    if (file_handle->zone_map_ != nullptr) {
+      file_handle->zone_map_->Close();
+    }
+    if (file_handle->toast_ != nullptr) {
+      file_handle->toast_->Close();
+    }
+  }
+
+ private:
+  /** 删除数据文件的空闲空间映射、区域映射和toast文件（含toast的空闲空间映射） */
+  void DestroySideFiles(const std::string &filename) {
+    for (const std::string &suffix :
+         {RM_FSM_SUFFIX, RM_ZONE_MAP_SUFFIX, RM_TOAST_SUFFIX, RM_TOAST_SUFFIX + RM_FSM_SUFFIX}) {
+      if (disk_manager_->IsFile(filename + suffix)) {
+        disk_manager_->DestroyFile(filename + suffix);
+      }
+    }
   }
 };
 }  // namespace easydb
@@ -10,8 +10,15 @@
  */
 
 #pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "rm_defs.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
 
 namespace easydb {
 class RecScan {
@@ -27,15 +34,108 @@ class RecScan {
 
 class RmFileHandle;
 
+/**
+ * The live records of a page of a PAX file, column by column: RmScan::GetPageColumns() hands out the minipages in
+ * place, a caller only reads the columns it needs. Valid as long as the scan stays on the page.
+ */
+struct RmColumnBatch {
+  page_id_t page_no_{RM_NO_PAGE};
+  std::vector<uint32_t> slots_;         // the live slots, in slot order
+  std::vector<const char *> columns_;   // the minipage of each column
+  std::vector<uint16_t> column_sizes_;  // the size of a value of each column
+
+  /** @return the value of a column of a slot, in the format of the column in a record */
+  inline auto GetValueData(uint32_t col_idx, uint32_t slot_no) const -> const char * {
+    return columns_[col_idx] + slot_no * column_sizes_[col_idx];
+  }
+};
+
+/**
+ * Sequential scan of a table file. The page of the current record stays pinned until the scan moves past it, so
+ * GetTupleView() can hand out the record in place instead of copying it, and GetPageBatch() all the records of the
+ * page at once.
+ */
 class RmScan : public RecScan {
+ public:
+  /** Decides from a page number whether a page can hold a record the caller wants, e.g. from the zone map. */
+  using PageFilter = std::function<bool(page_id_t page_no)>;
+
+ private:
   const RmFileHandle *file_handle_;
   RID rid_;
+  BufferAccessStrategy *strategy_;  // buffer ring for large tables, nullptr for normal access
+  std::shared_ptr<BufferAccessStrategy> prefetch_strategy_;  // buffer ring of the read-ahead, if strategy_ is set
+  page_id_t prefetched_until_;                               // pages before this one have been requested
+  Page *page_{nullptr};                                      // the pinned page of rid_, nullptr at the end
+  mutable std::vector<char> records_;  // the records of a PAX page put together again, the views point into them
+  PageFilter page_filter_;             // pages it turns down are neither read nor prefetched, nullptr for none
+  size_t pages_skipped_{0};            // pages turned down by page_filter_
 
  public:
-  RmScan(const RmFileHandle *file_handle);
+  RmScan(const RmFileHandle *file_handle, BufferAccessStrategy *strategy = nullptr, PageFilter page_filter = nullptr);
+
+  ~RmScan() override;
+
+  RmScan(const RmScan &) = delete;
+  RmScan &operator=(const RmScan &) = delete;
 
   void Next() override;
 
+  /**
+   * @return the current record, pointing into its pinned page. The view is valid until the next call of Next() or
+   * the destruction of the scan; the caller takes the record lock, if it needs one, before reading it.
+   * The record of a PAX page is copied together into a buffer of the scan, valid until the next read of the scan.
+   */
+  auto GetTupleView() const -> TupleView;
+
+  /** @return true if the file is stored column by column (RM_PAGE_FORMAT_PAX), see GetPageColumns() */
+  auto IsColumnar() const -> bool;
+
+  /**
+   * @brief Read the current record and all the live records after it on the same page, and leave the scan on the
+   * last of them, so that the next Next() moves on to the next page:
+   *
+   *   for (RmScan scan(fh); !scan.IsEnd(); scan.Next()) {
+   *     scan.GetPageBatch(batch);
+   *     ...
+   *   }
+   *
+   * The views point into the pinned page and are valid until the next call of Next().
+   * @param batch cleared and filled with the records, in slot order
+   */
+  void GetPageBatch(std::vector<TupleView> &batch);
+
+  /**
+   * @brief Like GetPageBatch(), but hand out the columns of the records of a PAX page instead of the records, so
+   * that a filter reads only the minipages of the columns it tests. GetPageRecords() puts the records that pass
+   * together afterwards.
+   * @param batch cleared and filled with the live slots and the minipages of the page
+   */
+  void GetPageColumns(RmColumnBatch &batch);
+
+  /**
+   * @brief Put the records of some slots of the current PAX page together, e.g. the slots of an RmColumnBatch that
+   * passed a filter. The views are valid until the next call of Next() or of one of the Get functions.
+   * @param slots live slots of the current page, in slot order
+   * @param batch cleared and filled with the records
+   */
+  void GetPageRecords(const std::vector<uint32_t> &slots, std::vector<TupleView> &batch);
+
+  /** @return the number of pages the page filter has turned down so far */
+  auto GetNumPagesSkipped() const -> size_t { return pages_skipped_; }
+
+ private:
+  /** Move to the first record at or after (`page_no`, `slot_no`), keeping its page pinned. */
+  void Seek(page_id_t page_no, uint32_t slot_no);
+
+  /** Unpin the current page, if there is one. */
+  void ReleasePage();
+
+  /** Keep PREFETCH_DEPTH pages after `page_no` requested from the buffer pool's read-ahead. */
+  void Prefetch(page_id_t page_no);
+
+ public:
+
   bool IsEnd() const override;
 
   RID GetRid() const override;
@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_toast.h
+ *
+ * Identification: src/include/record/rm_toast.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "rm_defs.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/table/tuple.h"
+
+namespace easydb {
+
+class RmFileHandle;
+
+/** The toast of table file `name` is kept in the file `name` + RM_TOAST_SUFFIX. */
+static const std::string RM_TOAST_SUFFIX = ".toast";
+
+/** Where the variable-length values of the records of a table are, which is all the toast has to know of them. */
+struct RmToastLayout {
+  uint32_t inlined_size_{0};            // the size of the fixed part of a record, the values follow it
+  std::vector<uint32_t> varlen_offsets_;  // where each VARCHAR column keeps the offset of its value, in column order
+};
+
+/** What a record keeps in place of the bytes of a value that was moved to the toast. */
+struct RmToastPointer {
+  int64_t first_chunk_;   // RID::Get() of the first chunk of the value
+  uint32_t raw_size_;     // the length of the value, as in the length field of its storage
+  uint32_t stored_size_;  // the bytes kept in the chunks, less than raw_size_ if they are compressed
+};
+
+/**
+ * The out-of-line storage of the long VARCHAR values of a table (The Oversized-Attribute Storage Technique).
+ *
+ * A record larger than TOAST_TUPLE_THRESHOLD has its longest values moved out, one at a time, until it is small
+ * enough or there is nothing left to move. A moved value is compressed if that makes it a quarter smaller, then cut
+ * into chunks of up to TOAST_CHUNK_SIZE bytes that are stored as records of a compact table file of their own, each
+ * one followed by the RID of the next. The record keeps the length field TOAST_MARKER and an RmToastPointer in
+ * place of the bytes of the value, so its size no longer depends on the value, and the table pages only hold short
+ * records. A scan that does not read a toasted column never reads its chunks.
+ *
+ * Chunks are deleted when the record that points to them goes away for good: when an update replaces it, or when
+ * VACUUM removes it after a delete (a delete can still be rolled back until then). The file is only created once
+ * the first value is toasted. Like the free space map it is not logged.
+ */
+class RmToast {
+ public:
+  static constexpr uint32_t TOAST_MARKER = 0xFFFFFFFE;  // the length field of a toasted value, next to NULL
+  static constexpr size_t TOAST_TUPLE_THRESHOLD = PAGE_SIZE / 4;
+  static constexpr size_t TOAST_CHUNK_SIZE = 1000;  // four chunks fit in a compact page
+  /** the bytes a toasted value takes in its record, the length field included */
+  static constexpr size_t TOAST_STORAGE_SIZE = sizeof(uint32_t) + sizeof(RmToastPointer);
+
+  /**
+   * @param path the path of the chunk file, opened if it exists and created by the first value toasted otherwise
+   * @param layout where the VARCHAR values of the records are, not empty
+   */
+  RmToast(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, std::string path, RmToastLayout layout);
+
+  ~RmToast();
+
+  auto GetLayout() const -> const RmToastLayout & { return layout_; }
+
+  /** @return true if a record has to go through Toast() before it is stored */
+  inline auto NeedsToast(const Tuple &tuple) const -> bool { return tuple.GetLength() > TOAST_TUPLE_THRESHOLD; }
+
+  /**
+   * @brief Move the longest values of a record out until it is no larger than TOAST_TUPLE_THRESHOLD.
+   * @return the record to store instead of `tuple`
+   */
+  auto Toast(const Tuple &tuple) -> Tuple;
+
+  /**
+   * @brief Put the values of some columns of a stored record back in place.
+   * @param record the stored record
+   * @param varlen_offsets the columns to read back, by their offset in the record (Column::GetOffset()), nullptr for
+   * all of them; the other toasted values are left as pointers
+   * @param[out] out the record with the values, written only if one of them was toasted
+   * @return true if there was a value to read back, false if `record` can be used as it is
+   */
+  auto Detoast(const TupleView &record, const std::vector<uint32_t> *varlen_offsets, std::vector<char> *out) -> bool;
+
+  /** @brief Delete the chunks of all the toasted values of a stored record that is going away. */
+  void Free(const TupleView &record);
+
+  /** @brief Give the space of the deleted chunks back, see RmFileHandle::Vacuum(). */
+  void Vacuum();
+
+  /** @brief Write the chunk file back and close it. */
+  void Close();
+
+  /**
+   * @brief Compress `size` bytes of `src` with a byte-oriented LZ77 coding.
+   * @return false if the compressed bytes would not be smaller than `max_size`
+   */
+  static auto Compress(const char *src, size_t size, size_t max_size, std::vector<char> *dst) -> bool;
+
+  /**
+   * @brief Decompress what Compress() wrote into exactly `raw_size` bytes.
+   * @throws InternalError if the compressed bytes are corrupt
+   */
+  static void Decompress(const char *src, size_t size, char *dst, size_t raw_size);
+
+ private:
+  /** @return the chunk file, created and opened if `create`, nullptr if it does not exist yet and not `create` */
+  auto GetChunks(bool create) -> RmFileHandle *;
+
+  /** Store a value in chunks. @return the pointer to it */
+  auto StoreValue(const char *data, uint32_t size) -> RmToastPointer;
+
+  /** Read a value back from its chunks into `dst`, which has room for pointer.raw_size_ bytes. */
+  void ReadValue(const RmToastPointer &pointer, char *dst);
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  std::string path_;
+  RmToastLayout layout_;
+
+  std::mutex open_latch_;  // protects the creation of chunks_
+  std::unique_ptr<RmFileHandle> chunks_;
+};
+
+}  // namespace easydb
@@ -0,0 +1,139 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_zone_map.h
+ *
+ * Identification: src/include/record/rm_zone_map.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/errors.h"
+#include "rm_defs.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace easydb {
+
+/** The zone map of table file `name` is kept in the file `name` + RM_ZONE_MAP_SUFFIX. */
+static const std::string RM_ZONE_MAP_SUFFIX = ".zm";
+
+/** A column of the records of a table that the zone map keeps the range of. */
+struct RmZoneColumn {
+  uint16_t offset_;  // where the value starts in a record
+  uint16_t type_;    // TypeId of the column: TYPE_INT, TYPE_LONG, TYPE_FLOAT, TYPE_DOUBLE or TYPE_DATE
+
+  /** @return true if the zone map can keep the range of a column of type `type` */
+  static inline auto IsSupported(TypeId type) -> bool {
+    return type == TYPE_INT || type == TYPE_LONG || type == TYPE_FLOAT || type == TYPE_DOUBLE || type == TYPE_DATE;
+  }
+
+  /** @return the size of a value of the column in a record */
+  inline auto Size() const -> size_t { return type_ == TYPE_INT ? sizeof(int32_t) : sizeof(int64_t); }
+
+  inline auto operator==(const RmZoneColumn &other) const -> bool {
+    return offset_ == other.offset_ && type_ == other.type_;
+  }
+};
+
+/**
+ * The zone map of a table file: the lowest and the highest value of some numeric and date columns over the records
+ * of every page of the table, kept in pages of a file of its own that go through the buffer pool like the table
+ * pages do. A scan skips the pages whose ranges cannot satisfy its conditions without reading them.
+ *
+ * The ranges only grow while the table is in use: inserts and updates widen the range of their page before they
+ * write the record, deletes leave it as it is. VACUUM computes the ranges of the pages it compacts again. Unlike the
+ * free space map, a zone map that lags behind would hide records, so it is not trusted after a crash: the header
+ * says whether the map was closed cleanly, and the table file rebuilds a map that was not.
+ *
+ * Map file format: map page 0 holds the header, the entries of the table pages follow from map page 1 on, the
+ * entry of table page n is entry n % ENTRIES_PER_PAGE of map page 1 + n / ENTRIES_PER_PAGE. Each entry is
+ *  -------------------------------------------------------------------------
+ *  | HasRecords (1) | Min (value size) Max (value size) of each column | ... |
+ *  -------------------------------------------------------------------------
+ * with the values in the format of the columns in a record.
+ */
+class RmZoneMap {
+ public:
+  /**
+   * @brief Open the zone map of a table file, creating it if it does not exist.
+   * @param path the path of the map file
+   * @param columns the columns to keep the ranges of
+   */
+  RmZoneMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, const std::string &path,
+            std::vector<RmZoneColumn> columns);
+
+  /**
+   * @return true if the ranges of the map cannot be used: the map file has just been created, was not closed
+   * cleanly or was kept for other columns. The caller fills the map in again by Reset() and Extend().
+   */
+  auto NeedsRebuild() const -> bool { return needs_rebuild_; }
+
+  auto GetColumns() const -> const std::vector<RmZoneColumn> & { return columns_; }
+
+  /** @return the index of the column of the map that starts at `offset` in a record */
+  auto FindColumn(uint32_t offset) const -> std::optional<size_t>;
+
+  /** @brief Forget the records of a table page, e.g. before its ranges are computed again. */
+  void Reset(page_id_t page_no);
+
+  /** @brief Widen the ranges of a table page to the values of a record that is written to it. */
+  void Extend(page_id_t page_no, const char *record);
+
+  /**
+   * @brief Read the ranges of a table page.
+   * @param[out] zones the lowest and the highest value of each column, not changed if the page has no records
+   * @return false if there has never been a record on the page since its ranges were last computed
+   */
+  auto GetZones(page_id_t page_no, std::vector<std::pair<Value, Value>> *zones) -> bool;
+
+  /** @brief Mark the map as closed cleanly, write it back, drop its pages from the buffer pool and close its file. */
+  void Close();
+
+ private:
+  struct Header {
+    uint32_t magic_;        // ZONE_MAP_MAGIC
+    uint32_t clean_;        // 1 if the map was closed cleanly
+    uint32_t num_columns_;  // followed by the columns
+  };
+
+  static constexpr uint32_t ZONE_MAP_MAGIC = 0x5a4d4150;  // "ZMAP"
+
+  /** @return map page `map_page_no`, pinned; the map is extended up to it if `create` */
+  auto FetchMapPage(page_id_t map_page_no, bool create) -> Page *;
+
+  /** @return the entry of a table page in its pinned map page */
+  inline auto Entry(Page *page, page_id_t page_no) const -> char * {
+    return page->GetData() + Page::OFFSET_PAGE_HDR + (page_no % entries_per_page_) * entry_size_;
+  }
+
+  /** Write the header to map page 0, with the given clean flag, and flush it. */
+  void WriteHeader(bool clean);
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  int fd_;
+  std::vector<RmZoneColumn> columns_;
+  std::vector<size_t> value_offsets_;  // where the min of each column starts in an entry
+  size_t entry_size_;
+  size_t entries_per_page_;
+  bool needs_rebuild_;
+
+  std::mutex latch_;        // protects the map pages and num_map_pages_
+  page_id_t num_map_pages_;  // including the header page
+};
+
+}  // namespace easydb
@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <unordered_set>
@@ -593,11 +594,14 @@ class LogManager {
 
   LogBuffer *get_log_buffer() { return &log_buffer_; }
 
+  /** @return the LSN of the last log record on disk, INVALID_LSN if there is none */
+  lsn_t GetPersistLsn() { return persist_lsn_.load(); }
+
  private:
   std::atomic<lsn_t> global_lsn_{0};  // 全局lsn，递增，用于为每条记录分发lsn
   std::mutex latch_;                  // 用于对log_buffer_的互斥访问
   LogBuffer log_buffer_;              // 日志缓冲区
-  lsn_t persist_lsn_;                 // 记录已经持久化到磁盘中的最后一条日志的日志号
+  std::atomic<lsn_t> persist_lsn_{INVALID_LSN};  // 记录已经持久化到磁盘中的最后一条日志的日志号
   DiskManager *disk_manager_;
 };
 
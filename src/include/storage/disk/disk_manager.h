@@ -21,14 +21,25 @@
 #include <filesystem>
 #include <fstream>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
 
 namespace easydb {
 
+class IoUring;
+
+/** One page of a batched read or write, see DiskManager::ReadPageBatch() and DiskManager::WritePageBatch(). */
+struct PageIORequest {
+  int fd;
+  page_id_t page_id;
+  char *data;  // PAGE_SIZE bytes
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -41,7 +52,7 @@ class DiskManager {
    */
   explicit DiskManager(const std::filesystem::path &db_dir);
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Write a page to the database file.
@@ -61,6 +72,60 @@ class DiskManager {
    */
   virtual void ReadPage(int fd, page_id_t page_id, char *page_data, size_t num_bytes);
 
+  /**
+   * Write consecutive pages with a single pwritev() (split only when num_pages exceeds IOV_MAX).
+   * @param fd file descriptor of the database file
+   * @param first_page id of the first page
+   * @param pages num_pages buffers of PAGE_SIZE bytes, pages[i] is written to page first_page + i
+   * @param num_pages number of pages
+   */
+  virtual void WritePages(int fd, page_id_t first_page, const char *const *pages, size_t num_pages);
+
+  /**
+   * Read consecutive pages with a single preadv(). The part of the range beyond the end of the file is zero filled,
+   * as ReadPage() does.
+   * @param fd file descriptor of the database file
+   * @param first_page id of the first page
+   * @param[out] pages num_pages buffers of PAGE_SIZE bytes, page first_page + i is read into pages[i]
+   * @param num_pages number of pages
+   */
+  virtual void ReadPages(int fd, page_id_t first_page, char *const *pages, size_t num_pages);
+
+  /**
+   * Write a set of pages, possibly of different files. The requests are sorted and adjacent pages are coalesced into
+   * vectored writes; with io_uring enabled all of them are submitted with one system call.
+   * @param requests pages to write, reordered by (fd, page_id)
+   */
+  void WritePageBatch(std::vector<PageIORequest> &requests);
+
+  /**
+   * Read a set of pages, see WritePageBatch().
+   * @param requests pages to read, reordered by (fd, page_id)
+   */
+  void ReadPageBatch(std::vector<PageIORequest> &requests);
+
+  /**
+   * Turn the io_uring backend of the batch operations on or off.
+   * @return true if io_uring is in use, false if it was disabled or the kernel refused to set it up
+   */
+  auto SetIoUringEnabled(bool enabled) -> bool;
+
+  auto IsIoUringEnabled() -> bool;
+
+  /**
+   * Open the files opened from now on with O_DIRECT, so that their pages are cached by the buffer pool only. Files on
+   * a filesystem that rejects O_DIRECT are opened normally.
+   */
+  void SetDirectIO(bool enabled) { direct_io_ = enabled; }
+
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+  /** @return true if the file was opened with O_DIRECT */
+  auto IsDirectFd(int fd) const -> bool { return fd >= 0 && fd < MAX_FD && direct_fd_[fd]; }
+
+  /** Alignment of the buffers, offsets and lengths of O_DIRECT I/O. */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = PAGE_SIZE;
+
   /**
    * Allocate a new page in the database file.
    * @param fd file descriptor of the database file
@@ -109,6 +174,23 @@ class DiskManager {
   // Log operations
 
  protected:
+  /** Submit the coalesced runs of a sorted batch to io_uring, runs it could not complete are redone synchronously. */
+  void SubmitBatchToIoUring(std::vector<PageIORequest> &requests, bool is_write);
+
+  /** @return a ring for one batch, an idle one or a new one, nullptr if io_uring is disabled or unavailable */
+  auto AcquireRing() -> std::unique_ptr<IoUring>;
+
+  /** Give back a ring taken by AcquireRing(), dropping it if io_uring was disabled meanwhile. */
+  void ReleaseRing(std::unique_ptr<IoUring> ring);
+
+  /** @return true if the I/O can be issued as is on `fd`, false if it needs an aligned bounce buffer */
+  auto CanTransferDirectly(int fd, const void *buf, size_t num_bytes) const -> bool;
+
+  /** Read / write a (partial) page of an O_DIRECT file through an aligned bounce buffer. */
+  void ReadPageBounced(int fd, page_id_t page_id, char *page_data, size_t num_bytes);
+
+  void WritePageBounced(int fd, page_id_t page_id, const char *page_data, size_t num_bytes);
+
   static constexpr int MAX_FD = 8192;
 
   // streams to write db directory
@@ -119,6 +201,13 @@ class DiskManager {
   std::unordered_map<int, std::filesystem::path> fd2path_;
   int log_fd_{-1};
   std::atomic<page_id_t> fd2pageno_[MAX_FD]{};
+  std::atomic<bool> direct_io_{ENABLE_DIRECT_IO};
+  std::atomic<bool> direct_fd_[MAX_FD]{};
+  // io_uring backend of the batch operations. Each batch has a ring of its own while it runs, so that the batches of
+  // different threads are in flight together; the latch only guards the idle rings, never an I/O.
+  bool io_uring_enabled_{false};
+  std::vector<std::unique_ptr<IoUring>> idle_rings_;
+  std::mutex io_uring_latch_;
 };
 
 }  // namespace easydb
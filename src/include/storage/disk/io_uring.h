@@ -0,0 +1,95 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * io_uring.h
+ *
+ * Identification: src/include/storage/disk/io_uring.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace easydb {
+
+/**
+ * @brief A minimal io_uring instance, driven through the raw system calls (no liburing dependency).
+ *
+ * Vectored reads and writes are queued with a completion callback, `SubmitAndWait` hands every queued request to the
+ * kernel with one `io_uring_enter` call and runs the callbacks as the completions arrive. The instance is not thread
+ * safe, the owner serializes its use.
+ */
+class IoUring {
+ public:
+  /** Called with the number of bytes transferred, or -errno. */
+  using Callback = std::function<void(int result)>;
+
+  /**
+   * @param entries size of the submission queue, rounded up to a power of two by the kernel
+   * @note check IsValid(), the setup fails on kernels without io_uring or when it is forbidden by seccomp
+   */
+  explicit IoUring(unsigned entries);
+
+  ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  auto IsValid() const -> bool { return ring_fd_ >= 0; }
+
+  /**
+   * @brief Queue a readv/writev of `iov_count` buffers at `offset` of `fd`. The iovecs must stay alive until the
+   * request completes.
+   * @return false if the submission queue is full, call SubmitAndWait() and retry
+   */
+  auto PrepareReadv(int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback) -> bool;
+
+  auto PrepareWritev(int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback) -> bool;
+
+  /**
+   * @brief Submit all queued requests and wait for every one of them, running the callbacks.
+   * @return false if the kernel rejected the submission (the callbacks of the rejected requests get -errno)
+   */
+  auto SubmitAndWait() -> bool;
+
+ private:
+  auto Prepare(uint8_t opcode, int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback) -> bool;
+
+  void ReapCompletions();
+
+  int ring_fd_{-1};
+  unsigned sq_entries_{0};
+
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // pointers into the mmapped rings
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+
+  unsigned queued_{0};     // prepared, not yet submitted
+  unsigned in_flight_{0};  // submitted, not yet completed
+  /** Callbacks of the outstanding requests, indexed by the user_data of their sqe. */
+  std::vector<Callback> callbacks_;
+  std::vector<unsigned> free_slots_;
+};
+
+}  // namespace easydb
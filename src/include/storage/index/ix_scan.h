@@ -26,6 +26,7 @@ class IxScan : public RecScan {
   Iid iid_;  // 初始为lower（用于遍历的指针）
   Iid end_;  // 初始为upper
   BufferPoolManager *bpm_;
+  int leaves_until_prefetch_{0};  // 还需经过多少个叶子结点才再次发起预读
 
  public:
   IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm)
@@ -33,6 +34,12 @@ class IxScan : public RecScan {
 
   void Next() override;
 
+ private:
+  /** 沿叶子结点链表预读当前叶子之后的PREFETCH_DEPTH个叶子，每经过PREFETCH_DEPTH / 2个叶子发起一次 */
+  void Prefetch();
+
+ public:
+
   bool IsEnd() const override { return iid_ == end_; }
 
   RID GetRid() const override;
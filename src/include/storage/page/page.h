@@ -59,15 +59,14 @@ class Page {
   friend class BufferPoolManager;
 
  public:
-  /** Constructor. Zeros out the page data. */
+  /** Constructor. The page data is attached by the buffer pool, see `data_`. */
   Page() { ResetMemory(); }
 
   /** Default destructor. */
   ~Page() = default;
 
   /** @return the actual data contained within this page */
-  inline auto GetData() -> char * { return data_.data(); }
-  // inline auto GetData() -> char * { return data_; }
+  inline auto GetData() -> char * { return data_; }
 
   /** @return the page id of this page */
   inline auto GetPageId() const -> PageId { return page_id_; }
@@ -111,35 +110,32 @@ class Page {
  private:
   /** @brief Resets the frame.
    *
-   * Zeroes out the data that is held within the frame and sets all fields to default values.
+   * Zeroes out the data that is held within the frame and sets all fields to default values. The pin count is left
+   * alone: the buffer pool's optimistic hit path may change it at any time, so it is only ever adjusted by increments.
    */
   inline void ResetMemory() {
-    data_.resize(PAGE_SIZE);
-    std::fill(data_.begin(), data_.end(), 0);
-    // memset(data_, 0, PAGE_SIZE);
+    if (data_ != nullptr) {
+      memset(data_, 0, PAGE_SIZE);
+    }
     page_id_.page_no = INVALID_PAGE_ID;
-    pin_count_.store(0, std::memory_order_release);
     is_dirty_.store(false, std::memory_order_release);
   }
 
   /** @brief The actual data that is stored within a page.
    *
-   * In practice, this should be stored as a `char data_[PAGE_SIZE]`.
-   * However, in order to allow address sanitizer to detect buffer overflow, we store it as a vector.
-   *
-   * Note that friend classes should make sure not increase the size of this data field.
+   * PAGE_SIZE bytes of the buffer pool's FrameArena: the data of all frames is one contiguous, aligned allocation,
+   * and the Page objects only hold the book-keeping of the frames.
    */
-  std::vector<char> data_;
-  // char data_[PAGE_SIZE];
+  char *data_{nullptr};
 
   /** @brief The ID of this page. */
   PageId page_id_;
 
   /** @brief The pin count of this page. */
-  std::atomic<size_t> pin_count_;
+  std::atomic<size_t> pin_count_{0};
 
   /** @brief True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  std::atomic<bool> is_dirty_;
+  std::atomic<bool> is_dirty_{false};
 
   /** @brief The page latch protecting data access. */
   std::shared_mutex rwlatch_;
@@ -114,7 +114,7 @@ class Tuple {
 
   auto GetValue(const Schema *schema, std::string column_name) const -> Value;
 
-  auto GetValue(const Column col) const -> Value;
+  auto GetValue(const Column &col) const -> Value;
 
   auto GetValueVec(const Schema *schema) const -> std::vector<Value>;
 
@@ -138,10 +138,63 @@ class Tuple {
 
   auto GetDataPtr(const Schema *schema, std::string column_name) const -> const char *;
 
-  auto GetDataPtr(const Column col) const -> const char *;
+  auto GetDataPtr(const Column &col) const -> const char *;
 
   RID rid_{};  // if pointing to the table heap, the rid is valid
   std::vector<char> data_;
 };
 
+/**
+ * A read-only view of a tuple that is stored somewhere else, usually in a page pinned by a table scan. It has the
+ * same format as Tuple and the same accessors, but does not own (or copy) the bytes: it is only valid as long as
+ * the storage it points into, so it has to be materialized into a Tuple to outlive the pin of its page.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t size, RID rid) : rid_(rid), data_(data), size_(size) {}
+
+  explicit TupleView(const Tuple &tuple) : rid_(tuple.GetRid()), data_(tuple.GetData()), size_(tuple.GetLength()) {}
+
+  // return RID of the viewed tuple
+  inline auto GetRid() const -> RID { return rid_; }
+
+  // Get the address of the viewed tuple
+  inline auto GetData() const -> const char * { return data_; }
+
+  // Get length of the tuple, including varchar length
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column, the same as Tuple::GetValue
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  auto GetValue(const Schema *schema, const std::string &column_name) const -> Value;
+
+  auto GetValue(const Column &col) const -> Value;
+
+  // Generates a key tuple given schemas and attributes
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema,
+                    const std::vector<uint32_t> &key_attrs) const -> Tuple;
+
+  // Copy the viewed bytes into a tuple of its own
+  auto Materialize() const -> Tuple;
+
+ private:
+  // Get the starting storage address of a column
+  auto GetDataPtr(const Column &col) const -> const char *;
+
+  RID rid_{};
+  const char *data_{nullptr};
+  uint32_t size_{0};
+};
+
+/**
+ * @brief Write the tuple a join makes of two tuples, the columns of `left` followed by those of `right`, into `out`,
+ * reusing its memory. The bytes are the same as those of a Tuple built from the values of both with the schema of
+ * the join, without building the values.
+ */
+void ConcatTuples(const TupleView &left, const Schema &left_schema, const TupleView &right,
+                  const Schema &right_schema, std::vector<char> *out);
+
 }  // namespace easydb
@@ -0,0 +1,141 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * tuple_accessor.h
+ *
+ * Identification: src/include/storage/table/tuple_accessor.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "catalog/schema.h"
+#include "type/limits.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace easydb {
+
+/**
+ * Reads the values of a column of type `type` straight from the bytes of a tuple, without building a Value.
+ * Read() takes the storage of a value (see ColumnAccessor::GetDataPtr) and returns the C++ value that the Type of the
+ * column compares; IsNull() tells the NULL sentinel of the type apart, like Value::IsNull() does.
+ */
+template <TypeId type>
+struct TypedReader;
+
+template <>
+struct TypedReader<TYPE_INT> {
+  using CppType = int32_t;
+  static inline auto Read(const char *storage) -> CppType {
+    CppType value;
+    std::memcpy(&value, storage, sizeof(value));
+    return value;
+  }
+  static inline auto IsNull(CppType value) -> bool { return value == EASYDB_INT32_NULL; }
+};
+
+template <>
+struct TypedReader<TYPE_LONG> {
+  using CppType = int64_t;
+  static inline auto Read(const char *storage) -> CppType {
+    CppType value;
+    std::memcpy(&value, storage, sizeof(value));
+    return value;
+  }
+  static inline auto IsNull(CppType value) -> bool { return value == EASYDB_INT64_NULL; }
+};
+
+template <>
+struct TypedReader<TYPE_DOUBLE> {
+  using CppType = double;
+  static inline auto Read(const char *storage) -> CppType {
+    CppType value;
+    std::memcpy(&value, storage, sizeof(value));
+    return value;
+  }
+  static inline auto IsNull(CppType value) -> bool { return value == EASYDB_DECIMAL_NULL; }
+};
+
+// FLOAT is stored as a double, like DOUBLE
+template <>
+struct TypedReader<TYPE_FLOAT> : TypedReader<TYPE_DOUBLE> {};
+
+template <>
+struct TypedReader<TYPE_DATE> {
+  using CppType = uint64_t;
+  static inline auto Read(const char *storage) -> CppType {
+    CppType value;
+    std::memcpy(&value, storage, sizeof(value));
+    return value;
+  }
+  static inline auto IsNull(CppType value) -> bool { return value == EASYDB_TIMESTAMP_NULL; }
+};
+
+// the storage of a string is its length, counting the terminating '\0', followed by its bytes
+template <>
+struct TypedReader<TYPE_VARCHAR> {
+  using CppType = std::string_view;
+  static inline auto Read(const char *storage) -> CppType {
+    uint32_t len;
+    std::memcpy(&len, storage, sizeof(len));
+    if (len == EASYDB_VALUE_NULL) {
+      return {};
+    }
+    return {storage + sizeof(uint32_t), len == 0 ? 0 : len - 1};
+  }
+  static inline auto IsNull(CppType value) -> bool { return value.data() == nullptr; }
+};
+
+template <>
+struct TypedReader<TYPE_CHAR> : TypedReader<TYPE_VARCHAR> {};
+
+/**
+ * A column of a schema resolved once to where its values are in a tuple, so that reading it for each tuple needs
+ * neither a lookup by name nor the Column itself.
+ */
+class ColumnAccessor {
+ public:
+  ColumnAccessor() = default;
+
+  explicit ColumnAccessor(const Column &col)
+      : offset_(col.GetOffset()), type_(col.GetType()), inlined_(col.IsInlined()) {}
+
+  ColumnAccessor(const Schema &schema, const std::string &col_name) : ColumnAccessor(schema.GetColumn(col_name)) {}
+
+  inline auto GetType() const -> TypeId { return type_; }
+
+  /** @return the storage of the value of the column in the bytes of a tuple, the same as Tuple::GetDataPtr */
+  inline auto GetDataPtr(const char *tuple) const -> const char * {
+    if (inlined_) {
+      return tuple + offset_;
+    }
+    // a string is stored after the inlined columns, the column holds its offset in the tuple
+    int32_t offset;
+    std::memcpy(&offset, tuple + offset_, sizeof(offset));
+    return tuple + offset;
+  }
+
+  /** @return the value of the column as the C++ type of `type`, which has to be the type of the column */
+  template <TypeId type>
+  inline auto Read(const char *tuple) const -> typename TypedReader<type>::CppType {
+    return TypedReader<type>::Read(GetDataPtr(tuple));
+  }
+
+  /** @return the value of the column in the bytes of a tuple, the same as Tuple::GetValue */
+  inline auto GetValue(const char *tuple) const -> Value { return Value::DeserializeFrom(GetDataPtr(tuple), type_); }
+
+ private:
+  uint32_t offset_{0};
+  TypeId type_{TYPE_EMPTY};
+  bool inlined_{true};
+};
+
+}  // namespace easydb
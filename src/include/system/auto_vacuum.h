@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * auto_vacuum.h
+ *
+ * Identification: src/include/system/auto_vacuum.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "common/config.h"
+
+namespace easydb {
+
+class SmManager;
+class TransactionManager;
+class LockManager;
+class LogManager;
+
+/**
+ * @brief Background vacuum.
+ *
+ * A single thread that periodically vacuums the tables that had at least `min_dead_tuples` tuples deleted since they
+ * were last vacuumed (see SmManager::VacuumTable()). Every table is vacuumed in a transaction of its own that takes
+ * the exclusive table lock; when wait-die aborts it because an older transaction uses the table, the table is left
+ * for the next round.
+ */
+class AutoVacuum {
+ public:
+  /**
+   * @param interval time between two rounds
+   * @param min_dead_tuples deleted tuples that make a table worth vacuuming
+   */
+  AutoVacuum(SmManager *sm_manager, TransactionManager *txn_manager, LockManager *lock_manager,
+             LogManager *log_manager, std::chrono::milliseconds interval, size_t min_dead_tuples);
+
+  ~AutoVacuum();
+
+ private:
+  void Run();
+
+  SmManager *sm_manager_;
+  TransactionManager *txn_manager_;
+  LockManager *lock_manager_;
+  LogManager *log_manager_;
+  const std::chrono::milliseconds interval_;
+  const size_t min_dead_tuples_;
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace easydb
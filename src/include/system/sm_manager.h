@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <mutex>
+
 #include "common/context.h"
 #include "record/rm_file_handle.h"
 #include "record/rm_manager.h"
@@ -39,6 +41,7 @@ class SmManager {
   std::unordered_map<std::string, std::unique_ptr<IxIndexHandle>>
       ihs_;  // file name -> index file handle, 当前数据库中每个索引的文件
  private:
+  std::mutex fhs_latch_;  // 保护建表/删表时对fhs_的修改，使后台VACUUM可以遍历fhs_
   DiskManager *disk_manager_;
   BufferPoolManager *buffer_pool_manager_;
   RmManager *rm_manager_;
@@ -89,12 +92,23 @@ class SmManager {
 
   void DescTable(const std::string &tab_name, Context *context);
 
-  void CreateTable(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context);
+  void CreateTable(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                   bool column_storage = false);
 
   void DropTable(const std::string &tab_name, Context *context);
 
   void ShowIndex(const std::string &tab_name, Context *context);
 
+  void ShowBufferStats(Context *context);
+
+  void ShowIoStats(Context *context);
+
+  void Vacuum(const std::string &tab_name, Context *context);
+
+  auto VacuumTable(const std::string &tab_name, Context *context) -> RmVacuumStats;
+
+  auto GetVacuumCandidates(size_t min_dead_tuples) -> std::vector<std::string>;
+
   void CreateIndex(const std::string &tab_name, const std::vector<std::string> &col_names, Context *context);
 
   void DropIndex(const std::string &tab_name, const std::vector<std::string> &col_names, Context *context);
@@ -237,6 +251,12 @@ class SmManager {
     return table_attr_sum_[table_name][attr_name];
   }
 
+ private:
+  /** @return the columns of a table that its zone map keeps the ranges of, none if zone maps are disabled */
+  static auto ZoneColumns(const Schema &schema) -> std::vector<RmZoneColumn>;
+
+  /** @return where the VARCHAR values of the records of a table are, empty if it has none */
+  static auto ToastLayout(const Schema &schema) -> RmToastLayout;
 };
 
 }  // namespace easydb
@@ -66,7 +66,7 @@ class Value {
   // BIGINT
   Value(TypeId type, int64_t i);
   // LONG
-  Value(TypeId type, long long ll) { Value(type, static_cast<int64_t>(ll)); }
+  Value(TypeId type, long long ll) : Value(type, static_cast<int64_t>(ll)) {}
   // TIMESTAMP
   Value(TypeId type, uint64_t i);
   // CHAR and VARCHAR
@@ -21,10 +21,10 @@ using namespace ast;
 %define parse.error verbose
 
 // keywords
-%token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY AS COUNT MAX MIN SUM GROUP HAVING IN
+%token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY AS COUNT MAX MIN SUM AVG GROUP HAVING IN
 WHERE UPDATE SET SELECT INT CHAR VARCHAR FLOAT DATETIME NOT_NULL INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY 
 UNIQUE ENABLE_NESTLOOP ENABLE_SORTMERGE ENABLE_HASHJOIN ENABLE_OPTIMIZER
-STATIC_CHECKPOINT LOAD OUTPUT_FILE
+STATIC_CHECKPOINT LOAD OUTPUT_FILE BUFFER_STATS IO_STATS VACUUM WITH
 
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
@@ -125,6 +125,18 @@ dbStmt:
     {
         $$ = std::make_shared<ShowIndex>($4);
     }
+    |   SHOW BUFFER_STATS
+    {
+        $$ = std::make_shared<ShowBufferStats>();
+    }
+    |   SHOW IO_STATS
+    {
+        $$ = std::make_shared<ShowIoStats>();
+    }
+    |   VACUUM tbName
+    {
+        $$ = std::make_shared<Vacuum>($2);
+    }
     ;
 
 setStmt:
@@ -146,6 +158,10 @@ ddl:
     {
         $$ = std::make_shared<CreateTable>($3, $5);
     }
+    |   CREATE TABLE tbName '(' fieldList ')' WITH '(' IDENTIFIER '=' IDENTIFIER ')'
+    {
+        $$ = std::make_shared<CreateTable>($3, $5, std::vector<std::pair<std::string, std::string>>{{$9, $11}});
+    }
     |   DROP TABLE tbName
     {
         $$ = std::make_shared<DropTable>($3);
@@ -364,6 +380,10 @@ col:
     {
         $$ = std::make_shared<Col>("", $3, $6, SUM_AGG);
     }
+    |   AVG '(' colName ')' AS colName
+    {
+        $$ = std::make_shared<Col>("", $3, $6, AVG_AGG);
+    }
     |   COUNT '(' '*' ')'
     {
         $$ = std::make_shared<Col>("", "", "", COUNT_AGG);
@@ -384,6 +404,10 @@ col:
     {
         $$ = std::make_shared<Col>("", $3, "", SUM_AGG);
     }
+    |   AVG '(' colName ')'
+    {
+        $$ = std::make_shared<Col>("", $3, "", AVG_AGG);
+    }
     ;
 
 colList:
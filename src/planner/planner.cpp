@@ -748,7 +748,24 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query, Contex
           table_join_executors = std::make_shared<JoinPlan>(T_SortMerge, std::move(left), std::move(right), join_conds);
         }
       } else if (enable_hash_join) {
-        table_join_executors = std::make_shared<JoinPlan>(T_HashJoin, std::move(left), std::move(right), join_conds);
+        // 输入够大时并行执行hash join；并行的hash join不落盘，左表（build侧）的行需要放得进内存
+        // 没有统计信息时行数只是猜测，此时使用会落盘的串行hash join
+        int left_count = sm_manager_->GetTableCount(it->lhs_col.tab_name);
+        int right_count = sm_manager_->GetTableCount(it->rhs_col.tab_name);
+        PlanTag tag = T_HashJoin;
+        if (left_count >= 0 && right_count >= 0 &&
+            std::max(left_count, right_count) >= PARALLEL_HASH_JOIN_MIN_ROWS) {
+          // 变长列按声明的长度计入，只算inline部分会低估VARCHAR表的大小
+          const Schema &left_schema = sm_manager_->db_.get_table(it->lhs_col.tab_name).schema;
+          double row_bytes = left_schema.GetInlinedStorageSize();
+          for (uint32_t col_idx : left_schema.GetUnlinedColumns()) {
+            row_bytes += left_schema.GetColumn(col_idx).GetStorageSize();
+          }
+          if (static_cast<double>(left_count) * row_bytes <= HASH_JOIN_MEMORY_BUDGET) {
+            tag = T_ParallelHashJoin;
+          }
+        }
+        table_join_executors = std::make_shared<JoinPlan>(tag, std::move(left), std::move(right), join_conds);
       } else {
         // error
         throw EASYDBError("No join executor selected!");
@@ -867,9 +884,62 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
   if (plannerRoot->tag != T_Empty)
     plannerRoot = std::make_shared<ProjectionPlan>(T_Projection, std::move(plannerRoot), std::move(sel_cols));
 
+  // 扫描只需要从toast中读回查询用到的VARCHAR字段
+  std::vector<TabCol> read_cols;
+  std::vector<std::shared_ptr<ScanPlan>> scans;
+  collect_read_cols(plannerRoot, read_cols, scans);
+  for (auto &scan : scans) {
+    scan->read_cols_.clear();
+    for (auto &col : read_cols) {
+      // 没有表名的字段按所有表的字段处理
+      if (col.tab_name.empty() || col.tab_name == scan->tab_name_) {
+        scan->read_cols_.push_back(col.col_name);
+      }
+    }
+    scan->reads_all_cols_ = false;
+  }
+
   return plannerRoot;
 }
 
+/**
+ * @brief 收集计划树中用到的字段：投影、排序、聚合的字段以及扫描和连接条件中的字段
+ *
+ * @param plan 计划树
+ * @param read_cols 用到的字段
+ * @param scans 计划树中的扫描
+ */
+void Planner::collect_read_cols(const std::shared_ptr<Plan> &plan, std::vector<TabCol> &read_cols,
+                                std::vector<std::shared_ptr<ScanPlan>> &scans) {
+  auto add_conds = [&read_cols](const std::vector<Condition> &conds) {
+    for (auto &cond : conds) {
+      read_cols.push_back(cond.lhs_col);
+      if (!cond.is_rhs_val && !cond.is_rhs_stmt) {
+        read_cols.push_back(cond.rhs_col);
+      }
+    }
+  };
+  if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+    add_conds(x->conds_);
+    scans.push_back(x);
+  } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+    add_conds(x->conds_);
+    collect_read_cols(x->left_, read_cols, scans);
+    collect_read_cols(x->right_, read_cols, scans);
+  } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+    read_cols.insert(read_cols.end(), x->sel_cols_.begin(), x->sel_cols_.end());
+    collect_read_cols(x->subplan_, read_cols, scans);
+  } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+    read_cols.push_back(x->sel_col_);
+    collect_read_cols(x->subplan_, read_cols, scans);
+  } else if (auto x = std::dynamic_pointer_cast<AggregationPlan>(plan)) {
+    read_cols.insert(read_cols.end(), x->sel_cols_.begin(), x->sel_cols_.end());
+    read_cols.insert(read_cols.end(), x->group_cols_.begin(), x->group_cols_.end());
+    add_conds(x->having_conds_);
+    collect_read_cols(x->subplan_, read_cols, scans);
+  }
+}
+
 // 生成DDL语句和DML语句的查询执行计划
 std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context *context) {
   std::shared_ptr<Plan> plannerRoot;
@@ -886,7 +956,18 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
         throw InternalError("Unexpected field type");
       }
     }
-    plannerRoot = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+    auto ddl_plan = std::make_shared<DDLPlan>(T_CreateTable, x->tab_name, std::vector<std::string>(), col_defs);
+    for (auto &[name, value] : x->options) {
+      auto lower = [](std::string str) {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        return str;
+      };
+      if (lower(name) != "storage" || (lower(value) != "column" && lower(value) != "row")) {
+        throw InternalError("Unsupported table option " + name + " = " + value + ", expected storage = {row | column}");
+      }
+      ddl_plan->column_storage_ = lower(value) == "column";
+    }
+    plannerRoot = ddl_plan;
   } else if (auto x = std::dynamic_pointer_cast<ast::DropTable>(query->parse)) {
     // drop table;
     plannerRoot =
@@ -919,6 +1000,8 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
           std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, x->tab_name, query->conds, index_col_names);
     }
 
+    // 扫描只用来找到要删除的记录，不需要读回toast中的值
+    std::static_pointer_cast<ScanPlan>(table_scan_executors)->reads_all_cols_ = false;
     plannerRoot = std::make_shared<DMLPlan>(T_Delete, table_scan_executors, x->tab_name, std::vector<Value>(),
                                             query->conds, std::vector<SetClause>());
   } else if (auto x = std::dynamic_pointer_cast<ast::UpdateStmt>(query->parse)) {
@@ -938,6 +1021,8 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
       table_scan_executors =
           std::make_shared<ScanPlan>(T_IndexScan, sm_manager_, x->tab_name, query->conds, index_col_names);
     }
+    // 扫描只用来找到要更新的记录，更新时再按rid读出完整的记录
+    std::static_pointer_cast<ScanPlan>(table_scan_executors)->reads_all_cols_ = false;
     plannerRoot = std::make_shared<DMLPlan>(T_Update, table_scan_executors, x->tab_name, std::vector<Value>(),
                                             query->conds, query->set_clauses);
   } else if (auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse)) {
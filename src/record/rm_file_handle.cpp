@@ -16,33 +16,181 @@
 
 namespace easydb {
 
+void RmPageHandle::InitPaxLayout(RmFileHdr *file_hdr, const std::vector<int> &column_sizes) {
+  if (column_sizes.empty() || column_sizes.size() > static_cast<size_t>(RM_PAX_MAX_COLUMNS)) {
+    throw InternalError("RmPageHandle::InitPaxLayout Error: a PAX table has 1 to " +
+                        std::to_string(RM_PAX_MAX_COLUMNS) + " columns");
+  }
+  int record_size = 0;
+  for (int column_size : column_sizes) {
+    record_size += column_size;
+  }
+  if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
+    throw InvalidRecordSizeError(record_size);
+  }
+  auto align = [](size_t offset) { return (offset + 7) & ~static_cast<size_t>(7); };
+  // start from the capacity without the padding, and give records back until the padding fits as well
+  auto capacity = static_cast<size_t>((PAGE_SIZE - TABLE_PAGE_HEADER_SIZE) * 8 / (record_size * 8 + 1));
+  while (true) {
+    size_t offset = align(TABLE_PAGE_HEADER_SIZE + (capacity + 7) / 8);
+    for (size_t col = 0; col < column_sizes.size(); col++) {
+      file_hdr->pax_column_sizes[col] = static_cast<uint16_t>(column_sizes[col]);
+      file_hdr->pax_column_offsets[col] = static_cast<uint16_t>(offset);
+      offset = align(offset + capacity * column_sizes[col]);
+    }
+    if (offset <= PAGE_SIZE) {
+      break;
+    }
+    capacity--;
+  }
+  file_hdr->page_format = RM_PAGE_FORMAT_PAX;
+  file_hdr->record_size = record_size;
+  file_hdr->pax_capacity = static_cast<int>(capacity);
+  file_hdr->pax_num_columns = static_cast<int>(column_sizes.size());
+}
+
+void RmPageHandle::ReadPaxRecord(uint32_t slot_no, char *dst) const {
+  for (int col = 0; col < file_hdr->pax_num_columns; col++) {
+    uint16_t size = file_hdr->pax_column_sizes[col];
+    memcpy(dst, page_start_ + file_hdr->pax_column_offsets[col] + slot_no * size, size);
+    dst += size;
+  }
+}
+
+void RmPageHandle::WritePaxRecord(uint32_t slot_no, const char *src) {
+  for (int col = 0; col < file_hdr->pax_num_columns; col++) {
+    uint16_t size = file_hdr->pax_column_sizes[col];
+    memcpy(page_start_ + file_hdr->pax_column_offsets[col] + slot_no * size, src, size);
+    src += size;
+  }
+}
+
 auto RmPageHandle::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
+  if (pax_) {
+    if (tuple.GetLength() != static_cast<uint32_t>(file_hdr->record_size)) {
+      throw InternalError("RmPageHandle::GetNextTupleOffset Error: a PAX page only stores records of fixed size");
+    }
+    // the place of a record follows from its slot number, there is no offset to hand out
+    if (page_hdr_->num_records >= file_hdr->pax_capacity) {
+      return std::nullopt;
+    }
+    return 0;
+  }
   size_t slot_end_offset;
   if (page_hdr_->num_records > 0) {
-    auto &[offset, size, meta] = tuple_info_[page_hdr_->num_records - 1];
-    slot_end_offset = offset;
+    slot_end_offset = StoredOffset(page_hdr_->num_records - 1);
   } else {
     slot_end_offset = PAGE_SIZE;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
-  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (page_hdr_->num_records + 1);
-  // Note that we donnot use (tuple_offset < offset_size) because slot_end_offset may < tuple.GetLength()
-  if (slot_end_offset < offset_size + tuple.GetLength()) {
+  size_t slot_size = SlotSize(file_hdr->page_format);
+  size_t stored_size = InsertSize(file_hdr->page_format, meta, tuple) - slot_size;
+  auto tuple_offset = slot_end_offset - stored_size;
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + slot_size * (page_hdr_->num_records + 1);
+  // Note that we donnot use (tuple_offset < offset_size) because slot_end_offset may < stored_size
+  if (slot_end_offset < offset_size + stored_size) {
     return std::nullopt;
   }
   return tuple_offset;
 }
 
+auto RmPageHandle::GetFreeSpace() const -> size_t {
+  if (pax_) {
+    return static_cast<size_t>(file_hdr->pax_capacity - page_hdr_->num_records) * file_hdr->record_size;
+  }
+  size_t slot_end_offset = PAGE_SIZE;
+  if (page_hdr_->num_records > 0) {
+    slot_end_offset = StoredOffset(page_hdr_->num_records - 1);
+  }
+  return slot_end_offset - (TABLE_PAGE_HEADER_SIZE + SlotSize(file_hdr->page_format) * page_hdr_->num_records);
+}
+
+auto RmPageHandle::ReadMeta(uint32_t slot_no) const -> TupleMeta {
+  if (pax_) {
+    return TupleMeta{0, IsSlotDeleted(slot_no)};
+  }
+  if (!compact_) {
+    return std::get<2>(tuple_info_[slot_no]);
+  }
+  const RmSlot &slot = slots_[slot_no];
+  TupleMeta meta{0, slot.IsDeleted()};
+  if (slot.HasTs()) {
+    memcpy(&meta.ts_, page_start_ + slot.offset_, sizeof(timestamp_t));
+  }
+  return meta;
+}
+
+void RmPageHandle::WriteMeta(uint32_t slot_no, const TupleMeta &meta) {
+  if (pax_) {
+    if (meta.ts_ != 0) {
+      throw InternalError("RmPageHandle::WriteMeta Error: a PAX page does not store timestamps");
+    }
+    char *bitmap = page_start_ + TABLE_PAGE_HEADER_SIZE;
+    if (meta.is_deleted_) {
+      Bitmap::set(bitmap, static_cast<int>(slot_no));
+    } else {
+      Bitmap::reset(bitmap, static_cast<int>(slot_no));
+    }
+    return;
+  }
+  if (!compact_) {
+    std::get<2>(tuple_info_[slot_no]) = meta;
+    return;
+  }
+  RmSlot &slot = slots_[slot_no];
+  if (slot.HasTs()) {
+    memcpy(page_start_ + slot.offset_, &meta.ts_, sizeof(timestamp_t));
+  } else if (meta.ts_ != 0) {
+    throw InternalError("RmPageHandle::WriteMeta Error: no room for the timestamp of the tuple");
+  }
+  slot.size_flags_ = meta.is_deleted_ ? (slot.size_flags_ | RmSlot::DELETED) : (slot.size_flags_ & ~RmSlot::DELETED);
+}
+
+void RmPageHandle::SetStoredPlace(uint32_t slot_no, uint16_t offset, uint16_t size) {
+  if (!compact_) {
+    std::get<0>(tuple_info_[slot_no]) = offset;
+    std::get<1>(tuple_info_[slot_no]) = size;
+    return;
+  }
+  RmSlot &slot = slots_[slot_no];
+  uint16_t flags = slot.size_flags_ & ~RmSlot::SIZE_MASK;
+  if (size == 0) {
+    flags &= ~RmSlot::HAS_TS;
+  }
+  slot.offset_ = offset;
+  slot.size_flags_ = flags | size;
+}
+
+auto RmPageHandle::AppendTuple(uint16_t offset, const TupleMeta &meta, const Tuple &tuple) -> uint16_t {
+  auto tuple_id = page_hdr_->num_records;
+  if (pax_) {
+    WriteMeta(tuple_id, meta);
+    WritePaxRecord(tuple_id, tuple.data_.data());
+    page_hdr_->num_records++;
+    return tuple_id;
+  }
+  if (compact_) {
+    bool store_ts = meta.ts_ != 0;
+    uint16_t ts_size = store_ts ? sizeof(timestamp_t) : 0;
+    uint16_t flags = (store_ts ? RmSlot::HAS_TS : 0) | (meta.is_deleted_ ? RmSlot::DELETED : 0);
+    slots_[tuple_id] = RmSlot{offset, static_cast<uint16_t>(flags | (ts_size + tuple.GetLength()))};
+    if (store_ts) {
+      memcpy(page_start_ + offset, &meta.ts_, sizeof(timestamp_t));
+    }
+    offset += ts_size;
+  } else {
+    tuple_info_[tuple_id] = std::make_tuple(offset, tuple.GetLength(), meta);
+  }
+  page_hdr_->num_records++;
+  memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
+  return tuple_id;
+}
+
 auto RmPageHandle::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
   auto tuple_offset = GetNextTupleOffset(meta, tuple);
   if (tuple_offset == std::nullopt) {
     return std::nullopt;
   }
-  auto tuple_id = page_hdr_->num_records;
-  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
-  page_hdr_->num_records++;
-  memcpy(page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
-  return tuple_id;
+  return AppendTuple(*tuple_offset, meta, tuple);
 }
 
 void RmPageHandle::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
@@ -50,11 +198,10 @@ void RmPageHandle::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
   if (tuple_id >= page_hdr_->num_records) {
     throw easydb::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+  if (!IsSlotDeleted(tuple_id) && meta.is_deleted_) {
     page_hdr_->num_deleted_records++;
   }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  WriteMeta(tuple_id, meta);
 }
 
 auto RmPageHandle::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
@@ -62,12 +209,54 @@ auto RmPageHandle::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>
   if (tuple_id >= page_hdr_->num_records) {
     throw easydb::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, meta] = tuple_info_[tuple_id];
   Tuple tuple;
+  if (pax_) {
+    tuple.data_.resize(file_hdr->record_size);
+    ReadPaxRecord(tuple_id, tuple.data_.data());
+    tuple.rid_ = rid;
+    return std::make_pair(ReadMeta(tuple_id), std::move(tuple));
+  }
+  auto [offset, size] = TupleData(tuple_id);
   tuple.data_.resize(size);
   memmove(tuple.data_.data(), page_start_ + offset, size);
   tuple.rid_ = rid;
-  return std::make_pair(meta, std::move(tuple));
+  return std::make_pair(ReadMeta(tuple_id), std::move(tuple));
+}
+
+auto RmPageHandle::GetTupleView(const RID &rid) const -> TupleView {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= page_hdr_->num_records) {
+    throw easydb::Exception("Tuple ID out of range");
+  }
+  if (pax_) {
+    throw InternalError("RmPageHandle::GetTupleView Error: the records of a PAX page are not stored in place");
+  }
+  auto [offset, size] = TupleData(tuple_id);
+  return {page_start_ + offset, size, rid};
+}
+
+void RmPageHandle::GetTupleViews(uint32_t first_slot, std::vector<TupleView> &views) const {
+  page_id_t page_no = page->GetPageId().page_no;
+  uint32_t num_records = page_hdr_->num_records;
+  if (pax_) {
+    throw InternalError("RmPageHandle::GetTupleViews Error: the records of a PAX page are not stored in place");
+  }
+  if (compact_) {
+    for (uint32_t slot_no = first_slot; slot_no < num_records; slot_no++) {
+      const RmSlot &slot = slots_[slot_no];
+      if (!slot.IsDeleted()) {
+        uint16_t ts_size = slot.HasTs() ? sizeof(timestamp_t) : 0;
+        views.emplace_back(page_start_ + slot.offset_ + ts_size, slot.Size() - ts_size, RID{page_no, slot_no});
+      }
+    }
+    return;
+  }
+  for (uint32_t slot_no = first_slot; slot_no < num_records; slot_no++) {
+    auto &[offset, size, meta] = tuple_info_[slot_no];
+    if (!meta.is_deleted_) {
+      views.emplace_back(page_start_ + offset, size, RID{page_no, slot_no});
+    }
+  }
 }
 
 auto RmPageHandle::GetTupleMeta(const RID &rid) const -> TupleMeta {
@@ -75,8 +264,7 @@ auto RmPageHandle::GetTupleMeta(const RID &rid) const -> TupleMeta {
   if (tuple_id >= page_hdr_->num_records) {
     throw easydb::Exception("Tuple ID out of range");
   }
-  auto &[_1, _2, meta] = tuple_info_[tuple_id];
-  return meta;
+  return ReadMeta(tuple_id);
 }
 
 void RmPageHandle::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
@@ -84,7 +272,18 @@ void RmPageHandle::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &
   if (tuple_id >= page_hdr_->num_records) {
     throw easydb::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  if (pax_) {
+    if (tuple.GetLength() != static_cast<uint32_t>(file_hdr->record_size)) {
+      throw easydb::Exception("Tuple size mismatch");
+    }
+    if (!IsSlotDeleted(tuple_id) && meta.is_deleted_) {
+      page_hdr_->num_deleted_records++;
+    }
+    WriteMeta(tuple_id, meta);
+    WritePaxRecord(tuple_id, tuple.data_.data());
+    return;
+  }
+  auto [offset, size] = TupleData(tuple_id);
   // if (size != tuple.GetLength()) {
   //   throw easydb::Exception("Tuple size mismatch");
   // }
@@ -92,59 +291,145 @@ void RmPageHandle::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &
   if (size < tuple.GetLength()) {
     throw easydb::Exception("Tuple size mismatch");
   }
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+  if (!IsSlotDeleted(tuple_id) && meta.is_deleted_) {
     page_hdr_->num_deleted_records++;
   }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  WriteMeta(tuple_id, meta);
   memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
 }
 
 auto RmPageHandle::IsTupleDeleted(const RID &rid) -> bool {
-  auto meta = GetTupleMeta(rid);
-  return meta.is_deleted_;
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= page_hdr_->num_records) {
+    throw easydb::Exception("Tuple ID out of range");
+  }
+  return IsSlotDeleted(tuple_id);
 }
 
-auto RmFileHandle::InsertTuple(const TupleMeta &meta, const Tuple &tuple, Context *context) -> std::optional<RID> {
-  // 1. Fetch the current first free page handle
-  RmPageHandle page_handle = CreatePageHandle();
-  int page_no = page_handle.page->GetPageId().page_no;
-  std::optional<uint16_t> tuple_offset;
-
-  // 2. Find a free slot in the page handle
-  while (true) {
-    tuple_offset = page_handle.GetNextTupleOffset(meta, tuple);
-    if (tuple_offset != std::nullopt) {
-      break;
+auto RmPageHandle::NeedsCompaction() const -> bool {
+  uint32_t num_records = page_hdr_->num_records;
+  if (pax_) {
+    // the records do not move, only the deleted ones at the end can be given back
+    return num_records > 0 && IsSlotDeleted(num_records - 1);
+  }
+  for (uint32_t slot_no = 0; slot_no < num_records; slot_no++) {
+    if (IsSlotDeleted(slot_no) && (StoredSize(slot_no) > 0 || slot_no == num_records - 1)) {
+      return true;
     }
+  }
+  return false;
+}
 
-    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
-    EASYDB_ENSURE(page_handle.GetNumTuples() != 0, "tuple is too large, cannot insert");
+auto RmPageHandle::Compact(uint32_t *slots_reclaimed) -> size_t {
+  size_t free_space = GetFreeSpace();
 
-    auto new_page_handle = CreateNewPageHandle();
-    page_handle.SetNextPageId(new_page_handle.page->GetPageId().page_no);
-    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
-
-    page_handle = std::move(new_page_handle);
-    page_no = page_handle.page->GetPageId().page_no;
+  // 1. Give the dead slots at the end back, the slots before them keep their numbers
+  uint16_t num_records = page_hdr_->num_records;
+  while (num_records > 0 && IsSlotDeleted(num_records - 1)) {
+    num_records--;
   }
-
-  // 3. Insert the tuple to the free slot
-  // auto slot_no = *page_handle.InsertTuple(meta, tuple);
-  auto slot_no = page_handle.page_hdr_->num_records;
-  auto rid = RID(page_no, slot_no);
-  // lock manager
-  if (context != nullptr) {
-    context->lock_mgr_->LockExclusiveOnRecord(context->txn_, rid, fd_);
+  *slots_reclaimed = page_hdr_->num_records - num_records;
+  if (pax_) {
+    for (uint16_t slot_no = num_records; slot_no < page_hdr_->num_records; slot_no++) {
+      Bitmap::reset(page_start_ + TABLE_PAGE_HEADER_SIZE, slot_no);
+    }
+    page_hdr_->num_records = num_records;
+    page_hdr_->num_deleted_records = 0;
+    for (uint16_t slot_no = 0; slot_no < num_records; slot_no++) {
+      page_hdr_->num_deleted_records += IsSlotDeleted(slot_no) ? 1 : 0;
+    }
+    return GetFreeSpace() - free_space;
   }
 
-  page_handle.tuple_info_[slot_no] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
-  page_handle.page_hdr_->num_records++;
-  memcpy(page_handle.page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
-
-  // Unpin the page that was pinned in create_page_handle
-  buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
+  // 2. Lay the live tuples out again from the end of the page in slot order, a dead slot is left empty at the
+  //    offset of the tuple before it, so that the last slot still has the lowest offset
+  char old_page[PAGE_SIZE];
+  memcpy(old_page, page_start_, PAGE_SIZE);
+  uint16_t tuple_end = PAGE_SIZE;
+  uint16_t num_deleted = 0;
+  for (uint16_t slot_no = 0; slot_no < num_records; slot_no++) {
+    if (IsSlotDeleted(slot_no)) {
+      SetStoredPlace(slot_no, tuple_end, 0);
+      num_deleted++;
+    } else {
+      uint16_t size = StoredSize(slot_no);
+      tuple_end -= size;
+      memcpy(page_start_ + tuple_end, old_page + StoredOffset(slot_no), size);
+      SetStoredPlace(slot_no, tuple_end, size);
+    }
+  }
+  page_hdr_->num_records = num_records;
+  page_hdr_->num_deleted_records = num_deleted;
+  return GetFreeSpace() - free_space;
+}
 
-  return rid;
+auto RmFileHandle::InsertTuple(const TupleMeta &meta, const Tuple &new_tuple, Context *context,
+                               BufferAccessStrategy *strategy) -> std::optional<RID> {
+  // a large tuple is stored with its long values moved to the toast
+  std::optional<Tuple> toasted;
+  if (toast_ != nullptr && toast_->NeedsToast(new_tuple)) {
+    toasted = toast_->Toast(new_tuple);
+  }
+  const Tuple &tuple = toasted.has_value() ? *toasted : new_tuple;
+  uint8_t min_class =
+      RmFreeSpaceMap::RequestToClass(RmPageHandle::InsertSize(file_hdr_.page_format, meta, tuple));
+  // no record points at the chunks of a failed insert, they are freed before the error leaves
+  try {
+    while (true) {
+      // 1. Find a page with enough free space in the free space map, or add a new page
+      page_id_t page_no = fsm_->FindPage(min_class);
+      bool is_new_page = page_no == RM_NO_PAGE;
+      RmPageHandle page_handle = is_new_page ? CreateNewPageHandle(strategy) : FetchPageHandle(page_no, strategy);
+      page_no = page_handle.page->GetPageId().page_no;
+      if (is_new_page) {
+        fsm_->SetHint(page_no);
+      }
+
+      // 2. Check the free space, the map is only a hint
+      page_handle.page->WLatch();
+      std::optional<uint16_t> tuple_offset = page_handle.GetNextTupleOffset(meta, tuple);
+      if (tuple_offset == std::nullopt) {
+        // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+        bool is_empty = page_handle.GetNumTuples() == 0;
+        fsm_->SetClass(page_no, RmFreeSpaceMap::FreeSpaceToClass(page_handle.GetFreeSpace()));
+        page_handle.page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+        EASYDB_ENSURE(!is_empty, "tuple is too large, cannot insert");
+        continue;
+      }
+
+      // 3. Insert the tuple to the free slot
+      auto slot_no = page_handle.page_hdr_->num_records;
+      auto rid = RID(page_no, slot_no);
+      // lock manager, an abort leaves the page as it was
+      if (context != nullptr) {
+        try {
+          context->lock_mgr_->LockExclusiveOnRecord(context->txn_, rid, fd_);
+        } catch (...) {
+          page_handle.page->WUnlatch();
+          buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+          throw;
+        }
+      }
+
+      // the range of the page covers the record before anyone can see it
+      if (zone_map_ != nullptr) {
+        zone_map_->Extend(page_no, tuple.GetData());
+      }
+      page_handle.AppendTuple(*tuple_offset, meta, tuple);
+      fsm_->SetClass(page_no, RmFreeSpaceMap::FreeSpaceToClass(page_handle.GetFreeSpace()));
+      page_handle.page->WUnlatch();
+
+      // Unpin the page that was pinned in FetchPageHandle / CreateNewPageHandle
+      buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
+      return rid;
+    }
+  } catch (...) {
+    if (toasted.has_value()) {
+      toast_->Free(TupleView(*toasted));
+    }
+    throw;
+  }
 }
 
 auto RmFileHandle::InsertTuple(RID rid, const TupleMeta &meta, const Tuple &tuple, Context *context) -> bool {
@@ -155,6 +440,10 @@ auto RmFileHandle::InsertTuple(RID rid, const TupleMeta &meta, const Tuple &tupl
   RmPageHandle page_handle = FetchPageHandle(rid.GetPageId());
   auto [old_meta, old_tup] = page_handle.GetTuple(rid);
   if (old_meta.is_deleted_) {
+    // the ranges of the page may have been computed without the deleted record
+    if (zone_map_ != nullptr) {
+      zone_map_->Extend(rid.GetPageId(), old_tup.GetData());
+    }
     old_meta.is_deleted_ = false;
     page_handle.UpdateTupleMeta(old_meta, rid);
   } else {
@@ -178,6 +467,7 @@ auto RmFileHandle::DeleteTuple(RID rid, Context *context) -> bool {
   meta.is_deleted_ = true;
   page_handle.UpdateTupleMeta(meta, rid);
   buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
+  num_dead_tuples_.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
 
@@ -190,9 +480,37 @@ auto RmFileHandle::UpdateTupleInPlace(const TupleMeta &meta, const Tuple &tuple,
   }
   RmPageHandle page_handle = FetchPageHandle(rid.GetPageId());
   auto [old_meta, old_tup] = page_handle.GetTuple(rid);
+  // the check sees the old values, `old_stored` keeps the pointers to their chunks if some were toasted
+  std::vector<char> old_stored;
+  bool old_toasted = toast_ != nullptr && toast_->Detoast(TupleView(old_tup), nullptr, &old_stored);
+  if (old_toasted) {
+    std::swap(old_tup.data_, old_stored);
+  }
   if (check == nullptr || check(old_meta, old_tup, rid)) {
-    page_handle.UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+    if (toast_ == nullptr) {
+      if (zone_map_ != nullptr) {
+        zone_map_->Extend(rid.GetPageId(), tuple.GetData());
+      }
+      page_handle.UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+      buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
+      return true;
+    }
+    // the new values are toasted before the old ones are freed, a failed update leaves the old record untouched
+    Tuple stored = toast_->NeedsToast(tuple) ? toast_->Toast(tuple) : tuple;
+    try {
+      page_handle.UpdateTupleInPlaceUnsafe(meta, stored, rid);
+    } catch (...) {
+      toast_->Free(TupleView(stored));
+      buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+      throw;
+    }
+    if (zone_map_ != nullptr) {
+      zone_map_->Extend(rid.GetPageId(), stored.GetData());
+    }
     buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
+    if (old_toasted) {
+      toast_->Free(TupleView(old_stored.data(), old_stored.size(), rid));
+    }
     return true;
   }
   buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
@@ -205,7 +523,13 @@ void RmFileHandle::UpdateTupleMeta(const TupleMeta &meta, RID rid, Context *cont
     context->lock_mgr_->LockExclusiveOnRecord(context->txn_, rid, fd_);
   }
   RmPageHandle page_handle = FetchPageHandle(rid.GetPageId());
-  page_handle.UpdateTupleMeta(meta, rid);
+  try {
+    page_handle.UpdateTupleMeta(meta, rid);
+  } catch (...) {
+    // e.g. a timestamp that does not fit into a compact slot, the page is left as it was
+    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+    throw;
+  }
   buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), true);
 }
 
@@ -218,6 +542,7 @@ auto RmFileHandle::GetTuple(RID rid, Context *context) -> std::pair<TupleMeta, T
   auto [meta, tuple] = page_handle.GetTuple(rid);
   buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
   tuple.rid_ = rid;
+  Detoast(tuple, nullptr);
   return std::make_pair(meta, std::move(tuple));
 }
 
@@ -266,7 +591,8 @@ auto RmFileHandle::GetTupleMeta(RID rid, Context *context) -> TupleMeta {
  * @param {Context*} context
  * @return {unique_ptr<Tuple>} rid对应的记录对象指针
  */
-auto RmFileHandle::GetTupleValue(const RID &rid, Context *context) -> std::unique_ptr<Tuple> {
+auto RmFileHandle::GetTupleValue(const RID &rid, Context *context, const std::vector<uint32_t> *detoast_cols)
+    -> std::unique_ptr<Tuple> {
   // lock manager
   if (context != nullptr) {
     context->lock_mgr_->LockSharedOnRecord(context->txn_, rid, fd_);
@@ -281,6 +607,8 @@ auto RmFileHandle::GetTupleValue(const RID &rid, Context *context) -> std::uniqu
   // Unpin the page
   buffer_pool_manager_->UnpinPage({fd_, rid.GetPageId()}, false);
 
+  // 3. Read the toasted values of the columns asked for back
+  Detoast(tuple, detoast_cols);
   return std::make_unique<Tuple>(tuple);
 }
 
@@ -296,11 +624,11 @@ auto RmFileHandle::GetKeyTuple(const Schema &schema, const Schema &key_schema, c
 
   // 2. Initialize a unique pointer to RmRecord
   auto [meta, tuple] = page_handle.GetTuple(rid);
-  auto key_tuple = tuple.KeyFromTuple(schema, key_schema, key_attrs);
 
   // Unpin the page
   buffer_pool_manager_->UnpinPage({fd_, rid.GetPageId()}, false);
-  return key_tuple;
+  Detoast(tuple, nullptr);
+  return tuple.KeyFromTuple(schema, key_schema, key_attrs);
 }
 
 // /**
@@ -367,25 +695,26 @@ auto RmFileHandle::GetKeyTuple(const Schema &schema, const Schema &key_schema, c
 /**
  * @description: 获取指定页面的页面句柄
  * @param {int} page_no 页面号
+ * @param {BufferAccessStrategy*} strategy 缓冲环，nullptr表示普通访问
  * @return {RmPageHandle} 指定页面的句柄
  * @note 该函数调用fetch_page进行pin操作，调用者需要调用UnpinPage进行unpin操作
  */
 // RmPageHandle RmFileHandle::FetchPageHandle(int page_no) const {
-RmPageHandle RmFileHandle::FetchPageHandle(page_id_t page_no) const {
+RmPageHandle RmFileHandle::FetchPageHandle(page_id_t page_no, BufferAccessStrategy *strategy) const {
   // Todo:
   // 使用缓冲池获取指定页面，并生成page_handle返回给上层
   // if page_no is invalid, throw PageNotExistError exception
   // return RmPageHandle(&file_hdr_, nullptr);
 
   // Ensure the page_no is within valid range
-  if (page_no < 0 || page_no >= file_hdr_.num_pages) {
+  if (page_no < 0 || page_no >= GetNumPages()) {
     throw PageNotExistError("", page_no);
     // throw InternalError("RmFileHandle::FetchPageHandle Error: Invalid page number.");
   }
 
   // Fetch the page from the buffer pool
   PageId page_id{fd_, page_no};
-  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  Page *page = buffer_pool_manager_->FetchPage(page_id, strategy);
 
   // If the page is not found, throw an error
   if (page == nullptr) {
@@ -404,17 +733,18 @@ RmPageHandle RmFileHandle::FetchPageHandle(page_id_t page_no) const {
  *       更新file_hdr_中的num_pages和first_free_page_no;
  *       写回文件头到磁盘
  */
-RmPageHandle RmFileHandle::CreateNewPageHandle() {
+RmPageHandle RmFileHandle::CreateNewPageHandle(BufferAccessStrategy *strategy) {
   // Todo:
   // 1.使用缓冲池来创建一个新page
   // 2.更新page handle中的相关信息
   // 3.更新file_hdr_
   // return RmPageHandle(&file_hdr_, nullptr);
 
-  // 1. Use the buffer pool to create a new page
+  // 1. Use the buffer pool to create a new page, one inserter at a time extends the file
+  std::scoped_lock lock(extend_latch_);
   PageId new_page_id;
   new_page_id.fd = fd_;
-  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id, strategy);
 
   if (new_page == nullptr) {
     throw InternalError("RmFileHandle::CreateNewPageHandle Error: Failed to create new page");
@@ -426,7 +756,8 @@ RmPageHandle RmFileHandle::CreateNewPageHandle() {
   new_page_handle.page_hdr_->Init();
 
   // 3. Update the file header
-  file_hdr_.num_pages++;
+  // published after the page exists, readers of GetNumPages() do not take extend_latch_
+  __atomic_store_n(&file_hdr_.num_pages, file_hdr_.num_pages + 1, __ATOMIC_RELEASE);
   file_hdr_.first_free_page_no = new_page_id.page_no;
 
   // Write the updated file header back to the disk
@@ -457,34 +788,6 @@ void RmFileHandle::SetPageLSN(page_id_t page_id_, lsn_t lsn) {
   buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
-/**
- * @brief 创建或获取一个空闲的page handle
- *
- * @return RmPageHandle 返回生成的空闲page handle
- * @note pin the page, remember to unpin it outside!
- */
-RmPageHandle RmFileHandle::CreatePageHandle() {
-  // Todo:
-  // 1. 判断file_hdr_中是否还有空闲页
-  //     1.1 没有空闲页：使用缓冲池来创建一个新page；可直接调用create_new_page_handle()
-  //     1.2 有空闲页：直接获取第一个空闲页
-  // 2. 生成page handle并返回给上层
-  // return RmPageHandle(&file_hdr_, nullptr);
-
-  int page_no = file_hdr_.first_free_page_no;
-  // 1. Check if there are free pages in file_hdr_
-  if (page_no == RM_NO_PAGE) {
-    // 1.1 No free pages: create a new page handle using the existing function
-    return CreateNewPageHandle();
-  }
-
-  // 1.2 There are free pages: fetch the first free page
-  RmPageHandle page_handle = FetchPageHandle(page_no);
-
-  // 2. Return the page handle
-  return page_handle;
-}
-
 /**
  * @description: 当一个页面从没有空闲空间的状态变为有空闲空间状态时，更新文件头和页头中空闲页面相关的元数据
  * @note 该函数更新
@@ -506,4 +809,92 @@ void RmFileHandle::ReleasePageHandle(RmPageHandle &page_handle) {
   disk_manager_->WritePage(fd_, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
 }
 
+/**
+ * @description: 整理表中每个页面，回收已删除记录占用的空间，并更新空闲空间映射
+ * @return {RmVacuumStats} 回收的页面数、slot数和字节数
+ * @note 调用者需持有表的排他锁，且表中已删除的记录都不会再被回滚
+ */
+auto RmFileHandle::Vacuum() -> RmVacuumStats {
+  RmVacuumStats stats;
+  num_dead_tuples_.store(0, std::memory_order_relaxed);
+  int num_pages = GetNumPages();
+  for (page_id_t page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages; page_no++) {
+    RmPageHandle page_handle = FetchPageHandle(page_no);
+    stats.pages_scanned_++;
+    page_handle.page->WLatch();
+    bool compact = page_handle.NeedsCompaction();
+    if (compact) {
+      // the deleted records that are removed for good take the chunks of their toasted values with them
+      if (toast_ != nullptr) {
+        for (uint32_t slot_no = 0; slot_no < page_handle.GetNumTuples(); slot_no++) {
+          if (page_handle.IsSlotDeleted(slot_no) && page_handle.StoredSize(slot_no) > 0) {
+            toast_->Free(page_handle.GetTupleView({page_no, slot_no}));
+          }
+        }
+      }
+      uint32_t slots_reclaimed = 0;
+      stats.bytes_reclaimed_ += page_handle.Compact(&slots_reclaimed);
+      stats.slots_reclaimed_ += slots_reclaimed;
+      stats.pages_compacted_++;
+      if (page_handle.GetNumTuples() == 0) {
+        stats.pages_emptied_++;
+      }
+      // the deleted records are gone for good, the ranges shrink to the live ones
+      ResetZones(page_handle);
+      fsm_->SetClass(page_no, RmFreeSpaceMap::FreeSpaceToClass(page_handle.GetFreeSpace()));
+    }
+    page_handle.page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), compact);
+  }
+  if (toast_ != nullptr) {
+    toast_->Vacuum();
+  }
+  return stats;
+}
+
+void RmFileHandle::Detoast(Tuple &tuple, const std::vector<uint32_t> *detoast_cols) {
+  std::vector<char> detoasted;
+  if (toast_ != nullptr && toast_->Detoast(TupleView(tuple), detoast_cols, &detoasted)) {
+    tuple.data_ = std::move(detoasted);
+  }
+}
+
+/**
+ * @brief 根据页面中未删除的记录重新计算该页面的取值范围，调用者持有页面的latch
+ */
+void RmFileHandle::ResetZones(RmPageHandle &page_handle) {
+  if (zone_map_ == nullptr) {
+    return;
+  }
+  page_id_t page_no = page_handle.page->GetPageId().page_no;
+  zone_map_->Reset(page_no);
+  for (uint32_t slot_no = 0; slot_no < page_handle.GetNumTuples(); slot_no++) {
+    if (!page_handle.IsSlotDeleted(slot_no)) {
+      zone_map_->Extend(page_no, page_handle.GetTuple({page_no, slot_no}).second.GetData());
+    }
+  }
+}
+
+/**
+ * @brief 根据每个页面中的记录重建区域映射，用于新建的或上次未正常关闭的映射文件
+ */
+void RmFileHandle::RebuildZoneMap() {
+  for (page_id_t page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++) {
+    RmPageHandle page_handle = FetchPageHandle(page_no);
+    ResetZones(page_handle);
+    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+  }
+}
+
+/**
+ * @brief 根据每个页面的空闲空间重建空闲空间映射，用于刚创建的空闲空间映射文件（如旧版本的表）
+ */
+void RmFileHandle::RebuildFreeSpaceMap() {
+  for (page_id_t page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++) {
+    RmPageHandle page_handle = FetchPageHandle(page_no);
+    fsm_->SetClass(page_no, RmFreeSpaceMap::FreeSpaceToClass(page_handle.GetFreeSpace()));
+    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+  }
+}
+
 }  // namespace easydb
@@ -0,0 +1,168 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_free_space_map.cpp
+ *
+ * Identification: src/record/rm_free_space_map.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "record/rm_free_space_map.h"
+
+#include <cstring>
+
+namespace easydb {
+
+RmFreeSpaceMap::RmFreeSpaceMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+                               const std::string &path)
+    : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), is_new_(!disk_manager->IsFile(path)) {
+  if (is_new_) {
+    disk_manager_->CreateFile(path);
+  }
+  fd_ = disk_manager_->OpenFile(path);
+  auto num_map_pages = static_cast<page_id_t>(std::max(0, disk_manager_->GetFileSize(path)) / PAGE_SIZE);
+  disk_manager_->SetFd2Pageno(fd_, num_map_pages);
+
+  // only the maxima of the groups are read, the fill classes themselves are read on demand
+  map_page_max_.resize(num_map_pages, 0);
+  for (page_id_t map_page_no = 0; map_page_no < num_map_pages; map_page_no++) {
+    Page *page = FetchMapPage(map_page_no, false);
+    uint8_t *group_max = GroupMax(page);
+    map_page_max_[map_page_no] = *std::max_element(group_max, group_max + FSM_GROUPS_PER_PAGE);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+
+  // the hints start out spread over the table, so that concurrent inserters do not all start at the first page
+  for (size_t i = 0; i < FSM_NUM_HINTS; i++) {
+    hints_[i] = static_cast<page_id_t>(num_map_pages * FSM_PAGES_PER_MAP_PAGE * i / FSM_NUM_HINTS);
+  }
+}
+
+auto RmFreeSpaceMap::FetchMapPage(size_t map_page_no, bool create) -> Page * {
+  while (create && map_page_no >= map_page_max_.size()) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw InternalError("RmFreeSpaceMap::FetchMapPage Error: Failed to create new map page");
+    }
+    std::memset(page->GetData() + Page::OFFSET_PAGE_HDR, 0, PAGE_SIZE - Page::OFFSET_PAGE_HDR);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    map_page_max_.push_back(0);
+  }
+  Page *page = buffer_pool_manager_->FetchPage({fd_, static_cast<page_id_t>(map_page_no)});
+  if (page == nullptr) {
+    throw InternalError("RmFreeSpaceMap::FetchMapPage Error: Failed to fetch map page");
+  }
+  return page;
+}
+
+auto RmFreeSpaceMap::GetClass(page_id_t page_no) -> uint8_t {
+  std::scoped_lock lock(latch_);
+  size_t map_page_no = page_no / FSM_PAGES_PER_MAP_PAGE;
+  if (map_page_no >= map_page_max_.size()) {
+    return 0;
+  }
+  Page *page = FetchMapPage(map_page_no, false);
+  uint8_t fill_class = GetNibble(Classes(page), page_no % FSM_PAGES_PER_MAP_PAGE);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return fill_class;
+}
+
+void RmFreeSpaceMap::SetClass(page_id_t page_no, uint8_t fill_class) {
+  std::scoped_lock lock(latch_);
+  size_t map_page_no = page_no / FSM_PAGES_PER_MAP_PAGE;
+  size_t index = page_no % FSM_PAGES_PER_MAP_PAGE;
+  Page *page = FetchMapPage(map_page_no, true);
+  uint8_t *classes = Classes(page);
+  uint8_t old_class = GetNibble(classes, index);
+  if (old_class == fill_class) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return;
+  }
+  int shift = (index % 2) * 4;
+  classes[index / 2] = static_cast<uint8_t>((classes[index / 2] & ~(0xf << shift)) | (fill_class << shift));
+
+  // keep the group maximum and the map page maximum up to date, they only have to be recomputed when they drop
+  size_t group = index / FSM_GROUP_SIZE;
+  uint8_t *group_max = GroupMax(page);
+  uint8_t old_group_max = group_max[group];
+  if (fill_class >= old_group_max) {
+    group_max[group] = fill_class;
+  } else if (old_class == old_group_max) {
+    uint8_t max = 0;
+    for (size_t i = group * FSM_GROUP_SIZE; i < (group + 1) * FSM_GROUP_SIZE; i++) {
+      max = std::max(max, GetNibble(classes, i));
+    }
+    group_max[group] = max;
+  }
+  if (group_max[group] >= map_page_max_[map_page_no]) {
+    map_page_max_[map_page_no] = group_max[group];
+  } else if (old_group_max == map_page_max_[map_page_no]) {
+    map_page_max_[map_page_no] = *std::max_element(group_max, group_max + FSM_GROUPS_PER_PAGE);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+auto RmFreeSpaceMap::FindPage(uint8_t min_class) -> page_id_t {
+  if (min_class >= FSM_NUM_CLASSES) {
+    return RM_NO_PAGE;
+  }
+  std::scoped_lock lock(latch_);
+  size_t total_groups = map_page_max_.size() * FSM_GROUPS_PER_PAGE;
+  if (total_groups == 0) {
+    return RM_NO_PAGE;
+  }
+  page_id_t &hint = Hint();
+  size_t start_group = (static_cast<size_t>(hint) / FSM_GROUP_SIZE) % total_groups;
+
+  Page *page = nullptr;
+  size_t fetched_map_page_no = 0;
+  for (size_t step = 0; step < total_groups; step++) {
+    size_t group_no = (start_group + step) % total_groups;
+    size_t map_page_no = group_no / FSM_GROUPS_PER_PAGE;
+    if (map_page_max_[map_page_no] < min_class) {
+      // skip the rest of this map page
+      step += FSM_GROUPS_PER_PAGE - 1 - group_no % FSM_GROUPS_PER_PAGE;
+      continue;
+    }
+    if (page == nullptr || fetched_map_page_no != map_page_no) {
+      if (page != nullptr) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      }
+      page = FetchMapPage(map_page_no, false);
+      fetched_map_page_no = map_page_no;
+    }
+    size_t group = group_no % FSM_GROUPS_PER_PAGE;
+    if (GroupMax(page)[group] < min_class) {
+      continue;
+    }
+    uint8_t *classes = Classes(page);
+    for (size_t i = group * FSM_GROUP_SIZE; i < (group + 1) * FSM_GROUP_SIZE; i++) {
+      if (GetNibble(classes, i) >= min_class) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        hint = static_cast<page_id_t>(map_page_no * FSM_PAGES_PER_MAP_PAGE + i);
+        return hint;
+      }
+    }
+  }
+  if (page != nullptr) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  return RM_NO_PAGE;
+}
+
+void RmFreeSpaceMap::SetHint(page_id_t page_no) {
+  std::scoped_lock lock(latch_);
+  Hint() = page_no;
+}
+
+void RmFreeSpaceMap::Close() {
+  buffer_pool_manager_->FlushAllPages(fd_);
+  // the fd may be reused by another file, whose pages must not be taken for the ones of the map
+  buffer_pool_manager_->RemoveAllPages(fd_);
+  disk_manager_->CloseFile(fd_);
+}
+
+}  // namespace easydb
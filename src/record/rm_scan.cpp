@@ -10,7 +10,9 @@
  */
 
 #include "record/rm_scan.h"
+#include <algorithm>
 #include <cstdint>
+#include "common/stats.h"
 #include "record/rm_file_handle.h"
 
 namespace easydb {
@@ -18,52 +20,189 @@ namespace easydb {
 /**
  * @brief 初始化file_handle和rid
  * @param file_handle
+ * @param strategy 扫描大表时使用的缓冲环
+ * @param page_filter 跳过其返回false的页面（如根据区域映射），nullptr表示扫描所有页面
  */
-RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
+RmScan::RmScan(const RmFileHandle *file_handle, BufferAccessStrategy *strategy, PageFilter page_filter)
+    : file_handle_(file_handle),
+      strategy_(strategy),
+      prefetched_until_(RM_FIRST_RECORD_PAGE),
+      page_filter_(std::move(page_filter)) {
   // Initialize file_handle and set rid_ to the first valid record
   // Start from the first data page (page 0 is the file header)
   // Initialize slot_no to 0 to start scanning from the beginning
   rid_.Set(RM_FIRST_RECORD_PAGE, 0);
+
+  // The read-ahead of a ring scan gets a ring of its own, the scan's ring is only used by the scanning thread
+  if (strategy_ != nullptr) {
+    prefetch_strategy_ = std::make_shared<BufferAccessStrategy>(AccessType::PREFETCH, strategy_->GetRingSize());
+  }
+  Prefetch(RM_FIRST_RECORD_PAGE - 1);
+  Seek(RM_FIRST_RECORD_PAGE, 0);
+}
+
+RmScan::~RmScan() { ReleasePage(); }
+
+/**
+ * @brief 预读当前页面之后的PREFETCH_DEPTH个页面，每次至少请求PREFETCH_DEPTH / 2个页面以减少请求次数
+ */
+void RmScan::Prefetch(page_id_t page_no) {
+  auto *bpm = file_handle_->buffer_pool_manager_;
+  if (!bpm->IsPrefetchEnabled()) {
+    return;
+  }
+  page_id_t num_pages = file_handle_->GetNumPages();
+  page_id_t first = std::max(prefetched_until_, page_no + 1);
+  page_id_t last = std::min(num_pages, page_no + 1 + PREFETCH_DEPTH);
+  if (first >= last || (last - first < std::max(1, PREFETCH_DEPTH / 2) && last < num_pages)) {
+    return;
+  }
+  prefetched_until_ = last;
+  if (page_filter_ == nullptr) {
+    bpm->PrefetchPages(file_handle_->fd_, first, last - first, prefetch_strategy_);
+    return;
+  }
+  // only the runs of pages that the filter lets through are read ahead
+  page_id_t run_start = first;
+  for (page_id_t page = first; page <= last; page++) {
+    if (page < last && page_filter_(page)) {
+      continue;
+    }
+    if (page > run_start) {
+      bpm->PrefetchPages(file_handle_->fd_, run_start, page - run_start, prefetch_strategy_);
+    }
+    run_start = page + 1;
+  }
 }
 
 /**
  * @brief 找到文件中下一个存放了记录的位置
  */
-void RmScan::Next() {
-  auto page_no = rid_.GetPageId();
-  auto slot_no = rid_.GetSlotNum() + 1;
+void RmScan::Next() { Seek(rid_.GetPageId(), rid_.GetSlotNum() + 1); }
 
-  bool found_valid_record = false;
+/**
+ * @brief 从(page_no, slot_no)开始找到第一条未删除的记录，并保持其所在页面pin住
+ */
+void RmScan::Seek(page_id_t page_no, uint32_t slot_no) {
   // If we have not reached the end of the file
-  while (page_no < file_handle_->file_hdr_.num_pages) {
-    RmPageHandle page_handle = file_handle_->FetchPageHandle(page_no);
+  while (page_no < file_handle_->GetNumPages()) {
+    if (page_ == nullptr || page_->GetPageId().page_no != page_no) {
+      ReleasePage();
+      // a page the filter turns down is not read at all
+      if (page_filter_ != nullptr && !page_filter_(page_no)) {
+        pages_skipped_++;
+        Stats::Add(StatCounter::SCAN_PAGES_SKIPPED);
+        page_no++;
+        slot_no = 0;
+        Prefetch(page_no);
+        continue;
+      }
+      page_ = file_handle_->FetchPageHandle(page_no, strategy_).page;
+    }
+    RmPageHandle page_handle(&file_handle_->file_hdr_, page_);
     uint32_t num_records = page_handle.GetNumTuples();
 
     while (slot_no < num_records) {
-      // If not deleted, we have found a valid record
+      // If not deleted, we have found a valid record, its page stays pinned
       if (!page_handle.IsTupleDeleted({page_no, slot_no})) {
-        found_valid_record = true;
-        break;
+        rid_.Set(page_no, slot_no);
+        return;
       }
-      // Move to the next slot
       slot_no++;
-    };
+    }
 
-    // Unpin the page that was pinned in 'fetch_page_handle'
-    file_handle_->buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+    // We have reached the end of the page, move to the next page
+    page_no++;
+    slot_no = 0;
+    Prefetch(page_no);
+  }
+  ReleasePage();
+  rid_.Set(page_no, slot_no);
+}
 
-    // If we have reached the end of the page, move to the next page
-    if (slot_no == num_records) {
-      page_no++;
-      slot_no = 0;
+void RmScan::ReleasePage() {
+  if (page_ != nullptr) {
+    file_handle_->buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+  }
+}
+
+auto RmScan::GetTupleView() const -> TupleView {
+  RmPageHandle page_handle(&file_handle_->file_hdr_, page_);
+  if (IsColumnar()) {
+    records_.resize(file_handle_->file_hdr_.record_size);
+    page_handle.ReadPaxRecord(rid_.GetSlotNum(), records_.data());
+    return {records_.data(), static_cast<uint32_t>(records_.size()), rid_};
+  }
+  return page_handle.GetTupleView(rid_);
+}
+
+auto RmScan::IsColumnar() const -> bool { return file_handle_->file_hdr_.page_format == RM_PAGE_FORMAT_PAX; }
+
+void RmScan::GetPageBatch(std::vector<TupleView> &batch) {
+  batch.clear();
+  if (page_ == nullptr) {
+    return;
+  }
+  RmPageHandle page_handle(&file_handle_->file_hdr_, page_);
+  if (IsColumnar()) {
+    std::vector<uint32_t> slots;
+    for (uint32_t slot_no = rid_.GetSlotNum(); slot_no < page_handle.GetNumTuples(); slot_no++) {
+      if (!page_handle.IsSlotDeleted(slot_no)) {
+        slots.push_back(slot_no);
+      }
     }
+    GetPageRecords(slots, batch);
+  } else {
+    page_handle.GetTupleViews(rid_.GetSlotNum(), batch);
+  }
+  // stay on the last record of the batch, the page stays pinned until the caller moves on
+  rid_ = batch.back().GetRid();
+}
 
-    // If we have found a valid record, break out of the loop
-    if (found_valid_record) {
-      break;
+void RmScan::GetPageColumns(RmColumnBatch &batch) {
+  batch.slots_.clear();
+  batch.columns_.clear();
+  batch.column_sizes_.clear();
+  batch.page_no_ = rid_.GetPageId();
+  if (page_ == nullptr) {
+    return;
+  }
+  if (!IsColumnar()) {
+    throw InternalError("RmScan::GetPageColumns Error: the file is not stored column by column");
+  }
+  const RmFileHdr &file_hdr = file_handle_->file_hdr_;
+  RmPageHandle page_handle(&file_hdr, page_);
+  for (uint32_t slot_no = rid_.GetSlotNum(); slot_no < page_handle.GetNumTuples(); slot_no++) {
+    if (!page_handle.IsSlotDeleted(slot_no)) {
+      batch.slots_.push_back(slot_no);
     }
   }
-  rid_.Set(page_no, slot_no);
+  for (int col = 0; col < file_hdr.pax_num_columns; col++) {
+    batch.columns_.push_back(page_handle.GetColumnData(col));
+    batch.column_sizes_.push_back(file_hdr.pax_column_sizes[col]);
+  }
+  // like GetPageBatch(), stay on the last record of the page
+  rid_.Set(batch.page_no_, batch.slots_.back());
+}
+
+void RmScan::GetPageRecords(const std::vector<uint32_t> &slots, std::vector<TupleView> &batch) {
+  batch.clear();
+  if (page_ == nullptr) {
+    return;
+  }
+  if (!IsColumnar()) {
+    throw InternalError("RmScan::GetPageRecords Error: the file is not stored column by column");
+  }
+  RmPageHandle page_handle(&file_handle_->file_hdr_, page_);
+  page_id_t page_no = page_->GetPageId().page_no;
+  auto record_size = static_cast<uint32_t>(file_handle_->file_hdr_.record_size);
+  records_.resize(slots.size() * record_size);
+  for (size_t i = 0; i < slots.size(); i++) {
+    char *record = records_.data() + i * record_size;
+    page_handle.ReadPaxRecord(slots[i], record);
+    batch.emplace_back(record, record_size, RID{page_no, slots[i]});
+  }
 }
 
 /**
@@ -71,7 +210,7 @@ void RmScan::Next() {
  */
 bool RmScan::IsEnd() const {
   // Check if we have reached the end of the file
-  return rid_.GetPageId() >= file_handle_->file_hdr_.num_pages;
+  return rid_.GetPageId() >= file_handle_->GetNumPages();
 }
 
 /**
@@ -0,0 +1,361 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_toast.cpp
+ *
+ * Identification: src/record/rm_toast.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "record/rm_toast.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/stats.h"
+#include "record/rm_manager.h"
+#include "type/limits.h"
+
+namespace easydb {
+
+namespace {
+
+constexpr int64_t NO_CHUNK = -1;  // the next chunk of the last chunk of a value
+
+// the LZ77 coding: a control byte tells, from its lowest bit on, which of the next 8 items are literal bytes (0) and
+// which are matches (1), a match is the distance back to the bytes to copy (2 bytes) and their number - MIN_MATCH
+constexpr size_t MIN_MATCH = 3;
+constexpr size_t MAX_MATCH = MIN_MATCH + 255;
+constexpr size_t MAX_DISTANCE = 65535;
+constexpr int HASH_BITS = 12;
+
+inline auto ReadU32(const char *src) -> uint32_t {
+  uint32_t value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+inline void WriteU32(char *dst, uint32_t value) { std::memcpy(dst, &value, sizeof(value)); }
+
+inline auto HashOf(const unsigned char *src) -> uint32_t {
+  uint32_t bytes = src[0] | (src[1] << 8) | (src[2] << 16);
+  return (bytes * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/** @return the bytes that follow the length field of a stored value */
+inline auto PayloadSize(uint32_t len) -> uint32_t {
+  if (len == EASYDB_VALUE_NULL) {
+    return 0;
+  }
+  return len == RmToast::TOAST_MARKER ? sizeof(RmToastPointer) : len;
+}
+
+}  // namespace
+
+RmToast::RmToast(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, std::string path,
+                 RmToastLayout layout)
+    : disk_manager_(disk_manager),
+      buffer_pool_manager_(buffer_pool_manager),
+      path_(std::move(path)),
+      layout_(std::move(layout)) {}
+
+RmToast::~RmToast() = default;
+
+auto RmToast::GetChunks(bool create) -> RmFileHandle * {
+  std::scoped_lock lock(open_latch_);
+  if (chunks_ != nullptr) {
+    return chunks_.get();
+  }
+  if (!disk_manager_->IsFile(path_)) {
+    if (!create) {
+      return nullptr;
+    }
+    // the chunks are records of a compact table file; they are larger than a table record may be, so the header is
+    // written here rather than by RmManager::CreateFile()
+    disk_manager_->CreateFile(path_);
+    if (disk_manager_->IsFile(path_ + RM_FSM_SUFFIX)) {
+      disk_manager_->DestroyFile(path_ + RM_FSM_SUFFIX);
+    }
+    RmFileHdr file_hdr{};
+    file_hdr.Init();
+    file_hdr.record_size = sizeof(int64_t) + TOAST_CHUNK_SIZE;
+    int fd = disk_manager_->OpenFile(path_);
+    disk_manager_->WritePage(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, sizeof(file_hdr));
+    disk_manager_->CloseFile(fd);
+  }
+  chunks_ = RmManager(disk_manager_, buffer_pool_manager_).OpenFile(path_);
+  return chunks_.get();
+}
+
+auto RmToast::Toast(const Tuple &tuple) -> Tuple {
+  const char *data = tuple.GetData();
+  size_t num_values = layout_.varlen_offsets_.size();
+  std::vector<uint32_t> value_offsets(num_values);
+  std::vector<bool> moved(num_values, false);
+  for (size_t i = 0; i < num_values; i++) {
+    value_offsets[i] = ReadU32(data + layout_.varlen_offsets_[i]);
+  }
+
+  // pick the values to move, the longest first, until the record is small enough
+  size_t size = tuple.GetLength();
+  while (size > TOAST_TUPLE_THRESHOLD) {
+    size_t longest = num_values;
+    uint32_t longest_size = sizeof(RmToastPointer);  // moving a shorter value would not make the record smaller
+    for (size_t i = 0; i < num_values; i++) {
+      uint32_t len = ReadU32(data + value_offsets[i]);
+      if (!moved[i] && len != EASYDB_VALUE_NULL && len != TOAST_MARKER && len > longest_size) {
+        longest = i;
+        longest_size = len;
+      }
+    }
+    if (longest == num_values) {
+      break;
+    }
+    moved[longest] = true;
+    size -= longest_size - sizeof(RmToastPointer);
+  }
+
+  // the values follow the fixed part in column order, as Tuple lays them out
+  std::vector<char> record(data, data + layout_.inlined_size_);
+  record.reserve(size);
+  for (size_t i = 0; i < num_values; i++) {
+    const char *value = data + value_offsets[i];
+    uint32_t len = ReadU32(value);
+    size_t offset = record.size();
+    WriteU32(record.data() + layout_.varlen_offsets_[i], static_cast<uint32_t>(offset));
+    if (moved[i]) {
+      RmToastPointer pointer = StoreValue(value + sizeof(uint32_t), len);
+      record.resize(offset + TOAST_STORAGE_SIZE);
+      WriteU32(record.data() + offset, TOAST_MARKER);
+      std::memcpy(record.data() + offset + sizeof(uint32_t), &pointer, sizeof(pointer));
+    } else {
+      record.insert(record.end(), value, value + sizeof(uint32_t) + PayloadSize(len));
+    }
+  }
+  Tuple toasted(std::move(record));
+  toasted.SetRid(tuple.GetRid());
+  return toasted;
+}
+
+auto RmToast::Detoast(const TupleView &record, const std::vector<uint32_t> *varlen_offsets, std::vector<char> *out)
+    -> bool {
+  const char *data = record.GetData();
+  auto selected = [varlen_offsets](uint32_t varlen_offset) {
+    return varlen_offsets == nullptr ||
+           std::find(varlen_offsets->begin(), varlen_offsets->end(), varlen_offset) != varlen_offsets->end();
+  };
+  bool any = false;
+  for (uint32_t varlen_offset : layout_.varlen_offsets_) {
+    if (ReadU32(data + ReadU32(data + varlen_offset)) == TOAST_MARKER && selected(varlen_offset)) {
+      any = true;
+      break;
+    }
+  }
+  if (!any) {
+    return false;
+  }
+
+  out->assign(data, data + layout_.inlined_size_);
+  for (uint32_t varlen_offset : layout_.varlen_offsets_) {
+    const char *value = data + ReadU32(data + varlen_offset);
+    uint32_t len = ReadU32(value);
+    size_t offset = out->size();
+    WriteU32(out->data() + varlen_offset, static_cast<uint32_t>(offset));
+    if (len == TOAST_MARKER && selected(varlen_offset)) {
+      RmToastPointer pointer;
+      std::memcpy(&pointer, value + sizeof(uint32_t), sizeof(pointer));
+      out->resize(offset + sizeof(uint32_t) + pointer.raw_size_);
+      WriteU32(out->data() + offset, pointer.raw_size_);
+      ReadValue(pointer, out->data() + offset + sizeof(uint32_t));
+    } else {
+      out->insert(out->end(), value, value + sizeof(uint32_t) + PayloadSize(len));
+    }
+  }
+  return true;
+}
+
+auto RmToast::StoreValue(const char *data, uint32_t size) -> RmToastPointer {
+  const char *bytes = data;
+  auto stored_size = static_cast<uint32_t>(size);
+  std::vector<char> compressed;
+  if (ENABLE_TOAST_COMPRESSION && Compress(data, size, size - size / 4, &compressed)) {
+    bytes = compressed.data();
+    stored_size = static_cast<uint32_t>(compressed.size());
+  }
+
+  // the chunks are inserted from the last one on, so that each one can be given the RID of the next
+  RmFileHandle *chunks = GetChunks(true);
+  int64_t next = NO_CHUNK;
+  std::vector<char> chunk;
+  size_t num_chunks = (stored_size + TOAST_CHUNK_SIZE - 1) / TOAST_CHUNK_SIZE;
+  for (size_t i = num_chunks; i-- > 0;) {
+    size_t begin = i * TOAST_CHUNK_SIZE;
+    size_t len = std::min<size_t>(TOAST_CHUNK_SIZE, stored_size - begin);
+    chunk.resize(sizeof(int64_t) + len);
+    std::memcpy(chunk.data(), &next, sizeof(int64_t));
+    std::memcpy(chunk.data() + sizeof(int64_t), bytes + begin, len);
+    auto rid = chunks->InsertTuple(TupleMeta{0, false}, Tuple(static_cast<int>(chunk.size()), chunk.data()), nullptr);
+    next = rid->Get();
+  }
+  return {next, size, stored_size};
+}
+
+void RmToast::ReadValue(const RmToastPointer &pointer, char *dst) {
+  RmFileHandle *chunks = GetChunks(false);
+  if (chunks == nullptr) {
+    throw InternalError("RmToast::ReadValue Error: the toast file " + path_ + " does not exist");
+  }
+  bool compressed = pointer.stored_size_ < pointer.raw_size_;
+  std::vector<char> stored;
+  char *bytes = dst;
+  if (compressed) {
+    stored.resize(pointer.stored_size_);
+    bytes = stored.data();
+  }
+
+  size_t pos = 0;
+  int64_t next = pointer.first_chunk_;
+  while (pos < pointer.stored_size_) {
+    if (next == NO_CHUNK) {
+      throw InternalError("RmToast::ReadValue Error: a toasted value ends early");
+    }
+    RID rid(next);
+    RmPageHandle page_handle = chunks->FetchPageHandle(rid.GetPageId());
+    TupleView chunk = page_handle.GetTupleView(rid);
+    size_t len = std::min<size_t>(chunk.GetLength() - sizeof(int64_t), pointer.stored_size_ - pos);
+    std::memcpy(&next, chunk.GetData(), sizeof(int64_t));
+    std::memcpy(bytes + pos, chunk.GetData() + sizeof(int64_t), len);
+    buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+    pos += len;
+    Stats::Add(StatCounter::TOAST_CHUNKS_READ);
+  }
+  if (compressed) {
+    Decompress(stored.data(), stored.size(), dst, pointer.raw_size_);
+  }
+}
+
+void RmToast::Free(const TupleView &record) {
+  const char *data = record.GetData();
+  for (uint32_t varlen_offset : layout_.varlen_offsets_) {
+    const char *value = data + ReadU32(data + varlen_offset);
+    if (ReadU32(value) != TOAST_MARKER) {
+      continue;
+    }
+    RmToastPointer pointer;
+    std::memcpy(&pointer, value + sizeof(uint32_t), sizeof(pointer));
+    RmFileHandle *chunks = GetChunks(false);
+    if (chunks == nullptr) {
+      throw InternalError("RmToast::Free Error: the toast file " + path_ + " does not exist");
+    }
+    for (int64_t next = pointer.first_chunk_; next != NO_CHUNK;) {
+      RID rid(next);
+      RmPageHandle page_handle = chunks->FetchPageHandle(rid.GetPageId());
+      std::memcpy(&next, page_handle.GetTupleView(rid).GetData(), sizeof(int64_t));
+      buffer_pool_manager_->UnpinPage(page_handle.page->GetPageId(), false);
+      chunks->DeleteTuple(rid, nullptr);
+    }
+  }
+}
+
+void RmToast::Vacuum() {
+  if (RmFileHandle *chunks = GetChunks(false)) {
+    chunks->Vacuum();
+  }
+}
+
+void RmToast::Close() {
+  std::scoped_lock lock(open_latch_);
+  if (chunks_ != nullptr) {
+    RmManager(disk_manager_, buffer_pool_manager_).CloseFile(chunks_.get());
+    chunks_.reset();
+  }
+}
+
+auto RmToast::Compress(const char *src, size_t size, size_t max_size, std::vector<char> *dst) -> bool {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  std::array<int64_t, 1 << HASH_BITS> last_seen;  // the last position of each hash of 3 bytes
+  last_seen.fill(-1);
+  dst->clear();
+  dst->reserve(max_size);
+  size_t pos = 0;
+  while (pos < size) {
+    size_t control_pos = dst->size();
+    uint8_t control = 0;
+    dst->push_back(0);
+    for (int item = 0; item < 8 && pos < size; item++) {
+      size_t match_len = 0;
+      size_t distance = 0;
+      if (pos + MIN_MATCH <= size) {
+        uint32_t hash = HashOf(in + pos);
+        int64_t candidate = last_seen[hash];
+        last_seen[hash] = static_cast<int64_t>(pos);
+        if (candidate >= 0 && pos - candidate <= MAX_DISTANCE && std::memcmp(in + candidate, in + pos, MIN_MATCH) == 0) {
+          size_t max_len = std::min(MAX_MATCH, size - pos);
+          match_len = MIN_MATCH;
+          while (match_len < max_len && in[candidate + match_len] == in[pos + match_len]) {
+            match_len++;
+          }
+          distance = pos - candidate;
+        }
+      }
+      if (match_len == 0) {
+        dst->push_back(static_cast<char>(in[pos++]));
+      } else {
+        control |= 1 << item;
+        dst->push_back(static_cast<char>(distance & 0xff));
+        dst->push_back(static_cast<char>(distance >> 8));
+        dst->push_back(static_cast<char>(match_len - MIN_MATCH));
+        // the positions inside the match can start later matches too
+        for (size_t i = pos + 1; i < pos + match_len && i + MIN_MATCH <= size; i++) {
+          last_seen[HashOf(in + i)] = static_cast<int64_t>(i);
+        }
+        pos += match_len;
+      }
+      if (dst->size() >= max_size) {
+        return false;
+      }
+    }
+    (*dst)[control_pos] = static_cast<char>(control);
+  }
+  return true;
+}
+
+void RmToast::Decompress(const char *src, size_t size, char *dst, size_t raw_size) {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  size_t in_pos = 0;
+  size_t out_pos = 0;
+  while (out_pos < raw_size) {
+    if (in_pos >= size) {
+      throw InternalError("RmToast::Decompress Error: the compressed value is truncated");
+    }
+    uint8_t control = in[in_pos++];
+    for (int item = 0; item < 8 && out_pos < raw_size; item++) {
+      if ((control & (1 << item)) == 0) {
+        if (in_pos >= size) {
+          throw InternalError("RmToast::Decompress Error: the compressed value is truncated");
+        }
+        dst[out_pos++] = static_cast<char>(in[in_pos++]);
+        continue;
+      }
+      if (in_pos + 3 > size) {
+        throw InternalError("RmToast::Decompress Error: the compressed value is truncated");
+      }
+      size_t distance = in[in_pos] | (in[in_pos + 1] << 8);
+      size_t len = in[in_pos + 2] + MIN_MATCH;
+      in_pos += 3;
+      if (distance == 0 || distance > out_pos || out_pos + len > raw_size) {
+        throw InternalError("RmToast::Decompress Error: the compressed value is corrupt");
+      }
+      // byte by byte, a match may overlap the bytes it produces
+      for (size_t i = 0; i < len; i++, out_pos++) {
+        dst[out_pos] = dst[out_pos - distance];
+      }
+    }
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,184 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_zone_map.cpp
+ *
+ * Identification: src/record/rm_zone_map.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "record/rm_zone_map.h"
+
+#include <cstring>
+
+namespace easydb {
+
+namespace {
+
+/** Widen the range [min, max] of an entry to `value`, all in the format of a column of type T. */
+template <typename T>
+void Widen(char *min, char *max, const char *value, bool has_records) {
+  T v, lo, hi;
+  memcpy(&v, value, sizeof(T));
+  memcpy(&lo, min, sizeof(T));
+  memcpy(&hi, max, sizeof(T));
+  if (!has_records || v < lo) {
+    memcpy(min, &v, sizeof(T));
+  }
+  if (!has_records || v > hi) {
+    memcpy(max, &v, sizeof(T));
+  }
+}
+
+}  // namespace
+
+RmZoneMap::RmZoneMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, const std::string &path,
+                     std::vector<RmZoneColumn> columns)
+    : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), columns_(std::move(columns)) {
+  entry_size_ = 1;
+  for (const RmZoneColumn &column : columns_) {
+    value_offsets_.push_back(entry_size_);
+    entry_size_ += 2 * column.Size();
+  }
+  entries_per_page_ = (PAGE_SIZE - Page::OFFSET_PAGE_HDR) / entry_size_;
+  if (entries_per_page_ == 0 ||
+      sizeof(Header) + columns_.size() * sizeof(RmZoneColumn) > PAGE_SIZE - Page::OFFSET_PAGE_HDR) {
+    throw InternalError("RmZoneMap Error: too many columns for a zone map");
+  }
+
+  if (!disk_manager_->IsFile(path)) {
+    disk_manager_->CreateFile(path);
+  }
+  fd_ = disk_manager_->OpenFile(path);
+  num_map_pages_ = static_cast<page_id_t>(std::max(0, disk_manager_->GetFileSize(path)) / PAGE_SIZE);
+  disk_manager_->SetFd2Pageno(fd_, num_map_pages_);
+
+  // the ranges are only trusted if the map was closed cleanly, and kept for the same columns
+  needs_rebuild_ = true;
+  if (num_map_pages_ > 0) {
+    Page *page = FetchMapPage(0, false);
+    const char *data = page->GetData() + Page::OFFSET_PAGE_HDR;
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic_ == ZONE_MAP_MAGIC && header.clean_ == 1 && header.num_columns_ == columns_.size()) {
+      std::vector<RmZoneColumn> stored(columns_.size());
+      memcpy(stored.data(), data + sizeof(header), stored.size() * sizeof(RmZoneColumn));
+      needs_rebuild_ = stored != columns_;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  // the map is in use from now on, a crash leaves it marked as not clean
+  WriteHeader(false);
+}
+
+auto RmZoneMap::FetchMapPage(page_id_t map_page_no, bool create) -> Page * {
+  while (create && map_page_no >= num_map_pages_) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw InternalError("RmZoneMap::FetchMapPage Error: Failed to create new map page");
+    }
+    // a new entry has no records
+    std::memset(page->GetData() + Page::OFFSET_PAGE_HDR, 0, PAGE_SIZE - Page::OFFSET_PAGE_HDR);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    num_map_pages_++;
+  }
+  Page *page = buffer_pool_manager_->FetchPage({fd_, map_page_no});
+  if (page == nullptr) {
+    throw InternalError("RmZoneMap::FetchMapPage Error: Failed to fetch map page");
+  }
+  return page;
+}
+
+void RmZoneMap::WriteHeader(bool clean) {
+  std::scoped_lock lock(latch_);
+  Page *page = FetchMapPage(0, true);
+  char *data = page->GetData() + Page::OFFSET_PAGE_HDR;
+  Header header{ZONE_MAP_MAGIC, clean ? 1u : 0u, static_cast<uint32_t>(columns_.size())};
+  memcpy(data, &header, sizeof(header));
+  memcpy(data + sizeof(header), columns_.data(), columns_.size() * sizeof(RmZoneColumn));
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  buffer_pool_manager_->FlushPage(page->GetPageId());
+}
+
+auto RmZoneMap::FindColumn(uint32_t offset) const -> std::optional<size_t> {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i].offset_ == offset) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+void RmZoneMap::Reset(page_id_t page_no) {
+  std::scoped_lock lock(latch_);
+  Page *page = FetchMapPage(1 + page_no / static_cast<page_id_t>(entries_per_page_), true);
+  memset(Entry(page, page_no), 0, entry_size_);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+void RmZoneMap::Extend(page_id_t page_no, const char *record) {
+  std::scoped_lock lock(latch_);
+  Page *page = FetchMapPage(1 + page_no / static_cast<page_id_t>(entries_per_page_), true);
+  char *entry = Entry(page, page_no);
+  bool has_records = entry[0] != 0;
+  for (size_t i = 0; i < columns_.size(); i++) {
+    char *min = entry + value_offsets_[i];
+    char *max = min + columns_[i].Size();
+    const char *value = record + columns_[i].offset_;
+    switch (columns_[i].type_) {
+      case TYPE_INT:
+        Widen<int32_t>(min, max, value, has_records);
+        break;
+      case TYPE_LONG:
+        Widen<int64_t>(min, max, value, has_records);
+        break;
+      case TYPE_FLOAT:
+      case TYPE_DOUBLE:
+        Widen<double>(min, max, value, has_records);
+        break;
+      case TYPE_DATE:
+        Widen<uint64_t>(min, max, value, has_records);
+        break;
+      default:
+        break;
+    }
+  }
+  entry[0] = 1;
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+auto RmZoneMap::GetZones(page_id_t page_no, std::vector<std::pair<Value, Value>> *zones) -> bool {
+  std::scoped_lock lock(latch_);
+  page_id_t map_page_no = 1 + page_no / static_cast<page_id_t>(entries_per_page_);
+  if (map_page_no >= num_map_pages_) {
+    // no record has been written to the page, or it would have been extended
+    return false;
+  }
+  Page *page = FetchMapPage(map_page_no, false);
+  const char *entry = Entry(page, page_no);
+  bool has_records = entry[0] != 0;
+  if (has_records) {
+    zones->resize(columns_.size());
+    for (size_t i = 0; i < columns_.size(); i++) {
+      auto type = static_cast<TypeId>(columns_[i].type_);
+      const char *min = entry + value_offsets_[i];
+      (*zones)[i] = {Value::DeserializeFrom(min, type), Value::DeserializeFrom(min + columns_[i].Size(), type)};
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return has_records;
+}
+
+void RmZoneMap::Close() {
+  // the ranges are written back before the header says that they can be trusted
+  buffer_pool_manager_->FlushAllPages(fd_);
+  WriteHeader(true);
+  // the fd may be reused by another file, whose pages must not be taken for the ones of the map
+  buffer_pool_manager_->RemoveAllPages(fd_);
+  disk_manager_->CloseFile(fd_);
+}
+
+}  // namespace easydb
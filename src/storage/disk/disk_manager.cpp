@@ -15,10 +15,16 @@
  */
 
 #include <fcntl.h>
+#include <limits.h>  // for IOV_MAX
 #include <sys/stat.h>
-#include <unistd.h>  // for lseek
+#include <sys/uio.h>  // for preadv/pwritev
+#include <unistd.h>   // for pread/pwrite
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>
@@ -28,10 +34,54 @@
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/stats.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/io_uring.h"
 
 namespace easydb {
 
+namespace {
+
+/**
+ * Call `fn(begin, count)` for every run of requests[begin, begin + count) that targets consecutive pages of one file.
+ * `requests` must be sorted by (fd, page_id). Runs are capped at IOV_MAX pages.
+ */
+template <typename Fn>
+void ForEachRun(const std::vector<PageIORequest> &requests, Fn &&fn) {
+  size_t begin = 0;
+  while (begin < requests.size()) {
+    size_t end = begin + 1;
+    while (end < requests.size() && end - begin < static_cast<size_t>(IOV_MAX) &&
+           requests[end].fd == requests[begin].fd &&
+           requests[end].page_id == requests[end - 1].page_id + 1) {
+      end++;
+    }
+    fn(begin, end - begin);
+    begin = end;
+  }
+}
+
+/** A heap buffer aligned for O_DIRECT I/O. */
+struct AlignedBuffer {
+  explicit AlignedBuffer(size_t size)
+      : data_(static_cast<char *>(std::aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, size))) {}
+  ~AlignedBuffer() { free(data_); }
+  char *data_;
+};
+
+auto RoundUpToAlignment(size_t num_bytes) -> size_t {
+  return (num_bytes + DiskManager::DIRECT_IO_ALIGNMENT - 1) / DiskManager::DIRECT_IO_ALIGNMENT *
+         DiskManager::DIRECT_IO_ALIGNMENT;
+}
+
+void SortRequests(std::vector<PageIORequest> &requests) {
+  std::sort(requests.begin(), requests.end(), [](const PageIORequest &a, const PageIORequest &b) {
+    return a.fd != b.fd ? a.fd < b.fd : a.page_id < b.page_id;
+  });
+}
+
+}  // namespace
+
 /**
  * Constructor: open/create a directory of database files & log files
  * @input db_dir: database directory name
@@ -71,27 +121,33 @@ DiskManager::DiskManager(const std::filesystem::path &db_dir) : dir_name_(db_dir
   // fd2path
   // fd2pageno_
   memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char)));
+
+  if (ENABLE_IO_URING) {
+    SetIoUringEnabled(true);
+  }
 }
 
+DiskManager::~DiskManager() = default;
+
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(int fd, page_id_t page_id, const char *page_data, size_t num_bytes) {
   // std::cerr << "[DiskManager] WritePage" << std::endl;
-  // Calculate the offset in the file
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-
-  // Set the write cursor to the page offset.
-
-  // Use lseek() to move the file pointer to the beginning of the target page
-  if (lseek(fd, offset, SEEK_SET) == -1) {
-    LOG_DEBUG("lseek error");
+  ScopedLatency latency(StatHistogram::WRITE_PAGE);
+  Stats::Add(StatCounter::IO_PAGES_WRITTEN);
+  Stats::Add(StatCounter::IO_BYTES_WRITTEN, num_bytes);
+  if (!CanTransferDirectly(fd, page_data, num_bytes)) {
+    WritePageBounced(fd, page_id, page_data, num_bytes);
     return;
   }
+  // Calculate the offset in the file
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
 
-  // Write the page data to the file
-  size_t write_count = write(fd, page_data, num_bytes);
-  if (write_count != num_bytes) {
+  // Write the page data at the page offset. pwrite() does not move the shared file cursor, so pages of the same file
+  // can be written by several threads at once.
+  ssize_t write_count = pwrite(fd, page_data, num_bytes, static_cast<off_t>(offset));
+  if (write_count < 0 || static_cast<size_t>(write_count) != num_bytes) {
     LOG_DEBUG("write error");
     return;
   }
@@ -101,22 +157,309 @@ void DiskManager::WritePage(int fd, page_id_t page_id, const char *page_data, si
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(int fd, page_id_t page_id, char *page_data, size_t num_bytes) {
+  ScopedLatency latency(StatHistogram::READ_PAGE);
+  Stats::Add(StatCounter::IO_PAGES_READ);
+  Stats::Add(StatCounter::IO_BYTES_READ, num_bytes);
+  if (!CanTransferDirectly(fd, page_data, num_bytes)) {
+    ReadPageBounced(fd, page_id, page_data, num_bytes);
+    return;
+  }
   // Calculate the offset in the file
-  int offset = page_id * PAGE_SIZE;
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+
+  // Read the page data at the page offset, see WritePage() for why pread() is used
+  ssize_t read_count = pread(fd, page_data, num_bytes, static_cast<off_t>(offset));
+  if (read_count < 0) {
+    read_count = 0;
+  }
+  if (static_cast<size_t>(read_count) != num_bytes) {
+    LOG_DEBUG("I/O error: Read hit the end of file at offset %zu, missing %zu bytes", offset,
+              num_bytes - static_cast<size_t>(read_count));
+    memset(page_data + read_count, 0, num_bytes - read_count);
+    return;
+  }
+}
 
-  // Use lseek() to move the file pointer to the beginning of the target page
-  if (lseek(fd, offset, SEEK_SET) == -1) {
-    LOG_DEBUG("lseek error");
+/**
+ * Write consecutive pages with one pwritev() per IOV_MAX pages
+ */
+void DiskManager::WritePages(int fd, page_id_t first_page, const char *const *pages, size_t num_pages) {
+  if (IsDirectFd(fd) && std::any_of(pages, pages + num_pages,
+                                    [&](const char *page) { return !CanTransferDirectly(fd, page, PAGE_SIZE); })) {
+    for (size_t i = 0; i < num_pages; i++) {
+      WritePage(fd, first_page + static_cast<page_id_t>(i), pages[i], PAGE_SIZE);
+    }
     return;
   }
+  std::vector<iovec> iov(std::min(num_pages, static_cast<size_t>(IOV_MAX)));
+  size_t done = 0;
+  while (done < num_pages) {
+    size_t count = std::min(num_pages - done, iov.size());
+    for (size_t i = 0; i < count; i++) {
+      iov[i].iov_base = const_cast<char *>(pages[done + i]);
+      iov[i].iov_len = PAGE_SIZE;
+    }
+    off_t offset = static_cast<off_t>(first_page + done) * PAGE_SIZE;
+    ssize_t write_count;
+    {
+      ScopedLatency latency(StatHistogram::WRITE_BATCH);
+      write_count = pwritev(fd, iov.data(), static_cast<int>(count), offset);
+    }
+    if (write_count < 0 || static_cast<size_t>(write_count) != count * PAGE_SIZE) {
+      // short or failed write: retry page by page, WritePage() reports the error
+      for (size_t i = 0; i < count; i++) {
+        WritePage(fd, first_page + static_cast<page_id_t>(done + i), pages[done + i], PAGE_SIZE);
+      }
+    } else {
+      Stats::Add(StatCounter::IO_PAGES_WRITTEN, count);
+      Stats::Add(StatCounter::IO_BYTES_WRITTEN, count * PAGE_SIZE);
+    }
+    done += count;
+  }
+}
 
-  // Read the page data from the file
-  size_t read_count = read(fd, page_data, num_bytes);
-  if (read_count != num_bytes) {
-    LOG_DEBUG("I/O error: Read hit the end of file at offset %d, missing %ld bytes", offset, num_bytes - read_count);
-    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+/**
+ * Read consecutive pages with one preadv() per IOV_MAX pages
+ */
+void DiskManager::ReadPages(int fd, page_id_t first_page, char *const *pages, size_t num_pages) {
+  if (IsDirectFd(fd) && std::any_of(pages, pages + num_pages,
+                                    [&](const char *page) { return !CanTransferDirectly(fd, page, PAGE_SIZE); })) {
+    for (size_t i = 0; i < num_pages; i++) {
+      ReadPage(fd, first_page + static_cast<page_id_t>(i), pages[i], PAGE_SIZE);
+    }
     return;
   }
+  std::vector<iovec> iov(std::min(num_pages, static_cast<size_t>(IOV_MAX)));
+  size_t done = 0;
+  while (done < num_pages) {
+    size_t count = std::min(num_pages - done, iov.size());
+    for (size_t i = 0; i < count; i++) {
+      iov[i].iov_base = pages[done + i];
+      iov[i].iov_len = PAGE_SIZE;
+    }
+    off_t offset = static_cast<off_t>(first_page + done) * PAGE_SIZE;
+    ssize_t read_count;
+    {
+      ScopedLatency latency(StatHistogram::READ_BATCH);
+      read_count = preadv(fd, iov.data(), static_cast<int>(count), offset);
+    }
+    if (read_count < 0) {
+      read_count = 0;
+    }
+    Stats::Add(StatCounter::IO_PAGES_READ, count);
+    Stats::Add(StatCounter::IO_BYTES_READ, static_cast<size_t>(read_count));
+    if (static_cast<size_t>(read_count) != count * PAGE_SIZE) {
+      // the run crosses the end of the file: zero fill what was not read
+      LOG_DEBUG("I/O error: Read hit the end of file at offset %zu, missing %zu bytes", static_cast<size_t>(offset),
+                count * PAGE_SIZE - static_cast<size_t>(read_count));
+      for (size_t i = static_cast<size_t>(read_count) / PAGE_SIZE; i < count; i++) {
+        size_t page_read = i == static_cast<size_t>(read_count) / PAGE_SIZE ? read_count % PAGE_SIZE : 0;
+        memset(pages[done + i] + page_read, 0, PAGE_SIZE - page_read);
+      }
+    }
+    done += count;
+  }
+}
+
+auto DiskManager::CanTransferDirectly(int fd, const void *buf, size_t num_bytes) const -> bool {
+  return !IsDirectFd(fd) ||
+         (reinterpret_cast<uintptr_t>(buf) % DIRECT_IO_ALIGNMENT == 0 && num_bytes % DIRECT_IO_ALIGNMENT == 0);
+}
+
+/**
+ * Read a page of an O_DIRECT file into an unaligned buffer (or a part of a page, e.g. a file header)
+ */
+void DiskManager::ReadPageBounced(int fd, page_id_t page_id, char *page_data, size_t num_bytes) {
+  size_t length = RoundUpToAlignment(num_bytes);
+  AlignedBuffer buf(length);
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  ssize_t read_count = pread(fd, buf.data_, length, static_cast<off_t>(offset));
+  if (read_count < 0) {
+    read_count = 0;
+  }
+  if (static_cast<size_t>(read_count) < num_bytes) {
+    LOG_DEBUG("I/O error: Read hit the end of file at offset %zu, missing %zu bytes", offset,
+              num_bytes - static_cast<size_t>(read_count));
+    memset(buf.data_ + read_count, 0, num_bytes - read_count);
+  }
+  memcpy(page_data, buf.data_, num_bytes);
+}
+
+/**
+ * Write an unaligned buffer to an O_DIRECT file. O_DIRECT only writes whole blocks, so a partial page is merged into
+ * the rest of the block as it is on disk first.
+ */
+void DiskManager::WritePageBounced(int fd, page_id_t page_id, const char *page_data, size_t num_bytes) {
+  size_t length = RoundUpToAlignment(num_bytes);
+  AlignedBuffer buf(length);
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  if (length != num_bytes) {
+    ssize_t read_count = pread(fd, buf.data_, length, static_cast<off_t>(offset));
+    if (read_count < 0) {
+      read_count = 0;
+    }
+    memset(buf.data_ + read_count, 0, length - read_count);
+  }
+  memcpy(buf.data_, page_data, num_bytes);
+  ssize_t write_count = pwrite(fd, buf.data_, length, static_cast<off_t>(offset));
+  if (write_count < 0 || static_cast<size_t>(write_count) != length) {
+    LOG_DEBUG("write error");
+  }
+}
+
+void DiskManager::WritePageBatch(std::vector<PageIORequest> &requests) {
+  if (requests.empty()) {
+    return;
+  }
+  SortRequests(requests);
+  if (IsIoUringEnabled()) {
+    SubmitBatchToIoUring(requests, true);
+    return;
+  }
+  std::vector<const char *> pages(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    pages[i] = requests[i].data;
+  }
+  ForEachRun(requests, [&](size_t begin, size_t count) {
+    WritePages(requests[begin].fd, requests[begin].page_id, pages.data() + begin, count);
+  });
+}
+
+void DiskManager::ReadPageBatch(std::vector<PageIORequest> &requests) {
+  if (requests.empty()) {
+    return;
+  }
+  SortRequests(requests);
+  if (IsIoUringEnabled()) {
+    SubmitBatchToIoUring(requests, false);
+    return;
+  }
+  std::vector<char *> pages(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    pages[i] = requests[i].data;
+  }
+  ForEachRun(requests, [&](size_t begin, size_t count) {
+    ReadPages(requests[begin].fd, requests[begin].page_id, pages.data() + begin, count);
+  });
+}
+
+void DiskManager::SubmitBatchToIoUring(std::vector<PageIORequest> &requests, bool is_write) {
+  struct Run {
+    size_t begin;
+    size_t count;
+    int result;
+  };
+  std::vector<Run> runs;
+  ForEachRun(requests, [&](size_t begin, size_t count) { runs.push_back({begin, count, 0}); });
+  std::vector<iovec> iov(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    iov[i].iov_base = requests[i].data;
+    iov[i].iov_len = PAGE_SIZE;
+  }
+
+  std::unique_ptr<IoUring> ring = AcquireRing();
+  if (ring == nullptr) {
+    // disabled concurrently, everything goes through the synchronous path below
+    for (auto &run : runs) {
+      run.result = -1;
+    }
+  } else {
+    for (auto &run : runs) {
+      const PageIORequest &first = requests[run.begin];
+      off_t offset = static_cast<off_t>(first.page_id) * PAGE_SIZE;
+      auto callback = [&run](int result) { run.result = result; };
+      auto prepare = [&]() {
+        return is_write ? ring->PrepareWritev(first.fd, &iov[run.begin], run.count, offset, callback)
+                        : ring->PrepareReadv(first.fd, &iov[run.begin], run.count, offset, callback);
+      };
+      if (!prepare()) {
+        // submission queue is full
+        ring->SubmitAndWait();
+        if (!prepare()) {
+          run.result = -1;
+        }
+      }
+    }
+    {
+      ScopedLatency latency(is_write ? StatHistogram::WRITE_BATCH : StatHistogram::READ_BATCH);
+      ring->SubmitAndWait();
+    }
+    ReleaseRing(std::move(ring));
+  }
+
+  // Count what the ring transferred, the runs redone below are counted by the synchronous path
+  for (const auto &run : runs) {
+    if (run.result == static_cast<int>(run.count * PAGE_SIZE)) {
+      Stats::Add(is_write ? StatCounter::IO_PAGES_WRITTEN : StatCounter::IO_PAGES_READ, run.count);
+      Stats::Add(is_write ? StatCounter::IO_BYTES_WRITTEN : StatCounter::IO_BYTES_READ, run.count * PAGE_SIZE);
+    }
+  }
+
+  // Redo the failed and short runs synchronously, which also zero fills reads beyond the end of the file.
+  for (const auto &run : runs) {
+    if (run.result == static_cast<int>(run.count * PAGE_SIZE)) {
+      continue;
+    }
+    const PageIORequest &first = requests[run.begin];
+    std::vector<char *> pages(run.count);
+    for (size_t i = 0; i < run.count; i++) {
+      pages[i] = requests[run.begin + i].data;
+    }
+    if (is_write) {
+      WritePages(first.fd, first.page_id, pages.data(), run.count);
+    } else {
+      ReadPages(first.fd, first.page_id, pages.data(), run.count);
+    }
+  }
+}
+
+auto DiskManager::SetIoUringEnabled(bool enabled) -> bool {
+  std::scoped_lock lock(io_uring_latch_);
+  if (!enabled) {
+    // the rings of the batches in flight are dropped when they are given back
+    io_uring_enabled_ = false;
+    idle_rings_.clear();
+    return false;
+  }
+  if (!io_uring_enabled_) {
+    auto ring = std::make_unique<IoUring>(IO_URING_QUEUE_DEPTH);
+    if (!ring->IsValid()) {
+      LOG_WARN("io_uring is not available, falling back to preadv/pwritev");
+      return false;
+    }
+    idle_rings_.push_back(std::move(ring));
+    io_uring_enabled_ = true;
+  }
+  return true;
+}
+
+auto DiskManager::IsIoUringEnabled() -> bool {
+  std::scoped_lock lock(io_uring_latch_);
+  return io_uring_enabled_;
+}
+
+auto DiskManager::AcquireRing() -> std::unique_ptr<IoUring> {
+  {
+    std::scoped_lock lock(io_uring_latch_);
+    if (!io_uring_enabled_) {
+      return nullptr;
+    }
+    if (!idle_rings_.empty()) {
+      std::unique_ptr<IoUring> ring = std::move(idle_rings_.back());
+      idle_rings_.pop_back();
+      return ring;
+    }
+  }
+  // every ring is busy: one more, set up outside the latch
+  auto ring = std::make_unique<IoUring>(IO_URING_QUEUE_DEPTH);
+  return ring->IsValid() ? std::move(ring) : nullptr;
+}
+
+void DiskManager::ReleaseRing(std::unique_ptr<IoUring> ring) {
+  std::scoped_lock lock(io_uring_latch_);
+  if (io_uring_enabled_) {
+    idle_rings_.push_back(std::move(ring));
+  }
 }
 
 /**
@@ -153,7 +496,11 @@ void DiskManager::CreateFile(const std::string &path) {
   if (IsFile(path)) {
     throw Exception("file " + path + " already exists");
   }
-  int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  int fd = open(path.c_str(), O_CREAT | O_RDWR | (direct_io_ ? O_DIRECT : 0), S_IRUSR | S_IWUSR);
+  if (fd == -1 && direct_io_ && errno == EINVAL) {
+    // the filesystem does not support O_DIRECT, OpenFile() will fall back to buffered I/O
+    fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  }
 
   if (fd == -1) {
     throw Exception("failed to create file " + path);
@@ -193,12 +540,19 @@ int DiskManager::OpenFile(const std::string &path) {
     throw Exception("file " + path + " is already opened by thread " + std::to_string(path2fd_[path]));
   }
 
-  // Open the file
-  int fd = open(path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  // Open the file, with O_DIRECT if asked for and supported by the filesystem
+  bool direct = direct_io_;
+  int fd = open(path.c_str(), O_RDWR | (direct ? O_DIRECT : 0), S_IRUSR | S_IWUSR);
+  if (fd == -1 && direct && errno == EINVAL) {
+    LOG_WARN("O_DIRECT is not supported for %s, falling back to buffered I/O", path.c_str());
+    direct = false;
+    fd = open(path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  }
 
   if (fd == -1) {
     throw Exception("failed to open file " + path);
   }
+  direct_fd_[fd] = direct;
 
   // Register the file in the map
   path2fd_[path] = fd;
@@ -229,6 +583,7 @@ void DiskManager::CloseFile(int fd) {
   }
 
   // Unregister the file in the map
+  direct_fd_[fd] = false;
   path2fd_.erase(fd2path_[fd]);
   fd2path_.erase(fd);
 }
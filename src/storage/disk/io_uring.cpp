@@ -0,0 +1,219 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * io_uring.cpp
+ *
+ * Identification: src/storage/disk/io_uring.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "storage/disk/io_uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace easydb {
+
+namespace {
+
+auto SysIoUringSetup(unsigned entries, io_uring_params *params) -> int {
+#ifdef __NR_io_uring_setup
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+auto SysIoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) -> int {
+#ifdef __NR_io_uring_enter
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+template <typename T>
+auto RingPtr(void *ring, unsigned offset) -> T * {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+IoUring::IoUring(unsigned entries) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  int ring_fd = SysIoUringSetup(entries, &params);
+  if (ring_fd < 0) {
+    return;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ =
+        mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      munmap(sq_ring_, sq_ring_size_);
+      sq_ring_ = nullptr;
+      close(ring_fd);
+      return;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    if (cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = cq_ring_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+
+  sq_head_ = RingPtr<unsigned>(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingPtr<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = RingPtr<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_array_ = RingPtr<unsigned>(sq_ring_, params.sq_off.array);
+  cq_head_ = RingPtr<unsigned>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingPtr<unsigned>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = RingPtr<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingPtr<void>(cq_ring_, params.cq_off.cqes);
+
+  sq_entries_ = params.sq_entries;
+  callbacks_.resize(sq_entries_);
+  for (unsigned i = 0; i < sq_entries_; i++) {
+    free_slots_.push_back(sq_entries_ - 1 - i);
+  }
+  ring_fd_ = ring_fd;
+}
+
+IoUring::~IoUring() {
+  if (!IsValid()) {
+    return;
+  }
+  if (queued_ > 0 || in_flight_ > 0) {
+    SubmitAndWait();
+  }
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+auto IoUring::PrepareReadv(int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback) -> bool {
+  return Prepare(IORING_OP_READV, fd, iov, iov_count, offset, std::move(callback));
+}
+
+auto IoUring::PrepareWritev(int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback) -> bool {
+  return Prepare(IORING_OP_WRITEV, fd, iov, iov_count, offset, std::move(callback));
+}
+
+auto IoUring::Prepare(uint8_t opcode, int fd, const iovec *iov, unsigned iov_count, off_t offset, Callback callback)
+    -> bool {
+  if (!IsValid() || free_slots_.empty()) {
+    return false;
+  }
+  unsigned slot = free_slots_.back();
+  free_slots_.pop_back();
+  callbacks_[slot] = std::move(callback);
+
+  // Only the submitting thread writes the tail, the kernel moves the head when it consumes entries.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->addr = reinterpret_cast<uint64_t>(iov);
+  sqe->len = iov_count;
+  sqe->user_data = slot;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  queued_++;
+  return true;
+}
+
+auto IoUring::SubmitAndWait() -> bool {
+  bool ok = true;
+  while (queued_ > 0 || in_flight_ > 0) {
+    int ret = SysIoUringEnter(ring_fd_, queued_, in_flight_ + queued_ > 0 ? 1 : 0, IORING_ENTER_GETEVENTS);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The queued entries were not consumed: take them back and fail their requests.
+      int error = errno;
+      unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+      unsigned tail = *sq_tail_;
+      for (unsigned i = head; i != tail; i++) {
+        auto *sqe = static_cast<io_uring_sqe *>(sqes_) + (sq_array_[i & *sq_mask_]);
+        auto slot = static_cast<unsigned>(sqe->user_data);
+        Callback callback = std::move(callbacks_[slot]);
+        free_slots_.push_back(slot);
+        if (callback) {
+          callback(-error);
+        }
+      }
+      __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+      queued_ = 0;
+      ok = false;
+      if (in_flight_ == 0) {
+        break;
+      }
+      continue;
+    }
+    queued_ -= static_cast<unsigned>(ret);
+    in_flight_ += static_cast<unsigned>(ret);
+    ReapCompletions();
+  }
+  return ok;
+}
+
+void IoUring::ReapCompletions() {
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    auto *cqe = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+    auto slot = static_cast<unsigned>(cqe->user_data);
+    int result = cqe->res;
+    head++;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    in_flight_--;
+
+    Callback callback = std::move(callbacks_[slot]);
+    free_slots_.push_back(slot);
+    if (callback) {
+      callback(result);
+    }
+  }
+}
+
+}  // namespace easydb
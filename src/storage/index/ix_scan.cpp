@@ -11,6 +11,8 @@
 
 #include "storage/index/ix_scan.h"
 
+#include <algorithm>
+
 namespace easydb {
 
 /**
@@ -28,12 +30,29 @@ void IxScan::Next() {
     // go to Next leaf
     iid_.slot_num_ = 0;
     iid_.page_id_ = node->GetNextLeaf();
+    Prefetch();
   }
   // Unpin the page that pinned in FetchNode()
   bpm_->UnpinPage(node->GetPageId(), false);
   delete node;
 }
 
+void IxScan::Prefetch() {
+  if (--leaves_until_prefetch_ > 0 || !bpm_->IsPrefetchEnabled()) {
+    return;
+  }
+  leaves_until_prefetch_ = std::max(1, PREFETCH_DEPTH / 2);
+  // the chain starts at the leaf the scan has just moved to and stops after the last leaf, whose next_leaf points
+  // back to the leaf header page
+  bpm_->PrefetchChain({ih_->GetFd(), iid_.page_id_}, PREFETCH_DEPTH + 1, [](const char *page_data) -> page_id_t {
+    auto *page_hdr = reinterpret_cast<const IxPageHdr *>(page_data);
+    if (!page_hdr->is_leaf || page_hdr->next_leaf == IX_NO_PAGE || page_hdr->next_leaf == IX_LEAF_HEADER_PAGE) {
+      return INVALID_PAGE_ID;
+    }
+    return page_hdr->next_leaf;
+  });
+}
+
 RID IxScan::GetRid() const { return ih_->GetRid(iid_); }
 
 }  // namespace easydb
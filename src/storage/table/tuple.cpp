@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -129,7 +130,7 @@ auto Tuple::GetValue(const Schema *schema, std::string column_name) const -> Val
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-auto Tuple::GetValue(const Column col) const -> Value {
+auto Tuple::GetValue(const Column &col) const -> Value {
   const TypeId column_type = col.GetType();
   const char *data_ptr = GetDataPtr(col);
   // the third parameter "is_inlined" is unused
@@ -183,7 +184,7 @@ auto Tuple::GetDataPtr(const Schema *schema, const std::string column_name) cons
   return (data_.data() + offset);
 }
 
-auto Tuple::GetDataPtr(const Column col) const -> const char * {
+auto Tuple::GetDataPtr(const Column &col) const -> const char * {
   bool is_inlined = col.IsInlined();
   // For inline type, data is stored where it is.
   if (is_inlined) {
@@ -231,4 +232,76 @@ void Tuple::DeserializeFrom(const char *storage) {
   memcpy(this->data_.data(), storage + sizeof(int32_t), size);
 }
 
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_idx);
+  return Value::DeserializeFrom(GetDataPtr(col), col.GetType());
+}
+
+auto TupleView::GetValue(const Schema *schema, const std::string &column_name) const -> Value {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_name);
+  return Value::DeserializeFrom(GetDataPtr(col), col.GetType());
+}
+
+auto TupleView::GetValue(const Column &col) const -> Value {
+  return Value::DeserializeFrom(GetDataPtr(col), col.GetType());
+}
+
+auto TupleView::KeyFromTuple(const Schema &schema, const Schema &key_schema,
+                             const std::vector<uint32_t> &key_attrs) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(key_attrs.size());
+  for (auto idx : key_attrs) {
+    values.emplace_back(this->GetValue(&schema, idx));
+  }
+  return {values, &key_schema};
+}
+
+auto TupleView::Materialize() const -> Tuple {
+  Tuple tuple(static_cast<int>(size_), data_);
+  tuple.SetRid(rid_);
+  return tuple;
+}
+
+auto TupleView::GetDataPtr(const Column &col) const -> const char * {
+  // For inline type, data is stored where it is.
+  if (col.IsInlined()) {
+    return data_ + col.GetOffset();
+  }
+  // Otherwise the relative offset of the VARCHAR data is stored there.
+  int32_t offset = *reinterpret_cast<const int32_t *>(data_ + col.GetOffset());
+  return data_ + offset;
+}
+
+void ConcatTuples(const TupleView &left, const Schema &left_schema, const TupleView &right,
+                  const Schema &right_schema, std::vector<char> *out) {
+  // [left inlined][right inlined][left varchars][right varchars]
+  uint32_t left_inlined = left_schema.GetInlinedStorageSize();
+  uint32_t right_inlined = right_schema.GetInlinedStorageSize();
+  uint32_t left_tail = left.GetLength() - left_inlined;
+  uint32_t right_tail = right.GetLength() - right_inlined;
+  out->resize(left.GetLength() + right.GetLength());
+  char *data = out->data();
+  std::memcpy(data, left.GetData(), left_inlined);
+  std::memcpy(data + left_inlined, right.GetData(), right_inlined);
+  std::memcpy(data + left_inlined + right_inlined, left.GetData() + left_inlined, left_tail);
+  std::memcpy(data + left.GetLength() + right_inlined, right.GetData() + right_inlined, right_tail);
+  // the varchars moved, their offsets follow them
+  for (uint32_t idx : left_schema.GetUnlinedColumns()) {
+    char *offset_ptr = data + left_schema.GetColumn(idx).GetOffset();
+    uint32_t offset;
+    std::memcpy(&offset, offset_ptr, sizeof(offset));
+    offset += right_inlined;
+    std::memcpy(offset_ptr, &offset, sizeof(offset));
+  }
+  for (uint32_t idx : right_schema.GetUnlinedColumns()) {
+    char *offset_ptr = data + left_inlined + right_schema.GetColumn(idx).GetOffset();
+    uint32_t offset;
+    std::memcpy(&offset, offset_ptr, sizeof(offset));
+    offset += left.GetLength();
+    std::memcpy(offset_ptr, &offset, sizeof(offset));
+  }
+}
+
 }  // namespace easydb
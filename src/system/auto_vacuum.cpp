@@ -0,0 +1,73 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * auto_vacuum.cpp
+ *
+ * Identification: src/system/auto_vacuum.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "system/auto_vacuum.h"
+
+#include "common/context.h"
+#include "common/errors.h"
+#include "system/sm_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace easydb {
+
+AutoVacuum::AutoVacuum(SmManager *sm_manager, TransactionManager *txn_manager, LockManager *lock_manager,
+                       LogManager *log_manager, std::chrono::milliseconds interval, size_t min_dead_tuples)
+    : sm_manager_(sm_manager),
+      txn_manager_(txn_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      interval_(interval),
+      min_dead_tuples_(min_dead_tuples) {
+  thread_ = std::thread(&AutoVacuum::Run, this);
+}
+
+AutoVacuum::~AutoVacuum() {
+  {
+    std::scoped_lock lock{latch_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void AutoVacuum::Run() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    cv_.wait_for(lock, interval_, [&] { return stop_.load(); });
+    if (stop_) {
+      return;
+    }
+    lock.unlock();
+
+    for (const std::string &tab_name : sm_manager_->GetVacuumCandidates(min_dead_tuples_)) {
+      if (stop_) {
+        break;
+      }
+      Transaction *txn = txn_manager_->Begin(nullptr, log_manager_);
+      txn->SetTxnMode(false);
+      Context context(lock_manager_, log_manager_, txn);
+      try {
+        sm_manager_->VacuumTable(tab_name, &context);
+        txn_manager_->Commit(txn, log_manager_);
+      } catch (TransactionAbortException &) {
+        // the table is in use by an older transaction, try again in the next round
+        txn_manager_->Abort(txn, log_manager_);
+      } catch (EASYDBError &) {
+        // the table has been dropped meanwhile
+        txn_manager_->Abort(txn, log_manager_);
+      }
+    }
+
+    lock.lock();
+  }
+}
+
+}  // namespace easydb
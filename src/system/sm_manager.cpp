@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include <string>
@@ -21,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/context.h"
 #include "common/errors.h"
 #include "common/exception.h"
+#include "common/stats.h"
 #include "record/record_printer.h"
 #include "record/rm_scan.h"
 #include "storage/index/ix_defs.h"
@@ -113,7 +115,8 @@ void SmManager::OpenDB(const std::string &db_name) {
     // debug
     std::cout << "open table name: " << table.first << std::endl;
     // the name of record file is table name, index file is table_name.index
-    fhs_.emplace(table.first, rm_manager_->OpenFile(table.first));
+    fhs_.emplace(table.first, rm_manager_->OpenFile(table.first, ZoneColumns(table.second.schema),
+                                                    ToastLayout(table.second.schema)));
     if (ix_manager_->Exists(table.first, db_.tabs_[table.first].cols)) {
       ihs_.emplace(table.first, ix_manager_->OpenIndex(table.first, table.second.cols));
     }
@@ -122,6 +125,38 @@ void SmManager::OpenDB(const std::string &db_name) {
   // stay in database dir
 }
 
+/**
+ * @description: 区域映射记录取值范围的字段：表中所有的数值和日期字段
+ * @param {Schema&} schema 表的schema
+ * @return {vector<RmZoneColumn>} 字段在记录中的偏移和类型，不使用区域映射时为空
+ */
+auto SmManager::ZoneColumns(const Schema &schema) -> std::vector<RmZoneColumn> {
+  std::vector<RmZoneColumn> zone_columns;
+  if (!ENABLE_ZONE_MAP) {
+    return zone_columns;
+  }
+  for (auto &col : schema.GetColumns()) {
+    if (RmZoneColumn::IsSupported(col.GetType())) {
+      zone_columns.push_back({static_cast<uint16_t>(col.GetOffset()), static_cast<uint16_t>(col.GetType())});
+    }
+  }
+  return zone_columns;
+}
+
+/**
+ * @description: 记录中VARCHAR字段的位置，过长的值由toast存放到记录之外
+ * @param {Schema&} schema 表的schema
+ * @return {RmToastLayout} 定长部分的大小和每个VARCHAR字段偏移量所在的位置，表中没有VARCHAR字段时为空
+ */
+auto SmManager::ToastLayout(const Schema &schema) -> RmToastLayout {
+  RmToastLayout layout;
+  layout.inlined_size_ = schema.GetInlinedStorageSize();
+  for (uint32_t col_idx : schema.GetUnlinedColumns()) {
+    layout.varlen_offsets_.push_back(schema.GetColumn(col_idx).GetOffset());
+  }
+  return layout;
+}
+
 /**
  * @description: 把数据库相关的元数据刷入磁盘中
  */
@@ -201,8 +236,10 @@ void SmManager::DescTable(const std::string &tab_name, Context *context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context
+ * @param {bool} column_storage 是否按列存储（PAX页面格式），只支持定长字段
  */
-void SmManager::CreateTable(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context) {
+void SmManager::CreateTable(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                            bool column_storage) {
   if (db_.is_table(tab_name)) {
     throw TableExistsError(tab_name);
   }
@@ -240,11 +277,36 @@ void SmManager::CreateTable(const std::string &tab_name, const std::vector<ColDe
 
   // Create & open record file
   int record_size = curr_offset;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
-  rm_manager_->CreateFile(tab_name, record_size);
+  if (!column_storage) {
+    // 过长的VARCHAR值存放在toast中，记录中只留下指向它的指针
+    record_size = 0;
+    for (auto &col_def : col_defs) {
+      record_size += col_def.type == TYPE_VARCHAR ? std::min(col_def.len, static_cast<int>(RmToast::TOAST_STORAGE_SIZE))
+                                                  : col_def.len;
+    }
+  }
+  if (column_storage) {
+    // PAX页面中每列的minipage大小固定，变长字段放不进去
+    if (!schema.IsInlined()) {
+      throw InternalError("Column storage only supports fixed-length columns, table " + tab_name + " has VARCHAR");
+    }
+    std::vector<int> column_sizes;
+    for (auto &col : schema.GetColumns()) {
+      column_sizes.push_back(static_cast<int>(col.GetStorageSize()));
+    }
+    // 记录按schema序列化，其大小以schema为准
+    rm_manager_->CreateFile(tab_name, static_cast<int>(schema.GetInlinedStorageSize()), RM_PAGE_FORMAT_PAX,
+                            column_sizes);
+  } else {
+    rm_manager_->CreateFile(tab_name, record_size);
+  }
 
   db_.tabs_[tab_name] = tab;
   // fhs_[tab_name] = rm_manager_->open_file(tab_name);
-  fhs_.emplace(tab_name, rm_manager_->OpenFile(tab_name));
+  {
+    std::scoped_lock lock(fhs_latch_);
+    fhs_.emplace(tab_name, rm_manager_->OpenFile(tab_name, ZoneColumns(schema), ToastLayout(schema)));
+  }
 
   // lock manager
   if (context != nullptr) {
@@ -283,7 +345,10 @@ void SmManager::DropTable(const std::string &tab_name, Context *context) {
   rm_manager_->CloseFile(fhs_[tab_name].get());
   buffer_pool_manager_->RemoveAllPages(fhs_[tab_name]->GetFd());
   rm_manager_->DestoryFile(tab_name);
-  fhs_.erase(tab_name);
+  {
+    std::scoped_lock lock(fhs_latch_);
+    fhs_.erase(tab_name);
+  }
   db_.tabs_.erase(tab_name);
   FlushMeta();
 }
@@ -312,6 +377,154 @@ void SmManager::ShowIndex(const std::string &tab_name, Context *context) {
   outfile.close();
 }
 
+namespace {
+
+/** @brief Format a latency in nanoseconds as microseconds with one decimal. */
+auto FormatMicros(double nanos) -> std::string {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.1f", nanos / 1000);
+  return buf;
+}
+
+}  // namespace
+
+/**
+ * @description: 显示缓冲池的统计信息：命中率、淘汰、后台写等（进程内所有线程的计数之和）
+ * @param {Context*} context
+ */
+void SmManager::ShowBufferStats(Context *context) {
+  StatsSnapshot stats = Stats::Snapshot();
+  uint64_t hits = stats.Get(StatCounter::BUFFER_HITS);
+  uint64_t misses = stats.Get(StatCounter::BUFFER_MISSES);
+  char hit_ratio[32];
+  snprintf(hit_ratio, sizeof(hit_ratio), "%.2f%%", hits + misses == 0 ? 0.0 : 100.0 * hits / (hits + misses));
+
+  RecordPrinter printer(2);
+  printer.print_separator(context);
+  printer.print_record({"Stat", "Value"}, context);
+  printer.print_separator(context);
+  printer.print_record({"frames", std::to_string(buffer_pool_manager_->Size())}, context);
+  printer.print_record({"partitions", std::to_string(buffer_pool_manager_->NumPartitions())}, context);
+  printer.print_record({"hit_ratio", hit_ratio}, context);
+  for (StatCounter counter :
+       {StatCounter::BUFFER_HITS, StatCounter::BUFFER_OPTIMISTIC_HITS, StatCounter::BUFFER_MISSES,
+        StatCounter::BUFFER_PIN_WAITS, StatCounter::BUFFER_SYNC_EVICTIONS, StatCounter::BUFFER_CLEAN_EVICTIONS,
+        StatCounter::BUFFER_BACKGROUND_WRITES, StatCounter::BUFFER_FLUSHED_PAGES,
+        StatCounter::BUFFER_PREFETCHED_PAGES}) {
+    printer.print_record({Stats::CounterName(counter), std::to_string(stats.Get(counter))}, context);
+  }
+  printer.print_separator(context);
+}
+
+/**
+ * @description: 显示磁盘I/O的统计信息：读写页数、字节数以及每类I/O调用的延迟分布（微秒）
+ * @param {Context*} context
+ */
+void SmManager::ShowIoStats(Context *context) {
+  StatsSnapshot stats = Stats::Snapshot();
+
+  std::vector<std::string> captions = {"Operation", "Count", "Avg(us)", "P50(us)", "P99(us)", "P99.9(us)", "Max(us)"};
+  RecordPrinter printer(captions.size());
+  printer.print_separator(context);
+  printer.print_record(captions, context);
+  printer.print_separator(context);
+  for (int h = 0; h < NUM_STAT_HISTOGRAMS; h++) {
+    auto histogram_id = static_cast<StatHistogram>(h);
+    const HistogramSnapshot &histogram = stats.GetHistogram(histogram_id);
+    printer.print_record({Stats::HistogramName(histogram_id), std::to_string(histogram.count_),
+                          FormatMicros(histogram.Mean()), FormatMicros(histogram.Percentile(50)),
+                          FormatMicros(histogram.Percentile(99)), FormatMicros(histogram.Percentile(99.9)),
+                          FormatMicros(histogram.max_)},
+                         context);
+  }
+  printer.print_separator(context);
+
+  RecordPrinter totals(2);
+  totals.print_separator(context);
+  totals.print_record({"Stat", "Value"}, context);
+  totals.print_separator(context);
+  for (StatCounter counter : {StatCounter::IO_PAGES_READ, StatCounter::IO_PAGES_WRITTEN, StatCounter::IO_BYTES_READ,
+                              StatCounter::IO_BYTES_WRITTEN, StatCounter::SCAN_PAGES_SKIPPED,
+                              StatCounter::TOAST_CHUNKS_READ, StatCounter::SPILL_BYTES_WRITTEN}) {
+    totals.print_record({Stats::CounterName(counter), std::to_string(stats.Get(counter))}, context);
+  }
+  totals.print_separator(context);
+}
+
+/**
+ * @description: VACUUM语句：整理表的页面，回收已删除记录占用的空间，并显示回收的页面数和字节数
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ */
+void SmManager::Vacuum(const std::string &tab_name, Context *context) {
+  RmVacuumStats stats = VacuumTable(tab_name, context);
+
+  RecordPrinter printer(2);
+  printer.print_separator(context);
+  printer.print_record({"Stat", "Value"}, context);
+  printer.print_separator(context);
+  printer.print_record({"pages_scanned", std::to_string(stats.pages_scanned_)}, context);
+  printer.print_record({"pages_compacted", std::to_string(stats.pages_compacted_)}, context);
+  printer.print_record({"pages_emptied", std::to_string(stats.pages_emptied_)}, context);
+  printer.print_record({"slots_reclaimed", std::to_string(stats.slots_reclaimed_)}, context);
+  printer.print_record({"bytes_reclaimed", std::to_string(stats.bytes_reclaimed_)}, context);
+  printer.print_separator(context);
+}
+
+/**
+ * @description: 在表的排他锁下整理表的所有页面，记录的RID不变，索引无需修改
+ * @param {string&} tab_name 表的名称
+ * @param {Context*} context
+ * @return {RmVacuumStats} 回收的页面数、slot数和字节数
+ * @note 整理后被删除记录的内容不复存在，删除操作不能再回滚，因此不能在显式事务中执行：
+ *       其他事务的删除在它们结束前持有表的意向锁，会阻塞（或使本事务回滚）排他锁的申请
+ */
+auto SmManager::VacuumTable(const std::string &tab_name, Context *context) -> RmVacuumStats {
+  if (context != nullptr && context->txn_->GetTxnMode()) {
+    throw InternalError("VACUUM cannot run inside a transaction block");
+  }
+  // the background vacuum runs concurrently with DDL, so the file handle is looked up under fhs_latch_, and looked up
+  // again once the table lock is held in case the table has been dropped (or dropped and created again) meanwhile
+  auto find_file = [&]() -> std::pair<RmFileHandle *, int> {
+    std::scoped_lock lock(fhs_latch_);
+    auto it = fhs_.find(tab_name);
+    if (it == fhs_.end()) {
+      throw TableNotFoundError(tab_name);
+    }
+    return {it->second.get(), it->second->GetFd()};
+  };
+  auto [fh, fd] = find_file();
+
+  // lock manager
+  if (context != nullptr) {
+    while (true) {
+      context->lock_mgr_->LockExclusiveOnTable(context->txn_, fd);
+      auto locked = find_file();
+      if (locked == std::make_pair(fh, fd)) {
+        break;
+      }
+      std::tie(fh, fd) = locked;
+    }
+  }
+  return fh->Vacuum();
+}
+
+/**
+ * @description: 找出上次整理后删除记录数达到阈值的表，供后台VACUUM使用
+ * @param {size_t} min_dead_tuples 删除记录数的阈值
+ * @return {vector<string>} 表的名称
+ */
+auto SmManager::GetVacuumCandidates(size_t min_dead_tuples) -> std::vector<std::string> {
+  std::scoped_lock lock(fhs_latch_);
+  std::vector<std::string> tab_names;
+  for (auto &[tab_name, fh] : fhs_) {
+    if (fh->GetNumDeadTuples() >= min_dead_tuples) {
+      tab_names.push_back(tab_name);
+    }
+  }
+  return tab_names;
+}
+
 /**
  * @description: 创建索引
  * @param {string&} tab_name 表的名称
@@ -359,11 +572,19 @@ void SmManager::CreateIndex(const std::string &tab_name, const std::vector<std::
   auto Iih = ix_manager_->OpenIndex(tab_name, index_cols);
   auto Rfh = fhs_.at(tab_name).get();
   RmScan rmScan(Rfh);
+  std::vector<char> detoasted;
 
   while (!rmScan.IsEnd()) {
     auto rid = rmScan.GetRid();
-    auto tuple = Rfh->GetTupleValue(rid, context);
-    auto key_tuple = Rfh->GetKeyTuple(tab_meta.schema, key_schema, key_ids, rid, context);
+    if (context != nullptr) {
+      context->lock_mgr_->LockSharedOnRecord(context->txn_, rid, Rfh->GetFd());
+    }
+    // the key is built straight from the page the scan holds pinned, unless a value has to come from the toast
+    TupleView view = rmScan.GetTupleView();
+    if (Rfh->GetToast() != nullptr && Rfh->GetToast()->Detoast(view, nullptr, &detoasted)) {
+      view = TupleView(detoasted.data(), detoasted.size(), rid);
+    }
+    auto key_tuple = view.KeyFromTuple(tab_meta.schema, key_schema, key_ids);
     // construct key
     char *key = new char[index_meta.col_tot_len];
     int offset = 0;
@@ -700,9 +921,10 @@ inline int ix_compare(const char *a, const char *b, const std::vector<ColMeta> c
  * @param context
  * @note: this function will insert one record into table
  */
-RID fh_insert(RmFileHandle *fh, std::vector<Value> &values, Schema *schema, Context *context) {
+RID fh_insert(RmFileHandle *fh, std::vector<Value> &values, Schema *schema, Context *context,
+              BufferAccessStrategy *strategy = nullptr) {
   Tuple tuple{values, schema};
-  auto rid = fh->InsertTuple(TupleMeta{0, false}, tuple, context);
+  auto rid = fh->InsertTuple(TupleMeta{0, false}, tuple, context, strategy);
   auto page_id = rid->GetPageId();
   auto slot_num = rid->GetSlotNum();
   // std::cout << "[TEST] insert rid: page id: " << page_id << " slot num: " << slot_num << std::endl;
@@ -796,6 +1018,9 @@ void SmManager::LoadData(const std::string &file_name, const std::string &table_
   // Batch data for indexes(just primary key for now)
   std::vector<std::pair<std::string, RID>> index_entries;
 
+  // The loaded pages go through a bulk-write ring instead of evicting the whole buffer pool
+  BufferAccessStrategy strategy(AccessType::BULK_WRITE, BULK_WRITE_RING_SIZE);
+
   while (line_start < data + file_size) {
     line_end = strchr(line_start, '\n');
     // Last line without \n
@@ -865,7 +1090,7 @@ void SmManager::LoadData(const std::string &file_name, const std::string &table_
 
     // no context for load data because context may be destroyed before load data finish
     // when using async load data
-    fh_insert(fh, values, &tab.schema, nullptr);
+    fh_insert(fh, values, &tab.schema, nullptr, &strategy);
 
     // // Extract the key for index
     // for (auto &index : tab.indexes) {
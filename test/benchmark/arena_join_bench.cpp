@@ -0,0 +1,125 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * arena_join_bench.cpp
+ *
+ * Identification: test/benchmark/arena_join_bench.cpp
+ *
+ * A three way join, (a JOIN b ON a_id = b_aid) JOIN c ON b_id = c_bid, over
+ * in-memory tables that show their tuples in place like a scan of pinned
+ * pages does, run with nested loop joins and with hash joins. Prints the
+ * heap allocations per result row, counted by replacing the global
+ * operator new, and the latency of the query, from beginTuple() to the
+ * last row handed to the consumer.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "execution/executor_abstract.h"
+#include "execution/executor_hash_join.h"
+#include "execution/executor_nestedloop_join.h"
+#include "execution/memory_scan_executor.hpp"
+#include "gtest/gtest.h"
+
+static std::atomic<uint64_t> num_allocations{0};
+
+void *operator new(size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace easydb {
+
+static const int NUM_A = 1000;
+static const int NUM_B = 4000;
+static const int NUM_C = 4000;
+
+static auto MakeJoinCond(const std::string &lhs_tab, const std::string &lhs_col, const std::string &rhs_tab,
+                         const std::string &rhs_col) -> Condition {
+  Condition cond;
+  cond.lhs_col = {.tab_name = lhs_tab, .col_name = lhs_col};
+  cond.op = OP_EQ;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = false;
+  cond.rhs_col = {.tab_name = rhs_tab, .col_name = rhs_col};
+  return cond;
+}
+
+template <typename JoinExecutor>
+static void RunJoin(const char *name, Context *context, const std::vector<Tuple> &a, const Schema &a_schema,
+                    const std::vector<Tuple> &b, const Schema &b_schema, const std::vector<Tuple> &c,
+                    const Schema &c_schema) {
+  auto ab = std::make_unique<JoinExecutor>(std::make_unique<MemoryScanExecutor>("a", a_schema, &a, context),
+                                           std::make_unique<MemoryScanExecutor>("b", b_schema, &b, context),
+                                           std::vector<Condition>{MakeJoinCond("a", "a_id", "b", "b_aid")});
+  JoinExecutor abc(std::move(ab), std::make_unique<MemoryScanExecutor>("c", c_schema, &c, context),
+                   std::vector<Condition>{MakeJoinCond("b", "b_id", "c", "c_bid")});
+
+  size_t rows = 0;
+  int64_t checksum = 0;
+  const Column &name_col = abc.schema().GetColumn("a_name");
+  uint64_t allocations_before = num_allocations.load();
+  auto start = std::chrono::steady_clock::now();
+  for (abc.beginTuple(); !abc.IsEnd(); abc.nextTuple()) {
+    // consume the row the way a projection does, in place if the join can show it
+    if (auto view = abc.NextView()) {
+      checksum += view->GetValue(name_col).GetStorageSize();
+    } else {
+      checksum += abc.Next()->GetValue(name_col).GetStorageSize();
+    }
+    rows++;
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  uint64_t allocations = num_allocations.load() - allocations_before;
+
+  EXPECT_EQ(rows, NUM_C);
+  std::printf("%-16s %8zu %16.2f %12.2f %10lld\n", name, rows, static_cast<double>(allocations) / rows,
+              elapsed.count() * 1000, static_cast<long long>(checksum));
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaJoinBench, ThreeWayJoin) {
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_name", TYPE_VARCHAR, 32)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_aid", TYPE_INT), Column("b_price", TYPE_DOUBLE)});
+  Schema c_schema({Column("c_id", TYPE_INT), Column("c_bid", TYPE_INT), Column("c_note", TYPE_VARCHAR, 32)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  std::vector<Tuple> c;
+  for (int i = 0; i < NUM_A; i++) {
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_VARCHAR, "name" + std::to_string(i))}, &a_schema);
+  }
+  for (int i = 0; i < NUM_B; i++) {
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, i % NUM_A), Value(TYPE_DOUBLE, i * 0.5)},
+                   &b_schema);
+  }
+  for (int i = 0; i < NUM_C; i++) {
+    c.emplace_back(
+        std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, (i * 7) % NUM_B), Value(TYPE_VARCHAR, "note")},
+        &c_schema);
+  }
+
+  Context context(nullptr, nullptr, nullptr);
+  std::printf("%-16s %8s %16s %12s %10s\n", "join", "rows", "allocations/row", "latency ms", "checksum");
+  RunJoin<NestedLoopJoinExecutor>("nested loop", &context, a, a_schema, b, b_schema, c, c_schema);
+  RunJoin<HashJoinExecutor>("hash", &context, a, a_schema, b, b_schema, c, c_schema);
+}
+
+}  // namespace easydb
@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * buffer_pool_contention_bench.cpp
+ *
+ * Identification: test/benchmark/buffer_pool_contention_bench.cpp
+ *
+ * Many threads fetch/unpin hot pages that all fit in the pool, so the only
+ * cost that grows with the thread count is contention on the pool latch(es).
+ * Prints fetch+unpin operations per second for a single latch and for a
+ * partitioned pool, each with the latched hit path and with the lock-free
+ * (optimistic) one.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "bpm_bench.easydb";
+const std::string BENCH_TABLE_NAME = "bpm_bench.table";
+
+static auto RunFetchUnpin(BufferPoolManager *bpm, int fd, int num_pages, int num_threads, int ops_per_thread)
+    -> double {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([=] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int> dist(0, num_pages - 1);
+      for (int i = 0; i < ops_per_thread; i++) {
+        PageId page_id{fd, dist(rng)};
+        Page *page = bpm->FetchPage(page_id);
+        if (page != nullptr) {
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads) * ops_per_thread / elapsed.count();
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolContentionBench, FetchUnpinThroughput) {
+  const int num_pages = 512;
+  const int ops_per_thread = 200000;
+  const size_t partitioned = 16;
+
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  disk_manager.CreateFile(path);
+  int fd = disk_manager.OpenFile(path);
+
+  std::printf("%-8s %-12s %-12s %16s\n", "threads", "partitions", "hit path", "ops/s");
+  for (size_t num_partitions : {static_cast<size_t>(1), partitioned}) {
+    disk_manager.SetFd2Pageno(fd, 0);
+    BufferPoolManager bpm(BUFFER_POOL_SIZE, &disk_manager, num_partitions);
+    for (int i = 0; i < num_pages; i++) {
+      PageId page_id{fd, INVALID_PAGE_ID};
+      ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+      bpm.UnpinPage(page_id, true);
+    }
+    for (bool optimistic : {false, true}) {
+      bpm.SetOptimisticHitsEnabled(optimistic);
+      for (int num_threads : {1, 2, 4, 8, 16}) {
+        double ops = RunFetchUnpin(&bpm, fd, num_pages, num_threads, ops_per_thread);
+        std::printf("%-8d %-12zu %-12s %16.0f\n", num_threads, num_partitions, optimistic ? "lock-free" : "latched",
+                    ops);
+      }
+    }
+    bpm.FlushAllDirtyPages();
+  }
+
+  disk_manager.CloseFile(fd);
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
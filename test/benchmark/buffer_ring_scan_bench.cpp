@@ -0,0 +1,120 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * buffer_ring_scan_bench.cpp
+ *
+ * Identification: test/benchmark/buffer_ring_scan_bench.cpp
+ *
+ * A point-lookup thread hits a small hot set while another thread keeps
+ * scanning a table that is several times larger than the buffer pool.
+ * Prints the hit rate of the lookups for each replacer, with the scan
+ * going through the shared replacement order and through a
+ * sequential-scan buffer ring.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "bpm_ring_bench.easydb";
+const std::string BENCH_TABLE_NAME = "bpm_ring_bench.table";
+
+static const int POOL_FRAMES = 256;
+static const int HOT_PAGES = 160;
+static const int SCAN_PAGES = 2048;
+static const int NUM_LOOKUPS = 200000;
+
+/** Runs the lookups against a fresh pool while the table is scanned, returns the hits and misses of the lookups. */
+static auto RunLookupsUnderScan(DiskManager *disk_manager, int fd, const std::string &replacer_type, bool use_ring)
+    -> BufferPoolAccessStats {
+  BufferPoolManager bpm(POOL_FRAMES, disk_manager, 4, replacer_type);
+
+  // Warm up the hot set.
+  for (page_id_t page_no = 0; page_no < HOT_PAGES; page_no++) {
+    bpm.FetchPage({fd, page_no});
+    bpm.UnpinPage({fd, page_no}, false);
+  }
+  auto warm_up = bpm.GetAccessStats(AccessType::NORMAL);
+
+  std::atomic<bool> done{false};
+  std::thread scanner([&] {
+    // Without a ring the scan still tags its accesses, so that they are not counted as lookups.
+    BufferAccessStrategy strategy(AccessType::SEQ_SCAN, use_ring ? SEQ_SCAN_RING_SIZE : 0);
+    while (!done) {
+      for (page_id_t page_no = HOT_PAGES; page_no < HOT_PAGES + SCAN_PAGES && !done; page_no++) {
+        bpm.FetchPage({fd, page_no}, &strategy);
+        bpm.UnpinPage({fd, page_no}, false);
+      }
+    }
+  });
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> dist(0, HOT_PAGES - 1);
+  for (int i = 0; i < NUM_LOOKUPS; i++) {
+    PageId page_id{fd, dist(rng)};
+    if (bpm.FetchPage(page_id) != nullptr) {
+      bpm.UnpinPage(page_id, false);
+    }
+    // Give the scanner a chance to run between lookups even on a single core.
+    if (i % 64 == 0) {
+      std::this_thread::yield();
+    }
+  }
+  done = true;
+  scanner.join();
+
+  auto stats = bpm.GetAccessStats(AccessType::NORMAL);
+  stats.hits -= warm_up.hits;
+  stats.misses -= warm_up.misses;
+  return stats;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingScanBench, PointLookupHitRateUnderScan) {
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  disk_manager.CreateFile(path);
+  int fd = disk_manager.OpenFile(path);
+
+  char data[PAGE_SIZE];
+  std::memset(data, 0, sizeof(data));
+  for (page_id_t page_no = 0; page_no < HOT_PAGES + SCAN_PAGES; page_no++) {
+    disk_manager.WritePage(fd, page_no, data, PAGE_SIZE);
+  }
+
+  std::printf("%-8s %-8s %14s %14s %12s\n", "replacer", "scan", "lookup hits", "lookup misses", "hit rate");
+  for (const std::string replacer_type : {"LRU", "LRU-K", "CLOCK"}) {
+    for (bool use_ring : {false, true}) {
+      auto stats = RunLookupsUnderScan(&disk_manager, fd, replacer_type, use_ring);
+      std::printf("%-8s %-8s %14zu %14zu %11.2f%%\n", replacer_type.c_str(), use_ring ? "ring" : "shared", stats.hits,
+                  stats.misses, stats.HitRate() * 100);
+      if (use_ring) {
+        // The ring never takes more than its own frames, the hot set stays cached.
+        EXPECT_EQ(stats.misses, 0);
+      }
+    }
+  }
+
+  disk_manager.CloseFile(fd);
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
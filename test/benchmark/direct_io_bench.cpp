@@ -0,0 +1,140 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * direct_io_bench.cpp
+ *
+ * Identification: test/benchmark/direct_io_bench.cpp
+ *
+ * Skewed random page reads and updates on a file twice the size of the
+ * buffer pool, with the file opened normally and with O_DIRECT. Reports
+ * the throughput, the resident set of the process and how much of the
+ * file the OS page cache holds on top of the buffer pool (via mincore).
+ * Both runs start with the file dropped from the page cache.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "direct_io_bench.easydb";
+const std::string BENCH_TABLE_NAME = "direct_io_bench.table";
+
+/** @return VmRSS of this process in KiB */
+static auto ResidentKiB() -> size_t {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmRSS:", 0) == 0) {
+      return std::stoul(line.substr(6));
+    }
+  }
+  return 0;
+}
+
+/** @return the number of pages of the file that are in the OS page cache */
+static auto CachedPages(int fd, size_t num_pages) -> size_t {
+  size_t length = num_pages * PAGE_SIZE;
+  void *map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    return 0;
+  }
+  long os_page = sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> residency((length + os_page - 1) / os_page);
+  size_t cached = 0;
+  if (mincore(map, length, residency.data()) == 0) {
+    for (unsigned char r : residency) {
+      cached += r & 1;
+    }
+  }
+  munmap(map, length);
+  return cached * os_page / PAGE_SIZE;
+}
+
+// NOLINTNEXTLINE
+TEST(DirectIOBench, SkewedReadWrite) {
+  const int pool_frames = 8192;  // 32 MiB
+  const int num_pages = 2 * pool_frames;
+  const int num_ops = 200000;
+
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  {
+    DiskManager disk_manager(BENCH_DB_NAME);
+    if (disk_manager.IsFile(path)) {
+      disk_manager.DestroyFile(path);
+    }
+    disk_manager.CreateFile(path);
+    int fd = disk_manager.OpenFile(path);
+    std::vector<char> page(PAGE_SIZE);
+    for (int i = 0; i < num_pages; i++) {
+      std::memcpy(page.data() + Page::OFFSET_PAGE_HDR, &i, sizeof(i));
+      disk_manager.WritePage(fd, i, page.data(), PAGE_SIZE);
+    }
+    fdatasync(fd);
+    disk_manager.CloseFile(fd);
+  }
+
+  std::printf("%-9s %10s %10s %12s %16s\n", "mode", "seconds", "ops/s", "rss (MiB)", "page cache (MiB)");
+  for (bool direct : {false, true}) {
+    DiskManager disk_manager(BENCH_DB_NAME);
+    disk_manager.SetDirectIO(direct);
+    int fd = disk_manager.OpenFile(path);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    disk_manager.SetFd2Pageno(fd, num_pages);
+    size_t rss_before = ResidentKiB();
+
+    int mismatches = 0;
+    std::chrono::duration<double> elapsed{};
+    {
+      BufferPoolManager bpm(pool_frames, &disk_manager);
+      // 80% of the accesses go to the first 40% of the file, which fits into the pool
+      std::mt19937 rng(42);
+      std::uniform_int_distribution<int> hot(0, num_pages * 2 / 5 - 1);
+      std::uniform_int_distribution<int> any(0, num_pages - 1);
+      std::uniform_int_distribution<int> percent(0, 99);
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_no = percent(rng) < 80 ? hot(rng) : any(rng);
+        Page *page = bpm.FetchPage({fd, page_no});
+        ASSERT_NE(page, nullptr);
+        int stored;
+        std::memcpy(&stored, page->GetData() + Page::OFFSET_PAGE_HDR, sizeof(stored));
+        mismatches += stored != page_no;
+        bool dirty = percent(rng) < 10;
+        if (dirty) {
+          page->GetData()[PAGE_SIZE - 1]++;
+        }
+        bpm.UnpinPage({fd, page_no}, dirty);
+      }
+      bpm.FlushAllPages(fd);
+      elapsed = std::chrono::steady_clock::now() - start;
+      // measured while the pool is still allocated
+      rss_before = ResidentKiB() - rss_before;
+    }
+    std::printf("%-9s %10.3f %10.0f %12.1f %16.1f\n", direct ? "direct" : "buffered", elapsed.count(),
+                num_ops / elapsed.count(), rss_before / 1024.0, CachedPages(fd, num_pages) * PAGE_SIZE / 1048576.0);
+    EXPECT_EQ(mismatches, 0);
+    disk_manager.CloseFile(fd);
+  }
+
+  DiskManager disk_manager(BENCH_DB_NAME);
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
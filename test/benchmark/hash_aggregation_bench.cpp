@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * hash_aggregation_bench.cpp
+ *
+ * Identification: test/benchmark/hash_aggregation_bench.cpp
+ *
+ * GROUP BY over 50M generated rows in 1000 groups, with COUNT, SUM, MIN, MAX and AVG. Prints the rows aggregated
+ * per second and the memory the groups take, which does not depend on the number of rows.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_aggregation.h"
+#include "gtest/gtest.h"
+
+namespace easydb {
+
+static const int64_t NUM_ROWS = 50000000;
+static const int NUM_GROUPS = 1000;
+
+/** `num_rows` rows cycling through `tuples`, handed out a batch at a time. */
+class GeneratorExecutor : public AbstractExecutor {
+ public:
+  GeneratorExecutor(Schema schema, std::vector<Tuple> tuples, int64_t num_rows)
+      : schema_(std::move(schema)), tuples_(std::move(tuples)), num_rows_(num_rows) {}
+
+  void beginTuple() override { idx_ = 0; }
+  void nextTuple() override { idx_++; }
+  bool IsEnd() const override { return idx_ >= num_rows_; }
+  std::unique_ptr<Tuple> Next() override { return std::make_unique<Tuple>(tuples_[idx_ % tuples_.size()]); }
+  RID &rid() override { return _abstract_rid; }
+  size_t tupleLen() const override { return schema_.GetInlinedStorageSize(); }
+  const Schema &schema() const override { return schema_; }
+  std::string getTabName() const override { return "t"; }
+
+  bool NextBatch(DataChunk &chunk) override {
+    chunk.Reset();
+    for (; idx_ < num_rows_ && !chunk.IsFull(); idx_++) {
+      chunk.AppendTuple(tuples_[idx_ % tuples_.size()].GetData());
+    }
+    return chunk.GetSize() > 0;
+  }
+
+ private:
+  Schema schema_;
+  std::vector<Tuple> tuples_;
+  int64_t num_rows_;
+  int64_t idx_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(HashAggregationBench, GroupBy) {
+  Schema schema({Column("g", TYPE_INT), Column("v", TYPE_LONG), Column("d", TYPE_DOUBLE)});
+  // 7919 distinct rows so that the values of a group vary
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 7919; i++) {
+    tuples.emplace_back(std::vector<Value>{Value(TYPE_INT, i % NUM_GROUPS), Value(TYPE_LONG, static_cast<int64_t>(i)),
+                                           Value(TYPE_DOUBLE, i * 0.5)},
+                        &schema);
+  }
+  auto col = [](const std::string &col_name, AggregationType type) -> TabCol {
+    return {.tab_name = "t", .col_name = col_name, .aggregation_type = type, .new_col_name = ""};
+  };
+  AggregationExecutor agg(std::make_unique<GeneratorExecutor>(schema, tuples, NUM_ROWS),
+                          {col("g", NO_AGG), col("*", COUNT_AGG), col("v", SUM_AGG), col("v", MIN_AGG),
+                           col("v", MAX_AGG), col("d", AVG_AGG)},
+                          {col("g", NO_AGG)}, {});
+
+  auto start = std::chrono::steady_clock::now();
+  int64_t total = 0;
+  size_t num_groups = 0;
+  for (agg.beginTuple(); !agg.IsEnd(); agg.nextTuple(), num_groups++) {
+    total += agg.Next()->GetValue(&agg.schema(), 1).GetAs<int32_t>();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(num_groups, NUM_GROUPS);
+  EXPECT_EQ(total, NUM_ROWS);
+  std::printf("%lld rows, %zu groups: %.2f s, %.0f rows/s, %zu bytes of groups\n", static_cast<long long>(NUM_ROWS),
+              num_groups, elapsed.count(), NUM_ROWS / elapsed.count(), agg.GetMemoryUsage());
+}
+
+}  // namespace easydb
@@ -0,0 +1,125 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * parallel_hash_join_bench.cpp
+ *
+ * Identification: test/benchmark/parallel_hash_join_bench.cpp
+ *
+ * A 2M row table joined with a 10M row one on a key column, by the parallel hash join with 1, 2, 4, 8 and 16 worker
+ * threads and by the serial one. Prints the time each takes and its speedup over the serial join; the speedup is
+ * bounded by the cores of the machine.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_hash_join.h"
+#include "execution/executor_parallel_hash_join.h"
+#include "gtest/gtest.h"
+
+namespace easydb {
+
+static const int64_t NUM_BUILD_ROWS = 2000000;
+static const int64_t NUM_PROBE_ROWS = 10000000;
+
+/** Rows whose first column counts from 0 and whose other columns come from `tuples`, handed out a batch at a time. */
+class GeneratorExecutor : public AbstractExecutor {
+ public:
+  GeneratorExecutor(std::string tab_name, Schema schema, std::vector<Tuple> tuples, int64_t num_rows, int64_t modulo)
+      : tab_name_(std::move(tab_name)),
+        schema_(std::move(schema)),
+        tuples_(std::move(tuples)),
+        num_rows_(num_rows),
+        modulo_(modulo) {}
+
+  void beginTuple() override { idx_ = 0; }
+  void nextTuple() override { idx_++; }
+  bool IsEnd() const override { return idx_ >= num_rows_; }
+  std::unique_ptr<Tuple> Next() override { return std::make_unique<Tuple>(MakeRow()); }
+  RID &rid() override { return _abstract_rid; }
+  size_t tupleLen() const override { return schema_.GetInlinedStorageSize(); }
+  const Schema &schema() const override { return schema_; }
+  std::string getTabName() const override { return tab_name_; }
+
+  bool NextBatch(DataChunk &chunk) override {
+    chunk.Reset();
+    for (; idx_ < num_rows_ && !chunk.IsFull(); idx_++) {
+      chunk.AppendTuple(MakeRow().GetData());
+    }
+    return chunk.GetSize() > 0;
+  }
+
+ private:
+  auto MakeRow() -> Tuple & {
+    Tuple &tuple = tuples_[idx_ % tuples_.size()];
+    auto key = static_cast<int32_t>(idx_ % modulo_);
+    std::memcpy(tuple.GetData(), &key, sizeof(key));
+    return tuple;
+  }
+
+  std::string tab_name_;
+  Schema schema_;
+  std::vector<Tuple> tuples_;
+  int64_t num_rows_;
+  int64_t modulo_;
+  int64_t idx_{0};
+};
+
+static auto CountRows(AbstractExecutor *join) -> int64_t {
+  DataChunk chunk(join->schema());
+  int64_t num_rows = 0;
+  for (join->beginBatch(); join->NextBatch(chunk);) {
+    num_rows += chunk.GetNumSelected();
+  }
+  return num_rows;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelHashJoinBench, Threads) {
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_v", TYPE_LONG)});
+  Schema b_schema({Column("b_aid", TYPE_INT), Column("b_v", TYPE_DOUBLE), Column("b_name", TYPE_VARCHAR, 16)});
+  std::vector<Tuple> a_tuples;
+  std::vector<Tuple> b_tuples;
+  for (int i = 0; i < 101; i++) {
+    a_tuples.emplace_back(std::vector<Value>{Value(TYPE_INT, 0), Value(TYPE_LONG, static_cast<int64_t>(i))}, &a_schema);
+    b_tuples.emplace_back(
+        std::vector<Value>{Value(TYPE_INT, 0), Value(TYPE_DOUBLE, i * 0.5), Value(TYPE_VARCHAR, std::to_string(i))},
+        &b_schema);
+  }
+  Condition cond;
+  cond.lhs_col = {.tab_name = "a", .col_name = "a_id"};
+  cond.op = OP_EQ;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = false;
+  cond.rhs_col = {.tab_name = "b", .col_name = "b_aid"};
+  // every row of b finds the one row of a with its key
+  auto make_left = [&]() {
+    return std::make_unique<GeneratorExecutor>("a", a_schema, a_tuples, NUM_BUILD_ROWS, NUM_BUILD_ROWS);
+  };
+  auto make_right = [&]() {
+    return std::make_unique<GeneratorExecutor>("b", b_schema, b_tuples, NUM_PROBE_ROWS, NUM_BUILD_ROWS);
+  };
+
+  HashJoinExecutor serial(make_left(), make_right(), {cond});
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(CountRows(&serial), NUM_PROBE_ROWS);
+  std::chrono::duration<double> serial_time = std::chrono::steady_clock::now() - start;
+  std::printf("serial hash join: %.2f s\n", serial_time.count());
+
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    ParallelHashJoinExecutor join(make_left(), make_right(), {cond}, num_threads);
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(CountRows(&join), NUM_PROBE_ROWS);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%2zu threads: %.2f s, %.2fx\n", num_threads, elapsed.count(), serial_time.count() / elapsed.count());
+  }
+}
+
+}  // namespace easydb
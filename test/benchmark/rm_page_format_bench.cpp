@@ -0,0 +1,103 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_page_format_bench.cpp
+ *
+ * Identification: test/benchmark/rm_page_format_bench.cpp
+ *
+ * A narrow fact table (three INT columns, 12 bytes a row) loaded into a
+ * file of the old page format, with a 24-byte TupleInfo per slot, and
+ * into one of the compact format, with 4-byte slots. Prints the pages
+ * and rows per page of each file, and the throughput of a filtered page
+ * batch scan over it, once with a warm buffer pool and once with every
+ * page read from disk.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/condition.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "rm_page_format_bench.easydb";
+const std::string BENCH_TABLE_NAME = "rm_page_format_bench.table";
+
+static const int NUM_RECORDS = 1000000;
+static const int SCAN_ROUNDS = 5;
+
+// NOLINTNEXTLINE
+TEST(RmPageFormatBench, NarrowTableScan) {
+  Schema schema({Column("id", TypeId::TYPE_INT), Column("customer", TypeId::TYPE_INT),
+                 Column("amount", TypeId::TYPE_INT)});
+
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  BufferPoolManager bpm(16384, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+
+  // amount < 10, i.e. 10% of the rows qualify
+  Condition cond;
+  cond.lhs_col = {BENCH_TABLE_NAME, "amount"};
+  cond.op = OP_LT;
+  cond.is_rhs_val = true;
+  cond.rhs_val = Value(TypeId::TYPE_INT, 10);
+
+  std::printf("%-10s %8s %10s %16s %16s\n", "format", "pages", "rows/page", "warm rows/s", "cold rows/s");
+  for (int page_format : {RM_PAGE_FORMAT_TUPLE_INFO, RM_PAGE_FORMAT_COMPACT}) {
+    if (disk_manager.IsFile(path)) {
+      rm_manager.DestoryFile(path);
+    }
+    rm_manager.CreateFile(path, static_cast<int>(schema.GetInlinedStorageSize()), page_format);
+    auto fh = rm_manager.OpenFile(path);
+    for (int i = 0; i < NUM_RECORDS; i++) {
+      std::vector<Value> values{Value(TypeId::TYPE_INT, i), Value(TypeId::TYPE_INT, i % 1000),
+                                Value(TypeId::TYPE_INT, i % 100)};
+      ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, Tuple(values, &schema), nullptr).has_value());
+    }
+    int num_pages = fh->GetNumPages() - RM_FIRST_RECORD_PAGE;
+
+    double rows_per_sec[2];
+    for (bool cold : {false, true}) {
+      uint64_t qualified = 0;
+      std::vector<TupleView> batch;
+      std::chrono::duration<double> elapsed{0};
+      for (int round = 0; round < SCAN_ROUNDS; round++) {
+        if (cold) {
+          bpm.FlushAllPages(fh->GetFd());
+          bpm.RemoveAllPages(fh->GetFd());
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+          scan.GetPageBatch(batch);
+          for (const TupleView &view : batch) {
+            if (cond.satisfy(view.GetValue(&schema, 2u), cond.rhs_val)) {
+              qualified++;
+            }
+          }
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+      }
+      EXPECT_EQ(qualified, static_cast<uint64_t>(NUM_RECORDS / 10 * SCAN_ROUNDS));
+      rows_per_sec[cold] = static_cast<double>(NUM_RECORDS) * SCAN_ROUNDS / elapsed.count();
+    }
+    std::printf("%-10s %8d %10.1f %16.0f %16.0f\n",
+                page_format == RM_PAGE_FORMAT_COMPACT ? "compact" : "tupleinfo", num_pages,
+                static_cast<double>(NUM_RECORDS) / num_pages, rows_per_sec[0], rows_per_sec[1]);
+    rm_manager.CloseFile(fh.get());
+  }
+  rm_manager.DestoryFile(path);
+}
+
+}  // namespace easydb
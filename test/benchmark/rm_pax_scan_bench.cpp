@@ -0,0 +1,128 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_pax_scan_bench.cpp
+ *
+ * Identification: test/benchmark/rm_pax_scan_bench.cpp
+ *
+ * A wide fact table (twenty INT columns, 80 bytes a row) loaded into a
+ * file of the compact row format and into one of the PAX format. The
+ * query filters on one column (10% of the rows qualify) and sums three
+ * others. The row file is scanned a page batch at a time; the PAX file
+ * once a page batch at a time, putting every record together, and once
+ * column by column, reading only the minipages of the four columns the
+ * query refers to. Prints the pages of each file and the throughput of
+ * each scan with a warm buffer pool.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "rm_pax_scan_bench.easydb";
+const std::string BENCH_TABLE_NAME = "rm_pax_scan_bench.table";
+
+static const int NUM_RECORDS = 500000;
+static const int NUM_COLUMNS = 20;
+static const int FILTER_COLUMN = 3;
+static const int SCAN_ROUNDS = 5;
+
+static inline auto ReadInt(const char *data) -> int {
+  int value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// NOLINTNEXTLINE
+TEST(RmPaxScanBench, WideTableFilterScan) {
+  const int record_size = NUM_COLUMNS * static_cast<int>(sizeof(int));
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  BufferPoolManager bpm(16384, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+
+  // SELECT SUM(c0 + c1 + c2) FROM t WHERE c3 < 10, c3 = i % 100
+  int64_t expected_sum = 0;
+  for (int i = 0; i < NUM_RECORDS; i++) {
+    if (i % 100 < 10) {
+      expected_sum += static_cast<int64_t>(i) * 3 + 3;
+    }
+  }
+
+  std::printf("%-14s %8s %16s\n", "scan", "pages", "warm rows/s");
+  for (int page_format : {RM_PAGE_FORMAT_COMPACT, RM_PAGE_FORMAT_PAX}) {
+    if (disk_manager.IsFile(path)) {
+      rm_manager.DestoryFile(path);
+    }
+    rm_manager.CreateFile(path, record_size, page_format, std::vector<int>(NUM_COLUMNS, sizeof(int)));
+    auto fh = rm_manager.OpenFile(path);
+    std::vector<int> record(NUM_COLUMNS);
+    for (int i = 0; i < NUM_RECORDS; i++) {
+      for (int col = 0; col < NUM_COLUMNS; col++) {
+        record[col] = col == FILTER_COLUMN ? i % 100 : i + col;
+      }
+      Tuple tuple(record_size, reinterpret_cast<char *>(record.data()));
+      ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, tuple, nullptr).has_value());
+    }
+    int num_pages = fh->GetNumPages() - RM_FIRST_RECORD_PAGE;
+
+    std::vector<bool> by_column_options{false};
+    if (page_format == RM_PAGE_FORMAT_PAX) {
+      by_column_options.push_back(true);
+    }
+    for (bool by_column : by_column_options) {
+      int64_t sum = 0;
+      std::vector<TupleView> batch;
+      RmColumnBatch columns;
+      std::vector<uint32_t> selected;
+      auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < SCAN_ROUNDS; round++) {
+        for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+          if (!by_column) {
+            scan.GetPageBatch(batch);
+            for (const TupleView &view : batch) {
+              const char *data = view.GetData();
+              if (ReadInt(data + FILTER_COLUMN * sizeof(int)) < 10) {
+                sum += ReadInt(data) + ReadInt(data + sizeof(int)) + ReadInt(data + 2 * sizeof(int));
+              }
+            }
+            continue;
+          }
+          scan.GetPageColumns(columns);
+          selected.clear();
+          for (uint32_t slot_no : columns.slots_) {
+            if (ReadInt(columns.GetValueData(FILTER_COLUMN, slot_no)) < 10) {
+              selected.push_back(slot_no);
+            }
+          }
+          for (uint32_t slot_no : selected) {
+            sum += ReadInt(columns.GetValueData(0, slot_no)) + ReadInt(columns.GetValueData(1, slot_no)) +
+                   ReadInt(columns.GetValueData(2, slot_no));
+          }
+        }
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      EXPECT_EQ(sum, expected_sum * SCAN_ROUNDS);
+      const char *name = page_format == RM_PAGE_FORMAT_COMPACT ? "compact rows" : by_column ? "pax columns" : "pax rows";
+      std::printf("%-14s %8d %16.0f\n", name, num_pages,
+                  static_cast<double>(NUM_RECORDS) * SCAN_ROUNDS / elapsed.count());
+    }
+    rm_manager.CloseFile(fh.get());
+  }
+  rm_manager.DestoryFile(path);
+}
+
+}  // namespace easydb
@@ -0,0 +1,91 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * scan_prefetch_bench.cpp
+ *
+ * Identification: test/benchmark/scan_prefetch_bench.cpp
+ *
+ * Full RmScan of a table with a cold buffer pool and a cold OS page cache
+ * (the file is dropped from it with posix_fadvise), with the buffer pool's
+ * read-ahead turned off and on. Every tuple is read and checksummed so
+ * that there is processing to overlap the reads with.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <fcntl.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "scan_prefetch_bench.easydb";
+const std::string BENCH_TABLE_NAME = "scan_prefetch_bench.table";
+
+// NOLINTNEXTLINE
+TEST(ScanPrefetchBench, ColdScanThroughput) {
+  const int record_size = 200;
+  const int num_records = 200000;
+  const int pool_frames = 1024;
+
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+
+  // Load the table once.
+  {
+    BufferPoolManager bpm(pool_frames, &disk_manager);
+    RmManager rm_manager(&disk_manager, &bpm);
+    rm_manager.CreateFile(path, record_size);
+    auto fh = rm_manager.OpenFile(path);
+    std::vector<char> data(record_size);
+    for (int i = 0; i < num_records; i++) {
+      std::memcpy(data.data(), &i, sizeof(i));
+      ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr).has_value());
+    }
+    rm_manager.CloseFile(fh.get());
+  }
+
+  std::printf("%-10s %8s %10s %14s\n", "prefetch", "pages", "seconds", "tuples/s");
+  for (bool prefetch : {false, true}) {
+    BufferPoolManager bpm(pool_frames, &disk_manager);
+    bpm.SetPrefetchEnabled(prefetch);
+    RmManager rm_manager(&disk_manager, &bpm);
+    auto fh = rm_manager.OpenFile(path);
+    fdatasync(fh->GetFd());
+    posix_fadvise(fh->GetFd(), 0, 0, POSIX_FADV_DONTNEED);
+
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    uint64_t checksum = 0;
+    for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+      auto tuple = fh->GetTupleValue(scan.GetRid(), nullptr);
+      for (int i = 0; i < tuple->GetLength(); i++) {
+        checksum = checksum * 31 + static_cast<unsigned char>(tuple->GetData()[i]);
+      }
+      count++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%-10s %8d %10.3f %14.0f   (checksum %llx)\n", prefetch ? "on" : "off", fh->GetFileHdr().num_pages,
+                elapsed.count(), count / elapsed.count(), static_cast<unsigned long long>(checksum));
+    EXPECT_EQ(count, num_records);
+    rm_manager.CloseFile(fh.get());
+  }
+
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
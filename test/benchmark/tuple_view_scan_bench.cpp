@@ -0,0 +1,133 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * tuple_view_scan_bench.cpp
+ *
+ * Identification: test/benchmark/tuple_view_scan_bench.cpp
+ *
+ * A filtered sequential scan of a warm table, the way SeqScanExecutor
+ * runs it: once with the old copy path (every tuple fetched and copied
+ * into a heap Tuple for the predicate, and again when it qualifies) and
+ * once evaluating the predicate on a TupleView of the pinned page and
+ * materializing only the qualifying tuples, one record at a time and a
+ * page batch at a time. Prints the heap allocations per scanned tuple,
+ * counted by replacing the global operator new, and the scan throughput.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/condition.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+static std::atomic<uint64_t> num_allocations{0};
+
+void *operator new(size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace easydb {
+
+const std::string BENCH_DB_NAME = "tuple_view_scan_bench.easydb";
+const std::string BENCH_TABLE_NAME = "tuple_view_scan_bench.table";
+
+static const int NUM_RECORDS = 200000;
+static const int SCAN_ROUNDS = 5;
+
+// NOLINTNEXTLINE
+TEST(TupleViewScanBench, FilteredScan) {
+  Schema schema({Column("id", TypeId::TYPE_INT), Column("val", TypeId::TYPE_INT),
+                 Column("name", TypeId::TYPE_CHAR, 64)});
+
+  DiskManager disk_manager(BENCH_DB_NAME);
+  std::string path = BENCH_DB_NAME + "/" + BENCH_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  BufferPoolManager bpm(4096, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  rm_manager.CreateFile(path, static_cast<int>(schema.GetInlinedStorageSize()));
+  auto fh = rm_manager.OpenFile(path);
+  for (int i = 0; i < NUM_RECORDS; i++) {
+    std::vector<Value> values{Value(TypeId::TYPE_INT, i), Value(TypeId::TYPE_INT, i % 100),
+                              Value(TypeId::TYPE_CHAR, std::string("row"))};
+    Tuple tuple(values, &schema);
+    ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, tuple, nullptr).has_value());
+  }
+
+  // val < 10, i.e. 10% of the rows qualify
+  Condition cond;
+  cond.lhs_col = {BENCH_TABLE_NAME, "val"};
+  cond.op = OP_LT;
+  cond.is_rhs_val = true;
+  cond.rhs_val = Value(TypeId::TYPE_INT, 10);
+
+  std::printf("%-8s %10s %12s %14s %14s\n", "path", "qualified", "allocs", "allocs/tuple", "tuples/s");
+  for (std::string path_name : {"copy", "view", "batch"}) {
+    uint64_t qualified = 0;
+    uint64_t checksum = 0;
+    auto emit = [&](const Tuple &out) {
+      checksum += out.GetValue(&schema, 0u).GetAs<int32_t>();
+      qualified++;
+    };
+    std::vector<TupleView> batch;
+    uint64_t allocations_before = num_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < SCAN_ROUNDS; round++) {
+      for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+        if (path_name == "copy") {
+          auto tuple = *fh->GetTupleValue(scan.GetRid(), nullptr);
+          if (cond.satisfy(tuple.GetValue(&schema, cond.lhs_col.col_name), cond.rhs_val)) {
+            emit(*fh->GetTupleValue(scan.GetRid(), nullptr));
+          }
+        } else if (path_name == "view") {
+          TupleView view = scan.GetTupleView();
+          if (cond.satisfy(view.GetValue(&schema, cond.lhs_col.col_name), cond.rhs_val)) {
+            emit(*std::make_unique<Tuple>(view.Materialize()));
+          }
+        } else {
+          scan.GetPageBatch(batch);
+          for (const TupleView &view : batch) {
+            if (cond.satisfy(view.GetValue(&schema, cond.lhs_col.col_name), cond.rhs_val)) {
+              emit(*std::make_unique<Tuple>(view.Materialize()));
+            }
+          }
+        }
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocations = num_allocations.load() - allocations_before;
+    double scanned = static_cast<double>(NUM_RECORDS) * SCAN_ROUNDS;
+    std::printf("%-8s %10llu %12llu %14.2f %14.0f   (checksum %llu)\n", path_name.c_str(),
+                static_cast<unsigned long long>(qualified), static_cast<unsigned long long>(allocations),
+                allocations / scanned, scanned / elapsed.count(), static_cast<unsigned long long>(checksum));
+    EXPECT_EQ(qualified, static_cast<uint64_t>(NUM_RECORDS / 10 * SCAN_ROUNDS));
+  }
+
+  rm_manager.CloseFile(fh.get());
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
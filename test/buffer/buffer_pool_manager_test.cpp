@@ -0,0 +1,649 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "bpm_test.easydb";
+const std::string TEST_TABLE_NAME = "bpm_test.table";
+
+class BufferPoolManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    disk_manager_ = std::make_unique<DiskManager>(TEST_DB_NAME);
+    path_ = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+    if (disk_manager_->IsFile(path_)) {
+      disk_manager_->DestroyFile(path_);
+    }
+    disk_manager_->CreateFile(path_);
+    fd_ = disk_manager_->OpenFile(path_);
+  }
+
+  void TearDown() override {
+    disk_manager_->CloseFile(fd_);
+    disk_manager_->DestroyFile(path_);
+  }
+
+  /** Every page is stamped with its page number so that stale or misplaced frames are detected. */
+  static void StampPage(Page *page, page_id_t page_no) {
+    for (int i = Page::SIZE_PAGE_HEADER; i + static_cast<int>(sizeof(page_id_t)) <= PAGE_SIZE; i += sizeof(page_id_t)) {
+      std::memcpy(page->GetData() + i, &page_no, sizeof(page_id_t));
+    }
+  }
+
+  static auto CheckPage(Page *page, page_id_t page_no) -> bool {
+    for (int i = Page::SIZE_PAGE_HEADER; i + static_cast<int>(sizeof(page_id_t)) <= PAGE_SIZE; i += sizeof(page_id_t)) {
+      page_id_t value;
+      std::memcpy(&value, page->GetData() + i, sizeof(page_id_t));
+      if (value != page_no) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::string path_;
+  int fd_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, PartitionedEvictionTest) {
+  const int num_pages = 64;
+  BufferPoolManager bpm(16, disk_manager_.get(), 4);
+  EXPECT_EQ(bpm.Size(), 16);
+  EXPECT_EQ(bpm.NumPartitions(), 4);
+
+  // Create more pages than frames, every page is written back when it is evicted.
+  for (int i = 0; i < num_pages; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    EXPECT_EQ(page_id.page_no, i);
+    StampPage(page, page_id.page_no);
+    EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+  }
+
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    EXPECT_EQ(page->GetPinCount(), 1);
+    EXPECT_TRUE(bpm.UnpinPage({fd_, i}, false));
+    EXPECT_FALSE(bpm.UnpinPage({fd_, i}, false));
+  }
+
+  // Flushing everything makes the data visible to a fresh buffer pool.
+  bpm.FlushAllDirtyPages();
+  BufferPoolManager other(8, disk_manager_.get(), 2);
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = other.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    other.UnpinPage({fd_, i}, false);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ConcurrentFetchTest) {
+  const int num_pages = 256;
+  const int num_threads = 8;
+  const int num_ops = 20000;
+  BufferPoolManager bpm(64, disk_manager_.get(), 8);
+
+  for (int i = 0; i < num_pages; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    StampPage(page, page_id.page_no);
+    bpm.UnpinPage(page_id, true);
+  }
+
+  // Readers and writers race on a pool much smaller than the data, so misses, dirty write-backs and hits on frames
+  // that are still loading all happen concurrently.
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int> dist(0, num_pages - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_no = dist(rng);
+        Page *page = bpm.FetchPage({fd_, page_no});
+        if (page == nullptr) {
+          continue;
+        }
+        bool dirty = (i % 4 == 0);
+        if (dirty) {
+          page->WLatch();
+          StampPage(page, page_no);
+          page->WUnlatch();
+        } else {
+          page->RLatch();
+          if (!CheckPage(page, page_no)) {
+            failures++;
+          }
+          page->RUnlatch();
+        }
+        bpm.UnpinPage({fd_, page_no}, dirty);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, OptimisticHitTest) {
+  const int num_frames = 64;
+  const int num_hot = 16;
+  const int num_cold = 256;
+  const int num_readers = 4;
+  const int num_ops = 20000;
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 4);
+
+  for (int i = 0; i < num_hot + num_cold; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    StampPage(page, page_id.page_no);
+    bpm.UnpinPage(page_id, true);
+  }
+
+  // Readers hit a small hot set while a scanner streams the cold pages through the pool, so the frames of hot pages
+  // are claimed for cold ones while readers pin them without the latch.
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  std::atomic<bool> done{false};
+  threads.emplace_back([&] {
+    for (int round = 0; !done; round++) {
+      page_id_t page_no = num_hot + round % num_cold;
+      Page *page = bpm.FetchPage({fd_, page_no});
+      if (page != nullptr) {
+        if (!CheckPage(page, page_no)) {
+          failures++;
+        }
+        bpm.UnpinPage({fd_, page_no}, round % 8 == 0);
+      }
+    }
+  });
+  for (int t = 0; t < num_readers; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int> dist(0, num_hot - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_no = dist(rng);
+        Page *page = bpm.FetchPage({fd_, page_no});
+        if (page == nullptr) {
+          continue;
+        }
+        if (!CheckPage(page, page_no)) {
+          failures++;
+        }
+        EXPECT_TRUE(bpm.UnpinPage({fd_, page_no}, false));
+      }
+    });
+  }
+  for (size_t t = 1; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  done = true;
+  threads[0].join();
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_GT(bpm.GetAccessStats(AccessType::NORMAL).optimistic_hits, 0);
+
+  // Every pin has been dropped, so every frame must be evictable again: all of them can be pinned at once.
+  std::vector<PageId> pinned;
+  for (int i = 0; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr) << "frame leaked after " << i << " pages";
+    pinned.push_back(page_id);
+  }
+  for (const PageId &page_id : pinned) {
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+    EXPECT_FALSE(bpm.UnpinPage(page_id, false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, BatchedLoadTest) {
+  const int num_pages = 48;
+  BufferPoolManager bpm(16, disk_manager_.get(), 4);
+  for (int i = 0; i < num_pages; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    StampPage(page, page_id.page_no);
+    bpm.UnpinPage(page_id, true);
+  }
+
+  // The pool holds the last 16 dirty pages, loading the first 16 writes them back and reads the others in batches.
+  EXPECT_EQ(bpm.LoadPages(fd_, 0, 16), 16);
+  EXPECT_EQ(bpm.LoadPages(fd_, 0, 16), 0);
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    EXPECT_EQ(page->GetPinCount(), 1);
+    bpm.UnpinPage({fd_, i}, i % 2 == 0);
+  }
+
+  // The batched flush leaves the pages unpinned and clean.
+  bpm.FlushAllPages(fd_);
+  BufferPoolManager other(num_pages, disk_manager_.get(), 2);
+  EXPECT_EQ(other.LoadPages(fd_, 0, num_pages), num_pages);
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = other.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    other.UnpinPage({fd_, i}, false);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, BackgroundWriterTest) {
+  const int num_frames = 16;
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 2);
+  // rounds are driven by hand to get exact counts
+  bpm.SetPageWriterEnabled(false);
+  LogManager log_manager(disk_manager_.get());
+  bpm.SetLogManager(&log_manager);
+
+  for (int i = 0; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    StampPage(page, page_id.page_no);
+    page->SetLSN(i % 2 == 0 ? 0 : 7);
+    bpm.UnpinPage(page_id, true);
+  }
+  // a pinned dirty page is left alone
+  ASSERT_NE(bpm.FetchPage({fd_, 0}), nullptr);
+
+  // Nothing is logged yet, so no page may be written.
+  EXPECT_EQ(bpm.WriteBackDirtyPages(64), 0);
+
+  // Log records 0..5 are persisted: the pages with LSN 0 can be written, the ones with LSN 7 can not.
+  for (int i = 0; i < 6; i++) {
+    BeginLogRecord record(i);
+    log_manager.add_log_to_buffer(&record);
+  }
+  log_manager.flush_log_to_disk();
+  EXPECT_EQ(bpm.WriteBackDirtyPages(64), num_frames / 2 - 1);
+  bpm.UnpinPage({fd_, 0}, false);
+  bpm.SetLogManager(nullptr);
+  EXPECT_EQ(bpm.WriteBackDirtyPages(4), 4);
+  EXPECT_EQ(bpm.WriteBackDirtyPages(64), num_frames / 2 - 4 + 1);
+  EXPECT_EQ(bpm.WriteBackDirtyPages(64), 0);
+  EXPECT_EQ(bpm.GetWriteStats().background_writes, num_frames);
+
+  // Every victim is clean now, new pages do not write anything back.
+  for (int i = 0; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+    bpm.UnpinPage(page_id, false);
+  }
+  auto stats = bpm.GetWriteStats();
+  EXPECT_EQ(stats.sync_evictions, 0);
+  EXPECT_EQ(stats.clean_evictions, num_frames);
+
+  for (int i = 0; i < num_frames; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    bpm.UnpinPage({fd_, i}, false);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ConcurrentWriteBackTest) {
+  // A page modified while the background writer copies it must stay dirty, or its last version would be lost when it
+  // is evicted.
+  const int num_frames = 16;
+  const int num_pages = 4;
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 2);
+  bpm.SetPageWriterEnabled(false);
+  for (int i = 0; i < num_pages; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+    bpm.UnpinPage(page_id, true);
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<page_id_t> last_stamp(num_pages);
+  std::thread writer([&] {
+    for (page_id_t stamp = 1; stamp <= 100000; stamp++) {
+      int page_no = stamp % num_pages;
+      Page *page = bpm.FetchPage({fd_, page_no});
+      StampPage(page, stamp);
+      last_stamp[page_no] = stamp;
+      bpm.UnpinPage({fd_, page_no}, true);
+    }
+    done = true;
+  });
+  while (!done) {
+    bpm.WriteBackDirtyPages(64);
+  }
+  writer.join();
+  bpm.WriteBackDirtyPages(64);
+
+  // evict every page, then read them back from the disk
+  for (int i = 0; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+    bpm.UnpinPage(page_id, false);
+  }
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, last_stamp[i]));
+    bpm.UnpinPage({fd_, i}, false);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, RemovePinnedPageTest) {
+  const int num_frames = 8;
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 1);
+  std::vector<PageId> page_ids;
+  for (int i = 0; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(page, nullptr);
+    StampPage(page, page_id.page_no);
+    page_ids.push_back(page_id);
+  }
+  // pages 0 and 1 are still held when the file is dropped, the others are not
+  for (int i = 2; i < num_frames; i++) {
+    bpm.UnpinPage(page_ids[i], true);
+  }
+  Page *held = bpm.FetchPage(page_ids[0]);
+  ASSERT_NE(held, nullptr);
+  Page *other = bpm.FetchPage(page_ids[1]);
+  ASSERT_NE(other, nullptr);
+  bpm.UnpinPage(page_ids[1], false);
+  bpm.RemoveAllPages(fd_);
+
+  // The holders still read their pages, and nobody else gets their frames meanwhile.
+  EXPECT_TRUE(CheckPage(held, page_ids[0].page_no));
+  EXPECT_TRUE(CheckPage(other, page_ids[1].page_no));
+  std::vector<PageId> new_pages;
+  for (int i = 2; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+    new_pages.push_back(page_id);
+  }
+  PageId page_id{fd_, INVALID_PAGE_ID};
+  EXPECT_EQ(bpm.NewPage(&page_id), nullptr);
+
+  // Their last unpins give the frames back: the whole pool can be pinned again.
+  EXPECT_TRUE(bpm.UnpinPage(page_ids[0], true));
+  EXPECT_TRUE(bpm.UnpinPage(page_ids[1], false));
+  EXPECT_TRUE(bpm.UnpinPage(page_ids[0], false));
+  EXPECT_FALSE(bpm.UnpinPage(page_ids[0], false));
+  for (int i = 0; i < 2; i++) {
+    PageId id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&id), nullptr);
+    new_pages.push_back(id);
+  }
+  for (const auto &id : new_pages) {
+    EXPECT_TRUE(bpm.UnpinPage(id, false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, RingScanTest) {
+  const int num_frames = 128;
+  const int num_hot_pages = 64;
+  const int num_scan_pages = 4 * num_frames;
+  // the hot pages live in a file of their own, the scanned table in fd_
+  std::string hot_path = path_ + ".hot";
+  if (disk_manager_->IsFile(hot_path)) {
+    disk_manager_->DestroyFile(hot_path);
+  }
+  disk_manager_->CreateFile(hot_path);
+  int hot_fd = disk_manager_->OpenFile(hot_path);
+  {
+    BufferPoolManager loader(16, disk_manager_.get(), 1);
+    for (int fd : {hot_fd, fd_}) {
+      for (int i = 0; i < (fd == hot_fd ? num_hot_pages : num_scan_pages); i++) {
+        PageId page_id{fd, INVALID_PAGE_ID};
+        Page *page = loader.NewPage(&page_id);
+        ASSERT_NE(page, nullptr);
+        StampPage(page, page_id.page_no);
+        loader.UnpinPage(page_id, true);
+      }
+    }
+    loader.FlushAllDirtyPages();
+  }
+
+  {
+    BufferPoolManager bpm(num_frames, disk_manager_.get(), 1);
+    bpm.SetPrefetchEnabled(false);
+    for (int i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(bpm.FetchPage({hot_fd, i}), nullptr);
+      bpm.UnpinPage({hot_fd, i}, false);
+    }
+    EXPECT_EQ(bpm.GetAccessStats(AccessType::NORMAL).misses, num_hot_pages);
+
+    // A scan of a table 4x the pool, page 0 of which someone else keeps pinned: the ring must not recycle its frame.
+    {
+      BufferAccessStrategy strategy(AccessType::SEQ_SCAN, SEQ_SCAN_RING_SIZE);
+      for (int i = 0; i < num_scan_pages; i++) {
+        Page *page = bpm.FetchPage({fd_, i}, &strategy);
+        ASSERT_NE(page, nullptr);
+        EXPECT_TRUE(CheckPage(page, i));
+        if (i == 0) {
+          ASSERT_EQ(bpm.FetchPage({fd_, 0}), page);
+        }
+        bpm.UnpinPage({fd_, i}, false);
+      }
+      EXPECT_EQ(bpm.GetAccessStats(AccessType::SEQ_SCAN).misses, num_scan_pages);
+    }
+    Page *pinned = bpm.FetchPage({fd_, 0});
+    ASSERT_NE(pinned, nullptr);
+    EXPECT_TRUE(CheckPage(pinned, 0));
+    bpm.UnpinPage({fd_, 0}, false);
+    bpm.UnpinPage({fd_, 0}, false);
+
+    // Every hot page is still cached, and of the table only the last ring's worth of pages is.
+    auto normal = bpm.GetAccessStats(AccessType::NORMAL);
+    for (int i = 0; i < num_hot_pages; i++) {
+      ASSERT_NE(bpm.FetchPage({hot_fd, i}), nullptr);
+      bpm.UnpinPage({hot_fd, i}, false);
+    }
+    for (int i = num_scan_pages - 1; i >= num_scan_pages - SEQ_SCAN_RING_SIZE; i--) {
+      ASSERT_NE(bpm.FetchPage({fd_, i}), nullptr);
+      bpm.UnpinPage({fd_, i}, false);
+    }
+    EXPECT_EQ(bpm.GetAccessStats(AccessType::NORMAL).hits, normal.hits + num_hot_pages + SEQ_SCAN_RING_SIZE);
+    EXPECT_EQ(bpm.GetAccessStats(AccessType::NORMAL).misses, normal.misses);
+
+    // The strategy is gone, its frames are shared again: the whole pool can be pinned at once.
+    for (int i = 0; i < num_frames; i++) {
+      Page *page = bpm.FetchPage({fd_, i});
+      ASSERT_NE(page, nullptr);
+      EXPECT_TRUE(CheckPage(page, i));
+    }
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    EXPECT_EQ(bpm.NewPage(&page_id), nullptr);
+    for (int i = 0; i < num_frames; i++) {
+      bpm.UnpinPage({fd_, i}, false);
+    }
+  }
+  disk_manager_->CloseFile(hot_fd);
+  disk_manager_->DestroyFile(hot_path);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, RingBulkWriteTest) {
+  const int num_frames = 64;
+  const int ring_size = 8;
+  const int num_pages = 200;
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 1);
+  bpm.SetPageWriterEnabled(false);
+
+  // A bulk load through a ring of 8 frames: each dirty ring frame has to be written back before it takes a new page.
+  {
+    BufferAccessStrategy strategy(AccessType::BULK_WRITE, ring_size);
+    for (int i = 0; i < num_pages; i++) {
+      PageId page_id{fd_, INVALID_PAGE_ID};
+      Page *page = bpm.NewPage(&page_id, &strategy);
+      ASSERT_NE(page, nullptr);
+      StampPage(page, page_id.page_no);
+      bpm.UnpinPage(page_id, true);
+    }
+  }
+  auto stats = bpm.GetWriteStats();
+  EXPECT_EQ(stats.sync_evictions, num_pages - ring_size);
+  EXPECT_EQ(stats.clean_evictions, 0);
+
+  // The written pages read back right, the ones still in the ring (read first) are found in the pool.
+  auto before = bpm.GetAccessStats(AccessType::NORMAL);
+  for (int i = num_pages - 1; i >= 0; i--) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    bpm.UnpinPage({fd_, i}, false);
+  }
+  EXPECT_EQ(bpm.GetAccessStats(AccessType::NORMAL).misses, before.misses + num_pages - ring_size);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, PrefetchTest) {
+  const int num_frames = 128;
+  const int num_pages = 64;
+  {
+    BufferPoolManager loader(16, disk_manager_.get(), 1);
+    for (int i = 0; i < num_pages; i++) {
+      PageId page_id{fd_, INVALID_PAGE_ID};
+      Page *page = loader.NewPage(&page_id);
+      ASSERT_NE(page, nullptr);
+      StampPage(page, page_id.page_no);
+      loader.UnpinPage(page_id, true);
+    }
+    loader.FlushAllDirtyPages();
+  }
+  BufferPoolManager bpm(num_frames, disk_manager_.get(), 4);
+  ASSERT_TRUE(bpm.IsPrefetchEnabled());
+
+  // Read-ahead of the whole file, and of a range that runs past its end: only the pages of the file are loaded.
+  bpm.PrefetchPages(fd_, 0, num_pages / 2);
+  bpm.PrefetchPages(fd_, num_pages / 2, num_pages);
+  for (int i = 0; i < 10000 && bpm.GetAccessStats(AccessType::PREFETCH).misses < num_pages; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm.FlushAllPages(fd_);
+  EXPECT_EQ(bpm.GetAccessStats(AccessType::PREFETCH).misses, num_pages);
+
+  // Every page is resident and nobody else has it pinned.
+  for (int i = 0; i < num_pages; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+    EXPECT_EQ(page->GetPinCount(), 1);
+    bpm.UnpinPage({fd_, i}, false);
+  }
+  EXPECT_EQ(bpm.GetAccessStats(AccessType::NORMAL).misses, 0);
+
+  // The page created past the old end of the file is the only frame of its page id.
+  PageId new_page_id{fd_, INVALID_PAGE_ID};
+  Page *new_page = bpm.NewPage(&new_page_id);
+  ASSERT_NE(new_page, nullptr);
+  EXPECT_EQ(new_page_id.page_no, num_pages);
+  StampPage(new_page, new_page_id.page_no);
+  bpm.UnpinPage(new_page_id, true);
+  EXPECT_EQ(bpm.FetchPage(new_page_id), new_page);
+  EXPECT_TRUE(CheckPage(new_page, new_page_id.page_no));
+  bpm.UnpinPage(new_page_id, false);
+  bpm.FlushAllPages(fd_);
+
+  // Drop the pages of the file again and again while read-ahead keeps loading them.
+  std::atomic<bool> stop{false};
+  std::thread prefetcher([&] {
+    std::mt19937 rng(7);
+    while (!stop) {
+      int first = static_cast<int>(rng() % num_pages);
+      bpm.PrefetchPages(fd_, first, static_cast<int>(rng() % 16) + 1);
+    }
+  });
+  for (int round = 0; round < 200; round++) {
+    if (round % 2 == 0) {
+      bpm.RemoveAllPages(fd_);
+    } else {
+      bpm.FlushAllPages(fd_);
+    }
+  }
+  stop = true;
+  prefetcher.join();
+  bpm.RemoveAllPages(fd_);
+
+  // No read-ahead left a pin or a stale frame behind: the pages read back right and the whole pool can be pinned.
+  for (int i = 0; i <= num_pages; i++) {
+    Page *page = bpm.FetchPage({fd_, i});
+    ASSERT_NE(page, nullptr);
+    EXPECT_TRUE(CheckPage(page, i));
+  }
+  std::vector<PageId> pinned;
+  for (int i = num_pages + 1; i < num_frames; i++) {
+    PageId page_id{fd_, INVALID_PAGE_ID};
+    ASSERT_NE(bpm.NewPage(&page_id), nullptr);
+    pinned.push_back(page_id);
+  }
+  PageId page_id{fd_, INVALID_PAGE_ID};
+  EXPECT_EQ(bpm.NewPage(&page_id), nullptr);
+  for (int i = 0; i <= num_pages; i++) {
+    bpm.UnpinPage({fd_, i}, false);
+  }
+  for (const auto &id : pinned) {
+    bpm.UnpinPage(id, false);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, FrameArenaTest) {
+  // The data of all frames is one aligned block, with and without huge pages.
+  for (bool use_huge_pages : {false, true}) {
+    const int num_frames = 600;
+    BufferPoolManager bpm(num_frames, disk_manager_.get(), 4, REPLACER_TYPE, use_huge_pages);
+    std::vector<char *> data;
+    for (int i = 0; i < num_frames; i++) {
+      PageId page_id{fd_, INVALID_PAGE_ID};
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(page, nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE, 0);
+      StampPage(page, page_id.page_no);
+      data.push_back(page->GetData());
+      bpm.UnpinPage(page_id, true);
+    }
+    std::sort(data.begin(), data.end());
+    EXPECT_EQ(data.back() - data.front(), (num_frames - 1) * PAGE_SIZE);
+    if (use_huge_pages) {
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(data.front()) % FrameArena::HUGE_PAGE_SIZE, 0);
+    }
+
+    bpm.FlushAllDirtyPages();
+    for (int i = 0; i < num_frames; i++) {
+      Page *page = bpm.FetchPage({fd_, i});
+      ASSERT_NE(page, nullptr);
+      EXPECT_TRUE(CheckPage(page, i));
+      bpm.UnpinPage({fd_, i}, false);
+    }
+  }
+}
+
+}  // namespace easydb
@@ -0,0 +1,76 @@
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "gtest/gtest.h"
+
+namespace easydb {
+
+TEST(ClockReplacerTest, TestFunctionality) {
+  ClockReplacer clock_replacer(7);
+
+  // Unpinned but never accessed frames are taken in hand order.
+  for (frame_id_t i = 1; i <= 6; i++) {
+    clock_replacer.Unpin(i);
+  }
+  clock_replacer.Unpin(1);
+  EXPECT_EQ(6, clock_replacer.Size());
+
+  int value;
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+
+  // A pinned frame is never a victim, an accessed frame gets a second chance.
+  clock_replacer.Pin(3);
+  clock_replacer.Pin(4);
+  clock_replacer.Unpin(4);
+  EXPECT_EQ(3, clock_replacer.Size());
+
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+
+  clock_replacer.Unpin(3);
+  clock_replacer.Remove(3);
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
+TEST(ClockReplacerTest, ConcurrentPinUnpin) {
+  const int num_frames = 64;
+  const int num_threads = 4;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Each thread owns a disjoint range of frames and pins/unpins it while others sweep.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int round = 0; round < 1000; round++) {
+        for (frame_id_t i = t * 16; i < (t + 1) * 16; i++) {
+          clock_replacer.Pin(i);
+          clock_replacer.Unpin(i);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_frames, clock_replacer.Size());
+
+  std::vector<bool> seen(num_frames, false);
+  int value;
+  for (int i = 0; i < num_frames; i++) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_FALSE(seen[value]);
+    seen[value] = true;
+  }
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+}
+
+}  // namespace easydb
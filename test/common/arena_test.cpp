@@ -0,0 +1,97 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * arena_test.cpp
+ *
+ * Identification: test/common/arena_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/arena.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+
+namespace easydb {
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, AllocateTest) {
+  Arena arena(1024);
+  EXPECT_EQ(arena.GetNumBlocks(), 0);
+
+  // small allocations share a block and keep their alignment
+  std::vector<char *> ptrs;
+  for (int i = 0; i < 10; i++) {
+    char *ptr = arena.Allocate(13);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(uint64_t), 0);
+    std::memset(ptr, i, 13);
+    ptrs.push_back(ptr);
+  }
+  EXPECT_EQ(arena.GetNumBlocks(), 1);
+  EXPECT_EQ(arena.GetBytesAllocated(), 130);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(ptrs[i][12], i);
+  }
+
+  // a large one that does not fit gets a block of its own, the small ones go on in the current block
+  char *large = arena.Allocate(900);
+  std::memset(large, 0x7f, 900);
+  EXPECT_EQ(arena.GetNumBlocks(), 2);
+  char *small = arena.Allocate(8);
+  EXPECT_EQ(small, ptrs[9] + 16);
+  EXPECT_EQ(arena.GetNumBlocks(), 2);
+
+  // running out of the current block takes a new one
+  for (int i = 0; i < 100; i++) {
+    arena.Allocate(200);
+  }
+  EXPECT_GT(arena.GetNumBlocks(), 2);
+
+  const char data[] = "some varchar payload";
+  char *copy = arena.Copy(data, sizeof(data));
+  EXPECT_STREQ(copy, data);
+
+  // a reset keeps a single block, which the next query starts in
+  arena.Reset();
+  EXPECT_EQ(arena.GetNumBlocks(), 1);
+  EXPECT_EQ(arena.GetBytesAllocated(), 0);
+  arena.Allocate(100);
+  EXPECT_EQ(arena.GetNumBlocks(), 1);
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaTest, JoinedTupleTest) {
+  Schema left_schema({Column("id", TYPE_INT), Column("name", TYPE_VARCHAR, 16), Column("note", TYPE_VARCHAR, 16)});
+  Schema right_schema({Column("city", TYPE_VARCHAR, 16), Column("score", TYPE_DOUBLE)});
+  std::vector<Column> joined_columns = left_schema.GetColumns();
+  joined_columns.insert(joined_columns.end(), right_schema.GetColumns().begin(), right_schema.GetColumns().end());
+  Schema joined_schema(joined_columns);
+
+  std::vector<Value> left_values{Value(TYPE_INT, 7), Value(TYPE_VARCHAR, "ann"), Value(TYPE_VARCHAR, "")};
+  std::vector<Value> right_values{Value(TYPE_VARCHAR, "paris"), Value(TYPE_DOUBLE, 6.5)};
+  Tuple left(left_values, &left_schema);
+  Tuple right(right_values, &right_schema);
+
+  // the way a join buffers its children and writes its rows
+  Arena arena;
+  TupleView left_view(arena.Copy(left.GetData(), left.GetLength()), left.GetLength(), left.GetRid());
+  TupleView right_view(arena.Copy(right.GetData(), right.GetLength()), right.GetLength(), right.GetRid());
+  std::vector<char> joined;
+  ConcatTuples(left_view, left_schema, right_view, right_schema, &joined);
+
+  std::vector<Value> joined_values = left_values;
+  joined_values.insert(joined_values.end(), right_values.begin(), right_values.end());
+  Tuple expected(joined_values, &joined_schema);
+  EXPECT_EQ(joined, std::vector<char>(expected.GetData(), expected.GetData() + expected.GetLength()));
+  TupleView joined_view(joined.data(), joined.size(), RID());
+  EXPECT_EQ(joined_view.GetValue(&joined_schema, "city").ToString(), "paris");
+  EXPECT_EQ(joined_view.GetValue(&joined_schema, "name").ToString(), "ann");
+}
+
+}  // namespace easydb
@@ -0,0 +1,106 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * stats_test.cpp
+ *
+ * Identification: test/common/stats_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/stats.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+// NOLINTNEXTLINE
+TEST(StatsTest, LatencyBucketsTest) {
+  // every value lies within its bucket, and the bucket is at most 1/16 of the value wide
+  for (uint64_t value : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 31ULL, 32ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+    size_t index = LatencyBuckets::Index(value);
+    ASSERT_LT(index, LatencyBuckets::NUM_BUCKETS);
+    EXPECT_GE(LatencyBuckets::HighestValue(index), value);
+    if (index > 0) {
+      EXPECT_LT(LatencyBuckets::HighestValue(index - 1), value);
+    }
+    EXPECT_LE(LatencyBuckets::HighestValue(index) - value, value / LatencyBuckets::SUB_BUCKETS);
+  }
+
+  HistogramSnapshot histogram;
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.buckets_[LatencyBuckets::Index(value * 1000)]++;
+    histogram.count_++;
+    histogram.sum_ += value * 1000;
+  }
+  histogram.max_ = 1000 * 1000;
+  EXPECT_NEAR(static_cast<double>(histogram.Percentile(50)), 500 * 1000, 500 * 1000 / 16);
+  EXPECT_NEAR(static_cast<double>(histogram.Percentile(99)), 990 * 1000, 990 * 1000 / 16);
+  EXPECT_EQ(histogram.Percentile(100), histogram.max_);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 500.5 * 1000);
+}
+
+// NOLINTNEXTLINE
+TEST(StatsTest, PerThreadAggregationTest) {
+  const int num_threads = 4;
+  const int num_ops = 10000;
+  StatsSnapshot before = Stats::Snapshot();
+
+  // the threads exit before the snapshot is taken, so their counts must have been kept
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([] {
+      for (int i = 0; i < num_ops; i++) {
+        Stats::Add(StatCounter::BUFFER_PIN_WAITS);
+        Stats::RecordLatency(StatHistogram::WRITE_BATCH, 1000 + i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  Stats::Add(StatCounter::BUFFER_PIN_WAITS, 5);
+
+  StatsSnapshot after = Stats::Snapshot();
+  EXPECT_EQ(after.Get(StatCounter::BUFFER_PIN_WAITS) - before.Get(StatCounter::BUFFER_PIN_WAITS),
+            num_threads * num_ops + 5);
+  const auto &histogram = after.GetHistogram(StatHistogram::WRITE_BATCH);
+  EXPECT_EQ(histogram.count_ - before.GetHistogram(StatHistogram::WRITE_BATCH).count_, num_threads * num_ops);
+  EXPECT_GE(histogram.max_, 1000 + num_ops - 1);
+}
+
+// NOLINTNEXTLINE
+TEST(StatsTest, DiskManagerStatsTest) {
+  const std::string db_name = "stats_test.easydb";
+  const std::string path = db_name + "/stats_test.table";
+  DiskManager disk_manager(db_name);
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  disk_manager.CreateFile(path);
+  int fd = disk_manager.OpenFile(path);
+
+  StatsSnapshot before = Stats::Snapshot();
+  char data[PAGE_SIZE] = {};
+  for (page_id_t page_no = 0; page_no < 8; page_no++) {
+    disk_manager.WritePage(fd, page_no, data, PAGE_SIZE);
+    disk_manager.ReadPage(fd, page_no, data, PAGE_SIZE);
+  }
+  StatsSnapshot after = Stats::Snapshot();
+
+  EXPECT_EQ(after.Get(StatCounter::IO_PAGES_WRITTEN) - before.Get(StatCounter::IO_PAGES_WRITTEN), 8);
+  EXPECT_EQ(after.Get(StatCounter::IO_BYTES_READ) - before.Get(StatCounter::IO_BYTES_READ), 8 * PAGE_SIZE);
+  EXPECT_EQ(after.GetHistogram(StatHistogram::READ_PAGE).count_ - before.GetHistogram(StatHistogram::READ_PAGE).count_,
+            8);
+  EXPECT_GT(after.GetHistogram(StatHistogram::WRITE_PAGE).sum_, before.GetHistogram(StatHistogram::WRITE_PAGE).sum_);
+
+  disk_manager.CloseFile(fd);
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
@@ -0,0 +1,138 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * aggregation_test.cpp
+ *
+ * Identification: test/execution/aggregation_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_aggregation.h"
+#include "execution/memory_scan_executor.hpp"
+#include "gtest/gtest.h"
+#include "type/limits.h"
+
+namespace easydb {
+
+static auto Col(const std::string &col_name, AggregationType type = NO_AGG) -> TabCol {
+  return {.tab_name = "t", .col_name = col_name, .aggregation_type = type, .new_col_name = ""};
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationTest, GroupByTest) {
+  Schema schema({Column("g", TYPE_INT), Column("s", TYPE_VARCHAR, 16), Column("v", TYPE_INT), Column("d", TYPE_DOUBLE)});
+  std::vector<Tuple> tuples;
+  struct Expected {
+    int count_{0};
+    int count_v_{0};
+    int sum_v_{0};
+    int min_v_{0};
+    int max_v_{0};
+    double sum_d_{0};
+    std::string max_s_;
+  };
+  std::map<int, Expected> expected;
+  for (int i = 0; i < 5000; i++) {
+    int g = i % 37;
+    std::string s = "s" + std::to_string(i % 13);
+    bool v_null = i % 11 == 0;
+    tuples.emplace_back(std::vector<Value>{Value(TYPE_INT, g), Value(TYPE_VARCHAR, s),
+                                           Value(TYPE_INT, v_null ? EASYDB_INT32_NULL : i), Value(TYPE_DOUBLE, i * 0.5)},
+                        &schema);
+    Expected &e = expected[g];
+    e.count_++;
+    e.sum_d_ += i * 0.5;
+    e.max_s_ = std::max(e.max_s_, s);
+    if (!v_null) {
+      e.min_v_ = e.count_v_ == 0 ? i : std::min(e.min_v_, i);
+      e.max_v_ = e.count_v_ == 0 ? i : std::max(e.max_v_, i);
+      e.count_v_++;
+      e.sum_v_ += i;
+    }
+  }
+
+  // select g, COUNT(*), COUNT(v), SUM(v), MIN(v), MAX(v), AVG(d), MAX(s) from t group by g
+  std::vector<TabCol> sel_cols{Col("g"),           Col("*", COUNT_AGG), Col("v", COUNT_AGG), Col("v", SUM_AGG),
+                               Col("v", MIN_AGG),  Col("v", MAX_AGG),   Col("d", AVG_AGG),   Col("s", MAX_AGG)};
+  AggregationExecutor agg(std::make_unique<MemoryScanExecutor>("t", schema, &tuples), sel_cols, {Col("g")}, {});
+  const Schema &out = agg.schema();
+  EXPECT_EQ(out.GetColumn(1).GetName(), "COUNT(*)");
+  EXPECT_EQ(out.GetColumn(6).GetType(), TYPE_FLOAT);
+  size_t num_groups = 0;
+  for (agg.beginTuple(); !agg.IsEnd(); agg.nextTuple(), num_groups++) {
+    auto tuple = agg.Next();
+    int g = tuple->GetValue(&out, 0).GetAs<int32_t>();
+    const Expected &e = expected.at(g);
+    EXPECT_EQ(tuple->GetValue(&out, 1).GetAs<int32_t>(), e.count_);
+    EXPECT_EQ(tuple->GetValue(&out, 2).GetAs<int32_t>(), e.count_v_);
+    EXPECT_EQ(tuple->GetValue(&out, 3).GetAs<int32_t>(), e.sum_v_);
+    EXPECT_EQ(tuple->GetValue(&out, 4).GetAs<int32_t>(), e.min_v_);
+    EXPECT_EQ(tuple->GetValue(&out, 5).GetAs<int32_t>(), e.max_v_);
+    EXPECT_DOUBLE_EQ(tuple->GetValue(&out, 6).GetAs<double>(), e.sum_d_ / e.count_);
+    EXPECT_EQ(tuple->GetValue(&out, 7).ToString(), e.max_s_);
+  }
+  EXPECT_EQ(num_groups, expected.size());
+  // one accumulator row per group, whatever the number of rows
+  EXPECT_LT(agg.GetMemoryUsage(), 128 * 1024);
+
+  // select g, s, COUNT(*) from t group by g, s having COUNT(*) > 10 and SUM(v) >= 25000
+  Condition count_cond;
+  count_cond.lhs_col = Col("*", COUNT_AGG);
+  count_cond.op = OP_GT;
+  count_cond.is_rhs_val = true;
+  count_cond.is_rhs_stmt = false;
+  count_cond.rhs_val = Value(TYPE_INT, 10);
+  Condition sum_cond = count_cond;
+  sum_cond.lhs_col = Col("v", SUM_AGG);
+  sum_cond.op = OP_GE;
+  sum_cond.rhs_val = Value(TYPE_INT, 25000);
+  AggregationExecutor having(std::make_unique<MemoryScanExecutor>("t", schema, &tuples),
+                             {Col("g"), Col("s"), Col("*", COUNT_AGG)}, {Col("g"), Col("s")}, {count_cond, sum_cond});
+  std::map<std::pair<int, std::string>, std::pair<int, int>> pairs;  // (g, s) -> (COUNT(*), SUM(v))
+  for (int i = 0; i < 5000; i++) {
+    auto &p = pairs[{i % 37, "s" + std::to_string(i % 13)}];
+    p.first++;
+    p.second += i % 11 == 0 ? 0 : i;
+  }
+  size_t num_expected = 0;
+  for (auto &[key, p] : pairs) {
+    num_expected += p.first > 10 && p.second >= 25000 ? 1 : 0;
+  }
+  size_t num_having = 0;
+  for (having.beginTuple(); !having.IsEnd(); having.nextTuple(), num_having++) {
+    auto tuple = having.Next();
+    auto &p = pairs.at({tuple->GetValue(&having.schema(), 0).GetAs<int32_t>(),
+                        tuple->GetValue(&having.schema(), 1).ToString()});
+    EXPECT_EQ(tuple->GetValue(&having.schema(), 2).GetAs<int32_t>(), p.first);
+    EXPECT_GT(p.first, 10);
+    EXPECT_GE(p.second, 25000);
+  }
+  EXPECT_GT(num_expected, 0);
+  EXPECT_EQ(num_having, num_expected);
+
+  // without group by there is one row even for no input, SUM of no values being NULL
+  std::vector<Tuple> empty;
+  AggregationExecutor total(std::make_unique<MemoryScanExecutor>("t", schema, &empty),
+                            {Col("*", COUNT_AGG), Col("v", SUM_AGG)}, {}, {});
+  total.beginTuple();
+  ASSERT_FALSE(total.IsEnd());
+  auto tuple = total.Next();
+  EXPECT_EQ(tuple->GetValue(&total.schema(), 0).GetAs<int32_t>(), 0);
+  EXPECT_TRUE(tuple->GetValue(&total.schema(), 1).IsNull());
+  total.nextTuple();
+  EXPECT_TRUE(total.IsEnd());
+
+  // a column neither grouped nor aggregated has no value
+  EXPECT_THROW(AggregationExecutor(std::make_unique<MemoryScanExecutor>("t", schema, &empty),
+                                   {Col("v"), Col("*", COUNT_AGG)}, {Col("g")}, {}),
+               InternalError);
+}
+
+}  // namespace easydb
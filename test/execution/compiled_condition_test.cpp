@@ -0,0 +1,145 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * compiled_condition_test.cpp
+ *
+ * Identification: test/execution/compiled_condition_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <vector>
+
+#include "execution/compiled_condition.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+
+namespace easydb {
+
+// NOLINTNEXTLINE
+TEST(CompiledConditionTest, SameAsValuesTest) {
+  Schema schema({Column("id", TYPE_INT), Column("amount", TYPE_LONG), Column("price", TYPE_DOUBLE),
+                 Column("day", TYPE_DATE), Column("name", TYPE_VARCHAR, 16), Column("code", TYPE_VARCHAR, 16)});
+  auto make_tuple = [&](int32_t id, int64_t amount, double price, uint64_t day, const std::string &name,
+                        const std::string &code) {
+    return Tuple({Value(TYPE_INT, id), Value(TYPE_LONG, amount), Value(TYPE_DOUBLE, price), Value(TYPE_DATE, day),
+                  Value(TYPE_VARCHAR, name), Value(TYPE_VARCHAR, code)},
+                 &schema);
+  };
+  std::vector<Tuple> tuples{
+      make_tuple(3, 3, 3.0, 20240101, "bob", "bob"),
+      make_tuple(-1, 7, 2.5, 20231231, "alice", "al"),
+      make_tuple(10, 10, 10.5, 20240102, "", "carol"),
+      make_tuple(EASYDB_INT32_NULL, EASYDB_INT64_NULL, EASYDB_DECIMAL_NULL, EASYDB_TIMESTAMP_NULL, "x", "x"),
+  };
+  std::vector<Value> constants{Value(TYPE_INT, 3),          Value(TYPE_LONG, static_cast<int64_t>(10)),
+                               Value(TYPE_DOUBLE, 2.5),     Value(TYPE_DATE, static_cast<uint64_t>(20240101)),
+                               Value(TYPE_VARCHAR, "bob"),  Value(TYPE_VARCHAR, ""),
+                               Value(TYPE_INT, EASYDB_INT32_NULL)};
+
+  int num_typed = 0;
+  for (CompOp op : {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE}) {
+    std::vector<Condition> conds;
+    // a column against a constant of a type it compares with, dates are left to the test below as their Values
+    // only compare in a release build
+    for (const auto &col : schema.GetColumns()) {
+      if (col.GetType() == TYPE_DATE) {
+        continue;
+      }
+      for (const Value &constant : constants) {
+        bool col_numeric = col.GetType() != TYPE_DATE && col.GetType() != TYPE_VARCHAR;
+        bool val_numeric = constant.GetTypeId() != TYPE_DATE && constant.GetTypeId() != TYPE_VARCHAR;
+        if (col_numeric != val_numeric || (!col_numeric && col.GetType() != constant.GetTypeId())) {
+          continue;
+        }
+        Condition cond;
+        cond.lhs_col = {.tab_name = "t", .col_name = col.GetName()};
+        cond.op = op;
+        cond.is_rhs_val = true;
+        cond.is_rhs_stmt = false;
+        cond.rhs_val = constant;
+        conds.push_back(cond);
+      }
+    }
+    // two columns of the same tuple
+    for (const auto &[lhs, rhs] : std::vector<std::pair<std::string, std::string>>{
+             {"id", "amount"}, {"amount", "price"}, {"price", "id"}, {"name", "code"}}) {
+      Condition cond;
+      cond.lhs_col = {.tab_name = "t", .col_name = lhs};
+      cond.op = op;
+      cond.is_rhs_val = false;
+      cond.is_rhs_stmt = false;
+      cond.rhs_col = {.tab_name = "t", .col_name = rhs};
+      conds.push_back(cond);
+    }
+
+    for (auto &cond : conds) {
+      CompiledCondition compiled(cond, schema, schema);
+      num_typed += compiled.IsTyped() ? 1 : 0;
+      for (const Tuple &tuple : tuples) {
+        Value lhs_v = tuple.GetValue(&schema, cond.lhs_col.col_name);
+        Value rhs_v = cond.is_rhs_val ? cond.rhs_val : tuple.GetValue(&schema, cond.rhs_col.col_name);
+        EXPECT_EQ(compiled.Evaluate(cond, tuple.GetData(), tuple.GetData()), cond.satisfy(lhs_v, rhs_v))
+            << cond.lhs_col.col_name << " " << op << " "
+            << (cond.is_rhs_val ? cond.rhs_val.ToString() : cond.rhs_col.col_name) << " on "
+            << tuple.ToString(&schema);
+      }
+    }
+  }
+  // every condition above has a kernel of its own
+  EXPECT_EQ(num_typed, 6 * (3 * 4 + 2 * 2 + 4));
+
+  // day >= 20240101, never true on NULL
+  Condition cond;
+  cond.lhs_col = {.tab_name = "t", .col_name = "day"};
+  cond.op = OP_GE;
+  cond.is_rhs_val = true;
+  cond.is_rhs_stmt = false;
+  cond.rhs_val = Value(TYPE_DATE, static_cast<uint64_t>(20240101));
+  CompiledCondition compiled(cond, schema, schema);
+  EXPECT_TRUE(compiled.IsTyped());
+  std::vector<bool> satisfied;
+  for (const Tuple &tuple : tuples) {
+    satisfied.push_back(compiled.Evaluate(cond, tuple.GetData(), tuple.GetData()));
+  }
+  EXPECT_EQ(satisfied, std::vector<bool>({true, false, true, false}));
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledConditionTest, JoinTest) {
+  Schema left_schema({Column("id", TYPE_INT), Column("name", TYPE_VARCHAR, 16)});
+  Schema right_schema({Column("name", TYPE_VARCHAR, 16), Column("score", TYPE_DOUBLE)});
+  Tuple left({Value(TYPE_INT, 7), Value(TYPE_VARCHAR, "ann")}, &left_schema);
+  Tuple right({Value(TYPE_VARCHAR, "ann"), Value(TYPE_DOUBLE, 6.5)}, &right_schema);
+
+  // right.score < left.id, written with the column of the right child first
+  Condition cond;
+  cond.lhs_col = {.tab_name = "r", .col_name = "score"};
+  cond.op = OP_LT;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = false;
+  cond.rhs_col = {.tab_name = "l", .col_name = "id"};
+  auto compiled = CompiledCondition::ForJoin(cond, "l", left_schema, "r", right_schema);
+  EXPECT_TRUE(compiled.IsTyped());
+  EXPECT_TRUE(compiled.EvaluateJoin(cond, left.GetData(), right.GetData()));
+
+  cond.lhs_col = {.tab_name = "l", .col_name = "name"};
+  cond.op = OP_EQ;
+  cond.rhs_col = {.tab_name = "r", .col_name = "name"};
+  compiled = CompiledCondition::ForJoin(cond, "l", left_schema, "r", right_schema);
+  EXPECT_TRUE(compiled.EvaluateJoin(cond, left.GetData(), right.GetData()));
+
+  // a string against a number goes through Values
+  cond.op = OP_GT;
+  cond.is_rhs_val = true;
+  cond.rhs_val = Value(TYPE_INT, 3);
+  compiled = CompiledCondition::ForJoin(cond, "l", left_schema, "r", right_schema);
+  EXPECT_FALSE(compiled.IsTyped());
+
+  cond.lhs_col = {.tab_name = "other", .col_name = "name"};
+  EXPECT_THROW(CompiledCondition::ForJoin(cond, "l", left_schema, "r", right_schema), InternalError);
+}
+
+}  // namespace easydb
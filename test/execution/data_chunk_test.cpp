@@ -0,0 +1,124 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * data_chunk_test.cpp
+ *
+ * Identification: test/execution/data_chunk_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/data_chunk.h"
+#include "execution/executor_abstract.h"
+#include "execution/executor_hash_join.h"
+#include "execution/memory_scan_executor.hpp"
+#include "gtest/gtest.h"
+
+namespace easydb {
+
+// NOLINTNEXTLINE
+TEST(DataChunkTest, ChunkTest) {
+  Schema schema({Column("id", TYPE_INT), Column("name", TYPE_VARCHAR, 16), Column("score", TYPE_DOUBLE),
+                 Column("note", TYPE_VARCHAR, 16)});
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 10; i++) {
+    Value note = i % 3 == 0 ? Value(TYPE_VARCHAR) : Value(TYPE_VARCHAR, "n");
+    tuples.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_VARCHAR, "name" + std::to_string(i)),
+                                           Value(TYPE_DOUBLE, i * 1.5), note},
+                        &schema);
+  }
+
+  DataChunk chunk(schema, 8);
+  for (int i = 0; i < 8; i++) {
+    chunk.AppendTuple(tuples[i].GetData());
+  }
+  EXPECT_TRUE(chunk.IsFull());
+  EXPECT_EQ(chunk.GetNumSelected(), 8);
+  EXPECT_EQ(chunk.GetValue(0, 5).GetAs<int>(), 5);
+  EXPECT_EQ(chunk.GetValue(1, 5).ToString(), "name5");
+  EXPECT_TRUE(chunk.GetValue(3, 6).IsNull());
+
+  // a row is written back as the tuple it was read from
+  std::vector<char> row;
+  for (uint32_t i = 0; i < 8; i++) {
+    chunk.GetRow(i, &row);
+    EXPECT_EQ(row, std::vector<char>(tuples[i].GetData(), tuples[i].GetData() + tuples[i].GetLength()));
+  }
+
+  // a filter narrows the selection, the rows stay where they are
+  const ColumnVector &ids = chunk.GetColumn(0);
+  chunk.Select([&](uint32_t row) { return TypedReader<TYPE_INT>::Read(ids.GetStorage(row)) % 2 == 1; });
+  chunk.Select([&](uint32_t row) { return TypedReader<TYPE_INT>::Read(ids.GetStorage(row)) > 2; });
+  ASSERT_EQ(chunk.GetNumSelected(), 3);
+  EXPECT_EQ(chunk.GetSelected(0), 3);
+  EXPECT_EQ(chunk.GetSelected(2), 7);
+
+  // a projection shows some columns of the batch and its selection without copying them
+  std::vector<uint32_t> col_ids{3, 0};
+  Schema projected = Schema::CopySchema(&schema, col_ids);
+  DataChunk view(projected, 8);
+  view.Reference(chunk, col_ids);
+  EXPECT_EQ(view.GetNumSelected(), 3);
+  EXPECT_EQ(&view.GetColumn(1), &chunk.GetColumn(0));
+  view.GetRow(view.GetSelected(1), &row);
+  Tuple expected({Value(TYPE_VARCHAR, "n"), Value(TYPE_INT, 5)}, &projected);
+  EXPECT_EQ(row, std::vector<char>(expected.GetData(), expected.GetData() + expected.GetLength()));
+  view.Reset();
+  EXPECT_EQ(view.GetSize(), 0);
+  EXPECT_NE(&view.GetColumn(1), &chunk.GetColumn(0));
+}
+
+// NOLINTNEXTLINE
+TEST(DataChunkTest, BatchHashJoinTest) {
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_name", TYPE_VARCHAR, 32)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_aid", TYPE_INT)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  for (int i = 0; i < 700; i++) {
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_VARCHAR, "name" + std::to_string(i))}, &a_schema);
+  }
+  // three rows of b for each row of a, more than fit in a batch
+  for (int i = 0; i < 2100; i++) {
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, i % 700)}, &b_schema);
+  }
+  Condition cond;
+  cond.lhs_col = {.tab_name = "a", .col_name = "a_id"};
+  cond.op = OP_EQ;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = false;
+  cond.rhs_col = {.tab_name = "b", .col_name = "b_aid"};
+
+  auto make_join = [&]() {
+    return std::make_unique<HashJoinExecutor>(std::make_unique<MemoryScanExecutor>("a", a_schema, &a),
+                                              std::make_unique<MemoryScanExecutor>("b", b_schema, &b),
+                                              std::vector<Condition>{cond});
+  };
+  std::vector<std::string> row_results;
+  auto row_join = make_join();
+  for (row_join->beginTuple(); !row_join->IsEnd(); row_join->nextTuple()) {
+    row_results.push_back(row_join->Next()->ToString(&row_join->schema()));
+  }
+
+  // the batches hold the rows of the row-at-a-time join, in the same order
+  std::vector<std::string> batch_results;
+  auto batch_join = make_join();
+  DataChunk chunk(batch_join->schema());
+  std::vector<char> row;
+  size_t num_batches = 0;
+  for (batch_join->beginBatch(); batch_join->NextBatch(chunk); num_batches++) {
+    for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+      chunk.GetRow(chunk.GetSelected(i), &row);
+      batch_results.push_back(Tuple(static_cast<int>(row.size()), row.data()).ToString(&batch_join->schema()));
+    }
+  }
+  EXPECT_EQ(row_results.size(), 2100);
+  EXPECT_EQ(batch_results, row_results);
+  EXPECT_EQ(num_batches, 3);
+}
+
+}  // namespace easydb
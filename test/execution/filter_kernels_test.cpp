@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * filter_kernels_test.cpp
+ *
+ * Identification: test/execution/filter_kernels_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "execution/filter_kernels.h"
+#include "gtest/gtest.h"
+#include "type/limits.h"
+
+namespace easydb {
+
+static auto MakeCond(const std::string &col_name, CompOp op, const Value &rhs_val) -> Condition {
+  Condition cond;
+  cond.lhs_col = {.tab_name = "t", .col_name = col_name};
+  cond.op = op;
+  cond.is_rhs_val = true;
+  cond.is_rhs_stmt = false;
+  cond.rhs_val = rhs_val;
+  return cond;
+}
+
+static auto MakeInCond(const std::string &col_name, std::vector<Value> values) -> Condition {
+  Condition cond;
+  cond.lhs_col = {.tab_name = "t", .col_name = col_name};
+  cond.op = OP_IN;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = true;
+  cond.is_rhs_exe_processed = true;
+  cond.rhs_in_col = std::move(values);
+  return cond;
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, KernelTest) {
+  Schema schema({Column("i", TYPE_INT), Column("l", TYPE_LONG), Column("d", TYPE_DOUBLE),
+                 Column("s", TYPE_VARCHAR, 16)});
+  // values from a small range so that every operator has rows on both sides, one in ten NULL; 1003 rows leave a
+  // tail that does not fill a register
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(-20, 20);
+  std::vector<std::string> strings{"", "a", "apple", "applesauce", "applesaucf", "banana", "bananas12", "zz"};
+  DataChunk chunk(schema);
+  for (int row = 0; row < 1003; row++) {
+    int n = dist(gen);
+    bool is_null = row % 10 == 3;
+    Tuple tuple({Value(TYPE_INT, is_null ? EASYDB_INT32_NULL : n),
+                 Value(TYPE_LONG, static_cast<int64_t>(is_null ? EASYDB_INT64_NULL : n * 1000000000LL)),
+                 Value(TYPE_DOUBLE, is_null ? EASYDB_DECIMAL_NULL : n * 0.5),
+                 is_null ? Value(TYPE_VARCHAR) : Value(TYPE_VARCHAR, strings[(n + 20) % strings.size()])},
+                &schema);
+    chunk.AppendTuple(tuple.GetData());
+  }
+
+  std::vector<Condition> conds;
+  for (CompOp op : {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE}) {
+    conds.push_back(MakeCond("i", op, Value(TYPE_INT, 3)));
+    conds.push_back(MakeCond("l", op, Value(TYPE_LONG, static_cast<int64_t>(-5000000000LL))));
+    conds.push_back(MakeCond("l", op, Value(TYPE_INT, 0)));
+    conds.push_back(MakeCond("d", op, Value(TYPE_DOUBLE, 2.5)));
+    conds.push_back(MakeCond("d", op, Value(TYPE_INT, -4)));
+    conds.push_back(MakeCond("s", op, Value(TYPE_VARCHAR, "applesauce")));
+    conds.push_back(MakeCond("s", op, Value(TYPE_VARCHAR, "b")));
+    conds.push_back(MakeCond("i", op, Value(TYPE_INT, EASYDB_INT32_NULL)));
+  }
+  conds.push_back(MakeInCond("i", {Value(TYPE_INT, 1), Value(TYPE_INT, -7), Value(TYPE_INT, EASYDB_INT32_NULL)}));
+  conds.push_back(MakeInCond("l", {Value(TYPE_INT, 2), Value(TYPE_LONG, static_cast<int64_t>(3000000000LL))}));
+  conds.push_back(MakeInCond("d", {Value(TYPE_DOUBLE, 1.5), Value(TYPE_INT, 4)}));
+  conds.push_back(MakeInCond("s", {Value(TYPE_VARCHAR, "apple"), Value(TYPE_VARCHAR, ""), Value(TYPE_VARCHAR, "x")}));
+
+  std::vector<SimdLevel> levels{SimdLevel::SCALAR};
+  if (FilterKernel::GetSimdLevel() != SimdLevel::SCALAR) {
+    levels.push_back(SimdLevel::SSE42);
+  }
+  if (FilterKernel::GetSimdLevel() == SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::AVX2);
+  }
+  std::vector<uint64_t> bitmap(FilterKernel::BitmapWords(chunk.GetSize()));
+  for (auto &cond : conds) {
+    uint32_t col_idx = schema.GetColIdx(cond.lhs_col.col_name);
+    auto kernel = FilterKernel::Create(cond, schema.GetColumn(col_idx).GetType());
+    ASSERT_NE(kernel, nullptr);
+    for (SimdLevel level : levels) {
+      kernel->Evaluate(chunk.GetColumn(col_idx), chunk.GetSize(), bitmap.data(), level);
+      for (uint32_t row = 0; row < chunk.GetSize(); row++) {
+        bool expected = cond.satisfy(chunk.GetValue(col_idx, row), cond.rhs_val);
+        ASSERT_EQ(((bitmap[row / 64] >> (row % 64)) & 1) != 0, expected)
+            << cond.lhs_col.col_name << " op " << cond.op << " level " << static_cast<int>(level) << " row " << row;
+      }
+    }
+  }
+
+  // the rows of a batch that pass are selected by the bitmap
+  auto kernel = FilterKernel::Create(MakeCond("i", OP_GT, Value(TYPE_INT, 15)), TYPE_INT);
+  kernel->Evaluate(chunk.GetColumn(0), chunk.GetSize(), bitmap.data());
+  chunk.SelectBitmap(bitmap.data());
+  ASSERT_GT(chunk.GetNumSelected(), 0);
+  for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+    EXPECT_GT(chunk.GetValue(0, chunk.GetSelected(i)).GetAs<int32_t>(), 15);
+  }
+
+  // an INT column against a DOUBLE constant is left to CompiledCondition
+  EXPECT_EQ(FilterKernel::Create(MakeCond("i", OP_LT, Value(TYPE_DOUBLE, 2.5)), TYPE_INT), nullptr);
+  EXPECT_EQ(FilterKernel::Create(MakeCond("s", OP_EQ, Value(TYPE_INT, 2)), TYPE_VARCHAR), nullptr);
+}
+
+}  // namespace easydb
@@ -0,0 +1,198 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * hash_join_test.cpp
+ *
+ * Identification: test/execution/hash_join_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_abstract.h"
+#include "execution/executor_hash_join.h"
+#include "execution/executor_parallel_hash_join.h"
+#include "execution/memory_scan_executor.hpp"
+#include "gtest/gtest.h"
+
+namespace easydb {
+
+static auto MakeEqCondition(const std::string &lhs_tab, const std::string &lhs_col, const std::string &rhs_tab,
+                            const std::string &rhs_col) -> Condition {
+  Condition cond;
+  cond.lhs_col = {.tab_name = lhs_tab, .col_name = lhs_col};
+  cond.op = OP_EQ;
+  cond.is_rhs_val = false;
+  cond.is_rhs_stmt = false;
+  cond.rhs_col = {.tab_name = rhs_tab, .col_name = rhs_col};
+  return cond;
+}
+
+/** @return the rows of a join, sorted, read a row at a time or a batch at a time */
+static auto RunJoin(AbstractExecutor *join, bool batch) -> std::vector<std::string> {
+  std::vector<std::string> results;
+  if (batch) {
+    DataChunk chunk(join->schema());
+    std::vector<char> row;
+    for (join->beginBatch(); join->NextBatch(chunk);) {
+      for (uint32_t i = 0; i < chunk.GetNumSelected(); i++) {
+        chunk.GetRow(chunk.GetSelected(i), &row);
+        results.push_back(Tuple(static_cast<int>(row.size()), row.data()).ToString(&join->schema()));
+      }
+    }
+  } else {
+    for (join->beginTuple(); !join->IsEnd(); join->nextTuple()) {
+      results.push_back(join->Next()->ToString(&join->schema()));
+    }
+  }
+  std::sort(results.begin(), results.end());
+  return results;
+}
+
+TEST(HashJoinTest, SpillTest) {
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_name", TYPE_VARCHAR, 32)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_aid", TYPE_LONG)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  for (int i = 0; i < 5000; i++) {
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_VARCHAR, "name" + std::to_string(i))}, &a_schema);
+  }
+  // two rows of a without a key, which join nothing
+  for (int i = 0; i < 2; i++) {
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, EASYDB_INT32_NULL), Value(TYPE_VARCHAR, "null")}, &a_schema);
+  }
+  // an INT joined with a BIGINT, two or three rows of b for each row of a and some that match nothing
+  for (int i = 0; i < 15100; i++) {
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_LONG, static_cast<int64_t>(i % 5100))}, &b_schema);
+  }
+  Condition cond = MakeEqCondition("a", "a_id", "b", "b_aid");
+  auto make_join = [&](size_t memory_budget) {
+    return std::make_unique<HashJoinExecutor>(std::make_unique<MemoryScanExecutor>("a", a_schema, &a),
+                                              std::make_unique<MemoryScanExecutor>("b", b_schema, &b),
+                                              std::vector<Condition>{cond}, memory_budget);
+  };
+
+  auto in_memory = make_join(HASH_JOIN_MEMORY_BUDGET);
+  std::vector<std::string> expected = RunJoin(in_memory.get(), false);
+  EXPECT_FALSE(in_memory->IsSpilled());
+  EXPECT_EQ(expected.size(), 4900 * 3 + 100 * 2);
+
+  // a budget of a few KB splits the table in the first pass, and its partitions again
+  for (bool batch : {false, true}) {
+    auto spilled = make_join(16 * 1024);
+    EXPECT_EQ(RunJoin(spilled.get(), batch), expected);
+    EXPECT_TRUE(spilled->IsSpilled());
+  }
+
+  // a join can run again
+  auto spilled = make_join(16 * 1024);
+  EXPECT_EQ(RunJoin(spilled.get(), false), expected);
+  EXPECT_EQ(RunJoin(spilled.get(), true), expected);
+}
+
+TEST(HashJoinTest, SkewedSpillTest) {
+  // one key with more rows than the budget: the partitioning gives up after HASH_JOIN_MAX_PASSES and joins it anyway
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_key", TYPE_VARCHAR, 16)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_key", TYPE_CHAR, 16)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  for (int i = 0; i < 3000; i++) {
+    std::string key = i < 2000 ? "hot" : "key" + std::to_string(i);
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_VARCHAR, key)}, &a_schema);
+  }
+  for (int i = 0; i < 20; i++) {
+    std::string key = i < 5 ? "hot" : "key" + std::to_string(2000 + i);
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_CHAR, key)}, &b_schema);
+  }
+  Condition cond = MakeEqCondition("b", "b_key", "a", "a_key");
+  auto make_join = [&](size_t memory_budget) {
+    return std::make_unique<HashJoinExecutor>(std::make_unique<MemoryScanExecutor>("a", a_schema, &a),
+                                              std::make_unique<MemoryScanExecutor>("b", b_schema, &b),
+                                              std::vector<Condition>{cond}, memory_budget);
+  };
+
+  auto in_memory = make_join(HASH_JOIN_MEMORY_BUDGET);
+  std::vector<std::string> expected = RunJoin(in_memory.get(), true);
+  EXPECT_EQ(expected.size(), 5 * 2000 + 15);
+
+  auto spilled = make_join(16 * 1024);
+  EXPECT_EQ(RunJoin(spilled.get(), true), expected);
+  EXPECT_TRUE(spilled->IsSpilled());
+}
+
+TEST(HashJoinTest, ParallelTest) {
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_name", TYPE_VARCHAR, 32)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_aid", TYPE_INT), Column("b_name", TYPE_VARCHAR, 32)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  for (int i = 0; i < 20000; i++) {
+    int id = i % 10 == 0 ? EASYDB_INT32_NULL : i % 7000;
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, id), Value(TYPE_VARCHAR, "a" + std::to_string(i % 5))},
+                   &a_schema);
+  }
+  for (int i = 0; i < 30000; i++) {
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, i % 9000),
+                                      Value(TYPE_VARCHAR, "a" + std::to_string(i % 3))},
+                   &b_schema);
+  }
+  // an equality to hash on, and one more condition tested on the pairs with the same key
+  std::vector<Condition> conds{MakeEqCondition("a", "a_id", "b", "b_aid"),
+                               MakeEqCondition("b", "b_name", "a", "a_name")};
+  auto make_left = [&]() { return std::make_unique<MemoryScanExecutor>("a", a_schema, &a); };
+  auto make_right = [&]() { return std::make_unique<MemoryScanExecutor>("b", b_schema, &b); };
+
+  HashJoinExecutor serial(make_left(), make_right(), conds);
+  std::vector<std::string> expected = RunJoin(&serial, true);
+  EXPECT_GT(expected.size(), 10000);
+
+  for (size_t num_threads : {1, 2, 4, 8}) {
+    ParallelHashJoinExecutor join(make_left(), make_right(), conds, num_threads);
+    EXPECT_EQ(join.GetNumThreads(), num_threads);
+    EXPECT_EQ(RunJoin(&join, false), expected);
+    EXPECT_EQ(RunJoin(&join, true), expected);
+  }
+
+  // without an equality every pair of rows is tested
+  std::vector<Tuple> small_b(b.begin(), b.begin() + 50);
+  std::vector<Condition> ne_conds{MakeEqCondition("a", "a_name", "b", "b_name")};
+  ne_conds[0].op = OP_NE;
+  HashJoinExecutor serial_ne(make_left(), std::make_unique<MemoryScanExecutor>("b", b_schema, &small_b), ne_conds);
+  ParallelHashJoinExecutor parallel_ne(make_left(), std::make_unique<MemoryScanExecutor>("b", b_schema, &small_b),
+                                       ne_conds, 4);
+  EXPECT_EQ(RunJoin(&parallel_ne, true), RunJoin(&serial_ne, false));
+}
+
+TEST(HashJoinTest, ParallelOutputBudgetTest) {
+  // 20 rows of a for each of 10 keys, 500 rows of b for each: 100000 joined rows, far more than the budget of a round
+  Schema a_schema({Column("a_id", TYPE_INT), Column("a_key", TYPE_INT)});
+  Schema b_schema({Column("b_id", TYPE_INT), Column("b_key", TYPE_INT)});
+  std::vector<Tuple> a;
+  std::vector<Tuple> b;
+  for (int i = 0; i < 200; i++) {
+    a.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, i % 10)}, &a_schema);
+  }
+  for (int i = 0; i < 5000; i++) {
+    b.emplace_back(std::vector<Value>{Value(TYPE_INT, i), Value(TYPE_INT, i % 10)}, &b_schema);
+  }
+  Condition cond = MakeEqCondition("a", "a_key", "b", "b_key");
+  auto make_left = [&]() { return std::make_unique<MemoryScanExecutor>("a", a_schema, &a); };
+  auto make_right = [&]() { return std::make_unique<MemoryScanExecutor>("b", b_schema, &b); };
+
+  HashJoinExecutor serial(make_left(), make_right(), {cond});
+  std::vector<std::string> expected = RunJoin(&serial, true);
+  EXPECT_EQ(expected.size(), 100000);
+
+  // a few KB a round: the workers leave most morsels of a round to the next ones
+  for (size_t num_threads : {1, 3}) {
+    ParallelHashJoinExecutor join(make_left(), make_right(), {cond}, num_threads, 4096);
+    EXPECT_EQ(RunJoin(&join, false), expected);
+    EXPECT_EQ(RunJoin(&join, true), expected);
+  }
+}
+
+}  // namespace easydb
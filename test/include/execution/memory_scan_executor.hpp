@@ -0,0 +1,54 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * memory_scan_executor.hpp
+ *
+ * Identification: test/include/execution/memory_scan_executor.hpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "execution/executor_abstract.h"
+
+namespace easydb {
+
+/**
+ * The rows of a table kept in memory, handed out a row at a time like a scan, and in place through NextView() like a
+ * scan of pinned pages. The executors of the tests and the benchmarks read it in place of a table.
+ */
+class MemoryScanExecutor : public AbstractExecutor {
+ public:
+  /** @param tuples the rows, which must outlive the executor */
+  MemoryScanExecutor(std::string tab_name, Schema schema, const std::vector<Tuple> *tuples,
+                     Context *context = nullptr)
+      : tab_name_(std::move(tab_name)), schema_(std::move(schema)), tuples_(tuples) {
+    context_ = context;
+  }
+
+  void beginTuple() override { idx_ = 0; }
+  void nextTuple() override { idx_++; }
+  bool IsEnd() const override { return idx_ >= tuples_->size(); }
+  std::unique_ptr<Tuple> Next() override { return std::make_unique<Tuple>((*tuples_)[idx_]); }
+  std::optional<TupleView> NextView() override { return TupleView((*tuples_)[idx_]); }
+  RID &rid() override { return _abstract_rid; }
+  size_t tupleLen() const override { return schema_.GetInlinedStorageSize(); }
+  const Schema &schema() const override { return schema_; }
+  std::string getTabName() const override { return tab_name_; }
+
+ private:
+  std::string tab_name_;
+  Schema schema_;
+  const std::vector<Tuple> *tuples_;
+  size_t idx_{0};
+};
+
+}  // namespace easydb
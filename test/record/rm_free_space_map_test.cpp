@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_free_space_map_test.cpp
+ *
+ * Identification: test/record/rm_free_space_map_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "record/rm_free_space_map.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_free_space_map_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_free_space_map_test.table";
+
+// NOLINTNEXTLINE
+TEST(RmFreeSpaceMapTest, FindPageTest) {
+  DiskManager disk_manager(TEST_DB_NAME);
+  BufferPoolManager bpm(64, &disk_manager);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME + RM_FSM_SUFFIX;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+
+  const page_id_t num_pages = 3 * RmFreeSpaceMap::FSM_PAGES_PER_MAP_PAGE;
+  {
+    RmFreeSpaceMap fsm(&disk_manager, &bpm, path);
+    EXPECT_TRUE(fsm.IsNew());
+    EXPECT_EQ(fsm.FindPage(1), RM_NO_PAGE);
+    for (page_id_t page_no = 1; page_no < num_pages; page_no++) {
+      fsm.SetClass(page_no, 1);
+    }
+    fsm.SetClass(num_pages - 10, 12);
+    fsm.SetClass(100, 15);
+    EXPECT_EQ(fsm.FindPage(13), 100);
+    EXPECT_EQ(fsm.FindPage(12), 100);
+    // dropping the only class 15 page lowers the group and map page maxima
+    fsm.SetClass(100, 0);
+    EXPECT_EQ(fsm.FindPage(13), RM_NO_PAGE);
+    EXPECT_EQ(fsm.FindPage(12), num_pages - 10);
+    EXPECT_EQ(fsm.FindPage(RmFreeSpaceMap::RequestToClass(PAGE_SIZE)), RM_NO_PAGE);
+    fsm.Close();
+  }
+
+  // the map is persistent
+  {
+    RmFreeSpaceMap fsm(&disk_manager, &bpm, path);
+    EXPECT_FALSE(fsm.IsNew());
+    EXPECT_EQ(fsm.GetClass(num_pages - 10), 12);
+    EXPECT_EQ(fsm.GetClass(100), 0);
+    EXPECT_EQ(fsm.GetClass(101), 1);
+    EXPECT_EQ(fsm.FindPage(12), num_pages - 10);
+    fsm.Close();
+  }
+  disk_manager.DestroyFile(path);
+}
+
+// NOLINTNEXTLINE
+TEST(RmFreeSpaceMapTest, InsertReusesFreeSpaceTest) {
+  DiskManager disk_manager(TEST_DB_NAME);
+  BufferPoolManager bpm(64, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    rm_manager.DestoryFile(path);
+  }
+  rm_manager.CreateFile(path, RM_MAX_RECORD_SIZE);
+  auto fh = rm_manager.OpenFile(path);
+
+  // large tuples leave a gap at the end of every page that the old free list never went back to
+  std::vector<char> large(1200);
+  std::vector<char> small(100);
+  for (int i = 0; i < 30; i++) {
+    ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, Tuple(large.size(), large.data()), nullptr).has_value());
+  }
+  int num_pages = fh->GetFileHdr().num_pages;
+  for (int i = 0; i < 8; i++) {
+    auto rid = fh->InsertTuple(TupleMeta{0, false}, Tuple(small.size(), small.data()), nullptr);
+    ASSERT_TRUE(rid.has_value());
+    EXPECT_LT(rid->GetPageId(), num_pages - 1) << "small tuple not put into the gap of an earlier page";
+  }
+  EXPECT_EQ(fh->GetFileHdr().num_pages, num_pages);
+  rm_manager.CloseFile(fh.get());
+
+  // a table without a map (e.g. created by an older version) gets one rebuilt when it is opened
+  disk_manager.DestroyFile(path + RM_FSM_SUFFIX);
+  fh = rm_manager.OpenFile(path);
+  auto rid = fh->InsertTuple(TupleMeta{0, false}, Tuple(small.size(), small.data()), nullptr);
+  ASSERT_TRUE(rid.has_value());
+  EXPECT_LT(rid->GetPageId(), num_pages - 1);
+
+  // concurrent inserters fill up the table without losing a tuple
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<char> data(50 + 40 * t, static_cast<char>(t));
+      for (int i = 0; i < 500; i++) {
+        ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, Tuple(data.size(), data.data()), nullptr).has_value());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  int count = 0;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    count++;
+  }
+  EXPECT_EQ(count, 30 + 8 + 1 + 4 * 500);
+  rm_manager.CloseFile(fh.get());
+  rm_manager.DestoryFile(path);
+}
+
+}  // namespace easydb
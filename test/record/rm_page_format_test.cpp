@@ -0,0 +1,222 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_page_format_test.cpp
+ *
+ * Identification: test/record/rm_page_format_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_page_format_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_page_format_test.table";
+
+// NOLINTNEXTLINE
+TEST(RmPageFormatTest, BothFormatsTest) {
+  const int record_size = 12;
+  const int num_records = 2000;
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  BufferPoolManager bpm(16, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+
+  std::vector<int> num_pages;
+  for (int page_format : {RM_PAGE_FORMAT_TUPLE_INFO, RM_PAGE_FORMAT_COMPACT}) {
+    if (disk_manager.IsFile(path)) {
+      rm_manager.DestoryFile(path);
+    }
+    rm_manager.CreateFile(path, record_size, page_format);
+    auto fh = rm_manager.OpenFile(path);
+    std::vector<RID> rids;
+    std::vector<char> data(record_size);
+    for (int i = 0; i < num_records; i++) {
+      std::memcpy(data.data(), &i, sizeof(i));
+      // only some tuples carry a timestamp
+      TupleMeta meta{i % 10 == 0 ? i + 1 : 0, false};
+      rids.push_back(*fh->InsertTuple(meta, Tuple(record_size, data.data()), nullptr));
+    }
+    for (int i = 0; i < num_records; i += 3) {
+      fh->DeleteTuple(rids[i], nullptr);
+    }
+    rm_manager.CloseFile(fh.get());
+
+    // the format is kept in the file header, the file reads back the same after it is opened again
+    fh = rm_manager.OpenFile(path);
+    EXPECT_EQ(fh->GetFileHdr().page_format, page_format);
+    num_pages.push_back(fh->GetNumPages() - RM_FIRST_RECORD_PAGE);
+    for (int i = 0; i < num_records; i++) {
+      auto [meta, tuple] = fh->GetTuple(rids[i], nullptr);
+      EXPECT_EQ(meta.is_deleted_, i % 3 == 0);
+      EXPECT_EQ(meta.ts_, i % 10 == 0 ? i + 1 : 0);
+      ASSERT_EQ(tuple.GetLength(), static_cast<uint32_t>(record_size));
+      EXPECT_EQ(*reinterpret_cast<const int *>(tuple.GetData()), i);
+    }
+    std::vector<int> scanned;
+    for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+      TupleView view = scan.GetTupleView();
+      EXPECT_EQ(view.GetLength(), static_cast<uint32_t>(record_size));
+      scanned.push_back(*reinterpret_cast<const int *>(view.GetData()));
+    }
+    std::vector<int> expected;
+    for (int i = 0; i < num_records; i++) {
+      if (i % 3 != 0) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(scanned, expected);
+
+    // the timestamp can be changed where there is one, but not added
+    fh->UpdateTupleMeta(TupleMeta{42, false}, rids[10], nullptr);
+    EXPECT_EQ(fh->GetTupleMeta(rids[10], nullptr).ts_, 42);
+    if (page_format == RM_PAGE_FORMAT_COMPACT) {
+      EXPECT_THROW(fh->UpdateTupleMeta(TupleMeta{42, false}, rids[11], nullptr), InternalError);
+    }
+
+    // vacuum keeps the timestamps of the live tuples
+    fh->Vacuum();
+    EXPECT_EQ(fh->GetTupleMeta(rids[10], nullptr).ts_, 42);
+    EXPECT_EQ(fh->GetTupleMeta(rids[20], nullptr).ts_, 21);
+    rm_manager.CloseFile(fh.get());
+  }
+  rm_manager.DestoryFile(path);
+
+  // a compact slot is 4 bytes instead of 24, a narrow table needs far fewer pages
+  EXPECT_LT(num_pages[1] * 2, num_pages[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(RmPageFormatTest, PaxFormatTest) {
+  // (int id, char(6) name, long amount), 18 bytes a record
+  const std::vector<int> column_sizes{4, 6, 8};
+  const int record_size = 18;
+  const int num_records = 2000;
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  BufferPoolManager bpm(16, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  if (disk_manager.IsFile(path)) {
+    rm_manager.DestoryFile(path);
+  }
+  EXPECT_THROW(rm_manager.CreateFile(path, record_size + 1, RM_PAGE_FORMAT_PAX, column_sizes), InvalidRecordSizeError);
+  rm_manager.CreateFile(path, record_size, RM_PAGE_FORMAT_PAX, column_sizes);
+  auto fh = rm_manager.OpenFile(path);
+
+  auto make_record = [&](int i) {
+    std::vector<char> data(record_size);
+    int64_t amount = i * 10;
+    std::memcpy(data.data(), &i, sizeof(i));
+    std::snprintf(data.data() + 4, 6, "n%04d", i % 10000);
+    std::memcpy(data.data() + 10, &amount, sizeof(amount));
+    return data;
+  };
+  std::vector<RID> rids;
+  for (int i = 0; i < num_records; i++) {
+    auto data = make_record(i);
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr));
+  }
+  for (int i = 0; i < num_records; i += 3) {
+    fh->DeleteTuple(rids[i], nullptr);
+  }
+  // a record of another size or a timestamp has no place on the page
+  std::vector<char> short_record(record_size - 1);
+  EXPECT_THROW(fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size - 1, short_record.data()), nullptr),
+               InternalError);
+  EXPECT_THROW(fh->UpdateTupleMeta(TupleMeta{42, false}, rids[1], nullptr), InternalError);
+  rm_manager.CloseFile(fh.get());
+
+  fh = rm_manager.OpenFile(path);
+  const RmFileHdr file_hdr = fh->GetFileHdr();
+  EXPECT_EQ(file_hdr.page_format, RM_PAGE_FORMAT_PAX);
+  // the pages are filled up to their capacity, there are no slots
+  EXPECT_EQ(rids[file_hdr.pax_capacity].GetPageId(), RM_FIRST_RECORD_PAGE + 1);
+  EXPECT_LE(file_hdr.pax_column_offsets[2] + file_hdr.pax_capacity * 8, static_cast<int>(PAGE_SIZE));
+  for (int i = 0; i < num_records; i++) {
+    auto [meta, tuple] = fh->GetTuple(rids[i], nullptr);
+    EXPECT_EQ(meta.is_deleted_, i % 3 == 0);
+    ASSERT_EQ(tuple.GetLength(), static_cast<uint32_t>(record_size));
+    EXPECT_EQ(std::memcmp(tuple.GetData(), make_record(i).data(), record_size), 0);
+  }
+
+  // the records are put together by the scan, one at a time or a page at a time
+  std::vector<int> expected;
+  for (int i = 0; i < num_records; i++) {
+    if (i % 3 != 0) {
+      expected.push_back(i);
+    }
+  }
+  std::vector<int> scanned;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    EXPECT_TRUE(scan.IsColumnar());
+    TupleView view = scan.GetTupleView();
+    EXPECT_EQ(std::memcmp(view.GetData(), make_record(*reinterpret_cast<const int *>(view.GetData())).data(),
+                          record_size),
+              0);
+    scanned.push_back(*reinterpret_cast<const int *>(view.GetData()));
+  }
+  EXPECT_EQ(scanned, expected);
+  scanned.clear();
+  std::vector<TupleView> batch;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    scan.GetPageBatch(batch);
+    for (const TupleView &view : batch) {
+      scanned.push_back(*reinterpret_cast<const int *>(view.GetData()));
+    }
+  }
+  EXPECT_EQ(scanned, expected);
+
+  // a column is read in place from its minipage, the records that pass a filter on it are put together
+  scanned.clear();
+  RmColumnBatch columns;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    scan.GetPageColumns(columns);
+    std::vector<uint32_t> selected;
+    for (uint32_t slot_no : columns.slots_) {
+      int64_t amount;
+      std::memcpy(&amount, columns.GetValueData(2, slot_no), sizeof(amount));
+      if (amount % 70 == 0) {
+        selected.push_back(slot_no);
+      }
+    }
+    scan.GetPageRecords(selected, batch);
+    for (const TupleView &view : batch) {
+      scanned.push_back(*reinterpret_cast<const int *>(view.GetData()));
+    }
+  }
+  std::vector<int> filtered;
+  for (int i : expected) {
+    if (i % 7 == 0) {
+      filtered.push_back(i);
+    }
+  }
+  EXPECT_EQ(scanned, filtered);
+
+  // updates go to the minipages, vacuum only gives back the deleted records at the end of a page
+  auto data = make_record(num_records + 1);
+  EXPECT_TRUE(fh->UpdateTupleInPlace(TupleMeta{0, false}, Tuple(record_size, data.data()), rids[1], nullptr));
+  EXPECT_EQ(std::memcmp(fh->GetTuple(rids[1], nullptr).second.GetData(), data.data(), record_size), 0);
+  fh->DeleteTuple(rids[num_records - 1], nullptr);
+  RmVacuumStats stats = fh->Vacuum();
+  EXPECT_GE(stats.slots_reclaimed_, 2u);  // at least the last two records of the file
+  EXPECT_EQ(stats.bytes_reclaimed_, stats.slots_reclaimed_ * record_size);
+  EXPECT_EQ(fh->GetTupleMeta(rids[3], nullptr).is_deleted_, true);
+  rm_manager.CloseFile(fh.get());
+  rm_manager.DestoryFile(path);
+}
+
+}  // namespace easydb
@@ -0,0 +1,226 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_scan_test.cpp
+ *
+ * Identification: test/record/rm_scan_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/executor_projection.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_scan_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_scan_test.table";
+
+/** A scan of a table file as an executor, handing out its records in place or only as copies. */
+class RmScanExecutor : public AbstractExecutor {
+ public:
+  RmScanExecutor(RmFileHandle *fh, Schema schema, bool use_views)
+      : fh_(fh), schema_(std::move(schema)), use_views_(use_views) {}
+
+  void beginTuple() override { scan_ = std::make_unique<RmScan>(fh_); }
+  void nextTuple() override { scan_->Next(); }
+  bool IsEnd() const override { return scan_->IsEnd(); }
+  std::unique_ptr<Tuple> Next() override { return fh_->GetTupleValue(scan_->GetRid(), nullptr); }
+  std::optional<TupleView> NextView() override {
+    return use_views_ ? std::optional<TupleView>(scan_->GetTupleView()) : std::nullopt;
+  }
+  RID &rid() override { return _abstract_rid; }
+  size_t tupleLen() const override { return schema_.GetInlinedStorageSize(); }
+  const Schema &schema() const override { return schema_; }
+  std::string getTabName() const override { return TEST_TABLE_NAME; }
+
+ private:
+  RmFileHandle *fh_;
+  Schema schema_;
+  bool use_views_;
+  std::unique_ptr<RmScan> scan_;
+};
+
+// NOLINTNEXTLINE
+TEST(RmScanTest, PageBatchTest) {
+  const int record_size = 100;
+  const int num_records = 1000;
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  BufferPoolManager bpm(16, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  rm_manager.CreateFile(path, record_size);
+  auto fh = rm_manager.OpenFile(path);
+
+  std::vector<RID> rids;
+  std::vector<char> data(record_size);
+  for (int i = 0; i < num_records; i++) {
+    std::memcpy(data.data(), &i, sizeof(i));
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr));
+  }
+  // delete every third record, among them the very first one
+  for (int i = 0; i < num_records; i += 3) {
+    fh->DeleteTuple(rids[i], nullptr);
+  }
+
+  std::vector<int> by_record;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    TupleView view = scan.GetTupleView();
+    EXPECT_EQ(view.GetRid(), scan.GetRid());
+    by_record.push_back(*reinterpret_cast<const int *>(view.GetData()));
+  }
+
+  std::vector<int> by_batch;
+  std::vector<TupleView> batch;
+  int num_batches = 0;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    scan.GetPageBatch(batch);
+    ASSERT_FALSE(batch.empty());
+    // a batch is one page, and the scan stays on its last record
+    EXPECT_EQ(batch.front().GetRid().GetPageId(), batch.back().GetRid().GetPageId());
+    EXPECT_EQ(batch.back().GetRid(), scan.GetRid());
+    for (const TupleView &view : batch) {
+      EXPECT_EQ(view.GetLength(), static_cast<uint32_t>(record_size));
+      by_batch.push_back(*reinterpret_cast<const int *>(view.GetData()));
+    }
+    num_batches++;
+  }
+
+  std::vector<int> expected;
+  for (int i = 0; i < num_records; i++) {
+    if (i % 3 != 0) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(by_record, expected);
+  EXPECT_EQ(by_batch, expected);
+  // one batch per page that has a live record
+  std::set<page_id_t> live_pages;
+  for (int i = 0; i < num_records; i++) {
+    if (i % 3 != 0) {
+      live_pages.insert(rids[i].GetPageId());
+    }
+  }
+  EXPECT_EQ(num_batches, static_cast<int>(live_pages.size()));
+
+  // the scans left no page pinned behind: all the frames can be pinned at once
+  ASSERT_GE(fh->GetFileHdr().num_pages, 16);
+  for (page_id_t page_no = 0; page_no < 16; page_no++) {
+    ASSERT_NE(bpm.FetchPage({fh->GetFd(), page_no}), nullptr) << "frame leaked after " << page_no << " pages";
+  }
+  for (page_id_t page_no = 0; page_no < 16; page_no++) {
+    EXPECT_TRUE(bpm.UnpinPage({fh->GetFd(), page_no}, false));
+  }
+
+  rm_manager.CloseFile(fh.get());
+  disk_manager.DestroyFile(path);
+}
+
+// NOLINTNEXTLINE
+TEST(RmScanTest, TupleViewTest) {
+  const int num_records = 3000;
+  Schema schema({Column("id", TYPE_INT), Column("big", TYPE_LONG), Column("name", TYPE_CHAR, 16),
+                 Column("score", TYPE_DOUBLE)});
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  BufferPoolManager bpm(16, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  rm_manager.CreateFile(path, static_cast<int>(schema.GetInlinedStorageSize()));
+  auto fh = rm_manager.OpenFile(path);
+
+  std::vector<RID> rids;
+  for (int i = 0; i < num_records; i++) {
+    std::vector<Value> values{Value(TYPE_INT, i), Value(TYPE_LONG, static_cast<int64_t>(i) * 1000000007),
+                              Value(TYPE_CHAR, "row" + std::to_string(i)), Value(TYPE_DOUBLE, i * 0.25)};
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, Tuple(values, &schema), nullptr));
+  }
+  // the first two pages are emptied, slot 0 of the third one and every 7th record after it are deleted
+  ASSERT_EQ(rids.front().GetPageId(), RM_FIRST_RECORD_PAGE);
+  page_id_t third_page = RM_FIRST_RECORD_PAGE + 2;
+  std::vector<int> expected;
+  for (int i = 0; i < num_records; i++) {
+    page_id_t page_no = rids[i].GetPageId();
+    if (page_no < third_page || (page_no == third_page && rids[i].GetSlotNum() == 0) || i % 7 == 0) {
+      fh->DeleteTuple(rids[i], nullptr);
+    } else {
+      expected.push_back(i);
+    }
+  }
+
+  // A view reads like the copy of its record, value by value.
+  std::vector<int> ids;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    TupleView view = scan.GetTupleView();
+    auto copy = fh->GetTupleValue(scan.GetRid(), nullptr);
+    ASSERT_EQ(view.GetLength(), copy->GetLength());
+    EXPECT_EQ(std::memcmp(view.GetData(), copy->GetData(), view.GetLength()), 0);
+    for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+      EXPECT_EQ(view.GetValue(&schema, col).ToString(), copy->GetValue(&schema, col).ToString());
+    }
+    Tuple materialized = view.Materialize();
+    EXPECT_EQ(materialized.ToString(&schema), copy->ToString(&schema));
+    ids.push_back(view.GetValue(&schema, 0u).GetAs<int32_t>());
+  }
+  EXPECT_EQ(ids, expected);
+
+  // A projection gets the same rows from the views of its child as from its copies.
+  std::vector<TabCol> sel_cols{{.tab_name = TEST_TABLE_NAME, .col_name = "name", .aggregation_type = NO_AGG},
+                               {.tab_name = TEST_TABLE_NAME, .col_name = "id", .aggregation_type = NO_AGG}};
+  auto project = [&](bool use_views) {
+    ProjectionExecutor projection(std::make_unique<RmScanExecutor>(fh.get(), schema, use_views), sel_cols, false);
+    std::vector<std::string> rows;
+    for (projection.beginTuple(); !projection.IsEnd(); projection.nextTuple()) {
+      rows.push_back(projection.Next()->ToString(&projection.schema()));
+    }
+    return rows;
+  };
+  std::vector<std::string> by_view = project(true);
+  EXPECT_EQ(by_view.size(), expected.size());
+  EXPECT_EQ(by_view, project(false));
+
+  // Scans given up in the middle of a page unpin it: all the frames can be pinned at once afterwards.
+  {
+    RmScan scan(fh.get());
+    scan.Next();
+    scan.Next();
+    EXPECT_EQ(scan.GetRid().GetPageId(), third_page);
+  }
+  {
+    ProjectionExecutor projection(std::make_unique<RmScanExecutor>(fh.get(), schema, true), sel_cols, false);
+    projection.beginTuple();
+    projection.nextTuple();
+    ASSERT_FALSE(projection.IsEnd());
+  }
+  ASSERT_GE(fh->GetFileHdr().num_pages, 16);
+  for (page_id_t page_no = 0; page_no < 16; page_no++) {
+    ASSERT_NE(bpm.FetchPage({fh->GetFd(), page_no}), nullptr) << "frame leaked after " << page_no << " pages";
+  }
+  for (page_id_t page_no = 0; page_no < 16; page_no++) {
+    EXPECT_TRUE(bpm.UnpinPage({fh->GetFd(), page_no}, false));
+  }
+
+  rm_manager.CloseFile(fh.get());
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
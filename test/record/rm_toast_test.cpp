@@ -0,0 +1,143 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_toast_test.cpp
+ *
+ * Identification: test/record/rm_toast_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/stats.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "record/rm_toast.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_toast_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_toast_test.table";
+
+static auto RandomText(size_t size, unsigned seed) -> std::string {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist('!', '~');
+  std::string text(size, ' ');
+  for (auto &c : text) {
+    c = static_cast<char>(dist(gen));
+  }
+  return text;
+}
+
+static auto CountRecords(RmFileHandle *fh) -> size_t {
+  size_t num_records = 0;
+  for (RmScan scan(fh); !scan.IsEnd(); scan.Next()) {
+    num_records++;
+  }
+  return num_records;
+}
+
+// NOLINTNEXTLINE
+TEST(RmToastTest, CompressTest) {
+  std::string text;
+  for (int i = 0; i < 500; i++) {
+    text += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\", \"tags\": [\"a\", \"b\"]}";
+  }
+  std::vector<char> compressed;
+  ASSERT_TRUE(RmToast::Compress(text.data(), text.size(), text.size() - text.size() / 4, &compressed));
+  EXPECT_LT(compressed.size(), text.size() / 4);
+  std::string decompressed(text.size(), '\0');
+  RmToast::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+  EXPECT_EQ(decompressed, text);
+
+  // random bytes do not get a quarter smaller, and a corrupt input is detected
+  std::string random = RandomText(5000, 1);
+  EXPECT_FALSE(RmToast::Compress(random.data(), random.size(), random.size() - random.size() / 4, &compressed));
+  compressed = {static_cast<char>(1), static_cast<char>(10), static_cast<char>(0), static_cast<char>(0)};
+  EXPECT_THROW(RmToast::Decompress(compressed.data(), compressed.size(), decompressed.data(), 10), InternalError);
+}
+
+// NOLINTNEXTLINE
+TEST(RmToastTest, ToastTest) {
+  Schema schema({Column("id", TYPE_INT), Column("note", TYPE_VARCHAR, 16), Column("body", TYPE_VARCHAR, 30000)});
+  RmToastLayout layout;
+  layout.inlined_size_ = schema.GetInlinedStorageSize();
+  for (uint32_t col_idx : schema.GetUnlinedColumns()) {
+    layout.varlen_offsets_.push_back(schema.GetColumn(col_idx).GetOffset());
+  }
+  const Column &body_col = schema.GetColumn("body");
+  const std::vector<uint32_t> body_cols{body_col.GetOffset()};
+  const std::vector<uint32_t> no_cols;
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  BufferPoolManager bpm(64, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    rm_manager.DestoryFile(path);
+  }
+  rm_manager.CreateFile(path, 100);
+  auto fh = rm_manager.OpenFile(path, {}, layout);
+  ASSERT_NE(fh->GetToast(), nullptr);
+
+  // a random value is stored as it is, a repetitive one compressed, a short one stays in its record
+  std::vector<std::string> bodies{RandomText(20000, 2), std::string(20000, 'x'), "short", RandomText(3000, 3)};
+  std::vector<RID> rids;
+  for (size_t i = 0; i < bodies.size(); i++) {
+    Tuple tuple({Value(TYPE_INT, static_cast<int>(i)), Value(TYPE_VARCHAR, "note"), Value(TYPE_VARCHAR, bodies[i])},
+                &schema);
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, tuple, nullptr));
+  }
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    EXPECT_LE(scan.GetTupleView().GetLength(), RmToast::TOAST_TUPLE_THRESHOLD);
+  }
+  for (size_t i = 0; i < bodies.size(); i++) {
+    auto [meta, tuple] = fh->GetTuple(rids[i], nullptr);
+    EXPECT_EQ(tuple.GetValue(&schema, "body").ToString(), bodies[i]);
+    EXPECT_EQ(tuple.GetValue(&schema, "note").ToString(), "note");
+  }
+
+  // the other columns of a record are read without touching its chunks
+  uint64_t chunks_read = Stats::Snapshot().Get(StatCounter::TOAST_CHUNKS_READ);
+  for (size_t i = 0; i < bodies.size(); i++) {
+    auto tuple = fh->GetTupleValue(rids[i], nullptr, &no_cols);
+    EXPECT_EQ(tuple->GetValue(&schema, "id").GetAs<int>(), static_cast<int>(i));
+    EXPECT_EQ(tuple->GetValue(&schema, "note").ToString(), "note");
+  }
+  EXPECT_EQ(Stats::Snapshot().Get(StatCounter::TOAST_CHUNKS_READ), chunks_read);
+  EXPECT_EQ(fh->GetTupleValue(rids[0], nullptr, &body_cols)->GetValue(&schema, "body").ToString(), bodies[0]);
+  // 20000 random characters and the '\0' take 21 chunks
+  EXPECT_EQ(Stats::Snapshot().Get(StatCounter::TOAST_CHUNKS_READ), chunks_read + 21);
+
+  // an update frees the chunks of the value it replaces, a delete only once the record is vacuumed
+  std::string new_body = RandomText(8000, 4);
+  Tuple updated({Value(TYPE_INT, 0), Value(TYPE_VARCHAR, "note"), Value(TYPE_VARCHAR, new_body)}, &schema);
+  EXPECT_TRUE(fh->UpdateTupleInPlace(TupleMeta{0, false}, updated, rids[0], nullptr));
+  EXPECT_EQ(fh->GetTuple(rids[0], nullptr).second.GetValue(&schema, "body").ToString(), new_body);
+  fh->DeleteTuple(rids[3], nullptr);
+  rm_manager.CloseFile(fh.get());
+
+  auto chunks = rm_manager.OpenFile(path + RM_TOAST_SUFFIX);
+  EXPECT_EQ(CountRecords(chunks.get()), 9 + 1 + 4);
+  rm_manager.CloseFile(chunks.get());
+
+  fh = rm_manager.OpenFile(path, {}, layout);
+  fh->Vacuum();
+  EXPECT_EQ(fh->GetTuple(rids[1], nullptr).second.GetValue(&schema, "body").ToString(), bodies[1]);
+  rm_manager.CloseFile(fh.get());
+  chunks = rm_manager.OpenFile(path + RM_TOAST_SUFFIX);
+  EXPECT_EQ(CountRecords(chunks.get()), 9 + 1);
+  rm_manager.CloseFile(chunks.get());
+
+  rm_manager.DestoryFile(path);
+  EXPECT_FALSE(disk_manager.IsFile(path + RM_TOAST_SUFFIX));
+}
+
+}  // namespace easydb
@@ -0,0 +1,109 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_vacuum_test.cpp
+ *
+ * Identification: test/record/rm_vacuum_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_vacuum_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_vacuum_test.table";
+
+// NOLINTNEXTLINE
+TEST(RmVacuumTest, CompactKeepsRidsTest) {
+  const int record_size = 100;
+  const int num_records = 1000;
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (disk_manager.IsFile(path)) {
+    disk_manager.DestroyFile(path);
+  }
+  BufferPoolManager bpm(64, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  rm_manager.CreateFile(path, record_size);
+  auto fh = rm_manager.OpenFile(path);
+
+  std::vector<RID> rids;
+  std::vector<char> data(record_size);
+  for (int i = 0; i < num_records; i++) {
+    std::memset(data.data(), i % 128, record_size);
+    std::memcpy(data.data(), &i, sizeof(i));
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr));
+  }
+  int num_pages = fh->GetNumPages();
+  page_id_t last_page = rids.back().GetPageId();
+
+  // delete every other record, and everything on the last page
+  std::vector<bool> deleted(num_records, false);
+  for (int i = 0; i < num_records; i++) {
+    if (i % 2 == 0 || rids[i].GetPageId() == last_page) {
+      fh->DeleteTuple(rids[i], nullptr);
+      deleted[i] = true;
+    }
+  }
+  EXPECT_GT(fh->GetNumDeadTuples(), static_cast<size_t>(num_records / 2));
+
+  RmVacuumStats stats = fh->Vacuum();
+  EXPECT_EQ(stats.pages_scanned_, static_cast<size_t>(num_pages - RM_FIRST_RECORD_PAGE));
+  EXPECT_EQ(stats.pages_compacted_, stats.pages_scanned_);
+  EXPECT_EQ(stats.pages_emptied_, 1u);
+  EXPECT_GE(stats.bytes_reclaimed_, static_cast<size_t>(num_records / 2 * record_size));
+  EXPECT_GT(stats.slots_reclaimed_, 0u);
+  EXPECT_EQ(fh->GetNumDeadTuples(), 0u);
+
+  // the live records are still found under their old RIDs, with their old contents
+  for (int i = 0; i < num_records; i++) {
+    if (deleted[i]) {
+      continue;
+    }
+    auto [meta, tuple] = fh->GetTuple(rids[i], nullptr);
+    ASSERT_FALSE(meta.is_deleted_);
+    ASSERT_EQ(tuple.GetLength(), static_cast<uint32_t>(record_size));
+    EXPECT_EQ(*reinterpret_cast<const int *>(tuple.GetData()), i);
+    EXPECT_EQ(tuple.GetData()[record_size - 1], static_cast<char>(i % 128));
+  }
+  std::vector<int> scanned;
+  for (RmScan scan(fh.get()); !scan.IsEnd(); scan.Next()) {
+    scanned.push_back(*reinterpret_cast<const int *>(scan.GetTupleView().GetData()));
+  }
+  std::vector<int> expected;
+  for (int i = 0; i < num_records; i++) {
+    if (!deleted[i]) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(scanned, expected);
+
+  // nothing is left to reclaim
+  RmVacuumStats again = fh->Vacuum();
+  EXPECT_EQ(again.pages_compacted_, 0u);
+  EXPECT_EQ(again.bytes_reclaimed_, 0u);
+
+  // the space goes back to the inserts, the file does not grow
+  int num_inserts = static_cast<int>(stats.bytes_reclaimed_ / (record_size + RmPageHandle::COMPACT_SLOT_SIZE)) / 2;
+  for (int i = 0; i < num_inserts; i++) {
+    ASSERT_TRUE(fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr).has_value());
+  }
+  EXPECT_EQ(fh->GetNumPages(), num_pages);
+
+  rm_manager.CloseFile(fh.get());
+  disk_manager.DestroyFile(path);
+}
+
+}  // namespace easydb
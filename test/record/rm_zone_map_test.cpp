@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------
+ *
+ * EasyDB
+ *
+ * rm_zone_map_test.cpp
+ *
+ * Identification: test/record/rm_zone_map_test.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "record/rm_manager.h"
+#include "record/rm_scan.h"
+#include "storage/disk/disk_manager.h"
+
+namespace easydb {
+
+const std::string TEST_DB_NAME = "rm_zone_map_test.easydb";
+const std::string TEST_TABLE_NAME = "rm_zone_map_test.table";
+
+// NOLINTNEXTLINE
+TEST(RmZoneMapTest, SkipPagesTest) {
+  // (int id, double price), 12 bytes a record, ids inserted in order
+  const int record_size = 12;
+  const int num_records = 5000;
+  const std::vector<RmZoneColumn> zone_columns{{0, TYPE_INT}, {4, TYPE_DOUBLE}};
+
+  DiskManager disk_manager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  BufferPoolManager bpm(16, &disk_manager);
+  RmManager rm_manager(&disk_manager, &bpm);
+  if (disk_manager.IsFile(path)) {
+    rm_manager.DestoryFile(path);
+  }
+  rm_manager.CreateFile(path, record_size);
+  auto fh = rm_manager.OpenFile(path, zone_columns);
+  ASSERT_NE(fh->GetZoneMap(), nullptr);
+
+  auto make_record = [&](int id, double price) {
+    std::vector<char> data(record_size);
+    std::memcpy(data.data(), &id, sizeof(id));
+    std::memcpy(data.data() + 4, &price, sizeof(price));
+    return data;
+  };
+  std::vector<RID> rids;
+  for (int i = 0; i < num_records; i++) {
+    auto data = make_record(i, i * 0.5);
+    rids.push_back(*fh->InsertTuple(TupleMeta{0, false}, Tuple(record_size, data.data()), nullptr));
+  }
+  page_id_t last_page = rids.back().GetPageId();
+  ASSERT_GT(last_page, RM_FIRST_RECORD_PAGE + 2);
+
+  // the ranges of a page are those of the records on it
+  std::vector<std::pair<Value, Value>> zones;
+  page_id_t page_no = rids[num_records / 2].GetPageId();
+  ASSERT_TRUE(fh->GetZoneMap()->GetZones(page_no, &zones));
+  int first = num_records / 2;
+  while (first > 0 && rids[first - 1].GetPageId() == page_no) {
+    first--;
+  }
+  int last = num_records / 2;
+  while (last + 1 < num_records && rids[last + 1].GetPageId() == page_no) {
+    last++;
+  }
+  EXPECT_TRUE(zones[0].first == Value(TYPE_INT, first));
+  EXPECT_TRUE(zones[0].second == Value(TYPE_INT, last));
+  EXPECT_TRUE(zones[1].second == Value(TYPE_DOUBLE, last * 0.5));
+
+  // an update widens the range of its page, neither it nor a delete narrows it
+  auto data = make_record(-7, 0);
+  EXPECT_TRUE(fh->UpdateTupleInPlace(TupleMeta{0, false}, Tuple(record_size, data.data()), rids[last], nullptr));
+  fh->DeleteTuple(rids[last - 1], nullptr);
+  ASSERT_TRUE(fh->GetZoneMap()->GetZones(page_no, &zones));
+  EXPECT_TRUE(zones[0].first == Value(TYPE_INT, -7));
+  EXPECT_TRUE(zones[0].second == Value(TYPE_INT, last));
+
+  // a scan filtering on id < 100 only reads the first page and the one with the updated record
+  {
+    std::vector<std::pair<Value, Value>> page_zones;
+    RmScan scan(fh.get(), nullptr, [&](page_id_t page) {
+      return fh->GetZoneMap()->GetZones(page, &page_zones) && page_zones[0].first < Value(TYPE_INT, 100);
+    });
+    std::vector<int> scanned;
+    for (; !scan.IsEnd(); scan.Next()) {
+      int id;
+      std::memcpy(&id, scan.GetTupleView().GetData(), sizeof(id));
+      if (id < 100) {
+        scanned.push_back(id);
+      }
+    }
+    EXPECT_EQ(scanned.size(), 101u);
+    EXPECT_EQ(scan.GetNumPagesSkipped(), static_cast<size_t>(last_page - RM_FIRST_RECORD_PAGE + 1 - 2));
+  }
+
+  // the ranges are kept over a clean close
+  rm_manager.CloseFile(fh.get());
+  fh = rm_manager.OpenFile(path, zone_columns);
+  EXPECT_FALSE(fh->GetZoneMap()->NeedsRebuild());
+  ASSERT_TRUE(fh->GetZoneMap()->GetZones(page_no, &zones));
+  EXPECT_TRUE(zones[0].first == Value(TYPE_INT, -7));
+
+  // vacuum computes the ranges of the pages it compacts again, without the deleted record
+  fh->Vacuum();
+  ASSERT_TRUE(fh->GetZoneMap()->GetZones(page_no, &zones));
+  EXPECT_TRUE(zones[0].first == Value(TYPE_INT, -7));
+  EXPECT_TRUE(zones[0].second == Value(TYPE_INT, last - 2));
+  rm_manager.CloseFile(fh.get());
+
+  // a map kept for other columns is built again from the records
+  fh = rm_manager.OpenFile(path, {{4, TYPE_DOUBLE}});
+  EXPECT_TRUE(fh->GetZoneMap()->NeedsRebuild());
+  ASSERT_TRUE(fh->GetZoneMap()->GetZones(page_no, &zones));
+  ASSERT_EQ(zones.size(), 1u);
+  EXPECT_TRUE(zones[0].first == Value(TYPE_DOUBLE, 0.0));
+  EXPECT_TRUE(zones[0].second == Value(TYPE_DOUBLE, (last - 2) * 0.5));
+  rm_manager.CloseFile(fh.get());
+  rm_manager.DestoryFile(path);
+}
+
+}  // namespace easydb
@@ -1,6 +1,9 @@
 
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -49,4 +52,117 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.CloseFile(fd);
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReadWritePagesTest) {
+  const size_t num_pages = 8;
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<std::vector<char>> buf(num_pages, std::vector<char>(PAGE_SIZE, 'x'));
+  std::vector<const char *> data_ptrs;
+  std::vector<char *> buf_ptrs;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::memset(data[i].data(), static_cast<int>('a' + i), PAGE_SIZE);
+    data_ptrs.push_back(data[i].data());
+    buf_ptrs.push_back(buf[i].data());
+  }
+  auto dm = DiskManager(TEST_DB_NAME);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (dm.IsFile(path)) {
+    dm.DestroyFile(path);
+  }
+  dm.CreateFile(path);
+  int fd = dm.OpenFile(path);
+
+  // pages 2..5 are written, reading 0..7 zero fills the pages that do not exist yet
+  dm.WritePages(fd, 2, data_ptrs.data() + 2, 4);
+  dm.ReadPages(fd, 0, buf_ptrs.data(), num_pages);
+  std::vector<char> zero(PAGE_SIZE, 0);
+  for (size_t i = 0; i < num_pages; i++) {
+    const auto &expected = i >= 2 && i < 6 ? data[i] : zero;
+    EXPECT_EQ(std::memcmp(buf[i].data(), expected.data(), PAGE_SIZE), 0) << "page " << i;
+  }
+
+  dm.CloseFile(fd);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PageBatchTest) {
+  auto dm = DiskManager(TEST_DB_NAME);
+  std::string path1 = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  std::string path2 = TEST_DB_NAME + "/" + TEST_TABLE_NAME + "2";
+  for (const auto &path : {path1, path2}) {
+    if (!dm.IsFile(path)) {
+      dm.CreateFile(path);
+    }
+  }
+  int fds[2] = {dm.OpenFile(path1), dm.OpenFile(path2)};
+
+  // run the batch once with preadv/pwritev and once with io_uring (if the kernel allows it)
+  for (bool use_io_uring : {false, true}) {
+    dm.SetIoUringEnabled(use_io_uring);
+    const int pages_per_file = 20;
+    std::vector<std::vector<char>> data(2 * pages_per_file, std::vector<char>(PAGE_SIZE));
+    std::vector<std::vector<char>> buf(2 * pages_per_file, std::vector<char>(PAGE_SIZE));
+    std::vector<PageIORequest> writes;
+    std::vector<PageIORequest> reads;
+    // a shuffled batch with a hole in the middle of each file
+    for (int i = 2 * pages_per_file - 1; i >= 0; i--) {
+      int page_no = i % pages_per_file;
+      if (page_no == 7) {
+        continue;
+      }
+      std::snprintf(data[i].data(), PAGE_SIZE, "file %d page %d io_uring %d", i / pages_per_file, page_no,
+                    use_io_uring);
+      writes.push_back({fds[i / pages_per_file], page_no, data[i].data()});
+      reads.push_back({fds[i / pages_per_file], page_no, buf[i].data()});
+    }
+    dm.WritePageBatch(writes);
+    dm.ReadPageBatch(reads);
+    for (int i = 0; i < 2 * pages_per_file; i++) {
+      if (i % pages_per_file != 7) {
+        EXPECT_EQ(std::memcmp(buf[i].data(), data[i].data(), PAGE_SIZE), 0) << "request " << i;
+      }
+    }
+  }
+
+  dm.CloseFile(fds[0]);
+  dm.CloseFile(fds[1]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOTest) {
+  auto dm = DiskManager(TEST_DB_NAME);
+  dm.SetDirectIO(true);
+  std::string path = TEST_DB_NAME + "/" + TEST_TABLE_NAME;
+  if (dm.IsFile(path)) {
+    dm.DestroyFile(path);
+  }
+  dm.CreateFile(path);
+  int fd = dm.OpenFile(path);  // falls back to buffered I/O if the filesystem rejects O_DIRECT
+
+  // aligned pages go straight to disk, unaligned buffers and partial pages through a bounce buffer
+  char *aligned = static_cast<char *>(std::aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, 2 * PAGE_SIZE));
+  std::vector<char> unaligned(PAGE_SIZE + 1);
+  std::memset(aligned, 'a', 2 * PAGE_SIZE);
+  dm.WritePages(fd, 1, std::vector<const char *>{aligned, aligned + PAGE_SIZE}.data(), 2);
+  std::memset(unaligned.data() + 1, 'u', PAGE_SIZE);
+  dm.WritePage(fd, 3, unaligned.data() + 1, PAGE_SIZE);
+  const char header[] = "file header";
+  dm.WritePage(fd, 1, header, sizeof(header));
+
+  dm.ReadPage(fd, 1, unaligned.data() + 1, PAGE_SIZE);
+  EXPECT_EQ(std::memcmp(unaligned.data() + 1, header, sizeof(header)), 0);
+  EXPECT_EQ(unaligned[1 + sizeof(header)], 'a');
+  EXPECT_EQ(unaligned[PAGE_SIZE], 'a');
+  char small[8];
+  dm.ReadPage(fd, 3, small, sizeof(small));
+  EXPECT_EQ(small[7], 'u');
+  dm.ReadPages(fd, 2, std::vector<char *>{aligned, aligned + PAGE_SIZE}.data(), 2);
+  EXPECT_EQ(aligned[0], 'a');
+  EXPECT_EQ(aligned[2 * PAGE_SIZE - 1], 'u');
+
+  std::free(aligned);
+  dm.CloseFile(fd);
+  EXPECT_FALSE(dm.IsDirectFd(fd));
+}
+
 }  // namespace easydb